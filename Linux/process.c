@@ -17,15 +17,32 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <math.h>
 #include <time.h>
 #include <unistd.h>
 #include <termios.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "process.h"
 
 #define FILE_NAME "process.txt"
 
 /* ------------------------------------------------------------------------------------------ Begin of weird stuff */
 
+// The library build (-DPROCESS_NO_MAIN) has no menus and never waits for keys
+#ifndef PROCESS_NO_MAIN
+
 // https://stackoverflow.com/questions/7469139/what-is-equivalent-to-getch-getche-in-linux
 
 char getch()
@@ -77,44 +94,50 @@ void sleep_ms(int milliseconds) // cross-platform sleep function
 #endif
 }
 
+#endif
+
 /* ------------------------------------------------------------------------------------------ End of weird stuff */
 
 /* ---------------------------------------------------------------------------------------------------- Core.h */
 
+#ifndef PROCESS_NO_MAIN
+
 //#define CLEAR_SCREEN system("cls")
 #define CLEAR_SCREEN system("clear")
 
 //#define SLEEP_F Sleep(200)
 #define SLEEP_F sleep_ms(300)
 
+#define ENTER getch()
+
+#endif
+
 #define PROCESS_MAX_PRI 5
 
-#define ENTER getch()
+// Forces inlining where a call through a constant function table has to
+// become a direct call
+#ifdef _MSC_VER
+#define FORCE_INLINE static __forceinline
+#else
+#define FORCE_INLINE static inline __attribute__((always_inline))
+#endif
 
-/**
- * @brief Status code returned by functions
- *
- * These status codes are returned by almost all functions in the project.
- * They are used to prevent unwanted results when a function fails and can
- * also be used by the user to control his/her own program flow.
- *
- */
-typedef enum Status
+// Index of the lowest set bit, bits must not be 0
+#ifdef _MSC_VER
+#include <intrin.h>
+static inline size_t bit_lowest(uint64_t bits)
 {
-	DS_OK = 0,					  /**< Returned by a function when all operations were successful */
-	DS_ERR_INVALID_POSITION = 1,  /**< When an invalid position is passed as argument */
-	DS_ERR_INVALID_OPERATION = 2, /**< When an invalid operation is made (e.g. remove element of an empty list ) */
-	DS_ERR_INVALID_SIZE = 3,	  /**< When an invalid size is given */
-	DS_ERR_NOT_FOUND = 4,		  /**< When a search fails to find a value */
-	DS_ERR_ALLOC = 5,			  /**< When a function fails to allocate memory  */
-	DS_ERR_UNEXPECTED_RESULT = 6, /**< When an unexpected result happens. Contact developers. */
-	DS_ERR_ITER = 7,			  /**< When an iteration reaches an unexpected value */
-	DS_ERR_NULL_POINTER = 8,	  /**< When a @c NULL parameter is passed to a function */
-	DS_ERR_FULL = 9,			  /**< When a structure reaches its maximum capacity */
-	DS_ERR_INVALID_ARGUMENT = 10  /**< When an argument passed is invalid for that operation */
-} Status;
+	unsigned long index;
+
+	_BitScanForward64(&index, bits);
 
-char *status_repr(Status status);
+	return index;
+}
+#else
+#define bit_lowest(bits) ((size_t)__builtin_ctzll(bits))
+#endif
+
+// Status and status_repr are part of the library interface, in process.h
 
 void print_status_repr(Status status);
 
@@ -189,6 +212,37 @@ Status str_realloc(String *str);
 
 /* ---------------------------------------------------------------------------------------------------- String.h */
 
+/* ---------------------------------------------------------------------------------------------------- BurstArena.h */
+
+#define BURST_ARENA_INIT_SIZE 1024 /*!< Bursts the first buffer holds */
+
+/**
+ * @brief The CPU and I/O bursts of many processes in one buffer
+ *
+ * Each process keeps the offset and the number of its bursts, so a table
+ * with millions of them costs a few reallocations of one buffer instead of
+ * an allocation per process. Every process with bursts holds a reference,
+ * as does whoever appends to it, and the last one to let go frees it. The
+ * references are atomic so copies of one table can be made on several
+ * threads, the bursts themselves never change once appended.
+ */
+typedef struct BurstArena
+{
+	size_t *burst;	 /*!< Bursts of each process one after the other */
+	size_t length;	 /*!< Entries of burst in use */
+	size_t capacity;   /*!< Entries burst can hold */
+	size_t references; /*!< Processes and readers holding the arena */
+} BurstArena;
+
+Status brs_init(BurstArena **arena);
+
+Status brs_reserve(BurstArena *arena, size_t count);
+
+void brs_retain(BurstArena *arena);
+void brs_release(BurstArena **arena);
+
+/* ---------------------------------------------------------------------------------------------------- BurstArena.h */
+
 /* ---------------------------------------------------------------------------------------------------- Process.h */
 
 typedef struct Process
@@ -199,8 +253,41 @@ typedef struct Process
 	size_t io;
 	size_t pri;
 	struct String *type; // SO UI UNI -> 0, 1, 2
+	size_t arrival;		 // Tick in which the process enters the system, given by the table or the submission
+	size_t first_run;	// Tick of the first dispatch, PROCESS_NOT_RUN before it
+	size_t finish;		 // Tick in which the process finished its execution
+	size_t waiting;		 // Ticks spent in a ready queue
+	size_t blocked;		 // Ticks spent blocked on I/O
+	size_t since;		 // Tick of the last ready or blocked transition
+	size_t slot;		 // Position in an IndexedHeap or LotteryPool, PROCESS_NO_SLOT when in none
+	size_t level;		 // Level in a MultilevelQueue
+	size_t generation;   // MultilevelQueue boost in which level was set
+	size_t vruntime;	 // Weighted CPU time of the fair scheduler
+	size_t period;		 // Ticks between two job releases, 0 when not periodic
+	size_t deadline;	 // Ticks a job has after its release, 0 for none (the period when periodic)
+	size_t job_cpu;		 // CPU time of each job
+	size_t job_io;		 // I/O time of each job
+	size_t job;			 // Current job, counted from 0
+	size_t due;			 // Absolute deadline of the current job, PROCESS_NO_DEADLINE for none
+	size_t jobs;		 // Jobs finished that had a deadline
+	size_t misses;		 // Jobs finished after their deadline
+	bool killed;		 // Killed by sch_kill
+	struct BurstArena *arena; // Where its bursts are, NULL when it is a single CPU phase with cpu and io
+	size_t first_burst;		  // Offset of its first burst in arena
+	size_t bursts;			  // CPU and I/O bursts in turn, starting and ending with CPU, 0 without arena
+	size_t burst;			  // Burst it is in, even when CPU, from 0 in every job
 } Process;
 
+// Every field of a process but its name, type and bursts, in declaration order
+#define PROCESS_FIELDS(X)                                                                                \
+	X(pid) X(cpu) X(io) X(pri) X(arrival) X(first_run) X(finish) X(waiting) X(blocked) X(since) X(slot) \
+		X(level) X(generation) X(vruntime) X(period) X(deadline) X(job_cpu) X(job_io) X(job) X(due)     \
+			X(jobs) X(misses) X(killed)
+
+#define PROCESS_NOT_RUN ((size_t)-1)
+#define PROCESS_NO_SLOT ((size_t)-1)
+#define PROCESS_NO_DEADLINE ((size_t)-1)
+
 Status prc_init(Process **prc, String *name, size_t pid, size_t cpu, size_t io, size_t pri, String *type);
 
 Status prc_delete(Process **prc);
@@ -211,6 +298,14 @@ int prc_compare(Process *prc1, Process *prc2);
 
 Status prc_copy(Process *prc, Process **result);
 
+void prc_set_bursts(Process *prc, BurstArena *arena, size_t first, size_t count);
+bool prc_same_bursts(Process *prc1, Process *prc2);
+
+void prc_dispatch(Process *prc, size_t now);
+void prc_ready(Process *prc, size_t now);
+void prc_block(Process *prc, size_t now);
+void prc_unblock(Process *prc, size_t now);
+
 /* ---------------------------------------------------------------------------------------------------- Process.h */
 
 /* ---------------------------------------------------------------------------------------------------- QueueArray.h */
@@ -325,1934 +420,2726 @@ Status dar_realloc(DynamicArray *dar);
 
 /* ---------------------------------------------------------------------------------------------------- PriorityQueue.h */
 
+// Backends of the priority queue, one is picked at compile time with
+// -DPQUEUE_BACKEND=<n>. All of them have the same interface and give the
+// same order, so the choice only changes how fast the queue is.
+#define PQUEUE_BINARY 0		// Indexed binary heap
+#define PQUEUE_QUATERNARY 1 // Indexed 4-ary heap, half as deep, more compares per level
+#define PQUEUE_PAIRING 2	// Pairing heap, O(1) enqueue and O(1) decrease of a priority
+#define PQUEUE_RADIX 3		// Radix heap, for priorities that mostly grow, like ticks
+
+#ifndef PQUEUE_BACKEND
+#define PQUEUE_BACKEND PQUEUE_BINARY
+#endif
+
 #ifndef PQUEUE_ARRAY_SPEC
 #define PQUEUE_ARRAY_SPEC
 
+#define PQUEUE_INIT_SIZE 8
+#define PQUEUE_GROW_RATE 2
 #define PQUEUE_T Process *
+#define PQUEUE_SLOT(value) ((value)->slot) // Where a value keeps its position, its handle in the queue
+#define PQUEUE_NO_SLOT PROCESS_NO_SLOT
 #define PQUEUE_DELETE prc_delete
 #define PQUEUE_DISPLAY prc_display
 
 #endif
 
+#if PQUEUE_BACKEND == PQUEUE_BINARY
+#define PQUEUE_BACKEND_NAME "binary heap"
+#elif PQUEUE_BACKEND == PQUEUE_QUATERNARY
+#define PQUEUE_BACKEND_NAME "4-ary heap"
+#elif PQUEUE_BACKEND == PQUEUE_PAIRING
+#define PQUEUE_BACKEND_NAME "pairing heap"
+#elif PQUEUE_BACKEND == PQUEUE_RADIX
+#define PQUEUE_BACKEND_NAME "radix heap"
+#else
+#error "Unknown PQUEUE_BACKEND"
+#endif
+
+#define PQUEUE_ARITY (PQUEUE_BACKEND == PQUEUE_QUATERNARY ? 4 : 2) // Children of a heap node
+#define PQUEUE_RADIX_BUCKETS 65									   // Not above last, then one per highest differing bit
+#define PQUEUE_NIL ((size_t)-1)									   // No pairing heap node
+#define PQUEUE_FREE ((size_t)-2)								   // prev of an unused pairing heap node
+
 typedef struct PriorityQueueNode
 {
-	PQUEUE_T data;					/*!< Node's data */
-	size_t priority;				/*!< Node's priority */
-	struct PriorityQueueNode *prev; /*!< Pointer to the previous node in the @c PriorityQueue */
+	PQUEUE_T data;   /*!< Node's data */
+	size_t priority; /*!< Node's priority, lowest first */
+	size_t order;	/*!< Insertion number, orders equal priorities */
+#if PQUEUE_BACKEND == PQUEUE_PAIRING
+	size_t child;   /*!< First child */
+	size_t sibling; /*!< Next sibling, or next unused node */
+	size_t prev;	/*!< Previous sibling, parent of a first child, or PQUEUE_FREE */
+#endif
 } PriorityQueueNode;
 
+/**
+ * @brief Indexed priority queue
+ *
+ * Every value keeps its own handle in the queue through PQUEUE_SLOT, so
+ * the priority of a queued value can be changed, or the value removed,
+ * without looking for it. Equal priorities leave in insertion order.
+ *
+ * The heaps keep their nodes in buffer and the handle is the index. The
+ * pairing heap uses buffer as a pool of linked nodes. The radix heap puts
+ * each node in the bucket of the highest bit where its priority differs
+ * from last, with index * PQUEUE_RADIX_BUCKETS + bucket as the handle.
+ * Bucket 0 is a heap of every priority not above last, so a priority that
+ * goes back below last costs a heap push instead of breaking the buckets.
+ */
 typedef struct PriorityQueue
 {
-	size_t length;					 /*!< Total @c Queue length */
-	struct PriorityQueueNode *front; /*!< Where @c PriorityQueueNode are removed */
-	struct PriorityQueueNode *rear;  /*!< Where @c PriorityQueueNode are inserted */
+#if PQUEUE_BACKEND == PQUEUE_RADIX
+	PriorityQueueNode *bucket[PQUEUE_RADIX_BUCKETS]; /*!< Nodes of each bucket */
+	size_t used[PQUEUE_RADIX_BUCKETS];				  /*!< Nodes in each bucket */
+	size_t room[PQUEUE_RADIX_BUCKETS];				  /*!< Nodes each bucket can hold */
+	size_t last;									  /*!< Only bucket 0 has priorities up to this */
+#else
+	PriorityQueueNode *buffer; /*!< Heap ordered nodes, or the pool of nodes */
+	size_t capacity;		   /*!< Nodes the buffer can hold */
+#endif
+#if PQUEUE_BACKEND == PQUEUE_PAIRING
+	size_t root; /*!< Node with the lowest priority */
+	size_t free; /*!< First unused node */
+#endif
+	size_t length; /*!< Total @c Queue length */
+	size_t order;  /*!< Insertion number of the next enqueue */
 } PriorityQueue;
 
 Status prq_init_queue(PriorityQueue **prq);
 
-Status prq_make_node(PriorityQueueNode **node, PQUEUE_T value, size_t priority);
-
 Status prq_get_length(PriorityQueue *prq, size_t *result);
 
 Status prq_enqueue(PriorityQueue *prq, PQUEUE_T value, size_t priority);
 
 Status prq_dequeue(PriorityQueue *prq, PQUEUE_T *result);
+Status prq_peek(PriorityQueue *prq, PQUEUE_T *result);
+
+Status prq_update(PriorityQueue *prq, PQUEUE_T value, size_t priority);
+Status prq_remove(PriorityQueue *prq, PQUEUE_T value);
+
+bool prq_contains(PriorityQueue *prq, PQUEUE_T value);
 
 Status prq_display(PriorityQueue *prq);
 
-Status prq_delete_node(PriorityQueueNode **node);
 Status prq_delete_queue(PriorityQueue **prq); // Erases and sets to NULL
 Status prq_erase_queue(PriorityQueue **prq);  // Erases and inits
 
 bool prq_is_empty(PriorityQueue *prq);
 
-//Status prq_copy_node(PriorityQueueNode *node, PriorityQueueNode **result);
-//Status prq_copy_queue(PriorityQueue *prq, PriorityQueue **result);
-
 /* ---------------------------------------------------------------------------------------------------- PriorityQueue.h */
 
-/* ----------------------------------------------------------------------------------------------------
- *
- *                                                                                         Header Files
- *
- * ---------------------------------------------------------------------------------------------------- */
-
-/* ----------------------------------------------------------------------------------------------------
-*
-*                                                                                         Source Files
-*
-* ---------------------------------------------------------------------------------------------------- */
+/* ---------------------------------------------------------------------------------------------------- IndexedHeap.h */
 
-/* ---------------------------------------------------------------------------------------------------- Core.c */
+#define INDEXED_HEAP_INIT_SIZE 8
+#define INDEXED_HEAP_GROW_RATE 2
 
-char *status_repr(Status status)
+typedef struct IndexedHeapNode
 {
-	switch (status)
-	{
-	case DS_OK:
-		return "DS_OK";
-	case DS_ERR_INVALID_POSITION:
-		return "DS_ERR_INVALID_POSITION";
-	case DS_ERR_INVALID_OPERATION:
-		return "DS_ERR_INVALID_OPERATION";
-	case DS_ERR_INVALID_SIZE:
-		return "DS_ERR_INVALID_SIZE";
-	case DS_ERR_NOT_FOUND:
-		return "DS_ERR_NOT_FOUND";
-	case DS_ERR_ALLOC:
-		return "DS_ERR_ALLOC";
-	case DS_ERR_UNEXPECTED_RESULT:
-		return "DS_ERR_UNEXPECTED_RESULT";
-	case DS_ERR_ITER:
-		return "DS_ERR_ITER";
-	case DS_ERR_NULL_POINTER:
-		return "DS_ERR_NULL_POINTER";
-	case DS_ERR_FULL:
-		return "DS_ERR_FULL";
-	case DS_ERR_INVALID_ARGUMENT:
-		return "DS_ERR_INVALID_ARGUMENT";
-	default:
-		return "DS_UNKNOWN_ERROR";
-	}
-}
+	size_t key;	/*!< Node's key, lowest first */
+	size_t order;  /*!< Insertion number, orders equal keys */
+	Process *data; /*!< Node's process */
+} IndexedHeapNode;
 
-void print_status_repr(Status status)
+/**
+ * @brief Binary min-heap of processes that knows where each one is
+ *
+ * Every process keeps its own position in @c Process.slot, so the key of a
+ * queued process can be changed, or the process removed, in O(log n)
+ * without looking for it. Equal keys leave in insertion order.
+ */
+typedef struct IndexedHeap
 {
-	printf("\n%s", status_repr(status));
-}
+	IndexedHeapNode *buffer; /*!< Heap ordered nodes */
+	size_t length;			 /*!< Nodes in the heap */
+	size_t capacity;		 /*!< Nodes the buffer can hold */
+	size_t order;			 /*!< Insertion number of the next push */
+} IndexedHeap;
 
-/* ---------------------------------------------------------------------------------------------------- Core.c */
+Status ihp_init(IndexedHeap **ihp);
 
-/* ---------------------------------------------------------------------------------------------------- String.c */
+Status ihp_push(IndexedHeap *ihp, Process *prc, size_t key);
 
-Status str_init(String **str)
-{
-	(*str) = malloc(sizeof(String));
+Status ihp_peek(IndexedHeap *ihp, Process **result);
+Status ihp_pop(IndexedHeap *ihp, Process **result);
 
-	if (!(*str))
-		return DS_ERR_ALLOC;
+Status ihp_update(IndexedHeap *ihp, Process *prc, size_t key);
+Status ihp_remove(IndexedHeap *ihp, Process *prc);
 
-	(*str)->buffer = malloc(sizeof(char) * STRING_INIT_SIZE);
+bool ihp_contains(IndexedHeap *ihp, Process *prc);
+bool ihp_is_empty(IndexedHeap *ihp);
 
-	if (!((*str)->buffer))
-		return DS_ERR_ALLOC;
+Status ihp_display(IndexedHeap *ihp);
 
-	(*str)->buffer[0] = '\0';
+Status ihp_delete(IndexedHeap **ihp);
 
-	(*str)->capacity = STRING_INIT_SIZE;
-	(*str)->growth_rate = STRING_GROW_RATE;
+/* ---------------------------------------------------------------------------------------------------- IndexedHeap.h */
 
-	(*str)->len = 0;
+/* ---------------------------------------------------------------------------------------------------- RingBuffer.h */
 
-	return DS_OK;
-}
+#define RING_BUFFER_INIT_SIZE 8 /*!< Must be a power of two */
 
-Status str_make(String **str, char *string)
+/**
+ * @brief FIFO of processes in a circular buffer
+ *
+ * Unlike @c QueueArray, dequeuing does not shift the buffer, so both ends
+ * are O(1). The capacity stays a power of two so positions wrap with a mask.
+ */
+typedef struct RingBuffer
 {
-	size_t length = str_len(string);
+	Process **buffer; /*!< Circular buffer */
+	size_t front;	 /*!< Position of the oldest process */
+	size_t length;	/*!< Processes in the buffer */
+	size_t capacity;  /*!< Processes the buffer can hold */
+} RingBuffer;
 
-	if (length == 0)
-		return DS_ERR_INVALID_ARGUMENT;
+Status rbf_init(RingBuffer **rbf);
 
-	Status st = str_init(str);
+Status rbf_enqueue(RingBuffer *rbf, Process *prc);
+Status rbf_dequeue(RingBuffer *rbf, Process **result);
 
-	if (st != DS_OK)
-		return st;
+bool rbf_is_empty(RingBuffer *rbf);
 
-	if ((*str)->capacity <= length)
-	{
-		size_t new_capacity = STRING_INIT_SIZE;
+Status rbf_display(RingBuffer *rbf);
 
-		while (new_capacity <= length)
-		{
-			new_capacity *= STRING_GROW_RATE;
-		}
+Status rbf_delete(RingBuffer **rbf);
 
-		char *new_buffer = realloc((*str)->buffer, sizeof(char) * new_capacity);
+/* ---------------------------------------------------------------------------------------------------- RingBuffer.h */
 
-		if (!new_buffer)
-		{
-			(*str)->capacity = STRING_INIT_SIZE;
+/* ---------------------------------------------------------------------------------------------------- MultilevelQueue.h */
 
-			return DS_ERR_ALLOC;
-		}
+#define MLFQ_MAX_LEVELS 64 /*!< One bit of the occupancy bitmap per level */
 
-		(*str)->buffer = new_buffer;
+/**
+ * @brief One FIFO per priority level and lazy global boosts
+ *
+ * A bitmap tells which levels have processes, so the next process to run is
+ * one bit scan away. A boost sends every process back to level 0 without
+ * touching them, it only starts a new generation: a process queued before
+ * it sees it through its generation, which no longer matches
+ * mlq->generation. Those are served first, the ones of the earliest boost
+ * first and level by level within a boost, so what a boost left unserved
+ * stays ahead of what the next one lifts. A level queue is in push order,
+ * so its boosted processes are the ones at its front.
+ */
+typedef struct MultilevelQueue
+{
+	size_t levels;					  /*!< Levels in use */
+	RingBuffer *queue[MLFQ_MAX_LEVELS]; /*!< FIFO of each level */
+	uint64_t occupied;				  /*!< Bit i set when level i has processes */
+	uint64_t pending;				   /*!< Bit i set when the first process of level i is from before the last boost */
+	size_t generation;				  /*!< Boosts so far */
+	size_t length;					  /*!< Processes in all levels */
+} MultilevelQueue;
 
-		(*str)->capacity = new_capacity;
-	}
+Status mlq_init(MultilevelQueue **mlq, size_t levels);
 
-	(*str)->len = length;
+Status mlq_push(MultilevelQueue *mlq, Process *prc, size_t level);
+Status mlq_pop(MultilevelQueue *mlq, Process **result);
 
-	size_t i;
-	for (i = 0; i < length; i++)
-	{
-		(*str)->buffer[i] = string[i];
-	}
+void mlq_boost(MultilevelQueue *mlq, size_t boosts);
 
-	(*str)->buffer[length] = '\0';
+size_t mlq_level(MultilevelQueue *mlq, Process *prc);
+void mlq_set_level(MultilevelQueue *mlq, Process *prc, size_t level);
 
-	return DS_OK;
-}
+bool mlq_is_empty(MultilevelQueue *mlq);
 
-Status str_get_string(String *str, char **result)
+Status mlq_display(MultilevelQueue *mlq);
+
+Status mlq_delete(MultilevelQueue **mlq);
+
+/* ---------------------------------------------------------------------------------------------------- MultilevelQueue.h */
+
+/* ---------------------------------------------------------------------------------------------------- RedBlackTree.h */
+
+typedef struct RedBlackNode
 {
-	(*result) = NULL;
+	size_t key;					 /*!< Node's key, lowest first */
+	size_t order;				 /*!< Insertion number, orders equal keys */
+	Process *data;				 /*!< Node's process */
+	bool red;					 /*!< Node's color */
+	struct RedBlackNode *parent; /*!< Parent node, NULL for the root */
+	struct RedBlackNode *left;   /*!< Lesser keys */
+	struct RedBlackNode *right;  /*!< Greater or equal keys */
+} RedBlackNode;
 
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+/**
+ * @brief Red-black tree of processes with a cached leftmost node
+ *
+ * Insertion and removal of the minimum are O(log n) and finding the minimum
+ * is O(1). Equal keys leave in insertion order. Removed nodes are kept for
+ * the next insertions instead of being freed.
+ */
+typedef struct RedBlackTree
+{
+	RedBlackNode *root;		/*!< Tree root */
+	RedBlackNode *leftmost; /*!< Node with the lowest key */
+	RedBlackNode *spare;	/*!< Removed nodes, linked by right */
+	size_t length;			/*!< Nodes in the tree */
+	size_t order;			/*!< Insertion number of the next insertion */
+} RedBlackTree;
 
-	if (str_buffer_empty(str))
-		return DS_ERR_INVALID_OPERATION;
+Status rbt_init(RedBlackTree **rbt);
 
-	char *string = malloc(sizeof(char) * (str->len + 1));
+Status rbt_insert(RedBlackTree *rbt, Process *prc, size_t key);
 
-	if (!string)
-		return DS_ERR_ALLOC;
+Status rbt_peek_min(RedBlackTree *rbt, Process **result);
+Status rbt_pop_min(RedBlackTree *rbt, Process **result);
 
-	size_t i;
-	for (i = 0; i < str->len; i++)
-		string[i] = str->buffer[i];
+bool rbt_is_empty(RedBlackTree *rbt);
 
-	string[str->len] = '\0';
+Status rbt_display(RedBlackTree *rbt);
 
-	(*result) = string;
+Status rbt_delete(RedBlackTree **rbt);
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- RedBlackTree.h */
 
-Status str_push_char_front(String *str, char ch)
+/* ---------------------------------------------------------------------------------------------------- ProcessIndex.h */
+
+#define PROCESS_INDEX_INIT_SIZE 16 /*!< Must be a power of two */
+
+/**
+ * @brief Finds the processes of a scheduler by PID
+ *
+ * Open addressing with linear probing over a power of two table kept at
+ * most half full, so finding, adding and removing a PID are O(1) on
+ * average. The index does not own the processes. With repeated PIDs only
+ * the first process is found.
+ */
+typedef struct ProcessIndex
 {
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+	Process **slots; /*!< Processes by hash of their PID, NULL when free */
+	size_t capacity; /*!< Slots, a power of two */
+	size_t length;   /*!< Processes in the index */
+} ProcessIndex;
 
-	Status st;
+Status pix_init(ProcessIndex **pix);
 
-	if (str_buffer_full(str))
-	{
-		st = str_realloc(str);
+Status pix_insert(ProcessIndex *pix, Process *prc);
+Status pix_find(ProcessIndex *pix, size_t pid, Process **result);
+Status pix_remove(ProcessIndex *pix, Process *prc);
 
-		if (st != DS_OK)
-			return st;
-	}
+Status pix_delete(ProcessIndex **pix);
 
-	size_t i;
-	for (i = str->len; i > 0; i--)
-	{
-		str->buffer[i] = str->buffer[i - 1];
-	}
+/* ---------------------------------------------------------------------------------------------------- ProcessIndex.h */
 
-	str->buffer[0] = ch;
+/* ---------------------------------------------------------------------------------------------------- Hooks.h */
 
-	(str->len)++;
+#ifndef HOOKS_SPEC
+#define HOOKS_SPEC
 
-	str->buffer[str->len] = '\0';
+#define HOOK_BATCH 256		   /*!< Events held before the observers get them */
+#define HOOK_MAX_OBSERVERS 8 /*!< Observers a scheduler can have */
 
-	return DS_OK;
-}
+#endif
 
-Status str_push_char_at(String *str, char ch, size_t index)
+/**
+ * @brief What a scheduler tells its observers
+ *
+ * A CPU slice starts with a dispatch and ends with a preempt, a block or a
+ * finish. Ready and leave are the ready queue changes the slices do not
+ * tell, exit is a process leaving the run, finished or killed.
+ */
+typedef enum HookKind
 {
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+	HOOK_DISPATCH, /*!< A process got the CPU */
+	HOOK_PREEMPT,  /*!< Its quantum or its periodic job ended, it may get the CPU back */
+	HOOK_BLOCK,	/*!< It left the CPU for I/O */
+	HOOK_UNBLOCK,  /*!< A process is back from I/O */
+	HOOK_FINISH,   /*!< A process left the CPU for good, finished or killed on it */
+	HOOK_TICK,	 /*!< Ticks went by */
+	HOOK_READY,	/*!< A process joined the ready queue from anywhere but the CPU */
+	HOOK_LEAVE,	/*!< A process left the ready queue without running */
+	HOOK_EXIT,	 /*!< A process left the run, right before it is kept or freed */
+	HOOK_COUNT
+} HookKind;
 
-	if (index > str->len)
-		return DS_ERR_INVALID_POSITION;
+/**
+ * @brief One thing that happened in a run
+ */
+typedef struct HookEvent
+{
+	HookKind kind; /*!< What happened */
+	size_t tick;   /*!< When, the last tick of a tick event */
+	Process *prc;  /*!< Process it happened to, NULL for ticks */
+	size_t busy;   /*!< Ticks of a tick event in which the CPU did useful work */
+} HookEvent;
 
-	Status st;
+// Gets consecutive events of one kind, in the order they happened
+typedef Status (*HookFunction)(void *context, const HookEvent *events, size_t count);
 
-	if (index == 0)
-	{
-		st = str_push_char_front(str, ch);
+/**
+ * @brief Something that watches a run
+ *
+ * Only the kinds with a function are recorded. Events are handed over in
+ * batches, so an observer that looks at the scheduler itself asks for its
+ * kinds in sync: the batch then ends with each of them.
+ */
+typedef struct Observer
+{
+	HookFunction on[HOOK_COUNT]; /*!< Function of each kind, NULL for the ones not wanted */
+	unsigned sync;				 /*!< Kinds, 1 << kind, delivered as soon as they happen */
+	void *context;				 /*!< Passed to every function */
+} Observer;
 
-		if (st != DS_OK)
-			return st;
-	}
-	else if (index == str->len)
-	{
-		st = str_push_char_front(str, ch);
+/**
+ * @brief Observers of a scheduler and the events they did not get yet
+ *
+ * A scheduler without observers has no Hooks at all, so reporting an event
+ * costs it one test of a pointer.
+ */
+typedef struct Hooks
+{
+	Observer observer[HOOK_MAX_OBSERVERS]; /*!< Registered observers */
+	size_t observers;					   /*!< Entries of observer in use */
+	unsigned mask;						   /*!< Kinds some observer wants */
+	unsigned sync;						   /*!< Kinds some observer wants in sync */
+	HookEvent event[HOOK_BATCH];		   /*!< Events not handed over yet, in order */
+	size_t length;						   /*!< Entries of event in use */
+	bool ticking;						   /*!< Ticks went by after the last event */
+	size_t tick;						   /*!< Last of those ticks */
+	size_t busy;						   /*!< Those ticks in which the CPU did useful work */
+} Hooks;
 
-		if (st != DS_OK)
-			return st;
-	}
-	else
-	{
-		if (str_buffer_full(str))
-		{
-			st = str_realloc(str);
+Status hok_init(Hooks **hooks);
 
-			if (st != DS_OK)
-				return st;
-		}
+Status hok_observe(Hooks *hooks, const Observer *obs);
+Status hok_unobserve(Hooks *hooks, const Observer *obs);
 
-		size_t i;
-		for (i = str->len; i > index; i--)
-		{
-			str->buffer[i] = str->buffer[i - 1];
-		}
+Status hok_flush(Hooks *hooks);
 
-		str->buffer[index] = ch;
+Status hok_delete(Hooks **hooks);
 
-		(str->len)++;
+/* ---------------------------------------------------------------------------------------------------- Hooks.h */
 
-		str->buffer[str->len] = '\0';
-	}
+/* ---------------------------------------------------------------------------------------------------- Metrics.h */
 
-	return DS_OK;
-}
-
-Status str_push_char_back(String *str, char ch)
-{
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
-
-	Status st;
+#ifndef METRICS_SPEC
+#define METRICS_SPEC
 
-	if (str_buffer_full(str))
-	{
-		st = str_realloc(str);
+#define STATISTIC_SUB_BITS 5								   /*!< log2 of the linear buckets per power of two */
+#define STATISTIC_SUB (1 << STATISTIC_SUB_BITS)				   /*!< Linear buckets per power of two */
+#define STATISTIC_BUCKETS ((64 - STATISTIC_SUB_BITS + 1) * STATISTIC_SUB) /*!< Buckets covering any size_t */
 
-		if (st != DS_OK)
-			return st;
-	}
+#endif
 
-	str->buffer[str->len] = ch;
+/**
+ * @brief Running summary of a sample of tick counts
+ *
+ * Values are counted in a log-linear histogram, so adding one is O(1) and
+ * percentiles come out within about 3% of the exact value without keeping
+ * the sample around.
+ */
+typedef struct Statistic
+{
+	size_t count;					   /*!< Values added */
+	double sum;						   /*!< Sum of the values */
+	size_t max;						   /*!< Largest value */
+	size_t buckets[STATISTIC_BUCKETS]; /*!< Histogram of the values */
+} Statistic;
 
-	(str->len)++;
+/**
+ * @brief Aggregate metrics of one scheduling run
+ *
+ * Updated by the algorithms as processes finish, never by looking back at
+ * what happened in each tick.
+ */
+typedef struct Metrics
+{
+	Statistic turnaround; /*!< finish - arrival */
+	Statistic waiting;	/*!< Ticks spent in a ready queue */
+	Statistic response;   /*!< first_run - arrival */
+	double slowdown;	  /*!< Sum of turnaround / ticks on the CPU */
+	double slowdown_sq;   /*!< Sum of the squares of the same */
+	size_t jobs;		  /*!< Finished jobs that had a deadline */
+	size_t misses;		  /*!< Jobs that finished after their deadline */
+	size_t finished;	  /*!< Finished processes */
+	size_t killed;		  /*!< Processes killed before they finished, not in the statistics */
+	size_t busy;		  /*!< Ticks in which the CPU did useful work */
+	size_t ticks;		  /*!< Length of the run */
+} Metrics;
 
-	str->buffer[str->len] = '\0';
+void sta_add(Statistic *sta, size_t value);
+double sta_mean(Statistic *sta);
+size_t sta_percentile(Statistic *sta, double p);
 
-	return DS_OK;
-}
+Status met_init(Metrics **met);
 
-Status str_push_front(String *str, char *ch)
-{
-	if (str == NULL || ch == NULL)
-		return DS_ERR_NULL_POINTER;
+void met_clear(Metrics *met);
 
-	size_t len = str_len(ch);
+void met_finish(Metrics *met, Process *prc);
 
-	if (len == 0)
-		return DS_ERR_INVALID_ARGUMENT;
+void met_observer(Metrics *met, Observer *obs);
 
-	Status st;
+double met_throughput(Metrics *met);
+double met_utilization(Metrics *met);
+double met_fairness(Metrics *met);
+double met_miss_ratio(Metrics *met);
 
-	while (!str_buffer_fits(str, len))
-	{
-		st = str_realloc(str);
+void met_summary(Metrics *met, SimulationMetrics *result);
 
-		if (st != DS_OK)
-			return st;
-	}
+Status met_display(Metrics *met);
+Status met_display_processes(QueueArray *finished);
+Status met_display_deadlines(QueueArray *finished);
 
-	size_t i;
-	for (i = str->len; i > 0; i--)
-	{
-		str->buffer[i + len - 1] = str->buffer[i - 1];
-	}
+Status met_delete(Metrics **met);
 
-	for (i = 0; i < len; i++)
-	{
-		str->buffer[i] = ch[i];
-	}
+/* ---------------------------------------------------------------------------------------------------- Metrics.h */
+/* ---------------------------------------------------------------------------------------------------- Writer.h */
 
-	str->len += len;
+#ifndef WRITER_SPEC
+#define WRITER_SPEC
 
-	str->buffer[str->len] = '\0';
+#define WRITER_BUFFER_SIZE (1 << 22) /*!< Bytes buffered before each write(2) */
 
-	return DS_OK;
-}
+#endif
 
-Status str_push_at(String *str, char *ch, size_t index)
+/**
+ * @brief Large buffered output to a file descriptor
+ *
+ * Output is only handed to the kernel in @c WRITER_BUFFER_SIZE chunks so big
+ * tables and traces are written at disk speed instead of syscall speed.
+ */
+typedef struct Writer
 {
-	if (str == NULL || ch == NULL)
-		return DS_ERR_NULL_POINTER;
+	int fd;			 /*!< Output file descriptor */
+	char *buffer;	/*!< Pending output */
+	size_t length;   /*!< Bytes pending in buffer */
+	size_t capacity; /*!< Buffer capacity */
+	size_t written;  /*!< Bytes handed to the kernel so far */
+} Writer;
 
-	Status st;
+Status wrt_open(Writer **wrt, char *path);
 
-	if (index == 0)
-	{
-		st = str_push_front(str, ch);
+Status wrt_write(Writer *wrt, const char *data, size_t length);
+Status wrt_string(Writer *wrt, const char *string);
+Status wrt_char(Writer *wrt, char c);
+Status wrt_size(Writer *wrt, size_t value);
+Status wrt_varint(Writer *wrt, uint64_t value);
 
-		if (st != DS_OK)
-			return st;
-	}
-	else if (index == str->len)
-	{
-		st = str_push_back(str, ch);
+Status wrt_flush(Writer *wrt);
 
-		if (st != DS_OK)
-			return st;
-	}
-	else
-	{
-		size_t len = str_len(ch);
+Status wrt_close(Writer **wrt);
 
-		if (len == 0)
-			return DS_ERR_INVALID_ARGUMENT;
+/* ---------------------------------------------------------------------------------------------------- Writer.h */
 
-		while (!str_buffer_fits(str, len))
-		{
-			st = str_realloc(str);
+/* ---------------------------------------------------------------------------------------------------- Trace.h */
 
-			if (st != DS_OK)
-				return st;
-		}
+#define TRACE_MAGIC "PSDT" /*!< First bytes of a dispatch trace */
+#define TRACE_NAME_MAX 4096 /*!< Longest run name a reader accepts */
+#define TRACE_WINDOW 1024	/*!< Records a repeat can reach back */
+#define TRACE_HASH 4096		/*!< Entries of the table that finds the last record like a new one */
+#define TRACE_REPEAT 7		/*!< Low bits of the head of a repeat record, TRACE_RUN with the gap bit */
+#define TRACE_INDEX_MAGIC "PSDX" /*!< First bytes of the index of a dispatch trace */
+#define TRACE_INDEX_SUFFIX ".idx" /*!< Added to the path of a dispatch trace for its index */
+#define TRACE_INDEX_EVERY 65536	 /*!< Slices between two index entries */
 
-		size_t i, j;
-		for (i = str->len; i >= index; i--)
-		{
-			str->buffer[i + len] = str->buffer[i];
-		}
+typedef enum TraceFormat
+{
+	TRACE_CHROME = 0,  /**< Chrome trace-event JSON */
+	TRACE_DISPATCH = 1 /**< Compact binary dispatch history, read back by TraceReader */
+} TraceFormat;
 
-		for (i = index, j = 0; i < index + len; i++, j++)
-		{
-			str->buffer[i] = ch[j];
-		}
+// Tag of a dispatch trace record, how a CPU slice ended or a new run
+typedef enum TraceEnd
+{
+	TRACE_PREEMPT = 0, /**< Back to the ready queue */
+	TRACE_BLOCK = 1,   /**< Left for I/O */
+	TRACE_FINISH = 2,  /**< Finished or was killed */
+	TRACE_RUN = 3	  /**< Not a slice, the start of a run */
+} TraceEnd;
 
-		str->len += len;
+/**
+ * @brief Trace output of scheduling runs
+ *
+ * In TRACE_CHROME every run is a trace process with one thread per
+ * simulated core. CPU bursts are complete ("X") slices on the core that ran
+ * them and I/O waits are async slices keyed by PID. One tick is written as
+ * one microsecond. The file can be opened in Perfetto or chrome://tracing.
+ *
+ * TRACE_DISPATCH only keeps which process had the CPU from which tick to
+ * which. It is TRACE_MAGIC and then LEB128 varints. A record starts with
+ * payload << 3 | gap << 2 | tag. TRACE_RUN starts a run: the payload is the
+ * length of its name, which follows. The other tags are a slice of CPU
+ * ticks, as many as the payload, run by one process without a break. With
+ * the gap bit set, the ticks between the end of the previous slice and its
+ * start follow. Then comes the zigzag difference between its PID and the
+ * PID of the previous slice. Both restart from 0 at each run.
+ *
+ * Slices are relative to the one before, so a schedule that goes round the
+ * same processes writes the same records over and over. TRACE_REPEAT
+ * stands for payload records, each a copy of the one that many records
+ * before it, given by the varint that follows, at most TRACE_WINDOW.
+ *
+ * A dispatch trace also writes an index, at its path plus
+ * TRACE_INDEX_SUFFIX, with an entry every TRACE_INDEX_EVERY slices. At an
+ * entry no repeat reaches back, so the trace can be read from there.
+ */
+typedef struct TraceRecord
+{
+	uint64_t head;	 /*!< First varint */
+	uint64_t gap;	 /*!< Idle ticks before the slice */
+	uint64_t zigzag; /*!< PID difference */
+} TraceRecord;
 
-		str->buffer[str->len] = '\0';
-	}
+/**
+ * @brief Where reading a dispatch trace can start, and the ready queue there
+ *
+ * Taken right after a dispatch. The index is TRACE_INDEX_MAGIC and then, for
+ * each entry, three lists of varints: the PIDs in the ready queue, sorted
+ * and as differences; the changes to the ready queue until the next entry
+ * that the slices do not tell, each the ticks since the one before (or
+ * since the entry) and then zigzag << 1 | leave, zigzag being the
+ * difference from the PID of the one before (or from 0); and the processes
+ * that had the CPU until the next entry, like the first list. The slices
+ * tell the rest: a process leaves the queue when its slice starts and,
+ * when the slice ends in TRACE_PREEMPT, is back in it. At the end, aligned
+ * to 8 bytes, the entries themselves, then the offset of the first one and
+ * their number as two uint64_t.
+ */
+typedef struct TraceEntry
+{
+	uint64_t run;		/*!< Run, from 1 */
+	uint64_t tick;		/*!< Tick of the dispatch */
+	uint64_t header;	/*!< Offset of the TRACE_RUN record of the run in the trace */
+	uint64_t offset;	/*!< Offset of the next record in the trace */
+	uint64_t clock;		/*!< End of the slice before that record */
+	uint64_t pid;		/*!< PID of that slice */
+	uint64_t queue;		/*!< Offset of the first list in the index, the second follows */
+	uint64_t queued;	/*!< PIDs in the first list */
+	uint64_t events;	/*!< Changes in the second list */
+	uint64_t processes; /*!< Offset of the third list in the index */
+	uint64_t ran;		/*!< PIDs in the third list */
+} TraceEntry;
+
+typedef struct Trace
+{
+	Writer *writer;		  /*!< Buffered output */
+	TraceFormat format;   /*!< What is written */
+	size_t run;			  /*!< Trace process id of the current run */
+	size_t events;		  /*!< Events written so far */
+	Process *slice;		  /*!< Process of the pending CPU slice, NULL when idle */
+	size_t slice_start;   /*!< Start of the pending CPU slice */
+	size_t slice_end;	 /*!< End of the pending slice, 0 while it is running */
+	size_t last_end;	  /*!< End of the last slice written, TRACE_DISPATCH */
+	size_t last_pid;	  /*!< PID of the last slice written, TRACE_DISPATCH */
+	TraceRecord *window;  /*!< Last TRACE_WINDOW records of the run, TRACE_DISPATCH */
+	size_t *seen;		  /*!< By hash, one plus the number of the last record that had it */
+	size_t records;		  /*!< Records of the run, repeated ones too */
+	size_t period;		  /*!< Distance of the repeat being matched, 0 for none */
+	size_t matched;		  /*!< Records it matched, not written yet */
+	size_t header;		  /*!< Offset of the TRACE_RUN record of the run */
+	Writer *index;		  /*!< Index of a TRACE_DISPATCH trace */
+	TraceEntry *entries;  /*!< Index entries, written when the trace is closed */
+	size_t entry_length;  /*!< Index entries so far */
+	size_t entry_capacity; /*!< Room in entries */
+	bool indexing;		  /*!< The last entry belongs to this run and takes its changes */
+	size_t since;		  /*!< Slices since the last entry */
+	size_t last_change;   /*!< Tick of the last ready queue change written */
+	size_t change_pid;	/*!< PID of that change */
+	size_t *queued;		  /*!< Ready PIDs given for the next entry */
+	size_t queued_length;   /*!< PIDs in queued */
+	size_t queued_capacity; /*!< Room in queued */
+	size_t *ran;		  /*!< Distinct PIDs of the slices since the last entry */
+	size_t ran_length;	/*!< PIDs in ran */
+	size_t ran_capacity;  /*!< Room in ran, half the slots of ran_set */
+	size_t *ran_set;	  /*!< The same PIDs plus one by hash, 0 when free */
+} Trace;
+
+Status trc_open(Trace **trc, char *path, TraceFormat format);
+
+Status trc_begin_run(Trace *trc, char *name);
+Status trc_end_run(Trace *trc);
+
+Status trc_dispatch(Trace *trc, Process *prc, size_t now);
+Status trc_preempt(Trace *trc, Process *prc, size_t now);
+Status trc_block(Trace *trc, Process *prc, size_t now);
+Status trc_unblock(Trace *trc, Process *prc, size_t now);
+Status trc_finish(Trace *trc, Process *prc, size_t now);
+
+// Ready queue changes that the slices do not tell: a process that becomes
+// ready from anywhere but the CPU, or leaves the queue without running
+Status trc_ready(Trace *trc, Process *prc, size_t now);
+Status trc_leave(Trace *trc, Process *prc, size_t now);
+
+// An index entry is due at this dispatch. The scheduler then gives every
+// ready PID to trc_queued and calls trc_index.
+bool trc_due(Trace *trc);
+Status trc_queued(Trace *trc, size_t pid);
+Status trc_index(Trace *trc, size_t now);
+
+Status trc_close(Trace **trc);
+
+/* ---------------------------------------------------------------------------------------------------- Trace.h */
+
+/* ---------------------------------------------------------------------------------------------------- Scheduler.h */
 
-	return DS_OK;
-}
+/**
+ * @brief Scheduling policies
+ *
+ * X(name, ID, option, label). Every policy listed here gets its own copy of
+ * the scheduling kernel, specialized at compile time with the functions of
+ * its policy_<name> table, an ALG_<ID> constant and an alg_<name> function.
+ * The option is the name used on the command line.
+ */
+#define SCHEDULER_POLICIES(X)                                  \
+	X(round_robin, ROUND_ROBIN, "rr", "Round Robin")           \
+	X(pri_static, PRI_STATIC, "static", "Static Priority")     \
+	X(pri_dynamic, PRI_DYNAMIC, "dynamic", "Dynamic Priority") \
+	X(pri_type, PRI_TYPE, "type", "By Process Type")         \
+	X(sjf, SJF, "sjf", "Shortest Job First")                   \
+	X(srtf, SRTF, "srtf", "Shortest Remaining Time First")     \
+	X(mlfq, MLFQ, "mlfq", "Multilevel Feedback Queue")         \
+	X(cfs, CFS, "cfs", "Completely Fair")                      \
+	X(lottery, LOTTERY, "lottery", "Lottery")                  \
+	X(edf, EDF, "edf", "Earliest Deadline First")              \
+	X(rm, RATE_MONOTONIC, "rm", "Rate Monotonic")
+
+typedef enum AlgorithmId
+{
+#define X(name, id, option, label) ALG_##id,
+	SCHEDULER_POLICIES(X)
+#undef X
+		ALG_COUNT
+} AlgorithmId;
 
-Status str_push_back(String *str, char *ch)
+#define SCHEDULER_MAX_HYPERPERIOD 1000000 /*!< Releases stop here when the periods have no smaller common multiple */
+#define SCHEDULER_MAX_EVENTS 64			  /*!< Kills and priority changes a run can be given */
+#define SCHEDULER_KILL ((size_t)-1)		  /*!< SchedulerEvent.pri of a kill */
+
+/**
+ * @brief A kill or a priority change applied to a run at a given tick
+ */
+typedef struct SchedulerEvent
 {
-	if (str == NULL || ch == NULL)
-		return DS_ERR_NULL_POINTER;
+	size_t tick; /*!< First tick at which it applies */
+	size_t pid;  /*!< Process it applies to */
+	size_t pri;  /*!< New priority, SCHEDULER_KILL to kill the process */
+} SchedulerEvent;
 
-	size_t len = str_len(ch);
+/**
+ * @brief Tunables of the policies that have any
+ *
+ * sch_default_params gives the values used when a caller passes none.
+ */
+typedef struct SchedulerParams
+{
+	size_t aging;						  /*!< Dynamic Priority: waiting ticks worth one priority level, 0 for none */
+	size_t mlfq_levels;					  /*!< MLFQ: number of levels */
+	size_t mlfq_quantum[MLFQ_MAX_LEVELS]; /*!< MLFQ: quantum of each level */
+	size_t mlfq_boost;					  /*!< MLFQ: ticks between two global boosts, 0 for none */
+	size_t cfs_latency;					  /*!< CFS: ticks in which every ready process should run once */
+	size_t cfs_granularity;				  /*!< CFS: shortest quantum */
+	uint64_t lottery_seed;				  /*!< Lottery: seed of the draws */
+	size_t horizon;						  /*!< Periodic jobs are released before this tick, 0 for one hyperperiod */
+	SchedulerEvent event[SCHEDULER_MAX_EVENTS]; /*!< Kills and priority changes, in tick order */
+	size_t events;								/*!< Entries of event in use */
+} SchedulerParams;
+
+void sch_default_params(SchedulerParams *params);
+
+Status sch_parse_quanta(SchedulerParams *params, const char *text);
+Status sch_parse_event(SchedulerParams *params, const char *text, bool kill);
+Status sch_parse_param(SchedulerParams *params, const char *name, const char *value);
 
-	if (len == 0)
-		return DS_ERR_INVALID_ARGUMENT;
+/**
+ * @brief Ready queue of the fair scheduler
+ */
+typedef struct FairQueue
+{
+	RedBlackTree *tree;  /*!< Ready processes by virtual runtime */
+	size_t min_vruntime; /*!< Never decreases, new and waking processes start near it */
+	size_t load;		 /*!< Sum of the weights of the processes in tree */
+} FairQueue;
 
-	Status st;
+/**
+ * @brief Takes a process that left a run, which frees it right after
+ *
+ * A scheduler with a sink does not keep its finished processes, so a run
+ * only holds the ones that arrived and did not finish yet.
+ */
+typedef Status (*SchedulerSink)(void *context, Process *prc);
 
-	while (!str_buffer_fits(str, len))
+/**
+ * @brief State of one simulation run
+ *
+ * Holds everything a policy needs between two ticks, so a run can be driven
+ * one tick at a time with sch_step or to the end with sch_run.
+ */
+typedef struct Scheduler
+{
+	AlgorithmId policy;		/*!< Policy and kernel of this scheduler */
+	SchedulerParams params; /*!< Tunables of the policy */
+	union
 	{
-		st = str_realloc(str);
+		RingBuffer *fifo;	  /*!< Ready queue of FIFO policies */
+		PriorityQueue *prq;	/*!< Ready queue of priority policies */
+		IndexedHeap *heap;	 /*!< Ready queue of policies that change queued keys */
+		MultilevelQueue *mlq; /*!< Ready queue of multilevel policies */
+		FairQueue *cfs;		  /*!< Ready queue of the fair policy */
+		struct LotteryPool *lottery; /*!< Ready queue of the lottery policy */
+	} ready;
+	size_t queued;		  /*!< Processes in the ready queue */
+	Process *running;	 /*!< Process on the CPU, NULL when it is free */
+	size_t slice;		  /*!< Ticks left in the quantum of the running process */
+	size_t dispatched;	/*!< Tick in which the running process got the CPU */
+	Process *blocked;	 /*!< Process waiting for I/O */
+	ProcessIndex *index;  /*!< Every process not finished yet, by PID */
+	size_t event;		  /*!< Next entry of params.event to apply */
+	IndexedHeap *timers;  /*!< Processes waiting for a release or the end of an I/O burst, keyed by its tick */
+	size_t hyperperiod;   /*!< Least common multiple of the periods, capped at SCHEDULER_MAX_HYPERPERIOD */
+	QueueArray *finished; /*!< Finished processes in completion order, empty with a sink */
+	SchedulerSink sink;   /*!< Optional, takes the finished processes instead of finished */
+	void *context;		  /*!< Passed to sink */
+	size_t clock;		  /*!< Current tick */
+	Hooks *hooks;		  /*!< Observers of the run, NULL when it has none */
+	Metrics *metrics;	 /*!< Optional metrics, kept by an observer set with sch_metrics */
+	Trace *trace;		  /*!< Optional trace output, written by an observer set with sch_trace */
+} Scheduler;
+
+Status sch_init(Scheduler **sch, AlgorithmId policy, const SchedulerParams *params);
+
+Status sch_submit(Scheduler *sch, Process *prc);
+Status sch_submit_ordered(Scheduler *sch, Process *prc, size_t order);
+
+Status sch_kill(Scheduler *sch, size_t pid);
+Status sch_set_priority(Scheduler *sch, size_t pid, size_t pri);
+
+Status sch_step(Scheduler *sch);
+Status sch_run(Scheduler *sch);
+Status sch_run_until(Scheduler *sch, size_t until);
+
+bool sch_done(Scheduler *sch);
+
+Status sch_discard(void *context, Process *prc);
+
+Status sch_observe(Scheduler *sch, const Observer *obs);
+Status sch_unobserve(Scheduler *sch, const Observer *obs);
+
+Status sch_metrics(Scheduler *sch, Metrics *metrics);
+Status sch_trace(Scheduler *sch, Trace *trace);
+
+#ifndef PROCESS_NO_MAIN
+void sch_display(Scheduler *sch);
+Status sch_visual(Scheduler *sch);
+#endif
 
-		if (st != DS_OK)
-			return st;
-	}
+Status sch_delete(Scheduler **sch);
 
-	size_t i, j;
-	for (i = str->len, j = 0; i < len + str->len; i++, j++)
-	{
-		str->buffer[i] = ch[j];
-	}
+typedef Status (*Algorithm)(QueueArray *pqueue, QueueArray **result, const SchedulerParams *params, Metrics *metrics,
+						   Trace *trace, bool visual);
 
-	str->len += len;
+#define X(name, id, option, label)                                                                    \
+	Status alg_##name(QueueArray *pqueue, QueueArray **result, const SchedulerParams *params, Metrics *metrics, \
+					  Trace *trace, bool visual);
+SCHEDULER_POLICIES(X)
+#undef X
 
-	str->buffer[str->len] = '\0';
+Status alg_stream(AlgorithmId policy, const char *path, const SchedulerParams *params, Metrics *metrics,
+				  Trace *trace, SchedulerSink sink, void *context);
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- Scheduler.h */
 
-Status str_prepend(String *str1, String *str2)
+/* ---------------------------------------------------------------------------------------------------- Random.h */
+
+/**
+ * @brief Seeded pseudo-random number stream (xoshiro256**)
+ *
+ * A stream is derived from a (seed, stream) pair. Independent units of work,
+ * like each sample of a Monte Carlo run, get their own stream so results do
+ * not depend on which thread happens to run them.
+ */
+typedef struct Random
 {
-	if (str1 == NULL || str2 == NULL)
-		return DS_ERR_NULL_POINTER;
+	uint64_t state[4]; /*!< Generator state */
+} Random;
 
-	if (str_buffer_empty(str2))
-		return DS_OK;
+void rng_seed(Random *rng, uint64_t seed, uint64_t stream);
 
-	Status st;
+uint64_t rng_next(Random *rng);
 
-	while (!str_buffer_fits(str1, str2->len))
-	{
-		st = str_realloc(str1);
+double rng_double(Random *rng);
 
-		if (st != DS_OK)
-			return st;
-	}
+size_t rng_range(Random *rng, size_t lo, size_t hi);
 
-	size_t i;
-	for (i = str1->len; i > 0; i--)
-	{
-		str1->buffer[i + str2->len - 1] = str1->buffer[i - 1];
-	}
+/**
+ * @brief Kind of a random @c Distribution
+ */
+typedef enum DistributionKind
+{
+	DIST_UNIFORM = 0,	 /**< Integers uniformly distributed in [a, b] */
+	DIST_EXPONENTIAL = 1, /**< Exponential with mean a, shifted by b */
+	DIST_PARETO = 2		  /**< Pareto with scale a and shape b */
+} DistributionKind;
 
-	for (i = 0; i < str2->len; i++)
-	{
-		str1->buffer[i] = str2->buffer[i];
-	}
+typedef struct Distribution
+{
+	DistributionKind kind; /*!< Distribution kind */
+	double a;			   /*!< First parameter */
+	double b;			   /*!< Second parameter */
+} Distribution;
 
-	str1->len += str2->len;
+size_t dst_sample(Distribution *dst, Random *rng);
 
-	str1->buffer[str1->len] = '\0';
+Status dst_parse(Distribution *dst, char *text);
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- Random.h */
 
-Status str_add(String *str1, String *str2, size_t index)
-{
-	if (str1 == NULL || str2 == NULL)
-		return DS_ERR_NULL_POINTER;
+/* ---------------------------------------------------------------------------------------------------- LotteryPool.h */
 
-	Status st;
+#define LOTTERY_POOL_INIT_SIZE 8 /*!< Must be a power of two */
 
-	if (index == 0)
-	{
-		st = str_prepend(str1, str2);
+/**
+ * @brief Ticket holders of a lottery and their draws
+ *
+ * Each process gets a position for as long as it is in the pool, and a
+ * Fenwick tree over the tickets of every position gives prefix sums in
+ * O(log n). Drawing a winner is one descent of the tree and changing the
+ * tickets of a process one update, both O(log n). A process with 0 tickets
+ * keeps its position but cannot win.
+ */
+typedef struct LotteryPool
+{
+	size_t *tree;	 /*!< Fenwick tree of the tickets, 1-based */
+	size_t *tickets;  /*!< Tickets at each position, 1-based */
+	Process **owner;  /*!< Process at each position, 1-based */
+	size_t *spare;	/*!< Positions given back */
+	size_t spares;	/*!< Positions in spare */
+	size_t used;	  /*!< Highest position handed out */
+	size_t capacity;  /*!< Positions, a power of two */
+	size_t length;	/*!< Processes with tickets */
+	size_t total;	 /*!< Tickets in the pool */
+	Random rng;		  /*!< Source of the draws */
+} LotteryPool;
 
-		if (st != DS_OK)
-			return st;
-	}
-	else if (index == str1->len)
-	{
-		st = str_append(str1, str2);
+Status lot_init(LotteryPool **lot, uint64_t seed);
 
-		if (st != DS_OK)
-			return st;
-	}
-	else
-	{
-		while (!str_buffer_fits(str1, str2->len))
-		{
-			st = str_realloc(str1);
+Status lot_set_tickets(LotteryPool *lot, Process *prc, size_t tickets);
+Status lot_remove(LotteryPool *lot, Process *prc);
 
-			if (st != DS_OK)
-				return st;
-		}
+Status lot_draw(LotteryPool *lot, Process **result);
 
-		size_t i, j;
-		for (i = str1->len; i >= index; i--)
-		{
-			str1->buffer[i + str2->len] = str1->buffer[i];
-		}
+bool lot_is_empty(LotteryPool *lot);
 
-		for (i = index, j = 0; i < index + str2->len; i++, j++)
-		{
-			str1->buffer[i] = str2->buffer[j];
-		}
+Status lot_display(LotteryPool *lot);
 
-		str1->len += str2->len;
+Status lot_delete(LotteryPool **lot);
 
-		str1->buffer[str1->len] = '\0';
-	}
+/* ---------------------------------------------------------------------------------------------------- LotteryPool.h */
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- Workload.h */
 
-Status str_append(String *str1, String *str2)
-{
-	if (str1 == NULL || str2 == NULL)
-		return DS_ERR_NULL_POINTER;
+#define PROCESS_TYPES 3
 
-	if (str_buffer_empty(str2))
-		return DS_OK;
+/**
+ * @brief Describes how random process tables are drawn
+ */
+typedef struct WorkloadSpec
+{
+	size_t processes;			 /*!< Processes per table */
+	Distribution cpu;			 /*!< CPU time distribution */
+	Distribution io;			 /*!< I/O time distribution */
+	Distribution pri;			 /*!< Priority distribution */
+	double types[PROCESS_TYPES]; /*!< Relative weights of SO, UI and UNI */
+	bool periodic;				 /*!< Whether processes get a period */
+	Distribution period;		 /*!< Period distribution, drawn only when periodic */
+	bool arriving;				 /*!< Whether processes arrive over time */
+	Distribution gap;			 /*!< Ticks between arrivals, drawn only when arriving */
+	bool bursty;				 /*!< Whether processes alternate CPU and I/O bursts */
+	Distribution bursts;		 /*!< CPU bursts of each process, drawn only when bursty */
+} WorkloadSpec;
 
-	Status st;
+void wkl_default(WorkloadSpec *spec);
 
-	while (!str_buffer_fits(str1, str2->len))
-	{
-		st = str_realloc(str1);
+Status wkl_parse_types(WorkloadSpec *spec, char *text);
 
-		if (st != DS_OK)
-			return st;
-	}
+Status wkl_generate(WorkloadSpec *spec, Random *rng, QueueArray **result);
 
-	size_t i, j;
-	for (i = str1->len, j = 0; i < str1->len + str2->len; i++, j++)
-	{
-		str1->buffer[i] = str2->buffer[j];
-	}
+Status wkl_write(WorkloadSpec *spec, Random *rng, char *path);
 
-	str1->len += str2->len;
+/* ---------------------------------------------------------------------------------------------------- Workload.h */
 
-	str1->buffer[str1->len] = '\0';
+/* ---------------------------------------------------------------------------------------------------- MonteCarlo.h */
 
-	return DS_OK;
-}
-
-Status str_pop_char_front(String *str)
+typedef enum MonteCarloMetric
 {
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+	MC_TURNAROUND_MEAN = 0, /**< Mean turnaround of a sample */
+	MC_TURNAROUND_P99 = 1,  /**< 99th percentile turnaround of a sample */
+	MC_WAITING_MEAN = 2,	/**< Mean waiting time of a sample */
+	MC_RESPONSE_MEAN = 3,   /**< Mean response time of a sample */
+	MC_THROUGHPUT = 4,		/**< Finished processes per tick */
+	MC_UTILIZATION = 5,		/**< Fraction of ticks the CPU did work */
+	MC_FAIRNESS = 6,		/**< Jain's index of the slowdowns */
+	MC_MISSES = 7,			/**< Fraction of jobs that missed their deadline */
+	MC_METRICS = 8
+} MonteCarloMetric;
+
+typedef struct MonteCarlo
+{
+	WorkloadSpec spec;		/*!< Workload distributions */
+	SchedulerParams params; /*!< Policy tunables */
+	size_t samples;	/*!< Number of random process tables */
+	size_t threads;	/*!< Worker threads */
+	uint64_t seed;	 /*!< Base seed, sample i uses stream i */
+	bool algorithms[ALG_COUNT]; /*!< Which algorithms to run */
+	double *values;	/*!< Results laid out as [algorithm][sample][metric] */
+} MonteCarlo;
 
-	if (str_buffer_empty(str))
-		return DS_ERR_INVALID_OPERATION;
+Status mc_init(MonteCarlo **mc);
 
-	size_t i;
-	for (i = 0; i < str->len; i++)
-	{
-		str->buffer[i] = str->buffer[i + 1];
-	}
+Status mc_run(MonteCarlo *mc);
 
-	(str->len)--;
+Status mc_report(MonteCarlo *mc);
 
-	str->buffer[str->len] = '\0';
+Status mc_delete(MonteCarlo **mc);
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- MonteCarlo.h */
 
-Status str_pop_char_at(String *str, size_t index)
-{
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+/* ---------------------------------------------------------------------------------------------------- Snapshot.h */
 
-	if (str_buffer_empty(str))
-		return DS_ERR_INVALID_OPERATION;
+#define SNAPSHOT_MAGIC 0x4e535350 /*!< "PSSN" in little endian, first varint of a snapshot */
+#define SNAPSHOT_VERSION 5		  /*!< Bumped when the layout changes */
+#define SNAPSHOT_INIT_SIZE 4096   /*!< First capacity of the buffer */
+#define SNAPSHOT_FILE_MAGIC 0x4b435350 /*!< "PSCK", first word of a checkpoint file */
+#define SNAPSHOT_EVERY 65536		   /*!< Default ticks between two checkpoint files of run */
+#define SNAPSHOT_POLL 1024			   /*!< Ticks run between two looks for SIGINT and SIGTERM */
 
-	if (index >= str->len)
-		return DS_ERR_INVALID_POSITION;
+/**
+ * @brief Encoded state of a scheduler between two ticks
+ *
+ * Everything a run needs to go on as if it never stopped: the clock, the
+ * parameters, every process with all of its times, the ready queue, the
+ * running, blocked and waiting processes, the finished ones, the metrics
+ * and the state of the lottery draws. Processes are written once and the
+ * structures refer to them by number. Sizes are LEB128 varints of the value
+ * plus one, so the (size_t)-1 markers take one byte like small values do.
+ * The trace and the visual flag are not part of it. A snapshot of a run of
+ * a table file leaves out the processes that did not arrive yet and reads
+ * them again from the table when it is restored.
+ */
+typedef struct Snapshot
+{
+	unsigned char *buffer; /*!< Encoded state */
+	size_t length;		   /*!< Bytes in buffer */
+	size_t capacity;	   /*!< Bytes buffer can hold */
+	size_t clock;		   /*!< Tick of the state */
+	char *table;		   /*!< Table file of the processes left out, NULL when it has them all */
+	size_t every;		   /*!< Ticks between the checkpoint files of the run it is from, 0 when unknown */
+} Snapshot;
 
-	Status st;
+Status snp_take(Snapshot **snp, Scheduler *sch);
+Status snp_take_table(Snapshot **snp, Scheduler *sch, const char *table);
 
-	if (index == 0)
-	{
-		st = str_pop_char_front(str);
+Status snp_restore(Snapshot *snp, Scheduler **sch, Metrics *metrics);
 
-		if (st != DS_OK)
-			return st;
-	}
-	else if (index == str->len - 1)
-	{
-		st = str_pop_char_back(str);
+Status snp_save(Snapshot *snp, const char *path);
+Status snp_load(Snapshot **snp, const char *path);
 
-		if (st != DS_OK)
-			return st;
-	}
-	else
-	{
-		size_t i;
-		for (i = index; i < str->len; i++)
-		{
-			str->buffer[i] = str->buffer[i + 1];
-		}
+Status snp_fork(Snapshot *snp, const char *path, pid_t *writer);
+Status snp_poll(pid_t *writer);
+Status snp_wait(pid_t *writer);
 
-		(str->len)--;
+Status snp_delete(Snapshot **snp);
 
-		str->buffer[str->len] = '\0';
-	}
+/* ---------------------------------------------------------------------------------------------------- Snapshot.h */
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- Checkpoint.h */
 
-Status str_pop_char_back(String *str)
+#define CHECKPOINT_INTERVAL 256		 /*!< Ticks between the first checkpoints of a run */
+#define CHECKPOINT_MAX 32			 /*!< Checkpoints kept, every other one is dropped beyond it */
+#define CHECKPOINT_BUDGET (64 << 20) /*!< Bytes of checkpoints kept, every other one is dropped beyond it */
+#define CHECKPOINT_SPACING 4		 /*!< Ticks after a checkpoint per byte of it before the next one */
+
+/**
+ * @brief State of a run at one tick, short of what the log keeps elsewhere
+ *
+ * The snapshot is partial: the processes that finished are the first ones
+ * of the result of the run, which never change, and the ones still waiting
+ * for their first arrival are made again from the rows of the next table.
+ */
+typedef struct Checkpoint
 {
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+	Snapshot *snapshot; /*!< Partial snapshot of the run */
+	size_t finished;	/*!< Processes finished before it, the first ones of the result */
+	size_t event;		/*!< Kills and priority changes applied before it */
+	size_t late;		/*!< Rows of its table that arrive after tick 0 */
+	size_t submitted;   /*!< Rows that arrive up to this tick had been submitted */
+} Checkpoint;
 
-	if (str_buffer_empty(str))
-		return DS_ERR_INVALID_OPERATION;
+/**
+ * @brief A row of the table that arrives after tick 0
+ */
+typedef struct CheckpointArrival
+{
+	size_t arrival; /*!< Tick it arrives */
+	size_t row;		/*!< Its position in the table */
+	size_t rank;	/*!< Its position among these rows, its insertion number in the timers */
+	bool targeted;  /*!< A kill or priority change names its PID, so it is submitted from the start */
+} CheckpointArrival;
 
-	(str->len)--;
+/**
+ * @brief Periodic checkpoints of the last run of one algorithm
+ *
+ * A run keeps a checkpoint every interval ticks. When there are too many of
+ * them, or they take too much memory, every other one is dropped and the
+ * interval doubles, so they stay spread over runs of any length. Rows are
+ * submitted as the run gets close to their arrival, so a checkpoint only
+ * holds the processes that have arrived and not finished. When the next
+ * table is the last one with a single row altered, added or removed, the
+ * run resumes from the last checkpoint taken before that row could make any
+ * difference: its arrival, or its first kill or priority change.
+ */
+typedef struct CheckpointLog
+{
+	AlgorithmId policy;					   /*!< Algorithm of the runs */
+	SchedulerParams params;				   /*!< Its tunables */
+	QueueArray *table;					   /*!< Rows of the last run in table order, NULL before it */
+	CheckpointArrival *arrivals;		   /*!< Rows of table that arrive after tick 0, by arrival and then rank */
+	size_t late;						   /*!< Entries of arrivals */
+	size_t fed;							   /*!< Entries of arrivals submitted in order so far */
+	QueueArray *result;					   /*!< Processes of the last run in the order they finished, NULL before it */
+	ProcessIndex *spare;				   /*!< Processes of result a resumed run makes again, reused for their rows */
+	Checkpoint checkpoints[CHECKPOINT_MAX]; /*!< Checkpoints of the last run in clock order */
+	size_t length;						   /*!< Checkpoints in use */
+	size_t bytes;						   /*!< Bytes of their snapshots */
+	size_t interval;					   /*!< Ticks between two checkpoints */
+	size_t next;						   /*!< Clock of the next checkpoint */
+} CheckpointLog;
 
-	str->buffer[str->len] = '\0';
+Status ckp_init(CheckpointLog **log, AlgorithmId policy, const SchedulerParams *params);
 
-	return DS_OK;
-}
+Status ckp_simulate(CheckpointLog *log, QueueArray *table, QueueArray **result, Metrics *metrics, bool visual,
+					size_t *resumed);
 
-Status str_display(String *str)
-{
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+Status ckp_delete(CheckpointLog **log);
 
-	if (str_buffer_empty(str))
-	{
-		printf("\nString\n[ empty ]\n");
-		return DS_OK;
-	}
+/* ---------------------------------------------------------------------------------------------------- Checkpoint.h */
 
-	printf("\nString\n%s\n", str->buffer);
+#ifndef PROCESS_NO_MAIN
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- Bench.h */
 
-Status str_display_raw(String *str)
+typedef enum BenchOpKind
 {
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
-
-	printf("\n");
+	BENCH_ENQUEUE = 0, /**< Value enters the queue */
+	BENCH_UPDATE = 1,  /**< Queued value gets a new priority */
+	BENCH_DEQUEUE = 2, /**< Lowest value leaves the queue */
+	BENCH_REMOVE = 3,  /**< Queued value is taken out */
+	BENCH_KINDS = 4
+} BenchOpKind;
+
+typedef struct BenchOp
+{
+	BenchOpKind kind; /*!< What was done to the queue */
+	size_t value;	 /*!< Index of the value, in the order the table was submitted */
+	size_t priority;  /*!< Priority of an enqueue or update */
+} BenchOp;
 
-	if (str_buffer_empty(str))
-		return DS_OK;
+/**
+ * @brief Priority queue operations of a real scheduler run
+ *
+ * Recorded by running a policy whose ready queue is the PriorityQueue with
+ * the queue calls logged, then replayed against a bare queue, so the time
+ * measured is the one of the compiled PQUEUE_BACKEND alone.
+ */
+typedef struct BenchLog
+{
+	BenchOp *ops;			   /*!< Operations in the order they were done */
+	size_t length;			   /*!< Recorded operations */
+	size_t capacity;		   /*!< Operations ops can hold */
+	size_t values;			   /*!< Processes of the table */
+	size_t peak;			   /*!< Longest the queue got */
+	size_t count[BENCH_KINDS]; /*!< Operations of each kind */
+	size_t below;			   /*!< Enqueues and updates below the last dequeued priority */
+	size_t last;			   /*!< Last dequeued priority, while recording */
+	uint64_t check;			   /*!< Hash of the dequeue order, equal for every backend */
+} BenchLog;
 
-	printf("%s", str->buffer);
+Status bch_record(AlgorithmId policy, QueueArray *table, const SchedulerParams *params, BenchLog **log);
 
-	return DS_OK;
-}
+Status bch_replay(BenchLog *log, size_t repeats, double *seconds);
 
-Status str_delete(String **str)
-{
-	if ((*str) == NULL)
-		return DS_ERR_NULL_POINTER;
+Status bch_report(BenchLog *log, double seconds, size_t repeats);
 
-	free((*str)->buffer);
+Status bch_delete(BenchLog **log);
 
-	free(*str);
+/* ---------------------------------------------------------------------------------------------------- Bench.h */
 
-	*str = NULL;
+/* ---------------------------------------------------------------------------------------------------- Check.h */
 
-	return DS_OK;
-}
+#define CHECK_TABLES 4	  /*!< Generated tables of a check by default */
+#define CHECK_PROCESSES 300 /*!< Rows of each generated table */
+#define CHECK_EDITS 4		/*!< Rows changed one after the other in each table */
+#define CHECK_LEVELS 4		/*!< Levels of the multilevel queue of the boost check */
+#define CHECK_QUEUED 32		/*!< Processes the boost check moves through its queue */
+#define CHECK_OPERATIONS 100000 /*!< Pushes, pops and boosts of the boost check */
 
-Status str_erase(String **str)
-{
-	if ((*str) == NULL)
-		return DS_ERR_NULL_POINTER;
+Status chk_resume(bool *algorithms, size_t tables, size_t seed);
 
-	Status st = str_delete(str);
+Status chk_boost(size_t seed);
 
-	if (st != DS_OK)
-		return st;
+/* ---------------------------------------------------------------------------------------------------- Check.h */
 
-	st = str_init(str);
+/* ---------------------------------------------------------------------------------------------------- Daemon.h */
 
-	if (st != DS_OK)
-		return st;
+#define DAEMON_SOCKET "/tmp/process.sock" /*!< Default socket path */
+#define DAEMON_MAGIC 0x31445350			  /*!< "PSD1" in little endian, first word of every request */
+#define DAEMON_MAX_OPTIONS 4096			  /*!< Longest options part of a request */
+#define DAEMON_MAX_WINDOW 256			  /*!< Most requests a client has in flight, its connection is not read past them */
 
-	return DS_OK;
-}
+/**
+ * @brief Header of a simulation request
+ *
+ * Followed by path bytes of the table path, without a terminator, and by
+ * options bytes of policy options, each one a name and a value ending in
+ * '\0' ("aging\0" "10\0"). The daemon only listens on a local socket, so
+ * every field is in host byte order.
+ */
+typedef struct DaemonRequest
+{
+	uint32_t magic;		/*!< DAEMON_MAGIC */
+	uint32_t id;		/*!< Chosen by the client and sent back in the reply */
+	uint16_t algorithm; /*!< AlgorithmId to run */
+	uint16_t path;		/*!< Bytes of the table path */
+	uint32_t options;   /*!< Bytes of the policy options */
+} DaemonRequest;
 
-Status str_clear(String *str)
+/**
+ * @brief Reply to one request
+ *
+ * Sent as soon as its run finishes, so the replies of pipelined requests
+ * can come back in any order.
+ */
+typedef struct DaemonReply
 {
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+	uint32_t id;			   /*!< id of the request */
+	uint32_t status;		   /*!< Status of the run, metrics is only valid when DS_OK */
+	SimulationMetrics metrics; /*!< Metrics of the run */
+} DaemonReply;
 
-	str->len = 0;
+/**
+ * @brief A process table kept loaded between requests
+ */
+typedef struct DaemonTable
+{
+	char *path;		   /*!< Path the clients name it by */
+	QueueArray *table; /*!< Processes sorted by PID, copied by every run */
+} DaemonTable;
 
-	str->buffer[0] = '\0';
+/**
+ * @brief A client connection
+ *
+ * Read by its own thread and written by the workers that run its requests.
+ * Freed by whichever of them is the last one to let go of it. The reader
+ * stops while DAEMON_MAX_WINDOW requests are pending, so one client cannot
+ * fill the queue of every worker.
+ */
+typedef struct DaemonConnection
+{
+	int fd;							/*!< Socket of the client */
+	pthread_mutex_t lock;			/*!< Serializes the replies and guards pending and closed */
+	pthread_cond_t answered;		/*!< Signaled when pending drops below DAEMON_MAX_WINDOW */
+	size_t pending;					/*!< Requests read and not answered yet */
+	bool closed;					/*!< The reader saw the end of the requests */
+	struct Daemon *daemon;			/*!< Daemon that accepted it */
+	struct DaemonConnection *next;  /*!< Next open connection of the daemon */
+} DaemonConnection;
 
-	return DS_OK;
-}
+/**
+ * @brief A request waiting for a worker
+ */
+typedef struct DaemonJob
+{
+	DaemonConnection *connection; /*!< Where the reply goes */
+	DaemonRequest request;		  /*!< Header of the request */
+	char *body;					  /*!< Path, a '\0' and the options */
+	struct DaemonJob *next;		  /*!< Next job in the queue */
+} DaemonJob;
 
-Status str_front(String *str, char *result)
+/**
+ * @brief Simulation server on a Unix domain socket
+ *
+ * Every connection has a reader thread that queues its requests, in the
+ * order they arrive, for a fixed pool of workers. Tables are loaded the first
+ * time a request names them and kept until the daemon stops.
+ */
+typedef struct Daemon
 {
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+	char *path;					   /*!< Path of the socket */
+	int listener;				   /*!< Listening socket */
+	pthread_t *workers;			   /*!< Worker threads */
+	size_t threads;				   /*!< Number of workers */
+	pthread_mutex_t lock;		   /*!< Guards the queue, the connections and stop */
+	pthread_cond_t ready;		   /*!< Signaled when a job is queued or the workers must stop */
+	pthread_cond_t idle;		   /*!< Signaled when a connection is freed */
+	DaemonJob *head;			   /*!< Next job to run */
+	DaemonJob *tail;			   /*!< Last job queued */
+	DaemonConnection *connections; /*!< Open connections */
+	size_t open;				   /*!< Length of connections */
+	bool stop;					   /*!< Workers exit once the queue is empty */
+	bool signaled;				   /*!< SIGINT or SIGTERM arrived */
+	pthread_mutex_t tables_lock;   /*!< Guards tables */
+	DaemonTable *tables;		   /*!< Loaded tables */
+	size_t loaded;				   /*!< Length of tables */
+	size_t served;				   /*!< Requests answered */
+} Daemon;
 
-	if (str_buffer_empty(str))
-		return DS_ERR_INVALID_OPERATION;
+Status dmn_init(Daemon **dmn, const char *path, size_t threads);
 
-	*result = str->buffer[0];
+Status dmn_serve(Daemon *dmn);
 
-	return DS_OK;
-}
+Status dmn_delete(Daemon **dmn);
 
-Status str_back(String *str, char *result)
-{
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+Status dmn_connect(const char *path, int *fd);
 
-	if (str_buffer_empty(str))
-		return DS_ERR_INVALID_OPERATION;
+Status dmn_send(int fd, const void *buffer, size_t length);
+Status dmn_receive(int fd, void *buffer, size_t length);
 
-	*result = str->buffer[str->len - 1];
+/* ---------------------------------------------------------------------------------------------------- Daemon.h */
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- ResultCache.h */
 
-size_t str_length(String *str)
-{
-	if (str == NULL)
-		return 0;
+#define RESULT_CACHE_DIRECTORY ".process-cache" /*!< Where the menu keeps results between sessions */
+#define RESULT_CACHE_MAGIC 0x43525350			/*!< "PSRC" in little endian, first word of a cache file */
+#define RESULT_CACHE_VERSION 2					/*!< Part of every key, bumped when results of the same input change */
+#define RESULT_CACHE_ENTRIES 32					/*!< Results kept in memory, the oldest one is dropped first */
 
-	return str->len;
-}
+/**
+ * @brief What a result is looked up by
+ *
+ * input is every column of every process, the algorithm and all of its
+ * parameters, encoded like a snapshot, and digest its 128 bit FNV-1a hash.
+ * The digest only finds a result, the input has to match too.
+ */
+typedef struct ResultKey
+{
+	uint64_t digest[2];			/*!< FNV-1a 128 of input, also the name of its file */
+	const unsigned char *input; /*!< Encoded table, algorithm and parameters */
+	size_t length;				/*!< Bytes in input */
+} ResultKey;
 
-size_t str_len(char *ch)
+/**
+ * @brief A finished run, as the menu shows it
+ */
+typedef struct ResultEntry
 {
-	char *h = ch;
+	uint64_t digest[2];	  /*!< Digest of input */
+	unsigned char *input; /*!< Copy of the input of the key it was stored under */
+	size_t length;		  /*!< Bytes in input */
+	QueueArray *finished; /*!< Copies of the processes in the order they finished */
+	Metrics metrics;	  /*!< Metrics of the run */
+} ResultEntry;
 
-	while (*ch)
-		++ch;
+/**
+ * @brief Results of past runs, addressed by what produced them
+ *
+ * A result is only handed back when the table, the algorithm and every one
+ * of its parameters are byte for byte the ones it was stored with, so an
+ * edited table can never hit an old result, not even through a collision
+ * of the digests. The encoded table is built once and reused until
+ * rch_invalidate, which the process table menu calls after every edit.
+ * Results are kept in memory and, when there is a directory, in one file
+ * per digest.
+ */
+typedef struct ResultCache
+{
+	char *directory;	  /*!< Cache directory, NULL to keep results in memory only */
+	ResultEntry *entries; /*!< Results in memory */
+	size_t length;		  /*!< Entries in use */
+	size_t oldest;		  /*!< Entry replaced next once all are in use */
+	Snapshot *input;	  /*!< The current table encoded, then the algorithm and parameters of the last key */
+	size_t table;		  /*!< Bytes of input that are the table */
+	uint64_t state[2];	  /*!< Digest of the table bytes of input, where the one of every key starts from */
+	bool encoded;		  /*!< The table in input is up to date */
+	size_t hits;		  /*!< Lookups answered from memory or disk */
+	size_t misses;		  /*!< Lookups that had to run the algorithm */
+} ResultCache;
 
-	return ch - h;
-}
+Status rch_init(ResultCache **cache, const char *directory);
 
-Status str_compare(String *str1, String *str2, int *result)
-{
-	if (str1 == NULL || str2 == NULL)
-		return DS_ERR_NULL_POINTER;
+void rch_invalidate(ResultCache *cache);
 
-	if (str_greater(str1, str2))
-		*result = 1;
-	else if (str_lesser(str1, str2))
-		*result = -1;
-	else
-		*result = 0;
+// The input of key belongs to cache and is only valid until the next call
+Status rch_key(ResultCache *cache, QueueArray *table, AlgorithmId alg, const SchedulerParams *params, ResultKey *key);
 
-	return DS_OK;
-}
+Status rch_lookup(ResultCache *cache, ResultKey *key, QueueArray **finished, Metrics *metrics);
+Status rch_store(ResultCache *cache, ResultKey *key, QueueArray *finished, Metrics *metrics);
 
-bool str_greater(String *str1, String *str2)
-{
-	if (str1 == NULL || str2 == NULL)
-		return false;
+Status rch_delete(ResultCache **cache);
 
-	size_t i, len = (str1->len > str2->len) ? str2->len : str1->len;
+/* ---------------------------------------------------------------------------------------------------- ResultCache.h */
 
-	for (i = 0; i < len; i++)
-	{
-		if (str1->buffer[i] - str2->buffer[i] < 0)
-			return true;
-		else if (str1->buffer[i] - str2->buffer[i] > 0)
-			return false;
-	}
+/* ---------------------------------------------------------------------------------------------------- Replay.h */
 
-	if (str1->len > str2->len)
-		return true;
+#define REPLAY_INTERVAL 64		 /*!< Ticks between the first snapshots of a replay */
+#define REPLAY_MAX 1024			 /*!< Snapshots kept, every other one is dropped beyond it */
+#define REPLAY_BUDGET (64 << 20) /*!< Bytes of snapshots kept, every other one is dropped beyond it */
 
-	return false;
-}
+/**
+ * @brief Consecutive steps of a run that move the clock by the same ticks
+ *
+ * Almost every step takes one tick, so a whole run is a few of these. A
+ * step that skips idle ticks or a kill that takes no tick starts a new one.
+ */
+typedef struct ReplayDelta
+{
+	size_t step;	/*!< Steps taken before the first one */
+	size_t clock;	/*!< Clock before the first one */
+	size_t advance; /*!< Ticks each one moves the clock */
+	size_t count;	/*!< Steps in it */
+} ReplayDelta;
 
-bool str_equals(String *str1, String *str2)
+typedef struct ReplayPoint
 {
-	if (str1 == NULL || str2 == NULL)
-		return false;
+	Snapshot *snapshot; /*!< Whole state after step */
+	size_t step;		/*!< Steps taken before it */
+} ReplayPoint;
 
-	if (str1->len != str2->len)
-		return false;
+/**
+ * @brief A run that can be shown at any of its ticks, backwards too
+ *
+ * The run is only simulated as far as it was looked at. On the way it keeps
+ * a snapshot every interval ticks and the clock of every step as deltas, so
+ * the state at any tick already seen is the last snapshot before it and at
+ * most interval ticks run again from there.
+ */
+typedef struct Replay
+{
+	Scheduler *sch;					/*!< State shown */
+	Metrics *metrics;				/*!< Metrics of sch */
+	size_t step;					/*!< Steps sch took since the start */
+	ReplayPoint points[REPLAY_MAX]; /*!< Snapshots, by step */
+	size_t length;					/*!< Entries of points */
+	size_t bytes;					/*!< Bytes of their snapshots */
+	size_t interval;				/*!< Ticks between two snapshots */
+	ReplayDelta *deltas;			/*!< Clock of every step taken so far */
+	size_t runs;					/*!< Entries of deltas */
+	size_t capacity;				/*!< Entries deltas can hold */
+	size_t steps;					/*!< Steps recorded, the furthest the run went */
+	size_t frontier;				/*!< Clock after them */
+	bool done;						/*!< The run finished at the frontier */
+} Replay;
 
-	size_t i;
-	for (i = 0; i < str1->len; i++)
-		if (str1->buffer[i] != str2->buffer[i])
-			return false;
+Status rpl_init(Replay **rpl, QueueArray *table, AlgorithmId policy, const SchedulerParams *params);
 
-	return true;
-}
+Status rpl_step(Replay *rpl);
+Status rpl_back(Replay *rpl);
+Status rpl_seek(Replay *rpl, size_t tick);
 
-bool str_lesser(String *str1, String *str2)
-{
-	if (str1 == NULL || str2 == NULL)
-		return false;
+Status rpl_view(Replay *rpl);
 
-	size_t i, len = (str1->len > str2->len) ? str2->len : str1->len;
+Status rpl_delete(Replay **rpl);
 
-	for (i = 0; i < len; i++)
-	{
-		if (str1->buffer[i] - str2->buffer[i] > 0)
-			return true;
-		else if (str1->buffer[i] - str2->buffer[i] < 0)
-			return false;
-	}
+/* ---------------------------------------------------------------------------------------------------- Replay.h */
 
-	if (str1->len < str2->len)
-		return false;
+/* ---------------------------------------------------------------------------------------------------- TraceReader.h */
 
-	return true;
-}
+#define TRACE_GANTT_WIDTH 80 /*!< Default columns of a Gantt chart */
 
-bool str_equals_str(String *str, char *string)
+typedef struct TraceSlice
 {
-	if (str == NULL || string == NULL)
-		return false;
+	size_t run;		 /*!< Run it belongs to, from 1 */
+	size_t pid;		 /*!< Process that had the CPU, 0 for TRACE_RUN */
+	size_t start;	 /*!< First tick */
+	size_t end;		 /*!< Tick after the last one */
+	TraceEnd reason; /*!< How it left the CPU, TRACE_RUN when a run starts */
+} TraceSlice;
 
-	size_t len = str_len(string);
+/**
+ * @brief Sequential reader of a TRACE_DISPATCH file
+ *
+ * The file is mapped, not read, so a trace larger than the memory can be
+ * read from any index entry without the pages before it.
+ */
+typedef struct TraceReader
+{
+	const unsigned char *data; /*!< Mapped trace */
+	size_t size;	/*!< Bytes in data */
+	size_t offset;	/*!< Next byte to read */
+	size_t run;		/*!< Run of the last record, 0 before the first one */
+	char *name;		/*!< Name of that run */
+	size_t clock;	/*!< End of the last slice of the run */
+	size_t pid;		/*!< PID of the last slice of the run */
+	TraceRecord *window; /*!< Last TRACE_WINDOW records of the run */
+	size_t records;	/*!< Records of the run, repeated ones too */
+	size_t period;	/*!< Distance of the repeat being copied */
+	size_t copies;	/*!< Records of it left to copy */
+} TraceReader;
 
-	if (str->len != len)
-		return false;
+Status trd_open(TraceReader **trd, const char *path);
 
-	size_t i;
-	for (i = 0; i < len; i++)
-		if (str->buffer[i] != string[i])
-			return false;
+Status trd_next(TraceReader *trd, TraceSlice *slice);
+Status trd_rewind(TraceReader *trd);
+Status trd_seek(TraceReader *trd, const TraceEntry *entry);
 
-	return true;
-}
+Status trd_gantt(TraceReader *trd, size_t run, size_t width);
 
-Status str_copy(String *str, String **result)
-{
-	*result = NULL;
+Status trd_close(TraceReader **trd);
 
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+/* ---------------------------------------------------------------------------------------------------- TraceReader.h */
 
-	Status st = str_init(result);
+/* ---------------------------------------------------------------------------------------------------- TraceIndex.h */
 
-	if (st != DS_OK)
-		return st;
+// A ready queue change found while reading from an index entry
+typedef struct TraceChange
+{
+	size_t pid;	/*!< Process */
+	size_t order; /*!< Position among the changes, the last one of a PID wins */
+	bool leave;	/*!< Left the queue, else entered it */
+} TraceChange;
 
-	while (!str_buffer_fits(*result, str->len))
-	{
-		st = str_realloc(*result);
+/**
+ * @brief Random access to a dispatch trace through its index
+ *
+ * Both files are mapped. The state at a tick is read from the last entry
+ * before it, and the slices of a process only from the entries whose
+ * processes include it.
+ */
+typedef struct TraceIndex
+{
+	TraceReader *reader;	   /*!< The trace */
+	const unsigned char *data; /*!< Mapped index */
+	size_t size;			   /*!< Bytes in data */
+	const TraceEntry *entries; /*!< Entries, inside data */
+	size_t length;			   /*!< Entries */
+	TraceChange *changes;	  /*!< Scratch for tix_state */
+	size_t capacity;		   /*!< Room in changes */
+} TraceIndex;
 
-		if (st != DS_OK)
-			return st;
-	}
+Status tix_open(TraceIndex **tix, const char *path); // path of the trace, the index is next to it
 
-	char *s1 = str->buffer, *s2 = (*result)->buffer;
+Status tix_state(TraceIndex *tix, size_t run, size_t tick);
+Status tix_history(TraceIndex *tix, size_t run, size_t pid);
 
-	while (*s2++ = *s1++)
-		;
+Status tix_close(TraceIndex **tix);
 
-	(*result)->len = str->len;
+/* ---------------------------------------------------------------------------------------------------- TraceIndex.h */
 
-	return DS_OK;
-}
+#endif
 
-Status str_swap(String **str1, String **str2)
-{
-	String *temp = (*str1);
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Header Files
+ *
+ * ---------------------------------------------------------------------------------------------------- */
 
-	(*str1) = (*str2);
-	(*str2) = temp;
+/* ----------------------------------------------------------------------------------------------------
+*
+*                                                                                         Source Files
+*
+* ---------------------------------------------------------------------------------------------------- */
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- Core.c */
 
-bool str_buffer_full(String *str)
+char *status_repr(Status status)
 {
-	return (str->len + 1) >= str->capacity;
+	switch (status)
+	{
+	case DS_OK:
+		return "DS_OK";
+	case DS_ERR_INVALID_POSITION:
+		return "DS_ERR_INVALID_POSITION";
+	case DS_ERR_INVALID_OPERATION:
+		return "DS_ERR_INVALID_OPERATION";
+	case DS_ERR_INVALID_SIZE:
+		return "DS_ERR_INVALID_SIZE";
+	case DS_ERR_NOT_FOUND:
+		return "DS_ERR_NOT_FOUND";
+	case DS_ERR_ALLOC:
+		return "DS_ERR_ALLOC";
+	case DS_ERR_UNEXPECTED_RESULT:
+		return "DS_ERR_UNEXPECTED_RESULT";
+	case DS_ERR_ITER:
+		return "DS_ERR_ITER";
+	case DS_ERR_NULL_POINTER:
+		return "DS_ERR_NULL_POINTER";
+	case DS_ERR_FULL:
+		return "DS_ERR_FULL";
+	case DS_ERR_INVALID_ARGUMENT:
+		return "DS_ERR_INVALID_ARGUMENT";
+	default:
+		return "DS_UNKNOWN_ERROR";
+	}
 }
 
-bool str_buffer_empty(String *str)
+void print_status_repr(Status status)
 {
-	return str->len == 0;
+	printf("\n%s", status_repr(status));
 }
 
-bool str_buffer_fits(String *str, size_t str_len)
-{
-	return (str->len + str_len) < str->capacity;
-}
+/* ---------------------------------------------------------------------------------------------------- Core.c */
 
-Status str_realloc(String *str)
-{
-	if (str == NULL)
-		return DS_ERR_NULL_POINTER;
+/* ---------------------------------------------------------------------------------------------------- String.c */
 
-	str->capacity *= str->growth_rate;
+Status str_init(String **str)
+{
+	(*str) = malloc(sizeof(String));
 
-	char *new_buffer = realloc(str->buffer, sizeof(char) * str->capacity);
+	if (!(*str))
+		return DS_ERR_ALLOC;
 
-	if (!new_buffer)
-	{
-		str->capacity /= str->growth_rate;
+	(*str)->buffer = malloc(sizeof(char) * STRING_INIT_SIZE);
 
+	if (!((*str)->buffer))
 		return DS_ERR_ALLOC;
-	}
 
-	str->buffer = new_buffer;
+	(*str)->buffer[0] = '\0';
 
-	str->buffer[str->len] = '\0';
+	(*str)->capacity = STRING_INIT_SIZE;
+	(*str)->growth_rate = STRING_GROW_RATE;
+
+	(*str)->len = 0;
 
 	return DS_OK;
 }
 
-/* ---------------------------------------------------------------------------------------------------- String.c */
+Status str_make(String **str, char *string)
+{
+	size_t length = str_len(string);
 
-/* ---------------------------------------------------------------------------------------------------- Process.c */
+	if (length == 0)
+		return DS_ERR_INVALID_ARGUMENT;
 
-Status prc_init(Process **prc, String *name, size_t pid, size_t cpu, size_t io, size_t pri, String *type)
-{
-	(*prc) = malloc(sizeof(Process));
+	Status st = str_init(str);
 
-	if (!(*prc))
-		return DS_ERR_ALLOC;
+	if (st != DS_OK)
+		return st;
 
-	(*prc)->name = name;
+	if ((*str)->capacity <= length)
+	{
+		size_t new_capacity = STRING_INIT_SIZE;
 
-	(*prc)->pid = pid;
-	(*prc)->cpu = cpu;
-	(*prc)->io = io;
-	(*prc)->pri = pri;
-	(*prc)->type = type;
+		while (new_capacity <= length)
+		{
+			new_capacity *= STRING_GROW_RATE;
+		}
 
-	return DS_OK;
-}
+		char *new_buffer = realloc((*str)->buffer, sizeof(char) * new_capacity);
 
-Status prc_delete(Process **prc)
-{
-	if (*prc == NULL)
-		return DS_ERR_NULL_POINTER;
+		if (!new_buffer)
+		{
+			(*str)->capacity = STRING_INIT_SIZE;
 
-	Status st = str_delete(&((*prc)->name));
+			return DS_ERR_ALLOC;
+		}
 
-	if (st != DS_OK)
-		return st;
+		(*str)->buffer = new_buffer;
 
-	st = str_delete(&((*prc)->type));
+		(*str)->capacity = new_capacity;
+	}
 
-	if (st != DS_OK)
-		return st;
+	(*str)->len = length;
 
-	free(*prc);
+	size_t i;
+	for (i = 0; i < length; i++)
+	{
+		(*str)->buffer[i] = string[i];
+	}
 
-	*prc = NULL;
+	(*str)->buffer[length] = '\0';
 
 	return DS_OK;
 }
 
-Status prc_display(Process *prc)
+Status str_get_string(String *str, char **result)
 {
-	if (prc == NULL)
+	(*result) = NULL;
+
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	printf("%10s\t%lu\t%lu\t%lu\t%lu\t%s\n", prc->name->buffer, prc->pid, prc->cpu, prc->io, prc->pri, prc->type->buffer);
+	if (str_buffer_empty(str))
+		return DS_ERR_INVALID_OPERATION;
 
-	return DS_OK;
-}
+	char *string = malloc(sizeof(char) * (str->len + 1));
 
-int prc_compare(Process *prc1, Process *prc2)
-{
-	if (prc1 == NULL || prc2 == NULL)
-		return 0;
+	if (!string)
+		return DS_ERR_ALLOC;
 
-	if (prc1->pid > prc2->pid)
-		return 1;
-	else if (prc1->pid < prc2->pid)
-		return -1;
+	size_t i;
+	for (i = 0; i < str->len; i++)
+		string[i] = str->buffer[i];
 
-	return 0;
+	string[str->len] = '\0';
+
+	(*result) = string;
+
+	return DS_OK;
 }
 
-Status prc_copy(Process *prc, Process **result)
+Status str_push_char_front(String *str, char ch)
 {
-	if (prc == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	String *name, *type;
+	Status st;
 
-	Status st = str_copy(prc->name, &name);
+	if (str_buffer_full(str))
+	{
+		st = str_realloc(str);
 
-	if (st != DS_OK)
-		return st;
+		if (st != DS_OK)
+			return st;
+	}
 
-	st = str_copy(prc->type, &type);
+	size_t i;
+	for (i = str->len; i > 0; i--)
+	{
+		str->buffer[i] = str->buffer[i - 1];
+	}
 
-	if (st != DS_OK)
-		return st;
+	str->buffer[0] = ch;
 
-	st = prc_init(result, name, prc->pid, prc->cpu, prc->io, prc->pri, type);
+	(str->len)++;
 
-	if (st != DS_OK)
-		return st;
+	str->buffer[str->len] = '\0';
 
 	return DS_OK;
 }
 
-// Specific use to prc
-size_t prc_translate_type(String *str)
+Status str_push_char_at(String *str, char ch, size_t index)
 {
 	if (str == NULL)
-		return 3;
+		return DS_ERR_NULL_POINTER;
 
-	if (str_equals_str(str, "SO"))
-		return 0;
-	else if (str_equals_str(str, "UI"))
-		return 1;
-	else if (str_equals_str(str, "UNI"))
-		return 2;
-	else
-		return 3;
-}
+	if (index > str->len)
+		return DS_ERR_INVALID_POSITION;
 
-/* ---------------------------------------------------------------------------------------------------- Process.c */
+	Status st;
 
-/* ---------------------------------------------------------------------------------------------------- QueueArray.c */
-
-Status qua_init(QueueArray **qua)
-{
-	(*qua) = malloc(sizeof(QueueArray));
-
-	if (!(*qua))
-		return DS_ERR_ALLOC;
+	if (index == 0)
+	{
+		st = str_push_char_front(str, ch);
 
-	(*qua)->buffer = malloc(sizeof(QUEUE_T) * QUEUE_ARRAY_INIT_SIZE);
+		if (st != DS_OK)
+			return st;
+	}
+	else if (index == str->len)
+	{
+		st = str_push_char_front(str, ch);
 
-	if (!((*qua)->buffer))
-		return DS_ERR_ALLOC;
+		if (st != DS_OK)
+			return st;
+	}
+	else
+	{
+		if (str_buffer_full(str))
+		{
+			st = str_realloc(str);
 
-	(*qua)->capacity = QUEUE_ARRAY_INIT_SIZE;
-	(*qua)->growth_rate = QUEUE_ARRAY_GROW_RATE;
+			if (st != DS_OK)
+				return st;
+		}
 
-	(*qua)->length = 0;
+		size_t i;
+		for (i = str->len; i > index; i--)
+		{
+			str->buffer[i] = str->buffer[i - 1];
+		}
 
-	return DS_OK;
-}
+		str->buffer[index] = ch;
 
-Status qua_get_length(QueueArray *qua, size_t *result)
-{
-	if (qua == NULL)
-		return DS_ERR_NULL_POINTER;
+		(str->len)++;
 
-	*result = qua->length;
+		str->buffer[str->len] = '\0';
+	}
 
 	return DS_OK;
 }
 
-size_t qua_length(QueueArray *qua)
-{
-	return qua->length;
-}
-
-Status qua_enqueue(QueueArray *qua, QUEUE_T value)
+Status str_push_char_back(String *str, char ch)
 {
-	if (qua == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (qua_is_full(qua))
+	Status st;
+
+	if (str_buffer_full(str))
 	{
-		Status st = qua_realloc(qua);
+		st = str_realloc(str);
 
 		if (st != DS_OK)
 			return st;
 	}
 
-	qua->buffer[qua->length] = value;
+	str->buffer[str->len] = ch;
 
-	(qua->length)++;
+	(str->len)++;
+
+	str->buffer[str->len] = '\0';
 
 	return DS_OK;
 }
 
-Status qua_dequeue(QueueArray *qua, QUEUE_T *value)
+Status str_push_front(String *str, char *ch)
 {
-	*value = 0;
-
-	if (qua == NULL)
+	if (str == NULL || ch == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (qua_is_empty(qua))
-		return DS_ERR_INVALID_OPERATION;
+	size_t len = str_len(ch);
 
-	*value = qua->buffer[0];
+	if (len == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	Status st;
+
+	while (!str_buffer_fits(str, len))
+	{
+		st = str_realloc(str);
+
+		if (st != DS_OK)
+			return st;
+	}
 
 	size_t i;
+	for (i = str->len; i > 0; i--)
+	{
+		str->buffer[i + len - 1] = str->buffer[i - 1];
+	}
 
-	for (i = 0; i < qua->length - 1; i++)
+	for (i = 0; i < len; i++)
 	{
-		qua->buffer[i] = qua->buffer[i + 1];
+		str->buffer[i] = ch[i];
 	}
 
-	(qua->length)--;
+	str->len += len;
+
+	str->buffer[str->len] = '\0';
 
 	return DS_OK;
 }
 
-Status qua_display(QueueArray *qua)
+Status str_push_at(String *str, char *ch, size_t index)
 {
-	if (qua == NULL)
+	if (str == NULL || ch == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	printf("\n");
-
-	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
-	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+	Status st;
 
-	if (qua_is_empty(qua))
+	if (index == 0)
 	{
-		printf("\n");
+		st = str_push_front(str, ch);
 
-		return DS_OK;
+		if (st != DS_OK)
+			return st;
 	}
-
-	Status st;
-
-	size_t i;
-	for (i = 0; i < qua->length; i++)
+	else if (index == str->len)
 	{
-		st = QUEUE_DISPLAY(qua->buffer[i]);
+		st = str_push_back(str, ch);
 
 		if (st != DS_OK)
 			return st;
 	}
+	else
+	{
+		size_t len = str_len(ch);
 
-	printf("\n");
+		if (len == 0)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		while (!str_buffer_fits(str, len))
+		{
+			st = str_realloc(str);
+
+			if (st != DS_OK)
+				return st;
+		}
+
+		size_t i, j;
+		for (i = str->len; i >= index; i--)
+		{
+			str->buffer[i + len] = str->buffer[i];
+		}
+
+		for (i = index, j = 0; i < index + len; i++, j++)
+		{
+			str->buffer[i] = ch[j];
+		}
+
+		str->len += len;
+
+		str->buffer[str->len] = '\0';
+	}
 
 	return DS_OK;
 }
 
-Status qua_delete(QueueArray **qua)
+Status str_push_back(String *str, char *ch)
 {
-	if ((*qua) == NULL)
+	if (str == NULL || ch == NULL)
 		return DS_ERR_NULL_POINTER;
 
+	size_t len = str_len(ch);
+
+	if (len == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
 	Status st;
 
-	size_t i;
-	for (i = 0; i < (*qua)->length; i++)
+	while (!str_buffer_fits(str, len))
 	{
-		st = QUEUE_DELETE(&((*qua)->buffer[i]));
+		st = str_realloc(str);
 
 		if (st != DS_OK)
 			return st;
 	}
 
-	free((*qua)->buffer);
+	size_t i, j;
+	for (i = str->len, j = 0; i < len + str->len; i++, j++)
+	{
+		str->buffer[i] = ch[j];
+	}
 
-	free(*qua);
+	str->len += len;
 
-	*qua = NULL;
+	str->buffer[str->len] = '\0';
 
 	return DS_OK;
 }
 
-Status qua_delete_shallow(QueueArray **qua)
+Status str_prepend(String *str1, String *str2)
 {
-	if ((*qua) == NULL)
+	if (str1 == NULL || str2 == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	free((*qua)->buffer);
-
-	free(*qua);
+	if (str_buffer_empty(str2))
+		return DS_OK;
 
-	*qua = NULL;
+	Status st;
 
-	return DS_OK;
-}
+	while (!str_buffer_fits(str1, str2->len))
+	{
+		st = str_realloc(str1);
 
-Status qua_erase(QueueArray **qua)
-{
-	if ((*qua) == NULL)
-		return DS_ERR_NULL_POINTER;
+		if (st != DS_OK)
+			return st;
+	}
 
-	Status st = qua_delete(qua);
+	size_t i;
+	for (i = str1->len; i > 0; i--)
+	{
+		str1->buffer[i + str2->len - 1] = str1->buffer[i - 1];
+	}
 
-	if (st != DS_OK)
-		return st;
+	for (i = 0; i < str2->len; i++)
+	{
+		str1->buffer[i] = str2->buffer[i];
+	}
 
-	st = qua_init(qua);
+	str1->len += str2->len;
 
-	if (st != DS_OK)
-		return st;
+	str1->buffer[str1->len] = '\0';
 
 	return DS_OK;
 }
 
-bool qua_is_empty(QueueArray *qua)
-{
-	return qua->length == 0;
-}
-
-bool qua_is_full(QueueArray *qua)
-{
-	return qua->length == qua->capacity;
-}
-
-Status qua_copy(QueueArray *qua, QueueArray **result)
+Status str_add(String *str1, String *str2, size_t index)
 {
-	if (qua == NULL)
+	if (str1 == NULL || str2 == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	Status st = qua_init(result);
-
-	if (st != DS_OK)
-		return st;
-
-	QUEUE_T copy;
+	Status st;
 
-	size_t i;
-	for (i = 0; i < qua->length; i++)
+	if (index == 0)
 	{
-		st = QUEUE_COPY(qua->buffer[i], &copy);
+		st = str_prepend(str1, str2);
 
 		if (st != DS_OK)
 			return st;
-
-		st = qua_enqueue(*result, copy);
+	}
+	else if (index == str1->len)
+	{
+		st = str_append(str1, str2);
 
 		if (st != DS_OK)
 			return st;
-
-		copy = NULL;
 	}
+	else
+	{
+		while (!str_buffer_fits(str1, str2->len))
+		{
+			st = str_realloc(str1);
 
-	return DS_OK;
-}
-
-Status qua_realloc(QueueArray *qua)
-{
-	if (qua == NULL)
-		return DS_ERR_NULL_POINTER;
+			if (st != DS_OK)
+				return st;
+		}
 
-	qua->capacity *= qua->growth_rate;
+		size_t i, j;
+		for (i = str1->len; i >= index; i--)
+		{
+			str1->buffer[i + str2->len] = str1->buffer[i];
+		}
 
-	QUEUE_T *new_buffer = realloc(qua->buffer, sizeof(QUEUE_T) * qua->capacity);
+		for (i = index, j = 0; i < index + str2->len; i++, j++)
+		{
+			str1->buffer[i] = str2->buffer[j];
+		}
 
-	if (!new_buffer)
-	{
-		qua->capacity /= qua->growth_rate;
+		str1->len += str2->len;
 
-		return DS_ERR_ALLOC;
+		str1->buffer[str1->len] = '\0';
 	}
 
-	qua->buffer = new_buffer;
-
 	return DS_OK;
 }
 
-/* ---------------------------------------------------------------------------------------------------- QueueArray.c */
+Status str_append(String *str1, String *str2)
+{
+	if (str1 == NULL || str2 == NULL)
+		return DS_ERR_NULL_POINTER;
 
-/* ---------------------------------------------------------------------------------------------------- DynamicArray.c */
+	if (str_buffer_empty(str2))
+		return DS_OK;
 
-Status dar_init(DynamicArray **dar)
-{
-	(*dar) = malloc(sizeof(DynamicArray));
+	Status st;
 
-	if (!(*dar))
-		return DS_ERR_ALLOC;
+	while (!str_buffer_fits(str1, str2->len))
+	{
+		st = str_realloc(str1);
 
-	(*dar)->buffer = calloc(DYNAMIC_ARRAY_INIT_SIZE, sizeof(DS_DAR_T));
+		if (st != DS_OK)
+			return st;
+	}
 
-	if (!((*dar)->buffer))
-		return DS_ERR_ALLOC;
+	size_t i, j;
+	for (i = str1->len, j = 0; i < str1->len + str2->len; i++, j++)
+	{
+		str1->buffer[i] = str2->buffer[j];
+	}
 
-	(*dar)->capacity = DYNAMIC_ARRAY_INIT_SIZE;
-	(*dar)->growth_rate = DYNAMIC_ARRAY_GROW_RATE;
+	str1->len += str2->len;
 
-	(*dar)->size = 0;
+	str1->buffer[str1->len] = '\0';
 
 	return DS_OK;
 }
 
-Status dar_insert_front(DynamicArray *dar, DS_DAR_T value)
+Status str_pop_char_front(String *str)
 {
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_full(dar))
-	{
-		Status st = dar_realloc(dar);
-
-		if (st != DS_OK)
-			return st;
-	}
+	if (str_buffer_empty(str))
+		return DS_ERR_INVALID_OPERATION;
 
 	size_t i;
-	for (i = dar->size; i > 0; i--)
+	for (i = 0; i < str->len; i++)
 	{
-		dar->buffer[i] = dar->buffer[i - 1];
+		str->buffer[i] = str->buffer[i + 1];
 	}
 
-	dar->buffer[0] = value;
+	(str->len)--;
 
-	(dar->size)++;
+	str->buffer[str->len] = '\0';
 
 	return DS_OK;
 }
 
-Status dar_insert_at(DynamicArray *dar, DS_DAR_T value, size_t index)
+Status str_pop_char_at(String *str, size_t index)
 {
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (index > dar->size)
+	if (str_buffer_empty(str))
+		return DS_ERR_INVALID_OPERATION;
+
+	if (index >= str->len)
 		return DS_ERR_INVALID_POSITION;
 
 	Status st;
 
 	if (index == 0)
 	{
-		st = dar_insert_front(dar, value);
+		st = str_pop_char_front(str);
 
 		if (st != DS_OK)
 			return st;
 	}
-	else if (index == dar->size)
+	else if (index == str->len - 1)
 	{
-		st = dar_insert_back(dar, value);
+		st = str_pop_char_back(str);
 
 		if (st != DS_OK)
 			return st;
 	}
 	else
 	{
-		if (dar_is_full(dar))
-		{
-			st = dar_realloc(dar);
-
-			if (st != DS_OK)
-				return st;
-		}
-
 		size_t i;
-		for (i = dar->size; i > index; i--)
+		for (i = index; i < str->len; i++)
 		{
-			dar->buffer[i] = dar->buffer[i - 1];
+			str->buffer[i] = str->buffer[i + 1];
 		}
 
-		dar->buffer[index] = value;
+		(str->len)--;
 
-		(dar->size)++;
+		str->buffer[str->len] = '\0';
 	}
 
 	return DS_OK;
 }
 
-Status dar_insert_back(DynamicArray *dar, DS_DAR_T value)
+Status str_pop_char_back(String *str)
 {
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_full(dar))
-	{
-		Status st = dar_realloc(dar);
-
-		if (st != DS_OK)
-			return st;
-	}
+	if (str_buffer_empty(str))
+		return DS_ERR_INVALID_OPERATION;
 
-	dar->buffer[dar->size] = value;
+	(str->len)--;
 
-	(dar->size)++;
+	str->buffer[str->len] = '\0';
 
 	return DS_OK;
 }
 
-Status dar_remove_front(DynamicArray *dar, DS_DAR_T *result)
+Status str_display(String *str)
 {
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
-
-	*result = dar->buffer[0];
-
-	size_t i;
-	for (i = 0; i < dar->size; i++)
+	if (str_buffer_empty(str))
 	{
-		dar->buffer[i] = dar->buffer[i + 1];
+		printf("\nString\n[ empty ]\n");
+		return DS_OK;
 	}
 
-	(dar->size)--;
+	printf("\nString\n%s\n", str->buffer);
 
 	return DS_OK;
 }
 
-Status dar_remove_at(DynamicArray *dar, size_t index, DS_DAR_T *result)
+Status str_display_raw(String *str)
 {
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
+	printf("\n");
 
-	if (index >= dar->size)
-		return DS_ERR_INVALID_POSITION;
+	if (str_buffer_empty(str))
+		return DS_OK;
 
-	Status st;
+	printf("%s", str->buffer);
 
-	if (index == 0)
-	{
-		st = dar_remove_front(dar, result);
+	return DS_OK;
+}
 
-		if (st != DS_OK)
-			return st;
-	}
-	else if (index == dar->size - 1)
-	{
-		st = dar_remove_back(dar, result);
+Status str_delete(String **str)
+{
+	if ((*str) == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		if (st != DS_OK)
-			return st;
-	}
-	else
-	{
-		*result = dar->buffer[index];
+	free((*str)->buffer);
 
-		size_t i;
-		for (i = index; i < dar->size; i++)
-		{
-			dar->buffer[i] = dar->buffer[i + 1];
-		}
+	free(*str);
 
-		(dar->size)--;
-	}
+	*str = NULL;
 
 	return DS_OK;
 }
 
-Status dar_remove_back(DynamicArray *dar, DS_DAR_T *result)
+Status str_erase(String **str)
 {
-	if (dar == NULL)
+	if ((*str) == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
+	Status st = str_delete(str);
 
-	*result = dar->buffer[dar->size - 1];
+	if (st != DS_OK)
+		return st;
 
-	(dar->size)--;
+	st = str_init(str);
+
+	if (st != DS_OK)
+		return st;
 
 	return DS_OK;
 }
 
-Status dar_remove_keys(DynamicArray *dar, DS_DAR_T value)
+Status str_clear(String *str)
 {
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
-
-	Status st;
-
-	DS_DAR_T result;
+	str->len = 0;
 
-	size_t i;
-	for (i = 0; i < dar->size; i++)
-	{
-		if (DS_DAR_COMPARATOR(dar->buffer[i], value) == 0)
-		{
-			st = dar_remove_at(dar, i, &result);
+	str->buffer[0] = '\0';
 
-			if (st != DS_OK)
-				return st;
+	return DS_OK;
+}
 
-			st = DS_DAR_DELETE(&result);
+Status str_front(String *str, char *result)
+{
+	if (str == NULL)
+		return DS_ERR_NULL_POINTER;
 
-			if (st != DS_OK)
-				return st;
+	if (str_buffer_empty(str))
+		return DS_ERR_INVALID_OPERATION;
 
-			i--;
-		}
-	}
+	*result = str->buffer[0];
 
 	return DS_OK;
 }
 
-Status dar_display(DynamicArray *dar)
+Status str_back(String *str, char *result)
 {
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	printf("\n");
+	if (str_buffer_empty(str))
+		return DS_ERR_INVALID_OPERATION;
 
-	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
-	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+	*result = str->buffer[str->len - 1];
 
-	if (dar_is_empty(dar))
-	{
-		printf("\n");
+	return DS_OK;
+}
 
-		return DS_OK;
-	}
+size_t str_length(String *str)
+{
+	if (str == NULL)
+		return 0;
 
-	Status st;
+	return str->len;
+}
 
-	size_t i;
-	for (i = 0; i < dar->size; i++)
-	{
-		st = DS_DAR_DISPLAY(dar->buffer[i]);
+size_t str_len(char *ch)
+{
+	char *h = ch;
 
-		if (st != DS_OK)
-			return st;
-	}
+	while (*ch)
+		++ch;
 
-	printf("\n");
+	return ch - h;
+}
+
+Status str_compare(String *str1, String *str2, int *result)
+{
+	if (str1 == NULL || str2 == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (str_greater(str1, str2))
+		*result = 1;
+	else if (str_lesser(str1, str2))
+		*result = -1;
+	else
+		*result = 0;
 
 	return DS_OK;
 }
 
-Status dar_delete(DynamicArray **dar)
+bool str_greater(String *str1, String *str2)
 {
-	if (*dar == NULL)
-		return DS_ERR_NULL_POINTER;
+	if (str1 == NULL || str2 == NULL)
+		return false;
 
-	Status st;
+	size_t i, len = (str1->len > str2->len) ? str2->len : str1->len;
 
-	size_t i;
-	for (i = 0; i < (*dar)->size; i++)
+	for (i = 0; i < len; i++)
 	{
-		st = DS_DAR_DELETE(&((*dar)->buffer[i]));
-
-		if (st != DS_OK)
-			return st;
+		if (str1->buffer[i] - str2->buffer[i] < 0)
+			return true;
+		else if (str1->buffer[i] - str2->buffer[i] > 0)
+			return false;
 	}
 
-	free((*dar)->buffer);
-	free((*dar));
-
-	(*dar) = NULL;
+	if (str1->len > str2->len)
+		return true;
 
-	return DS_OK;
+	return false;
 }
 
-Status dar_delete_shallow(DynamicArray **dar)
+bool str_equals(String *str1, String *str2)
 {
-	if (*dar == NULL)
-		return DS_ERR_NULL_POINTER;
+	if (str1 == NULL || str2 == NULL)
+		return false;
 
-	free((*dar)->buffer);
-	free((*dar));
+	if (str1->len != str2->len)
+		return false;
 
-	(*dar) = NULL;
+	size_t i;
+	for (i = 0; i < str1->len; i++)
+		if (str1->buffer[i] != str2->buffer[i])
+			return false;
 
-	return DS_OK;
+	return true;
 }
 
-Status dar_erase(DynamicArray **dar)
+bool str_lesser(String *str1, String *str2)
 {
-	if (dar == NULL)
-		return DS_ERR_NULL_POINTER;
+	if (str1 == NULL || str2 == NULL)
+		return false;
 
-	Status st = dar_delete(dar);
+	size_t i, len = (str1->len > str2->len) ? str2->len : str1->len;
 
-	if (st != DS_OK)
-		return st;
+	for (i = 0; i < len; i++)
+	{
+		if (str1->buffer[i] - str2->buffer[i] > 0)
+			return true;
+		else if (str1->buffer[i] - str2->buffer[i] < 0)
+			return false;
+	}
 
-	st = dar_init(dar);
+	if (str1->len < str2->len)
+		return false;
 
-	if (st != DS_OK)
-		return st;
+	return true;
+}
 
-	return DS_OK;
+bool str_equals_str(String *str, char *string)
+{
+	if (str == NULL || string == NULL)
+		return false;
+
+	size_t len = str_len(string);
+
+	if (str->len != len)
+		return false;
+
+	size_t i;
+	for (i = 0; i < len; i++)
+		if (str->buffer[i] != string[i])
+			return false;
+
+	return true;
 }
 
-Status dar_get(DynamicArray *dar, size_t index, DS_DAR_T *result)
+Status str_copy(String *str, String **result)
 {
-	*result = 0;
+	*result = NULL;
 
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
+	Status st = str_init(result);
 
-	if (index >= dar->size)
-		return DS_ERR_INVALID_POSITION;
+	if (st != DS_OK)
+		return st;
 
-	*result = dar->buffer[index];
+	while (!str_buffer_fits(*result, str->len))
+	{
+		st = str_realloc(*result);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	char *s1 = str->buffer, *s2 = (*result)->buffer;
+
+	while (*s2++ = *s1++)
+		;
+
+	(*result)->len = str->len;
 
 	return DS_OK;
 }
 
-size_t dar_cap(DynamicArray *dar)
+Status str_swap(String **str1, String **str2)
 {
-	return dar->capacity;
+	String *temp = (*str1);
+
+	(*str1) = (*str2);
+	(*str2) = temp;
+
+	return DS_OK;
 }
 
-size_t dar_size(DynamicArray *dar)
+bool str_buffer_full(String *str)
 {
-	return dar->size;
+	return (str->len + 1) >= str->capacity;
 }
 
-bool dar_is_empty(DynamicArray *dar)
+bool str_buffer_empty(String *str)
 {
-	return dar->size == 0;
+	return str->len == 0;
 }
 
-bool dar_is_full(DynamicArray *dar)
+bool str_buffer_fits(String *str, size_t str_len)
 {
-	return dar->size == dar->capacity;
+	return (str->len + str_len) < str->capacity;
 }
 
-Status dar_find_max(DynamicArray *dar, DS_DAR_T *result)
+Status str_realloc(String *str)
 {
-	*result = 0;
-
-	if (dar == NULL)
+	if (str == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
+	str->capacity *= str->growth_rate;
 
-	*result = dar->buffer[0];
+	char *new_buffer = realloc(str->buffer, sizeof(char) * str->capacity);
 
-	size_t i;
-	for (i = 0; i < dar->size; i++)
+	if (!new_buffer)
 	{
-		if (DS_DAR_COMPARATOR(dar->buffer[i], *result) > 0)
-			*result = dar->buffer[i];
+		str->capacity /= str->growth_rate;
+
+		return DS_ERR_ALLOC;
 	}
 
+	str->buffer = new_buffer;
+
+	str->buffer[str->len] = '\0';
+
 	return DS_OK;
 }
 
-Status dar_find_min(DynamicArray *dar, DS_DAR_T *result)
-{
-	*result = 0;
+/* ---------------------------------------------------------------------------------------------------- String.c */
 
-	if (dar == NULL)
-		return DS_ERR_NULL_POINTER;
+/* ---------------------------------------------------------------------------------------------------- BurstArena.c */
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
+Status brs_init(BurstArena **arena)
+{
+	(*arena) = malloc(sizeof(BurstArena));
 
-	*result = dar->buffer[0];
+	if (!(*arena))
+		return DS_ERR_ALLOC;
 
-	size_t i;
-	for (i = 0; i < dar->size; i++)
+	(*arena)->burst = malloc(sizeof(size_t) * BURST_ARENA_INIT_SIZE);
+
+	if (!((*arena)->burst))
 	{
-		if (DS_DAR_COMPARATOR(dar->buffer[i], *result) < 0)
-			*result = dar->buffer[i];
+		free(*arena);
+
+		*arena = NULL;
+
+		return DS_ERR_ALLOC;
 	}
 
+	(*arena)->length = 0;
+	(*arena)->capacity = BURST_ARENA_INIT_SIZE;
+	(*arena)->references = 1;
+
 	return DS_OK;
 }
 
-Status dar_find_max_pos(DynamicArray *dar, size_t *result)
+// Makes room for count more bursts, doubling the buffer as many times as needed
+Status brs_reserve(BurstArena *arena, size_t count)
 {
-	*result = 0;
+	if (arena->capacity - arena->length >= count)
+		return DS_OK;
 
-	if (dar == NULL)
-		return DS_ERR_NULL_POINTER;
+	size_t capacity = arena->capacity;
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
+	while (capacity - arena->length < count)
+		capacity *= 2;
 
-	size_t i;
-	for (i = 0; i < dar->size; i++)
-	{
-		if (DS_DAR_COMPARATOR(dar->buffer[i], dar->buffer[(*result)]) > 0)
-			*result = i;
-	}
+	size_t *burst = realloc(arena->burst, sizeof(size_t) * capacity);
+
+	if (!burst)
+		return DS_ERR_ALLOC;
+
+	arena->burst = burst;
+	arena->capacity = capacity;
 
 	return DS_OK;
 }
 
-Status dar_find_min_pos(DynamicArray *dar, size_t *result)
+void brs_retain(BurstArena *arena)
 {
-	*result = 0;
-
-	if (dar == NULL)
-		return DS_ERR_NULL_POINTER;
+	__atomic_add_fetch(&arena->references, 1, __ATOMIC_RELAXED);
+}
 
-	if (dar_is_empty(dar))
-		return DS_ERR_INVALID_OPERATION;
+void brs_release(BurstArena **arena)
+{
+	if ((*arena) == NULL)
+		return;
 
-	size_t i;
-	for (i = 0; i < dar->size; i++)
+	if (__atomic_sub_fetch(&(*arena)->references, 1, __ATOMIC_ACQ_REL) == 0)
 	{
-		if (DS_DAR_COMPARATOR(dar->buffer[i], dar->buffer[(*result)]) < 0)
-			*result = i;
+		free((*arena)->burst);
+		free(*arena);
 	}
 
-	return DS_OK;
+	*arena = NULL;
 }
 
-bool dar_exists(DynamicArray *dar, DS_DAR_T value)
-{
-	if (dar == NULL)
-		return false;
+/* ---------------------------------------------------------------------------------------------------- BurstArena.c */
 
-	if (dar_is_empty(dar))
-		return false;
+/* ---------------------------------------------------------------------------------------------------- Process.c */
 
-	size_t i;
-	for (i = 0; i < dar->size; i++)
-	{
-		if (DS_DAR_COMPARATOR(dar->buffer[i], value) == 0)
-			return true;
-	}
+Status prc_init(Process **prc, String *name, size_t pid, size_t cpu, size_t io, size_t pri, String *type)
+{
+	(*prc) = malloc(sizeof(Process));
 
-	return false;
+	if (!(*prc))
+		return DS_ERR_ALLOC;
+
+	(*prc)->name = name;
+
+	(*prc)->pid = pid;
+	(*prc)->cpu = cpu;
+	(*prc)->io = io;
+	(*prc)->pri = pri;
+	(*prc)->type = type;
+
+	(*prc)->arrival = 0;
+	(*prc)->first_run = PROCESS_NOT_RUN;
+	(*prc)->finish = 0;
+	(*prc)->waiting = 0;
+	(*prc)->blocked = 0;
+	(*prc)->since = 0;
+	(*prc)->slot = PROCESS_NO_SLOT;
+	(*prc)->level = 0;
+	(*prc)->generation = 0;
+	(*prc)->vruntime = 0;
+	(*prc)->period = 0;
+	(*prc)->deadline = 0;
+	(*prc)->job_cpu = cpu;
+	(*prc)->job_io = io;
+	(*prc)->job = 0;
+	(*prc)->due = PROCESS_NO_DEADLINE;
+	(*prc)->jobs = 0;
+	(*prc)->misses = 0;
+	(*prc)->killed = false;
+	(*prc)->arena = NULL;
+	(*prc)->first_burst = 0;
+	(*prc)->bursts = 0;
+	(*prc)->burst = 0;
+
+	return DS_OK;
 }
 
-Status dar_copy(DynamicArray *dar, QueueArray **result)
+Status prc_delete(Process **prc)
 {
-	if (dar == NULL)
+	if (*prc == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	Status st = qua_init(result);
+	brs_release(&((*prc)->arena));
+
+	Status st = str_delete(&((*prc)->name));
 
 	if (st != DS_OK)
 		return st;
 
-	DS_DAR_T copy;
-
-	size_t i;
-	for (i = 0; i < dar->size; i++)
-	{
-		st = DS_DAR_COPY(dar->buffer[i], &copy);
-
-		if (st != DS_OK)
-			return st;
+	st = str_delete(&((*prc)->type));
 
-		st = qua_enqueue(*result, copy);
+	if (st != DS_OK)
+		return st;
 
-		if (st != DS_OK)
-			return st;
+	free(*prc);
 
-		copy = NULL;
-	}
+	*prc = NULL;
 
 	return DS_OK;
 }
 
-Status dar_realloc(DynamicArray *dar)
+Status prc_display(Process *prc)
 {
-	if (dar == NULL)
+	if (prc == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	dar->capacity *= dar->growth_rate;
-
-	DS_DAR_T *new_buffer = realloc(dar->buffer, sizeof(DS_DAR_T) * dar->capacity);
+	printf("%10s\t%lu\t%lu\t%lu\t%lu\t%s\n", prc->name->buffer, prc->pid, prc->cpu, prc->io, prc->pri, prc->type->buffer);
 
-	if (!new_buffer)
-	{
-		dar->capacity /= dar->growth_rate;
+	return DS_OK;
+}
 
-		return DS_ERR_ALLOC;
-	}
+int prc_compare(Process *prc1, Process *prc2)
+{
+	if (prc1 == NULL || prc2 == NULL)
+		return 0;
 
-	dar->buffer = new_buffer;
+	if (prc1->pid > prc2->pid)
+		return 1;
+	else if (prc1->pid < prc2->pid)
+		return -1;
 
-	return DS_OK;
+	return 0;
 }
 
-Status sort_selection_array_dar(DS_DAR_T *array, size_t arr_size)
+Status prc_copy(Process *prc, Process **result)
 {
-	if (array == NULL)
+	if (prc == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (arr_size < 2)
-		return DS_ERR_INVALID_SIZE;
+	String *name, *type;
 
-	size_t i, j, min;
-	DS_DAR_T tmp;
+	Status st = str_copy(prc->name, &name);
 
-	for (i = 0; i < arr_size - 1; i++)
-	{
-		min = i;
+	if (st != DS_OK)
+		return st;
 
-		for (j = i + 1; j < arr_size; j++)
-			if (DS_DAR_COMPARATOR(array[j], array[min]) < 0)
-				min = j;
+	st = str_copy(prc->type, &type);
 
-		tmp = array[min];
-		array[min] = array[i];
-		array[i] = tmp;
-	}
+	if (st != DS_OK)
+		return st;
 
-	return DS_OK;
-}
+	st = prc_init(result, name, prc->pid, prc->cpu, prc->io, prc->pri, type);
 
-/* ---------------------------------------------------------------------------------------------------- DynamicArray.c */
+	if (st != DS_OK)
+		return st;
 
-/* ---------------------------------------------------------------------------------------------------- PriorityQueue.c */
+	(*result)->period = prc->period;
+	(*result)->deadline = prc->deadline;
+	(*result)->arrival = prc->arrival;
 
-Status prq_init_queue(PriorityQueue **prq)
-{
-	(*prq) = malloc(sizeof(PriorityQueue));
+	if (prc->arena != NULL)
+		prc_set_bursts(*result, prc->arena, prc->first_burst, prc->bursts);
 
-	if (!(*prq))
-		return DS_ERR_ALLOC;
+	return DS_OK;
+}
 
-	(*prq)->front = NULL;
-	(*prq)->rear = NULL;
+/**
+ * Makes the count bursts at first in arena the ones of the process, which
+ * then starts in the first of them, or drops its bursts when arena is NULL
+ * and leaves it with cpu and io.
+ */
+void prc_set_bursts(Process *prc, BurstArena *arena, size_t first, size_t count)
+{
+	if (arena != NULL)
+		brs_retain(arena);
 
-	(*prq)->length = 0;
+	brs_release(&(prc->arena));
 
-	return DS_OK;
+	prc->arena = arena;
+	prc->first_burst = arena != NULL ? first : 0;
+	prc->bursts = arena != NULL ? count : 0;
+	prc->burst = 0;
+
+	if (arena != NULL)
+	{
+		prc->cpu = arena->burst[first];
+		prc->io = 0;
+	}
 }
 
-Status prq_make_node(PriorityQueueNode **node, PQUEUE_T value, size_t priority)
+bool prc_same_bursts(Process *prc1, Process *prc2)
 {
-	(*node) = malloc(sizeof(PriorityQueueNode));
+	if (prc1->bursts != prc2->bursts)
+		return false;
 
-	if (!(*node))
-		return DS_ERR_ALLOC;
+	return prc1->bursts == 0 || memcmp(prc1->arena->burst + prc1->first_burst, prc2->arena->burst + prc2->first_burst,
+									   sizeof(size_t) * prc1->bursts) == 0;
+}
 
-	(*node)->prev = NULL;
+// Scheduling events. Each one only updates the process it concerns so the
+// per-process times cost O(1) per event.
 
-	(*node)->data = value;
-	(*node)->priority = priority;
+void prc_dispatch(Process *prc, size_t now)
+{
+	prc->waiting += now - prc->since;
 
-	return DS_OK;
+	if (prc->first_run == PROCESS_NOT_RUN)
+		prc->first_run = now;
 }
 
-Status prq_get_length(PriorityQueue *prq, size_t *result)
+void prc_ready(Process *prc, size_t now)
 {
-	*result = 0;
+	prc->since = now;
+}
 
-	if (prq == NULL)
-		return DS_ERR_NULL_POINTER;
+void prc_block(Process *prc, size_t now)
+{
+	prc->since = now;
+}
 
-	if (prq_is_empty(prq))
-		return DS_ERR_INVALID_OPERATION;
+void prc_unblock(Process *prc, size_t now)
+{
+	prc->blocked += now - prc->since;
 
-	PriorityQueueNode *scan = prq->front;
+	prc->since = now;
+}
 
-	while (scan != NULL)
-	{
-		(*result)++;
+// Specific use to prc
+size_t prc_translate_type(String *str)
+{
+	if (str == NULL)
+		return 3;
 
-		scan = scan->prev;
-	}
+	if (str_equals_str(str, "SO"))
+		return 0;
+	else if (str_equals_str(str, "UI"))
+		return 1;
+	else if (str_equals_str(str, "UNI"))
+		return 2;
+	else
+		return 3;
+}
 
-	if ((*result) != prq->length)
-		return DS_ERR_UNEXPECTED_RESULT;
+/* ---------------------------------------------------------------------------------------------------- Process.c */
 
-	return DS_OK;
-}
+/* ---------------------------------------------------------------------------------------------------- QueueArray.c */
 
-Status prq_enqueue(PriorityQueue *prq, PQUEUE_T value, size_t priority)
+Status qua_init(QueueArray **qua)
 {
-	if (prq == NULL)
-		return DS_ERR_NULL_POINTER;
+	(*qua) = malloc(sizeof(QueueArray));
 
-	PriorityQueueNode *node;
+	if (!(*qua))
+		return DS_ERR_ALLOC;
 
-	prq_make_node(&node, value, priority);
+	(*qua)->buffer = malloc(sizeof(QUEUE_T) * QUEUE_ARRAY_INIT_SIZE);
 
-	if (!node)
+	if (!((*qua)->buffer))
 		return DS_ERR_ALLOC;
 
-	if (prq_is_empty(prq))
-	{
-		prq->rear = node;
-		prq->front = node;
-	}
-	else
-	{
+	(*qua)->capacity = QUEUE_ARRAY_INIT_SIZE;
+	(*qua)->growth_rate = QUEUE_ARRAY_GROW_RATE;
 
-		PriorityQueueNode *before = NULL;
-		PriorityQueueNode *curr = prq->front;
+	(*qua)->length = 0;
 
-		while (curr != NULL && curr->priority <= node->priority)
-		{
-			before = curr;
+	return DS_OK;
+}
 
-			curr = curr->prev;
-		}
+Status qua_get_length(QueueArray *qua, size_t *result)
+{
+	if (qua == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		if (before == NULL)
-		{
+	*result = qua->length;
 
-			node->prev = prq->front;
+	return DS_OK;
+}
 
-			prq->front = node;
-		}
-		else
-		{
+size_t qua_length(QueueArray *qua)
+{
+	return qua->length;
+}
+
+Status qua_enqueue(QueueArray *qua, QUEUE_T value)
+{
+	if (qua == NULL)
+		return DS_ERR_NULL_POINTER;
 
-			node->prev = curr;
+	if (qua_is_full(qua))
+	{
+		Status st = qua_realloc(qua);
 
-			before->prev = node;
-		}
+		if (st != DS_OK)
+			return st;
 	}
 
-	(prq->length)++;
+	qua->buffer[qua->length] = value;
+
+	(qua->length)++;
 
 	return DS_OK;
 }
 
-Status prq_dequeue(PriorityQueue *prq, PQUEUE_T *result)
+Status qua_dequeue(QueueArray *qua, QUEUE_T *value)
 {
-	if (prq == NULL)
+	*value = 0;
+
+	if (qua == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (prq_is_empty(prq))
+	if (qua_is_empty(qua))
 		return DS_ERR_INVALID_OPERATION;
 
-	PriorityQueueNode *node = prq->front;
-
-	prq->front = prq->front->prev;
-
-	*result = node->data;
+	*value = qua->buffer[0];
 
-	free(node);
+	size_t i;
 
-	(prq->length)--;
+	for (i = 0; i < qua->length - 1; i++)
+	{
+		qua->buffer[i] = qua->buffer[i + 1];
+	}
 
-	if (prq->length == 0)
-		prq->rear = NULL;
+	(qua->length)--;
 
 	return DS_OK;
 }
 
-Status prq_display(PriorityQueue *prq)
+Status qua_display(QueueArray *qua)
 {
-	if (prq == NULL)
+	if (qua == NULL)
 		return DS_ERR_NULL_POINTER;
 
 	printf("\n");
@@ -2260,20 +3147,22 @@ Status prq_display(PriorityQueue *prq)
 	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
 	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
 
-	if (prq_is_empty(prq))
+	if (qua_is_empty(qua))
 	{
 		printf("\n");
 
 		return DS_OK;
 	}
 
-	PriorityQueueNode *scan = prq->front;
+	Status st;
 
-	while (scan != NULL)
+	size_t i;
+	for (i = 0; i < qua->length; i++)
 	{
-		PQUEUE_DISPLAY(scan->data);
+		st = QUEUE_DISPLAY(qua->buffer[i]);
 
-		scan = scan->prev;
+		if (st != DS_OK)
+			return st;
 	}
 
 	printf("\n");
@@ -2281,59 +3170,56 @@ Status prq_display(PriorityQueue *prq)
 	return DS_OK;
 }
 
-Status prq_delete_node(PriorityQueueNode **node)
-{
-	Status st = PQUEUE_DELETE(&((*node)->data));
-
-	if (st != DS_OK)
-		return st;
-
-	free(*node);
-
-	(*node) = NULL;
-
-	return DS_OK;
-}
-
-Status prq_delete_queue(PriorityQueue **prq)
+Status qua_delete(QueueArray **qua)
 {
-	if ((*prq) == NULL)
+	if ((*qua) == NULL)
 		return DS_ERR_NULL_POINTER;
 
 	Status st;
 
-	PriorityQueueNode *prev = (*prq)->front;
-
-	while ((*prq)->front != NULL)
+	size_t i;
+	for (i = 0; i < (*qua)->length; i++)
 	{
-		(*prq)->front = (*prq)->front->prev;
-
-		st = prq_delete_node(&prev);
+		st = QUEUE_DELETE(&((*qua)->buffer[i]));
 
 		if (st != DS_OK)
 			return st;
-
-		prev = (*prq)->front;
 	}
 
-	free((*prq));
+	free((*qua)->buffer);
 
-	(*prq) = NULL;
+	free(*qua);
+
+	*qua = NULL;
 
 	return DS_OK;
 }
 
-Status prq_erase_queue(PriorityQueue **prq)
+Status qua_delete_shallow(QueueArray **qua)
 {
-	if ((*prq) == NULL)
+	if ((*qua) == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	Status st = prq_delete_queue(prq);
+	free((*qua)->buffer);
+
+	free(*qua);
+
+	*qua = NULL;
+
+	return DS_OK;
+}
+
+Status qua_erase(QueueArray **qua)
+{
+	if ((*qua) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = qua_delete(qua);
 
 	if (st != DS_OK)
 		return st;
 
-	st = prq_init_queue(prq);
+	st = qua_init(qua);
 
 	if (st != DS_OK)
 		return st;
@@ -2341,1387 +3227,15858 @@ Status prq_erase_queue(PriorityQueue **prq)
 	return DS_OK;
 }
 
-bool prq_is_empty(PriorityQueue *prq)
+bool qua_is_empty(QueueArray *qua)
 {
-	return (prq->length == 0 || prq->rear == NULL);
+	return qua->length == 0;
 }
 
-/* ---------------------------------------------------------------------------------------------------- PriorityQueue.c */
-
-/* ----------------------------------------------------------------------------------------------------
- *
- *                                                                                         Source Files
- *
- * ---------------------------------------------------------------------------------------------------- */
-
-/* ----------------------------------------------------------------------------------------------------
- *
- *                                                                                         File IO Functions
- *
- * ---------------------------------------------------------------------------------------------------- */
+bool qua_is_full(QueueArray *qua)
+{
+	return qua->length == qua->capacity;
+}
 
-Status file_load(DynamicArray *process_table)
+Status qua_copy(QueueArray *qua, QueueArray **result)
 {
-	String *text;
+	if (qua == NULL)
+		return DS_ERR_NULL_POINTER;
 
-	Status st = str_init(&text);
+	Status st = qua_init(result);
 
 	if (st != DS_OK)
 		return st;
 
-	FILE *file = fopen(FILE_NAME, "r");
-
-	if (file == NULL)
-		return DS_ERR_UNEXPECTED_RESULT;
-
-	char c;
+	QUEUE_T copy;
 
-	while (1)
+	size_t i;
+	for (i = 0; i < qua->length; i++)
 	{
-		c = fgetc(file);
-
-		if (c == EOF)
-			break;
-
-		st = str_push_char_back(text, c);
+		st = QUEUE_COPY(qua->buffer[i], &copy);
 
 		if (st != DS_OK)
 			return st;
-	}
 
-	fclose(file);
-
-	if (text->len == 0)
-	{
-		str_delete(&text);
-		return DS_OK;
-	}
-
-	String *name, *pid_s, *cpu_s, *io_s, *pri_s, *type;
-	size_t pid, cpu, io, pri;
-
-	while (text->len > 1)
-	{
-		st += str_init(&name);
-		st += str_init(&pid_s);
-		st += str_init(&cpu_s);
-		st += str_init(&io_s);
-		st += str_init(&pri_s);
-		st += str_init(&type);
+		st = qua_enqueue(*result, copy);
 
 		if (st != DS_OK)
 			return st;
 
-		// Find name
-		while (1)
-		{
-			c = text->buffer[0];
+		copy = NULL;
+	}
 
-			st = str_pop_char_front(text);
+	return DS_OK;
+}
 
-			if (st != DS_OK)
-				return st;
+Status qua_realloc(QueueArray *qua)
+{
+	if (qua == NULL)
+		return DS_ERR_NULL_POINTER;
 
-			if (c == ',')
-				break;
+	qua->capacity *= qua->growth_rate;
 
-			st = str_push_char_back(name, c);
+	QUEUE_T *new_buffer = realloc(qua->buffer, sizeof(QUEUE_T) * qua->capacity);
 
-			if (st != DS_OK)
-				return st;
-		}
+	if (!new_buffer)
+	{
+		qua->capacity /= qua->growth_rate;
 
-		// Find pid_s
-		while (1)
-		{
-			c = text->buffer[0];
+		return DS_ERR_ALLOC;
+	}
 
-			st = str_pop_char_front(text);
+	qua->buffer = new_buffer;
 
-			if (st != DS_OK)
-				return st;
+	return DS_OK;
+}
 
-			if (c == ',')
-				break;
+/* ---------------------------------------------------------------------------------------------------- QueueArray.c */
 
-			st = str_push_char_back(pid_s, c);
+/* ---------------------------------------------------------------------------------------------------- DynamicArray.c */
 
-			if (st != DS_OK)
-				return st;
-		}
+Status dar_init(DynamicArray **dar)
+{
+	(*dar) = malloc(sizeof(DynamicArray));
 
-		// Find cpu_s
-		while (1)
-		{
-			c = text->buffer[0];
+	if (!(*dar))
+		return DS_ERR_ALLOC;
 
-			st = str_pop_char_front(text);
+	(*dar)->buffer = calloc(DYNAMIC_ARRAY_INIT_SIZE, sizeof(DS_DAR_T));
 
-			if (st != DS_OK)
-				return st;
+	if (!((*dar)->buffer))
+		return DS_ERR_ALLOC;
 
-			if (c == ',')
-				break;
+	(*dar)->capacity = DYNAMIC_ARRAY_INIT_SIZE;
+	(*dar)->growth_rate = DYNAMIC_ARRAY_GROW_RATE;
 
-			st = str_push_char_back(cpu_s, c);
+	(*dar)->size = 0;
 
-			if (st != DS_OK)
-				return st;
-		}
+	return DS_OK;
+}
 
-		// Find io_s
-		while (1)
-		{
-			c = text->buffer[0];
+Status dar_insert_front(DynamicArray *dar, DS_DAR_T value)
+{
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-			st = str_pop_char_front(text);
+	if (dar_is_full(dar))
+	{
+		Status st = dar_realloc(dar);
 
-			if (st != DS_OK)
-				return st;
+		if (st != DS_OK)
+			return st;
+	}
 
-			if (c == ',')
-				break;
+	size_t i;
+	for (i = dar->size; i > 0; i--)
+	{
+		dar->buffer[i] = dar->buffer[i - 1];
+	}
 
-			st = str_push_char_back(io_s, c);
+	dar->buffer[0] = value;
 
-			if (st != DS_OK)
-				return st;
-		}
+	(dar->size)++;
 
-		// Find pri_s
-		while (1)
-		{
-			c = text->buffer[0];
+	return DS_OK;
+}
 
-			st = str_pop_char_front(text);
+Status dar_insert_at(DynamicArray *dar, DS_DAR_T value, size_t index)
+{
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-			if (st != DS_OK)
-				return st;
+	if (index > dar->size)
+		return DS_ERR_INVALID_POSITION;
 
-			if (c == ',')
-				break;
+	Status st;
 
-			st = str_push_char_back(pri_s, c);
+	if (index == 0)
+	{
+		st = dar_insert_front(dar, value);
 
-			if (st != DS_OK)
-				return st;
-		}
+		if (st != DS_OK)
+			return st;
+	}
+	else if (index == dar->size)
+	{
+		st = dar_insert_back(dar, value);
 
-		// Find type
-		while (1)
+		if (st != DS_OK)
+			return st;
+	}
+	else
+	{
+		if (dar_is_full(dar))
 		{
-			c = text->buffer[0];
-
-			st = str_pop_char_front(text);
-
-			if (st != DS_OK)
-				return st;
-
-			if (c == '\n')
-				break;
-
-			st = str_push_char_back(type, c);
+			st = dar_realloc(dar);
 
 			if (st != DS_OK)
 				return st;
 		}
 
-		Process *process;
-
-		// Convert pid
-		sscanf(pid_s->buffer, "%lu", &pid);
-
-		// Convert cpu
-		sscanf(cpu_s->buffer, "%lu", &cpu);
+		size_t i;
+		for (i = dar->size; i > index; i--)
+		{
+			dar->buffer[i] = dar->buffer[i - 1];
+		}
 
-		// Convert io
-		sscanf(io_s->buffer, "%lu", &io);
+		dar->buffer[index] = value;
 
-		// Convert priority
-		sscanf(pri_s->buffer, "%lu", &pri);
+		(dar->size)++;
+	}
 
-		// Create process
-		st = prc_init(&process, name, pid, cpu, io, pri, type);
+	return DS_OK;
+}
 
-		if (st != DS_OK)
-			return st;
+Status dar_insert_back(DynamicArray *dar, DS_DAR_T value)
+{
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		// Add to array
-		st = dar_insert_back(process_table, process);
+	if (dar_is_full(dar))
+	{
+		Status st = dar_realloc(dar);
 
 		if (st != DS_OK)
 			return st;
-
-		process = NULL;
-
-		type = NULL;
-		name = NULL;
-
-		str_delete(&pid_s);
-		str_delete(&cpu_s);
-		str_delete(&io_s);
-		str_delete(&pri_s);
 	}
 
-	str_delete(&text);
+	dar->buffer[dar->size] = value;
+
+	(dar->size)++;
 
 	return DS_OK;
 }
 
-Status file_save(DynamicArray *content)
+Status dar_remove_front(DynamicArray *dar, DS_DAR_T *result)
 {
-	FILE *f = fopen(FILE_NAME, "w");
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-	if (f == NULL)
-		return DS_ERR_UNEXPECTED_RESULT;
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
+
+	*result = dar->buffer[0];
 
 	size_t i;
-	for (i = 0; i < content->size; i++)
+	for (i = 0; i < dar->size; i++)
 	{
-		fprintf(f, "%s,%lu,%lu,%lu,%lu,%s\n", content->buffer[i]->name->buffer,
-				content->buffer[i]->pid, content->buffer[i]->cpu, content->buffer[i]->io,
-				content->buffer[i]->pri, content->buffer[i]->type->buffer);
+		dar->buffer[i] = dar->buffer[i + 1];
 	}
 
-	fclose(f);
+	(dar->size)--;
 
 	return DS_OK;
 }
 
-/* ----------------------------------------------------------------------------------------------------
- *
- *                                                                                         File IO Functions
- *
- * ---------------------------------------------------------------------------------------------------- */
-
-/* ----------------------------------------------------------------------------------------------------
- *
- *                                                                                         Algorithms
- *
- * ---------------------------------------------------------------------------------------------------- */
-
-Status alg_round_robin(QueueArray *pqueue, QueueArray **result)
+Status dar_remove_at(DynamicArray *dar, size_t index, DS_DAR_T *result)
 {
-	if (pqueue == NULL)
+	if (dar == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (qua_is_empty(pqueue))
-		return DS_ERR_INVALID_ARGUMENT;
-
-	Status st;
-
-	QueueArray *finished;
-
-	st = qua_init(&finished);
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-	if (st != DS_OK)
-		return st;
+	if (index >= dar->size)
+		return DS_ERR_INVALID_POSITION;
 
-	// IO
-	Process *blocked = NULL;
+	Status st;
 
-	Process *current = NULL;
+	if (index == 0)
+	{
+		st = dar_remove_front(dar, result);
 
-	size_t iterations = 0;
+		if (st != DS_OK)
+			return st;
+	}
+	else if (index == dar->size - 1)
+	{
+		st = dar_remove_back(dar, result);
 
-	while (1)
+		if (st != DS_OK)
+			return st;
+	}
+	else
 	{
-		CLEAR_SCREEN;
+		*result = dar->buffer[index];
 
-		if (pqueue->length == 0 && blocked != NULL)
+		size_t i;
+		for (i = index; i < dar->size; i++)
 		{
-			st = qua_enqueue(pqueue, blocked);
-
-			if (st != DS_OK)
-				return st;
-
-			blocked = NULL;
+			dar->buffer[i] = dar->buffer[i + 1];
 		}
 
-		st = qua_dequeue(pqueue, &current);
-
-		if (st != DS_OK)
-			return st;
+		(dar->size)--;
+	}
 
-		if (current->cpu > 0)
-			(current->cpu)--;
+	return DS_OK;
+}
 
-		if (current->io > 0)
-		{
-			if (blocked == NULL)
-			{
-				(current->io)--;
+Status dar_remove_back(DynamicArray *dar, DS_DAR_T *result)
+{
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-				blocked = current;
-			}
-			else
-			{
-				st = qua_enqueue(pqueue, blocked);
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-				if (st != DS_OK)
-					return st;
+	*result = dar->buffer[dar->size - 1];
 
-				(current->io)--;
+	(dar->size)--;
 
-				blocked = current;
-			}
-		}
-		else
-		{
-			if (current->cpu > 0)
-			{
-				st = qua_enqueue(pqueue, current);
+	return DS_OK;
+}
 
-				if (st != DS_OK)
-					return st;
-			}
-			else
-			{
-				st = qua_enqueue(finished, current);
+Status dar_remove_keys(DynamicArray *dar, DS_DAR_T value)
+{
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-				if (st != DS_OK)
-					return st;
-			}
-		}
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-		current = NULL;
+	Status st;
 
-		qua_display(pqueue);
+	DS_DAR_T result;
 
-		printf("\nCurrently blocked:\n");
+	size_t i;
+	for (i = 0; i < dar->size; i++)
+	{
+		if (DS_DAR_COMPARATOR(dar->buffer[i], value) == 0)
+		{
+			st = dar_remove_at(dar, i, &result);
 
-		if (blocked != NULL)
-			prc_display(blocked);
-		else
-			printf("None\n");
+			if (st != DS_OK)
+				return st;
 
-		SLEEP_F;
-		//ENTER;
+			st = DS_DAR_DELETE(&result);
 
-		iterations++;
+			if (st != DS_OK)
+				return st;
 
-		if (pqueue->length == 0 && blocked == NULL)
-			break;
+			i--;
+		}
 	}
 
-	*result = finished;
-
 	return DS_OK;
 }
 
-Status alg_pri_static(QueueArray *pqueue, QueueArray **result)
+Status dar_display(DynamicArray *dar)
 {
-	if (pqueue == NULL)
+	if (dar == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (qua_is_empty(pqueue))
-		return DS_ERR_INVALID_ARGUMENT;
-
-	PriorityQueue *pri_queue;
-	QueueArray *finished;
-
-	Status st = prq_init_queue(&pri_queue);
+	printf("\n");
 
-	if (st != DS_OK)
-		return st;
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
 
-	st = qua_init(&finished);
+	if (dar_is_empty(dar))
+	{
+		printf("\n");
 
-	if (st != DS_OK)
-		return st;
+		return DS_OK;
+	}
 
-	Process *current = NULL;
-	Process *blocked = NULL;
+	Status st;
 
-	size_t i, len = pqueue->length;
-	for (i = 0; i < len; i++)
+	size_t i;
+	for (i = 0; i < dar->size; i++)
 	{
-		st = qua_dequeue(pqueue, &current);
-
-		if (st != DS_OK)
-			return st;
-
-		st = prq_enqueue(pri_queue, current, current->pri);
+		st = DS_DAR_DISPLAY(dar->buffer[i]);
 
 		if (st != DS_OK)
 			return st;
 	}
 
-	size_t iterations = 0;
-
-	while (1)
-	{
-		CLEAR_SCREEN;
+	printf("\n");
 
-		if (pri_queue->length == 0 && blocked != NULL)
-		{
-			st = prq_enqueue(pri_queue, blocked, blocked->pri);
+	return DS_OK;
+}
 
-			if (st != DS_OK)
-				return st;
+Status dar_delete(DynamicArray **dar)
+{
+	if (*dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-			blocked = NULL;
-		}
+	Status st;
 
-		st = prq_dequeue(pri_queue, &current);
+	size_t i;
+	for (i = 0; i < (*dar)->size; i++)
+	{
+		st = DS_DAR_DELETE(&((*dar)->buffer[i]));
 
 		if (st != DS_OK)
 			return st;
+	}
 
-		if (current->cpu > 0)
-			(current->cpu)--;
-
-		if (current->io > 0)
-		{
-			if (blocked == NULL)
-			{
-				(current->io)--;
-
-				blocked = current;
-			}
-			else
-			{
-				st = prq_enqueue(pri_queue, blocked, blocked->pri);
-
-				if (st != DS_OK)
-					return st;
-
-				(current->io)--;
-
-				blocked = current;
-			}
-		}
-		else
-		{
-			if (current->cpu > 0)
-			{
-				st = prq_enqueue(pri_queue, current, current->pri);
-
-				if (st != DS_OK)
-					return st;
-			}
-			else
-			{
-				st = qua_enqueue(finished, current);
-
-				if (st != DS_OK)
-					return st;
-			}
-		}
-
-		current = NULL;
-
-		prq_display(pri_queue);
-
-		printf("\nCurrently blocked:\n");
+	free((*dar)->buffer);
+	free((*dar));
 
-		if (blocked != NULL)
-			prc_display(blocked);
-		else
-			printf("None\n");
+	(*dar) = NULL;
 
-		SLEEP_F;
-		//ENTER;
+	return DS_OK;
+}
 
-		iterations++;
+Status dar_delete_shallow(DynamicArray **dar)
+{
+	if (*dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		if (pri_queue->length == 0 && blocked == NULL)
-			break;
-	}
+	free((*dar)->buffer);
+	free((*dar));
 
-	*result = finished;
+	(*dar) = NULL;
 
 	return DS_OK;
 }
 
-Status alg_pri_dynamic(QueueArray *pqueue, QueueArray **result)
+Status dar_erase(DynamicArray **dar)
 {
-	if (pqueue == NULL)
+	if (dar == NULL)
 		return DS_ERR_NULL_POINTER;
 
-	if (qua_is_empty(pqueue))
-		return DS_ERR_INVALID_ARGUMENT;
-
-	PriorityQueue *pri_queue;
-	QueueArray *finished;
-
-	Status st = prq_init_queue(&pri_queue);
+	Status st = dar_delete(dar);
 
 	if (st != DS_OK)
 		return st;
 
-	st = qua_init(&finished);
+	st = dar_init(dar);
 
 	if (st != DS_OK)
 		return st;
 
-	Process *current = NULL;
-	Process *blocked = NULL;
+	return DS_OK;
+}
 
-	size_t i, len = pqueue->length;
-	for (i = 0; i < len; i++)
-	{
-		st = qua_dequeue(pqueue, &current);
+Status dar_get(DynamicArray *dar, size_t index, DS_DAR_T *result)
+{
+	*result = 0;
 
-		if (st != DS_OK)
-			return st;
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		st = prq_enqueue(pri_queue, current, current->pri);
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-		if (st != DS_OK)
-			return st;
-	}
+	if (index >= dar->size)
+		return DS_ERR_INVALID_POSITION;
 
-	size_t iterations = 0;
+	*result = dar->buffer[index];
 
-	while (1)
-	{
-		CLEAR_SCREEN;
+	return DS_OK;
+}
 
-		if (pri_queue->length == 0 && blocked != NULL)
-		{
-			if (blocked->pri > 0)
-				(blocked->pri)--;
+size_t dar_cap(DynamicArray *dar)
+{
+	return dar->capacity;
+}
 
-			st = prq_enqueue(pri_queue, blocked, blocked->pri);
+size_t dar_size(DynamicArray *dar)
+{
+	return dar->size;
+}
 
-			if (st != DS_OK)
-				return st;
+bool dar_is_empty(DynamicArray *dar)
+{
+	return dar->size == 0;
+}
 
-			blocked = NULL;
-		}
+bool dar_is_full(DynamicArray *dar)
+{
+	return dar->size == dar->capacity;
+}
 
-		st = prq_dequeue(pri_queue, &current);
+Status dar_find_max(DynamicArray *dar, DS_DAR_T *result)
+{
+	*result = 0;
 
-		if (st != DS_OK)
-			return st;
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		if (current->cpu > 0)
-			(current->cpu)--;
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-		if (current->io > 0)
-		{
-			if (blocked == NULL)
-			{
-				(current->io)--;
+	*result = dar->buffer[0];
 
-				blocked = current;
-			}
-			else
-			{
-				if (blocked->pri > 0)
-					(blocked->pri)--;
+	size_t i;
+	for (i = 0; i < dar->size; i++)
+	{
+		if (DS_DAR_COMPARATOR(dar->buffer[i], *result) > 0)
+			*result = dar->buffer[i];
+	}
 
-				st = prq_enqueue(pri_queue, blocked, blocked->pri);
+	return DS_OK;
+}
 
-				if (st != DS_OK)
-					return st;
+Status dar_find_min(DynamicArray *dar, DS_DAR_T *result)
+{
+	*result = 0;
 
-				(current->io)--;
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-				blocked = current;
-			}
-		}
-		else
-		{
-			if (current->cpu > 0)
-			{
-				if (current->pri > 0)
-					(current->pri)++;
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-				st = prq_enqueue(pri_queue, current, current->pri);
+	*result = dar->buffer[0];
 
-				if (st != DS_OK)
-					return st;
-			}
-			else
-			{
-				st = qua_enqueue(finished, current);
+	size_t i;
+	for (i = 0; i < dar->size; i++)
+	{
+		if (DS_DAR_COMPARATOR(dar->buffer[i], *result) < 0)
+			*result = dar->buffer[i];
+	}
 
-				if (st != DS_OK)
-					return st;
-			}
-		}
+	return DS_OK;
+}
+
+Status dar_find_max_pos(DynamicArray *dar, size_t *result)
+{
+	*result = 0;
+
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		current = NULL;
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-		prq_display(pri_queue);
+	size_t i;
+	for (i = 0; i < dar->size; i++)
+	{
+		if (DS_DAR_COMPARATOR(dar->buffer[i], dar->buffer[(*result)]) > 0)
+			*result = i;
+	}
 
-		printf("\nCurrently blocked:\n");
+	return DS_OK;
+}
 
-		if (blocked != NULL)
-			prc_display(blocked);
-		else
-			printf("None\n");
+Status dar_find_min_pos(DynamicArray *dar, size_t *result)
+{
+	*result = 0;
 
-		SLEEP_F;
-		//ENTER;
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-		iterations++;
+	if (dar_is_empty(dar))
+		return DS_ERR_INVALID_OPERATION;
 
-		if (pri_queue->length == 0 && blocked == NULL)
-			break;
+	size_t i;
+	for (i = 0; i < dar->size; i++)
+	{
+		if (DS_DAR_COMPARATOR(dar->buffer[i], dar->buffer[(*result)]) < 0)
+			*result = i;
 	}
 
-	*result = finished;
-
 	return DS_OK;
 }
 
-Status alg_pri_type(QueueArray *pqueue, QueueArray **result)
+bool dar_exists(DynamicArray *dar, DS_DAR_T value)
 {
-	if (pqueue == NULL)
-		return DS_ERR_NULL_POINTER;
+	if (dar == NULL)
+		return false;
 
-	if (qua_is_empty(pqueue))
-		return DS_ERR_INVALID_ARGUMENT;
+	if (dar_is_empty(dar))
+		return false;
 
-	PriorityQueue *pri_queue;
-	QueueArray *finished;
+	size_t i;
+	for (i = 0; i < dar->size; i++)
+	{
+		if (DS_DAR_COMPARATOR(dar->buffer[i], value) == 0)
+			return true;
+	}
 
-	Status st = prq_init_queue(&pri_queue);
+	return false;
+}
 
-	if (st != DS_OK)
-		return st;
+Status dar_copy(DynamicArray *dar, QueueArray **result)
+{
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-	st = qua_init(&finished);
+	Status st = qua_init(result);
 
 	if (st != DS_OK)
 		return st;
 
-	Process *current = NULL;
-	Process *blocked = NULL;
+	DS_DAR_T copy;
 
-	size_t i, len = pqueue->length;
-	for (i = 0; i < len; i++)
+	size_t i;
+	for (i = 0; i < dar->size; i++)
 	{
-		st = qua_dequeue(pqueue, &current);
+		st = DS_DAR_COPY(dar->buffer[i], &copy);
 
 		if (st != DS_OK)
 			return st;
 
-		st = prq_enqueue(pri_queue, current, prc_translate_type(current->type));
+		st = qua_enqueue(*result, copy);
 
 		if (st != DS_OK)
 			return st;
-	}
 
-	size_t iterations = 0;
+		copy = NULL;
+	}
 
-	while (1)
-	{
-		CLEAR_SCREEN;
+	return DS_OK;
+}
 
-		if (pri_queue->length == 0 && blocked != NULL)
-		{
-			st = prq_enqueue(pri_queue, blocked, prc_translate_type(blocked->type));
+Status dar_realloc(DynamicArray *dar)
+{
+	if (dar == NULL)
+		return DS_ERR_NULL_POINTER;
 
-			if (st != DS_OK)
-				return st;
+	dar->capacity *= dar->growth_rate;
 
-			blocked = NULL;
-		}
+	DS_DAR_T *new_buffer = realloc(dar->buffer, sizeof(DS_DAR_T) * dar->capacity);
 
-		st = prq_dequeue(pri_queue, &current);
+	if (!new_buffer)
+	{
+		dar->capacity /= dar->growth_rate;
 
-		if (st != DS_OK)
-			return st;
+		return DS_ERR_ALLOC;
+	}
 
-		if (current->cpu > 0)
-			(current->cpu)--;
+	dar->buffer = new_buffer;
 
-		if (current->io > 0)
-		{
-			if (blocked == NULL)
-			{
-				(current->io)--;
+	return DS_OK;
+}
 
-				blocked = current;
-			}
-			else
-			{
-				st = prq_enqueue(pri_queue, blocked, prc_translate_type(blocked->type));
+Status sort_selection_array_dar(DS_DAR_T *array, size_t arr_size)
+{
+	if (array == NULL)
+		return DS_ERR_NULL_POINTER;
 
-				if (st != DS_OK)
-					return st;
+	if (arr_size < 2)
+		return DS_ERR_INVALID_SIZE;
 
-				(current->io)--;
+	size_t i, j, min;
+	DS_DAR_T tmp;
 
-				blocked = current;
-			}
-		}
-		else
-		{
-			if (current->cpu > 0)
-			{
-				st = prq_enqueue(pri_queue, current, prc_translate_type(current->type));
+	for (i = 0; i < arr_size - 1; i++)
+	{
+		min = i;
 
-				if (st != DS_OK)
-					return st;
-			}
-			else
-			{
-				st = qua_enqueue(finished, current);
+		for (j = i + 1; j < arr_size; j++)
+			if (DS_DAR_COMPARATOR(array[j], array[min]) < 0)
+				min = j;
 
-				if (st != DS_OK)
-					return st;
-			}
-		}
+		tmp = array[min];
+		array[min] = array[i];
+		array[i] = tmp;
+	}
 
-		current = NULL;
+	return DS_OK;
+}
 
-		prq_display(pri_queue);
+/* ---------------------------------------------------------------------------------------------------- DynamicArray.c */
 
-		printf("\nCurrently blocked:\n");
+/* ---------------------------------------------------------------------------------------------------- PriorityQueue.c */
 
-		if (blocked != NULL)
-			prc_display(blocked);
-		else
-			printf("None\n");
+static inline bool prq_before(PriorityQueueNode *node1, PriorityQueueNode *node2)
+{
+	return node1->priority < node2->priority || (node1->priority == node2->priority && node1->order < node2->order);
+}
 
-		SLEEP_F;
-		//getch();
+static Status prq_grow(PriorityQueueNode **buffer, size_t *capacity)
+{
+	size_t new_capacity = (*capacity == 0) ? PQUEUE_INIT_SIZE : *capacity * PQUEUE_GROW_RATE;
 
-		iterations++;
+	PriorityQueueNode *new_buffer = realloc(*buffer, sizeof(PriorityQueueNode) * new_capacity);
 
-		if (pri_queue->length == 0 && blocked == NULL)
-			break;
-	}
+	if (!new_buffer)
+		return DS_ERR_ALLOC;
 
-	*result = finished;
+	*buffer = new_buffer;
+	*capacity = new_capacity;
 
 	return DS_OK;
 }
 
-/* ----------------------------------------------------------------------------------------------------
- *
- *                                                                                         Algorithms
- *
- * ---------------------------------------------------------------------------------------------------- */
+#if PQUEUE_BACKEND == PQUEUE_RADIX
+#define PQUEUE_STRIDE PQUEUE_RADIX_BUCKETS
+#else
+#define PQUEUE_STRIDE 1
+#endif
 
-/* ----------------------------------------------------------------------------------------------------
- *
- *                                                                                         Menu Functions
- *
- * ---------------------------------------------------------------------------------------------------- */
+#if PQUEUE_BACKEND != PQUEUE_PAIRING
+
+// Array heap of the binary and 4-ary backends, and of bucket 0 of the radix
+// heap. The handle of the node at index is index * PQUEUE_STRIDE.
 
-Status process_table(DynamicArray **ptable)
+static inline void prq_place(PriorityQueueNode *heap, size_t index, PriorityQueueNode node)
 {
-	Status st;
+	heap[index] = node;
 
-	int choice;
+	PQUEUE_SLOT(node.data) = index * PQUEUE_STRIDE;
+}
 
-	size_t i;
+static void prq_sift_up(PriorityQueueNode *heap, size_t index)
+{
+	PriorityQueueNode node = heap[index];
 
-	while (1)
+	while (index > 0)
 	{
-		CLEAR_SCREEN;
-		printf(" +--------------------------------------------------+\n");
-		printf(" |                  Process Table                   |\n");
-		printf(" +--------------------------------------------------+\n");
-		printf(" | 0 - Return                                       |\n");
-		printf(" | 1 - Add process                                  |\n");
-		printf(" | 2 - Alter process                                |\n");
-		printf(" | 3 - Remove process                               |\n");
-		printf(" | 4 - List process table                           |\n");
-		printf(" | 5 - Clear process table                          |\n");
-		printf(" | 6 - Reload from file                             |\n");
-		printf(" | 7 - Save to file                                 |\n");
-		printf(" | 8 - Sort table by PID                            |\n");
-		printf(" +--------------------------------------------------+\n");
-		printf(" > ");
+		size_t parent = (index - 1) / PQUEUE_ARITY;
 
-		scanf("%d", &choice);
+		if (!prq_before(&node, &heap[parent]))
+			break;
 
-		if (choice == 0)
-		{
-			return DS_OK;
-		}
-		else if (choice == 1)
-		{
-			String *name, *type;
-			size_t pid = 0, pri, cpu, io;
+		prq_place(heap, index, heap[parent]);
 
-			st += str_init(&name);
-			st += str_init(&type);
+		index = parent;
+	}
 
-			if (st != DS_OK)
-				return st;
+	prq_place(heap, index, node);
+}
 
-			char c = ' ';
+static void prq_sift_down(PriorityQueueNode *heap, size_t length, size_t index)
+{
+	PriorityQueueNode node = heap[index];
 
-			getchar(); // get newline from scanf
+	while (1)
+	{
+		size_t first = PQUEUE_ARITY * index + 1;
 
-			printf("Name > ");
-			while (c != '\n')
-			{
-				c = getchar();
+		if (first >= length)
+			break;
 
-				if (c != '\n')
-				{
-					st = str_push_char_back(name, c);
+		size_t end = (length - first > PQUEUE_ARITY) ? first + PQUEUE_ARITY : length;
+		size_t child = first, i;
 
-					if (st != DS_OK)
-						return st;
-				}
-			}
+		for (i = first + 1; i < end; i++)
+			if (prq_before(&heap[i], &heap[child]))
+				child = i;
 
-			c = ' ';
+		if (!prq_before(&heap[child], &node))
+			break;
+
+		prq_place(heap, index, heap[child]);
+
+		index = child;
+	}
+
+	prq_place(heap, index, node);
+}
+
+// Takes out the node at index of a heap that is now length nodes long. The
+// node that was last fills the hole and moves up or down from there.
+static void prq_heap_take(PriorityQueueNode *heap, size_t length, size_t index)
+{
+	if (index == length)
+		return;
+
+	PQUEUE_T moved = heap[length].data;
+
+	prq_place(heap, index, heap[length]);
+
+	prq_sift_up(heap, index);
+	prq_sift_down(heap, length, PQUEUE_SLOT(moved) / PQUEUE_STRIDE);
+}
+
+#endif
+
+#if PQUEUE_BACKEND == PQUEUE_BINARY || PQUEUE_BACKEND == PQUEUE_QUATERNARY
+
+static Status prq_store_init(PriorityQueue *prq)
+{
+	prq->buffer = NULL;
+	prq->capacity = 0;
+
+	return prq_grow(&prq->buffer, &prq->capacity);
+}
+
+static void prq_store_free(PriorityQueue *prq)
+{
+	free(prq->buffer);
+}
+
+static Status prq_insert(PriorityQueue *prq, PriorityQueueNode node)
+{
+	if (prq->length == prq->capacity)
+	{
+		Status st = prq_grow(&prq->buffer, &prq->capacity);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	prq_place(prq->buffer, prq->length, node);
+
+	prq_sift_up(prq->buffer, (prq->length)++);
+
+	return DS_OK;
+}
+
+static inline Status prq_top(PriorityQueue *prq, PriorityQueueNode **result)
+{
+	*result = &prq->buffer[0];
+
+	return DS_OK;
+}
+
+static inline void prq_take(PriorityQueue *prq, PQUEUE_T value)
+{
+	prq_heap_take(prq->buffer, --(prq->length), PQUEUE_SLOT(value));
+}
+
+// The insertion number is kept, so a value does not lose its place among
+// equal priorities
+static Status prq_move(PriorityQueue *prq, PQUEUE_T value, size_t priority)
+{
+	size_t index = PQUEUE_SLOT(value);
+	size_t old = prq->buffer[index].priority;
+
+	prq->buffer[index].priority = priority;
+
+	if (priority < old)
+		prq_sift_up(prq->buffer, index);
+	else if (priority > old)
+		prq_sift_down(prq->buffer, prq->length, index);
+
+	return DS_OK;
+}
+
+static inline bool prq_has(PriorityQueue *prq, PQUEUE_T value)
+{
+	return PQUEUE_SLOT(value) < prq->length && prq->buffer[PQUEUE_SLOT(value)].data == value;
+}
+
+// Walks every node, in no particular order, starting with *cursor = 0
+static PriorityQueueNode *prq_next(PriorityQueue *prq, size_t *cursor)
+{
+	return (*cursor < prq->length) ? &prq->buffer[(*cursor)++] : NULL;
+}
+
+#elif PQUEUE_BACKEND == PQUEUE_PAIRING
+
+// Threads the nodes from first to the end of the pool into the free list,
+// which has to be empty
+static void prq_pool_link(PriorityQueue *prq, size_t first)
+{
+	size_t i;
+	for (i = first; i < prq->capacity; i++)
+	{
+		prq->buffer[i].prev = PQUEUE_FREE;
+		prq->buffer[i].sibling = (i + 1 < prq->capacity) ? i + 1 : PQUEUE_NIL;
+	}
+
+	prq->free = first;
+}
+
+static Status prq_store_init(PriorityQueue *prq)
+{
+	prq->buffer = NULL;
+	prq->capacity = 0;
+	prq->root = PQUEUE_NIL;
+
+	Status st = prq_grow(&prq->buffer, &prq->capacity);
+
+	if (st != DS_OK)
+		return st;
+
+	prq_pool_link(prq, 0);
+
+	return DS_OK;
+}
+
+static void prq_store_free(PriorityQueue *prq)
+{
+	free(prq->buffer);
+}
+
+// Joins two detached trees, the one with the later root goes under the other
+static size_t prq_meld(PriorityQueue *prq, size_t a, size_t b)
+{
+	if (a == PQUEUE_NIL)
+		return b;
+
+	if (b == PQUEUE_NIL)
+		return a;
+
+	PriorityQueueNode *buffer = prq->buffer;
+
+	if (prq_before(&buffer[b], &buffer[a]))
+	{
+		size_t tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	buffer[b].sibling = buffer[a].child;
+	buffer[b].prev = a;
+
+	if (buffer[a].child != PQUEUE_NIL)
+		buffer[buffer[a].child].prev = b;
+
+	buffer[a].child = b;
+
+	return a;
+}
+
+// Two pass pairing of a list of siblings into one detached tree: pairs are
+// melded left to right and then the pairs right to left. The pairs are kept
+// on a stack linked through sibling instead of recursing.
+static size_t prq_merge_pairs(PriorityQueue *prq, size_t first)
+{
+	PriorityQueueNode *buffer = prq->buffer;
+
+	size_t pairs = PQUEUE_NIL;
+
+	while (first != PQUEUE_NIL)
+	{
+		size_t a = first, b = buffer[a].sibling;
+
+		first = (b != PQUEUE_NIL) ? buffer[b].sibling : PQUEUE_NIL;
+
+		buffer[a].sibling = buffer[a].prev = PQUEUE_NIL;
+
+		if (b != PQUEUE_NIL)
+			buffer[b].sibling = buffer[b].prev = PQUEUE_NIL;
+
+		size_t pair = prq_meld(prq, a, b);
+
+		buffer[pair].sibling = pairs;
+		pairs = pair;
+	}
+
+	size_t root = pairs;
+
+	if (root == PQUEUE_NIL)
+		return root;
+
+	pairs = buffer[root].sibling;
+	buffer[root].sibling = PQUEUE_NIL;
+
+	while (pairs != PQUEUE_NIL)
+	{
+		size_t next = buffer[pairs].sibling;
+
+		buffer[pairs].sibling = PQUEUE_NIL;
+
+		root = prq_meld(prq, root, pairs);
+
+		pairs = next;
+	}
+
+	return root;
+}
+
+// Detaches a node that is not the root, with its subtree
+static void prq_cut(PriorityQueue *prq, size_t node)
+{
+	PriorityQueueNode *buffer = prq->buffer;
+
+	size_t prev = buffer[node].prev, sibling = buffer[node].sibling;
+
+	if (buffer[prev].child == node)
+		buffer[prev].child = sibling;
+	else
+		buffer[prev].sibling = sibling;
+
+	if (sibling != PQUEUE_NIL)
+		buffer[sibling].prev = prev;
+
+	buffer[node].sibling = buffer[node].prev = PQUEUE_NIL;
+}
+
+static Status prq_insert(PriorityQueue *prq, PriorityQueueNode node)
+{
+	if (prq->free == PQUEUE_NIL)
+	{
+		size_t first = prq->capacity;
+
+		Status st = prq_grow(&prq->buffer, &prq->capacity);
+
+		if (st != DS_OK)
+			return st;
+
+		prq_pool_link(prq, first);
+	}
+
+	size_t index = prq->free;
+
+	prq->free = prq->buffer[index].sibling;
+
+	node.child = node.sibling = node.prev = PQUEUE_NIL;
+
+	prq->buffer[index] = node;
+
+	PQUEUE_SLOT(node.data) = index;
+
+	prq->root = prq_meld(prq, prq->root, index);
+
+	(prq->length)++;
+
+	return DS_OK;
+}
+
+static inline Status prq_top(PriorityQueue *prq, PriorityQueueNode **result)
+{
+	*result = &prq->buffer[prq->root];
+
+	return DS_OK;
+}
+
+static void prq_take(PriorityQueue *prq, PQUEUE_T value)
+{
+	size_t node = PQUEUE_SLOT(value);
+
+	if (node == prq->root)
+		prq->root = prq_merge_pairs(prq, prq->buffer[node].child);
+	else
+	{
+		prq_cut(prq, node);
+
+		prq->root = prq_meld(prq, prq->root, prq_merge_pairs(prq, prq->buffer[node].child));
+	}
+
+	prq->buffer[node].prev = PQUEUE_FREE;
+	prq->buffer[node].sibling = prq->free;
+	prq->free = node;
+
+	(prq->length)--;
+}
+
+// A lower priority only cuts the node out with its subtree, a higher one
+// also gives its children back to the root. The insertion number is kept.
+static Status prq_move(PriorityQueue *prq, PQUEUE_T value, size_t priority)
+{
+	size_t node = PQUEUE_SLOT(value);
+	size_t old = prq->buffer[node].priority;
+
+	if (node == prq->root)
+	{
+		prq->buffer[node].priority = priority;
+
+		if (priority <= old)
+			return DS_OK;
+
+		prq->root = prq_merge_pairs(prq, prq->buffer[node].child);
+		prq->buffer[node].child = PQUEUE_NIL;
+	}
+	else
+	{
+		prq_cut(prq, node);
+
+		prq->buffer[node].priority = priority;
+
+		if (priority > old)
+		{
+			prq->root = prq_meld(prq, prq->root, prq_merge_pairs(prq, prq->buffer[node].child));
+			prq->buffer[node].child = PQUEUE_NIL;
+		}
+	}
+
+	prq->root = prq_meld(prq, prq->root, node);
+
+	return DS_OK;
+}
+
+static inline bool prq_has(PriorityQueue *prq, PQUEUE_T value)
+{
+	size_t node = PQUEUE_SLOT(value);
+
+	return node < prq->capacity && prq->buffer[node].prev != PQUEUE_FREE && prq->buffer[node].data == value;
+}
+
+// Walks every node, in no particular order, starting with *cursor = 0
+static PriorityQueueNode *prq_next(PriorityQueue *prq, size_t *cursor)
+{
+	while (*cursor < prq->capacity)
+	{
+		PriorityQueueNode *node = &prq->buffer[(*cursor)++];
+
+		if (node->prev != PQUEUE_FREE)
+			return node;
+	}
+
+	return NULL;
+}
+
+#elif PQUEUE_BACKEND == PQUEUE_RADIX
+
+static Status prq_store_init(PriorityQueue *prq)
+{
+	size_t i;
+	for (i = 0; i < PQUEUE_RADIX_BUCKETS; i++)
+	{
+		prq->bucket[i] = NULL;
+		prq->used[i] = 0;
+		prq->room[i] = 0;
+	}
+
+	prq->last = 0;
+
+	return DS_OK;
+}
+
+static void prq_store_free(PriorityQueue *prq)
+{
+	size_t i;
+	for (i = 0; i < PQUEUE_RADIX_BUCKETS; i++)
+		free(prq->bucket[i]);
+}
+
+// 0 up to last, else one more than the highest bit where they differ
+static inline size_t prq_radix_bucket(PriorityQueue *prq, size_t priority)
+{
+	if (priority <= prq->last)
+		return 0;
+
+	unsigned long long diff = priority ^ prq->last;
+
+#if defined(__GNUC__)
+	return 64 - __builtin_clzll(diff);
+#else
+	size_t bucket = 0;
+
+	while (diff)
+	{
+		diff >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+#endif
+}
+
+static Status prq_radix_put(PriorityQueue *prq, PriorityQueueNode node)
+{
+	size_t bucket = prq_radix_bucket(prq, node.priority);
+
+	if (prq->used[bucket] == prq->room[bucket])
+	{
+		Status st = prq_grow(&prq->bucket[bucket], &prq->room[bucket]);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	size_t index = (prq->used[bucket])++;
+
+	if (bucket == 0)
+	{
+		prq_place(prq->bucket[0], index, node);
+
+		prq_sift_up(prq->bucket[0], index);
+	}
+	else
+	{
+		prq->bucket[bucket][index] = node;
+
+		PQUEUE_SLOT(node.data) = index * PQUEUE_RADIX_BUCKETS + bucket;
+	}
+
+	return DS_OK;
+}
+
+static Status prq_insert(PriorityQueue *prq, PriorityQueueNode node)
+{
+	Status st = prq_radix_put(prq, node);
+
+	if (st != DS_OK)
+		return st;
+
+	(prq->length)++;
+
+	return DS_OK;
+}
+
+// When bucket 0 is empty, the lowest priority of the first bucket that is
+// not becomes last and that bucket is split into the buckets below it. A
+// node only ever moves down, at most once per bit of the priorities.
+static Status prq_top(PriorityQueue *prq, PriorityQueueNode **result)
+{
+	if (prq->used[0] == 0)
+	{
+		size_t bucket = 1;
+
+		while (prq->used[bucket] == 0)
+			bucket++;
+
+		PriorityQueueNode *nodes = prq->bucket[bucket];
+
+		size_t count = prq->used[bucket], lowest = nodes[0].priority, i;
+		for (i = 1; i < count; i++)
+			if (nodes[i].priority < lowest)
+				lowest = nodes[i].priority;
+
+		prq->last = lowest;
+		prq->used[bucket] = 0;
+
+		for (i = 0; i < count; i++)
+		{
+			Status st = prq_radix_put(prq, nodes[i]);
+
+			if (st != DS_OK)
+				return st;
+		}
+	}
+
+	*result = &prq->bucket[0][0];
+
+	return DS_OK;
+}
+
+static void prq_take(PriorityQueue *prq, PQUEUE_T value)
+{
+	size_t bucket = PQUEUE_SLOT(value) % PQUEUE_RADIX_BUCKETS;
+	size_t index = PQUEUE_SLOT(value) / PQUEUE_RADIX_BUCKETS;
+	size_t used = --(prq->used[bucket]);
+
+	if (bucket == 0)
+		prq_heap_take(prq->bucket[0], used, index);
+	else if (index != used)
+	{
+		prq->bucket[bucket][index] = prq->bucket[bucket][used];
+
+		PQUEUE_SLOT(prq->bucket[bucket][index].data) = index * PQUEUE_RADIX_BUCKETS + bucket;
+	}
+
+	(prq->length)--;
+}
+
+// The node is taken out and put back, keeping its insertion number
+static Status prq_move(PriorityQueue *prq, PQUEUE_T value, size_t priority)
+{
+	size_t bucket = PQUEUE_SLOT(value) % PQUEUE_RADIX_BUCKETS;
+	size_t index = PQUEUE_SLOT(value) / PQUEUE_RADIX_BUCKETS;
+
+	PriorityQueueNode node = prq->bucket[bucket][index];
+
+	prq_take(prq, value);
+
+	node.priority = priority;
+
+	return prq_insert(prq, node);
+}
+
+static inline bool prq_has(PriorityQueue *prq, PQUEUE_T value)
+{
+	size_t bucket = PQUEUE_SLOT(value) % PQUEUE_RADIX_BUCKETS;
+	size_t index = PQUEUE_SLOT(value) / PQUEUE_RADIX_BUCKETS;
+
+	return index < prq->used[bucket] && prq->bucket[bucket][index].data == value;
+}
+
+// Walks every node, in no particular order, starting with *cursor = 0
+static PriorityQueueNode *prq_next(PriorityQueue *prq, size_t *cursor)
+{
+	size_t position = *cursor, i;
+	for (i = 0; i < PQUEUE_RADIX_BUCKETS; i++)
+	{
+		if (position < prq->used[i])
+		{
+			(*cursor)++;
+
+			return &prq->bucket[i][position];
+		}
+
+		position -= prq->used[i];
+	}
+
+	return NULL;
+}
+
+#endif
+
+Status prq_init_queue(PriorityQueue **prq)
+{
+	(*prq) = malloc(sizeof(PriorityQueue));
+
+	if (!(*prq))
+		return DS_ERR_ALLOC;
+
+	if (prq_store_init(*prq) != DS_OK)
+	{
+		free(*prq);
+
+		*prq = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*prq)->length = 0;
+	(*prq)->order = 0;
+
+	return DS_OK;
+}
+
+Status prq_get_length(PriorityQueue *prq, size_t *result)
+{
+	*result = 0;
+
+	if (prq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (prq_is_empty(prq))
+		return DS_ERR_INVALID_OPERATION;
+
+	*result = prq->length;
+
+	return DS_OK;
+}
+
+Status prq_enqueue(PriorityQueue *prq, PQUEUE_T value, size_t priority)
+{
+	if (prq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	PriorityQueueNode node = {.data = value, .priority = priority, .order = (prq->order)++};
+
+	return prq_insert(prq, node);
+}
+
+Status prq_dequeue(PriorityQueue *prq, PQUEUE_T *result)
+{
+	Status st = prq_peek(prq, result);
+
+	if (st != DS_OK)
+		return st;
+
+	return prq_remove(prq, *result);
+}
+
+Status prq_peek(PriorityQueue *prq, PQUEUE_T *result)
+{
+	if (prq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (prq_is_empty(prq))
+		return DS_ERR_INVALID_OPERATION;
+
+	PriorityQueueNode *top;
+
+	Status st = prq_top(prq, &top);
+
+	if (st != DS_OK)
+		return st;
+
+	*result = top->data;
+
+	return DS_OK;
+}
+
+// Moves a queued value to its new priority. The insertion number is kept,
+// so a value does not lose its place among equal priorities.
+Status prq_update(PriorityQueue *prq, PQUEUE_T value, size_t priority)
+{
+	if (prq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (!prq_contains(prq, value))
+		return DS_ERR_NOT_FOUND;
+
+	return prq_move(prq, value, priority);
+}
+
+Status prq_remove(PriorityQueue *prq, PQUEUE_T value)
+{
+	if (prq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (!prq_contains(prq, value))
+		return DS_ERR_NOT_FOUND;
+
+	prq_take(prq, value);
+
+	PQUEUE_SLOT(value) = PQUEUE_NO_SLOT;
+
+	return DS_OK;
+}
+
+bool prq_contains(PriorityQueue *prq, PQUEUE_T value)
+{
+	return prq_has(prq, value);
+}
+
+static int prq_compare_nodes(const void *a, const void *b)
+{
+	PriorityQueueNode *node1 = (PriorityQueueNode *)a, *node2 = (PriorityQueueNode *)b;
+
+	return prq_before(node1, node2) ? -1 : prq_before(node2, node1);
+}
+
+// Shows the values in the order they will leave
+Status prq_display(PriorityQueue *prq)
+{
+	if (prq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	printf("\n");
+
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+
+	if (prq_is_empty(prq))
+	{
+		printf("\n");
+
+		return DS_OK;
+	}
+
+	PriorityQueueNode *sorted = malloc(sizeof(PriorityQueueNode) * prq->length), *node;
+
+	if (!sorted)
+		return DS_ERR_ALLOC;
+
+	size_t cursor = 0, i = 0;
+
+	while ((node = prq_next(prq, &cursor)) != NULL)
+		sorted[i++] = *node;
+
+	qsort(sorted, prq->length, sizeof(PriorityQueueNode), prq_compare_nodes);
+
+	for (i = 0; i < prq->length; i++)
+		PQUEUE_DISPLAY(sorted[i].data);
+
+	free(sorted);
+
+	printf("\n");
+
+	return DS_OK;
+}
+
+Status prq_delete_queue(PriorityQueue **prq)
+{
+	if ((*prq) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	PriorityQueueNode *node;
+
+	size_t cursor = 0;
+
+	while ((node = prq_next(*prq, &cursor)) != NULL)
+	{
+		st = PQUEUE_DELETE(&(node->data));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	prq_store_free(*prq);
+
+	free((*prq));
+
+	(*prq) = NULL;
+
+	return DS_OK;
+}
+
+Status prq_erase_queue(PriorityQueue **prq)
+{
+	if ((*prq) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = prq_delete_queue(prq);
+
+	if (st != DS_OK)
+		return st;
+
+	st = prq_init_queue(prq);
+
+	if (st != DS_OK)
+		return st;
+
+	return DS_OK;
+}
+
+bool prq_is_empty(PriorityQueue *prq)
+{
+	return prq->length == 0;
+}
+
+/* ---------------------------------------------------------------------------------------------------- PriorityQueue.c */
+
+/* ---------------------------------------------------------------------------------------------------- IndexedHeap.c */
+
+Status ihp_init(IndexedHeap **ihp)
+{
+	(*ihp) = malloc(sizeof(IndexedHeap));
+
+	if (!(*ihp))
+		return DS_ERR_ALLOC;
+
+	(*ihp)->buffer = malloc(sizeof(IndexedHeapNode) * INDEXED_HEAP_INIT_SIZE);
+
+	if (!((*ihp)->buffer))
+	{
+		free(*ihp);
+
+		*ihp = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*ihp)->length = 0;
+	(*ihp)->capacity = INDEXED_HEAP_INIT_SIZE;
+	(*ihp)->order = 0;
+
+	return DS_OK;
+}
+
+static inline bool ihp_before(IndexedHeapNode *node1, IndexedHeapNode *node2)
+{
+	return node1->key < node2->key || (node1->key == node2->key && node1->order < node2->order);
+}
+
+static inline void ihp_place(IndexedHeap *ihp, size_t index, IndexedHeapNode node)
+{
+	ihp->buffer[index] = node;
+
+	node.data->slot = index;
+}
+
+static void ihp_sift_up(IndexedHeap *ihp, size_t index)
+{
+	IndexedHeapNode node = ihp->buffer[index];
+
+	while (index > 0)
+	{
+		size_t parent = (index - 1) / 2;
+
+		if (!ihp_before(&node, &ihp->buffer[parent]))
+			break;
+
+		ihp_place(ihp, index, ihp->buffer[parent]);
+
+		index = parent;
+	}
+
+	ihp_place(ihp, index, node);
+}
+
+static void ihp_sift_down(IndexedHeap *ihp, size_t index)
+{
+	IndexedHeapNode node = ihp->buffer[index];
+
+	while (1)
+	{
+		size_t child = 2 * index + 1;
+
+		if (child >= ihp->length)
+			break;
+
+		if (child + 1 < ihp->length && ihp_before(&ihp->buffer[child + 1], &ihp->buffer[child]))
+			child++;
+
+		if (!ihp_before(&ihp->buffer[child], &node))
+			break;
+
+		ihp_place(ihp, index, ihp->buffer[child]);
+
+		index = child;
+	}
+
+	ihp_place(ihp, index, node);
+}
+
+static Status ihp_realloc(IndexedHeap *ihp)
+{
+	size_t capacity = ihp->capacity * INDEXED_HEAP_GROW_RATE;
+
+	IndexedHeapNode *new_buffer = realloc(ihp->buffer, sizeof(IndexedHeapNode) * capacity);
+
+	if (!new_buffer)
+		return DS_ERR_ALLOC;
+
+	ihp->buffer = new_buffer;
+	ihp->capacity = capacity;
+
+	return DS_OK;
+}
+
+Status ihp_push(IndexedHeap *ihp, Process *prc, size_t key)
+{
+	if (ihp == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (ihp->length == ihp->capacity)
+	{
+		Status st = ihp_realloc(ihp);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	IndexedHeapNode node = {key, (ihp->order)++, prc};
+
+	ihp_place(ihp, (ihp->length)++, node);
+
+	ihp_sift_up(ihp, ihp->length - 1);
+
+	return DS_OK;
+}
+
+Status ihp_peek(IndexedHeap *ihp, Process **result)
+{
+	if (ihp == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (ihp_is_empty(ihp))
+		return DS_ERR_INVALID_OPERATION;
+
+	*result = ihp->buffer[0].data;
+
+	return DS_OK;
+}
+
+Status ihp_pop(IndexedHeap *ihp, Process **result)
+{
+	Status st = ihp_peek(ihp, result);
+
+	if (st != DS_OK)
+		return st;
+
+	return ihp_remove(ihp, *result);
+}
+
+// Moves a queued process to its new key. The insertion number is kept, so a
+// process does not lose its place among equal keys.
+Status ihp_update(IndexedHeap *ihp, Process *prc, size_t key)
+{
+	if (ihp == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (!ihp_contains(ihp, prc))
+		return DS_ERR_NOT_FOUND;
+
+	size_t index = prc->slot;
+	size_t old = ihp->buffer[index].key;
+
+	ihp->buffer[index].key = key;
+
+	if (key < old)
+		ihp_sift_up(ihp, index);
+	else if (key > old)
+		ihp_sift_down(ihp, index);
+
+	return DS_OK;
+}
+
+Status ihp_remove(IndexedHeap *ihp, Process *prc)
+{
+	if (ihp == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (!ihp_contains(ihp, prc))
+		return DS_ERR_NOT_FOUND;
+
+	size_t index = prc->slot;
+
+	prc->slot = PROCESS_NO_SLOT;
+
+	(ihp->length)--;
+
+	if (index == ihp->length)
+		return DS_OK;
+
+	// The last node fills the hole and moves up or down from there
+	Process *moved = ihp->buffer[ihp->length].data;
+
+	ihp_place(ihp, index, ihp->buffer[ihp->length]);
+
+	ihp_sift_up(ihp, index);
+	ihp_sift_down(ihp, moved->slot);
+
+	return DS_OK;
+}
+
+bool ihp_contains(IndexedHeap *ihp, Process *prc)
+{
+	return prc->slot < ihp->length && ihp->buffer[prc->slot].data == prc;
+}
+
+bool ihp_is_empty(IndexedHeap *ihp)
+{
+	return ihp->length == 0;
+}
+
+// Shows the processes in heap order, not in the order they will run
+Status ihp_display(IndexedHeap *ihp)
+{
+	if (ihp == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	printf("\n");
+
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+
+	size_t i;
+	for (i = 0; i < ihp->length; i++)
+		prc_display(ihp->buffer[i].data);
+
+	printf("\n");
+
+	return DS_OK;
+}
+
+Status ihp_delete(IndexedHeap **ihp)
+{
+	if ((*ihp) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	size_t i;
+	for (i = 0; i < (*ihp)->length; i++)
+	{
+		st = prc_delete(&((*ihp)->buffer[i].data));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	free((*ihp)->buffer);
+	free(*ihp);
+
+	*ihp = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- IndexedHeap.c */
+
+/* ---------------------------------------------------------------------------------------------------- RingBuffer.c */
+
+Status rbf_init(RingBuffer **rbf)
+{
+	(*rbf) = malloc(sizeof(RingBuffer));
+
+	if (!(*rbf))
+		return DS_ERR_ALLOC;
+
+	(*rbf)->buffer = malloc(sizeof(Process *) * RING_BUFFER_INIT_SIZE);
+
+	if (!((*rbf)->buffer))
+	{
+		free(*rbf);
+
+		*rbf = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*rbf)->front = 0;
+	(*rbf)->length = 0;
+	(*rbf)->capacity = RING_BUFFER_INIT_SIZE;
+
+	return DS_OK;
+}
+
+// Doubles the buffer and unwraps the processes to its start
+static Status rbf_realloc(RingBuffer *rbf)
+{
+	Process **new_buffer = malloc(sizeof(Process *) * rbf->capacity * 2);
+
+	if (!new_buffer)
+		return DS_ERR_ALLOC;
+
+	size_t i;
+	for (i = 0; i < rbf->length; i++)
+		new_buffer[i] = rbf->buffer[(rbf->front + i) & (rbf->capacity - 1)];
+
+	free(rbf->buffer);
+
+	rbf->buffer = new_buffer;
+	rbf->front = 0;
+	rbf->capacity *= 2;
+
+	return DS_OK;
+}
+
+Status rbf_enqueue(RingBuffer *rbf, Process *prc)
+{
+	if (rbf == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (rbf->length == rbf->capacity)
+	{
+		Status st = rbf_realloc(rbf);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	rbf->buffer[(rbf->front + rbf->length) & (rbf->capacity - 1)] = prc;
+
+	(rbf->length)++;
+
+	return DS_OK;
+}
+
+Status rbf_dequeue(RingBuffer *rbf, Process **result)
+{
+	if (rbf == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (rbf_is_empty(rbf))
+		return DS_ERR_INVALID_OPERATION;
+
+	*result = rbf->buffer[rbf->front];
+
+	rbf->front = (rbf->front + 1) & (rbf->capacity - 1);
+
+	(rbf->length)--;
+
+	return DS_OK;
+}
+
+bool rbf_is_empty(RingBuffer *rbf)
+{
+	return rbf->length == 0;
+}
+
+Status rbf_display(RingBuffer *rbf)
+{
+	if (rbf == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	printf("\n");
+
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+
+	size_t i;
+	for (i = 0; i < rbf->length; i++)
+		prc_display(rbf->buffer[(rbf->front + i) & (rbf->capacity - 1)]);
+
+	printf("\n");
+
+	return DS_OK;
+}
+
+Status rbf_delete(RingBuffer **rbf)
+{
+	if ((*rbf) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	Process *prc;
+
+	while (!rbf_is_empty(*rbf))
+	{
+		rbf_dequeue(*rbf, &prc);
+
+		st = prc_delete(&prc);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	free((*rbf)->buffer);
+	free(*rbf);
+
+	*rbf = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- RingBuffer.c */
+
+/* ---------------------------------------------------------------------------------------------------- MultilevelQueue.c */
+
+Status mlq_init(MultilevelQueue **mlq, size_t levels)
+{
+	if (levels == 0 || levels > MLFQ_MAX_LEVELS)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	(*mlq) = malloc(sizeof(MultilevelQueue));
+
+	if (!(*mlq))
+		return DS_ERR_ALLOC;
+
+	(*mlq)->levels = levels;
+	(*mlq)->occupied = 0;
+	(*mlq)->pending = 0;
+	(*mlq)->generation = 0;
+	(*mlq)->length = 0;
+
+	size_t i;
+	for (i = 0; i < levels; i++)
+	{
+		Status st = rbf_init(&((*mlq)->queue[i]));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+Status mlq_push(MultilevelQueue *mlq, Process *prc, size_t level)
+{
+	if (mlq == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	mlq_set_level(mlq, prc, level);
+
+	Status st = rbf_enqueue(mlq->queue[prc->level], prc);
+
+	if (st != DS_OK)
+		return st;
+
+	mlq->occupied |= (uint64_t)1 << prc->level;
+
+	(mlq->length)++;
+
+	return DS_OK;
+}
+
+static inline Process *mlq_front(MultilevelQueue *mlq, size_t level)
+{
+	RingBuffer *rbf = mlq->queue[level];
+
+	return rbf->buffer[rbf->front];
+}
+
+// Pending level whose first process was queued in the earliest generation,
+// the lowest one among equals
+static size_t mlq_boosted(MultilevelQueue *mlq)
+{
+	uint64_t rest = mlq->pending & (mlq->pending - 1);
+
+	size_t best = bit_lowest(mlq->pending);
+
+	while (rest != 0)
+	{
+		size_t level = bit_lowest(rest);
+
+		if (mlq_front(mlq, level)->generation < mlq_front(mlq, best)->generation)
+			best = level;
+
+		rest &= rest - 1;
+	}
+
+	return best;
+}
+
+// Boosted processes go first, then the first level that has processes.
+// The process comes out with its level already up to date.
+Status mlq_pop(MultilevelQueue *mlq, Process **result)
+{
+	if (mlq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (mlq_is_empty(mlq))
+		return DS_ERR_INVALID_OPERATION;
+
+	size_t level = mlq->pending != 0 ? mlq_boosted(mlq) : bit_lowest(mlq->occupied);
+
+	Status st = rbf_dequeue(mlq->queue[level], result);
+
+	if (st != DS_OK)
+		return st;
+
+	if (rbf_is_empty(mlq->queue[level]))
+		mlq->occupied &= ~((uint64_t)1 << level);
+
+	if (rbf_is_empty(mlq->queue[level]) || mlq_front(mlq, level)->generation == mlq->generation)
+		mlq->pending &= ~((uint64_t)1 << level);
+
+	(mlq->length)--;
+
+	mlq_set_level(mlq, *result, mlq_level(mlq, *result));
+
+	return DS_OK;
+}
+
+// Several boosts in a row, with nothing pushed or popped between them, do
+// what the first one does, so they cost O(1) however many they are
+void mlq_boost(MultilevelQueue *mlq, size_t boosts)
+{
+	if (boosts == 0)
+		return;
+
+	mlq->pending = mlq->occupied;
+
+	mlq->generation += boosts;
+}
+
+// Level the process is on, 0 if a boost happened since it was set
+size_t mlq_level(MultilevelQueue *mlq, Process *prc)
+{
+	return prc->generation == mlq->generation ? prc->level : 0;
+}
+
+void mlq_set_level(MultilevelQueue *mlq, Process *prc, size_t level)
+{
+	prc->level = level < mlq->levels ? level : mlq->levels - 1;
+	prc->generation = mlq->generation;
+}
+
+bool mlq_is_empty(MultilevelQueue *mlq)
+{
+	return mlq->length == 0;
+}
+
+Status mlq_display(MultilevelQueue *mlq)
+{
+	if (mlq == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 0; i < mlq->levels; i++)
+	{
+		if (rbf_is_empty(mlq->queue[i]))
+			continue;
+
+		printf("\nLevel %lu\n", i);
+
+		rbf_display(mlq->queue[i]);
+	}
+
+	return DS_OK;
+}
+
+Status mlq_delete(MultilevelQueue **mlq)
+{
+	if ((*mlq) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 0; i < (*mlq)->levels; i++)
+	{
+		Status st = rbf_delete(&((*mlq)->queue[i]));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	free(*mlq);
+
+	*mlq = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- MultilevelQueue.c */
+
+/* ---------------------------------------------------------------------------------------------------- RedBlackTree.c */
+
+Status rbt_init(RedBlackTree **rbt)
+{
+	(*rbt) = malloc(sizeof(RedBlackTree));
+
+	if (!(*rbt))
+		return DS_ERR_ALLOC;
+
+	(*rbt)->root = NULL;
+	(*rbt)->leftmost = NULL;
+	(*rbt)->spare = NULL;
+	(*rbt)->length = 0;
+	(*rbt)->order = 0;
+
+	return DS_OK;
+}
+
+static inline bool rbt_before(RedBlackNode *node1, RedBlackNode *node2)
+{
+	return node1->key < node2->key || (node1->key == node2->key && node1->order < node2->order);
+}
+
+static inline bool rbt_red(RedBlackNode *node)
+{
+	return node != NULL && node->red;
+}
+
+static void rbt_rotate_left(RedBlackTree *rbt, RedBlackNode *node)
+{
+	RedBlackNode *right = node->right;
+
+	node->right = right->left;
+
+	if (right->left != NULL)
+		right->left->parent = node;
+
+	right->parent = node->parent;
+
+	if (node->parent == NULL)
+		rbt->root = right;
+	else if (node == node->parent->left)
+		node->parent->left = right;
+	else
+		node->parent->right = right;
+
+	right->left = node;
+	node->parent = right;
+}
+
+static void rbt_rotate_right(RedBlackTree *rbt, RedBlackNode *node)
+{
+	RedBlackNode *left = node->left;
+
+	node->left = left->right;
+
+	if (left->right != NULL)
+		left->right->parent = node;
+
+	left->parent = node->parent;
+
+	if (node->parent == NULL)
+		rbt->root = left;
+	else if (node == node->parent->right)
+		node->parent->right = left;
+	else
+		node->parent->left = left;
+
+	left->right = node;
+	node->parent = left;
+}
+
+Status rbt_insert(RedBlackTree *rbt, Process *prc, size_t key)
+{
+	if (rbt == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	RedBlackNode *node = rbt->spare;
+
+	if (node != NULL)
+		rbt->spare = node->right;
+	else
+	{
+		node = malloc(sizeof(RedBlackNode));
+
+		if (!node)
+			return DS_ERR_ALLOC;
+	}
+
+	node->key = key;
+	node->order = (rbt->order)++;
+	node->data = prc;
+	node->red = true;
+	node->left = NULL;
+	node->right = NULL;
+
+	RedBlackNode *parent = NULL, **link = &rbt->root;
+
+	bool leftmost = true;
+
+	while (*link != NULL)
+	{
+		parent = *link;
+
+		if (rbt_before(node, parent))
+			link = &parent->left;
+		else
+		{
+			link = &parent->right;
+
+			leftmost = false;
+		}
+	}
+
+	node->parent = parent;
+
+	*link = node;
+
+	if (leftmost)
+		rbt->leftmost = node;
+
+	(rbt->length)++;
+
+	// Two reds in a row: recolor while the uncle is red, then rotate once
+	// or twice
+	while (rbt_red(node->parent))
+	{
+		parent = node->parent;
+
+		RedBlackNode *grandparent = parent->parent;
+
+		if (parent == grandparent->left)
+		{
+			RedBlackNode *uncle = grandparent->right;
+
+			if (rbt_red(uncle))
+			{
+				parent->red = false;
+				uncle->red = false;
+				grandparent->red = true;
+
+				node = grandparent;
+
+				continue;
+			}
+
+			if (node == parent->right)
+			{
+				rbt_rotate_left(rbt, parent);
+
+				parent = node;
+			}
+
+			parent->red = false;
+			grandparent->red = true;
+
+			rbt_rotate_right(rbt, grandparent);
+
+			break;
+		}
+		else
+		{
+			RedBlackNode *uncle = grandparent->left;
+
+			if (rbt_red(uncle))
+			{
+				parent->red = false;
+				uncle->red = false;
+				grandparent->red = true;
+
+				node = grandparent;
+
+				continue;
+			}
+
+			if (node == parent->left)
+			{
+				rbt_rotate_right(rbt, parent);
+
+				parent = node;
+			}
+
+			parent->red = false;
+			grandparent->red = true;
+
+			rbt_rotate_left(rbt, grandparent);
+
+			break;
+		}
+	}
+
+	rbt->root->red = false;
+
+	return DS_OK;
+}
+
+Status rbt_peek_min(RedBlackTree *rbt, Process **result)
+{
+	if (rbt == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (rbt_is_empty(rbt))
+		return DS_ERR_INVALID_OPERATION;
+
+	*result = rbt->leftmost->data;
+
+	return DS_OK;
+}
+
+// Restores the black height after a black node was removed above child,
+// which may be NULL, hence the parent
+static void rbt_remove_fixup(RedBlackTree *rbt, RedBlackNode *child, RedBlackNode *parent)
+{
+	while (child != rbt->root && !rbt_red(child))
+	{
+		if (child == parent->left)
+		{
+			RedBlackNode *sibling = parent->right;
+
+			if (rbt_red(sibling))
+			{
+				sibling->red = false;
+				parent->red = true;
+
+				rbt_rotate_left(rbt, parent);
+
+				sibling = parent->right;
+			}
+
+			if (!rbt_red(sibling->left) && !rbt_red(sibling->right))
+			{
+				sibling->red = true;
+
+				child = parent;
+				parent = child->parent;
+
+				continue;
+			}
+
+			if (!rbt_red(sibling->right))
+			{
+				sibling->left->red = false;
+				sibling->red = true;
+
+				rbt_rotate_right(rbt, sibling);
+
+				sibling = parent->right;
+			}
+
+			sibling->red = parent->red;
+			parent->red = false;
+			sibling->right->red = false;
+
+			rbt_rotate_left(rbt, parent);
+		}
+		else
+		{
+			RedBlackNode *sibling = parent->left;
+
+			if (rbt_red(sibling))
+			{
+				sibling->red = false;
+				parent->red = true;
+
+				rbt_rotate_right(rbt, parent);
+
+				sibling = parent->left;
+			}
+
+			if (!rbt_red(sibling->left) && !rbt_red(sibling->right))
+			{
+				sibling->red = true;
+
+				child = parent;
+				parent = child->parent;
+
+				continue;
+			}
+
+			if (!rbt_red(sibling->left))
+			{
+				sibling->right->red = false;
+				sibling->red = true;
+
+				rbt_rotate_left(rbt, sibling);
+
+				sibling = parent->left;
+			}
+
+			sibling->red = parent->red;
+			parent->red = false;
+			sibling->left->red = false;
+
+			rbt_rotate_right(rbt, parent);
+		}
+
+		child = rbt->root;
+	}
+
+	if (child != NULL)
+		child->red = false;
+}
+
+// The leftmost node has no left child, so it is replaced by its right
+// child, which is either NULL or a red leaf that becomes the new leftmost
+Status rbt_pop_min(RedBlackTree *rbt, Process **result)
+{
+	Status st = rbt_peek_min(rbt, result);
+
+	if (st != DS_OK)
+		return st;
+
+	RedBlackNode *node = rbt->leftmost;
+	RedBlackNode *child = node->right, *parent = node->parent;
+
+	if (child != NULL)
+		child->parent = parent;
+
+	if (parent == NULL)
+		rbt->root = child;
+	else
+		parent->left = child;
+
+	rbt->leftmost = child != NULL ? child : parent;
+
+	if (!node->red)
+		rbt_remove_fixup(rbt, child, parent);
+
+	node->right = rbt->spare;
+
+	rbt->spare = node;
+
+	(rbt->length)--;
+
+	return DS_OK;
+}
+
+bool rbt_is_empty(RedBlackTree *rbt)
+{
+	return rbt->length == 0;
+}
+
+// In order, the order processes will leave
+Status rbt_display(RedBlackTree *rbt)
+{
+	if (rbt == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	printf("\n");
+
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+
+	RedBlackNode *node = rbt->leftmost;
+
+	while (node != NULL)
+	{
+		prc_display(node->data);
+
+		if (node->right != NULL)
+		{
+			node = node->right;
+
+			while (node->left != NULL)
+				node = node->left;
+		}
+		else
+		{
+			while (node->parent != NULL && node == node->parent->right)
+				node = node->parent;
+
+			node = node->parent;
+		}
+	}
+
+	printf("\n");
+
+	return DS_OK;
+}
+
+Status rbt_delete(RedBlackTree **rbt)
+{
+	if ((*rbt) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	Process *prc;
+
+	while (!rbt_is_empty(*rbt))
+	{
+		rbt_pop_min(*rbt, &prc);
+
+		st = prc_delete(&prc);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	while ((*rbt)->spare != NULL)
+	{
+		RedBlackNode *node = (*rbt)->spare;
+
+		(*rbt)->spare = node->right;
+
+		free(node);
+	}
+
+	free(*rbt);
+
+	*rbt = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- RedBlackTree.c */
+
+/* ---------------------------------------------------------------------------------------------------- LotteryPool.c */
+
+Status lot_init(LotteryPool **lot, uint64_t seed)
+{
+	(*lot) = malloc(sizeof(LotteryPool));
+
+	if (!(*lot))
+		return DS_ERR_ALLOC;
+
+	size_t size = LOTTERY_POOL_INIT_SIZE + 1;
+
+	(*lot)->tree = calloc(size, sizeof(size_t));
+	(*lot)->tickets = calloc(size, sizeof(size_t));
+	(*lot)->owner = calloc(size, sizeof(Process *));
+	(*lot)->spare = malloc(size * sizeof(size_t));
+
+	if (!(*lot)->tree || !(*lot)->tickets || !(*lot)->owner || !(*lot)->spare)
+		return DS_ERR_ALLOC;
+
+	(*lot)->spares = 0;
+	(*lot)->used = 0;
+	(*lot)->capacity = LOTTERY_POOL_INIT_SIZE;
+	(*lot)->length = 0;
+	(*lot)->total = 0;
+
+	rng_seed(&((*lot)->rng), seed, 0);
+
+	return DS_OK;
+}
+
+// Adds delta, which may wrap around to subtract, to a position
+static void lot_update(LotteryPool *lot, size_t position, size_t delta)
+{
+	for (; position <= lot->capacity; position += position & (~position + 1))
+		lot->tree[position] += delta;
+}
+
+// Rebuilds the tree in O(n) from the tickets
+static void lot_build(LotteryPool *lot)
+{
+	size_t i;
+	for (i = 1; i <= lot->capacity; i++)
+		lot->tree[i] = lot->tickets[i];
+
+	for (i = 1; i <= lot->capacity; i++)
+	{
+		size_t parent = i + (i & (~i + 1));
+
+		if (parent <= lot->capacity)
+			lot->tree[parent] += lot->tree[i];
+	}
+}
+
+// Doubles the positions
+static Status lot_realloc(LotteryPool *lot)
+{
+	size_t capacity = lot->capacity * 2, size = capacity + 1;
+
+	size_t *tree = realloc(lot->tree, size * sizeof(size_t));
+
+	if (!tree)
+		return DS_ERR_ALLOC;
+
+	lot->tree = tree;
+
+	size_t *tickets = realloc(lot->tickets, size * sizeof(size_t));
+
+	if (!tickets)
+		return DS_ERR_ALLOC;
+
+	lot->tickets = tickets;
+
+	Process **owner = realloc(lot->owner, size * sizeof(Process *));
+
+	if (!owner)
+		return DS_ERR_ALLOC;
+
+	lot->owner = owner;
+
+	size_t *spare = realloc(lot->spare, size * sizeof(size_t));
+
+	if (!spare)
+		return DS_ERR_ALLOC;
+
+	lot->spare = spare;
+
+	size_t i;
+	for (i = lot->capacity + 1; i <= capacity; i++)
+	{
+		lot->tickets[i] = 0;
+		lot->owner[i] = NULL;
+	}
+
+	lot->capacity = capacity;
+
+	lot_build(lot);
+
+	return DS_OK;
+}
+
+// Gives prc a position first if it has none
+Status lot_set_tickets(LotteryPool *lot, Process *prc, size_t tickets)
+{
+	if (lot == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t position = prc->slot;
+
+	if (position == PROCESS_NO_SLOT)
+	{
+		if (lot->spares > 0)
+			position = lot->spare[--(lot->spares)];
+		else
+		{
+			if (lot->used == lot->capacity)
+			{
+				Status st = lot_realloc(lot);
+
+				if (st != DS_OK)
+					return st;
+			}
+
+			position = ++(lot->used);
+		}
+
+		lot->owner[position] = prc;
+
+		prc->slot = position;
+	}
+
+	size_t old = lot->tickets[position];
+
+	if (old == 0 && tickets > 0)
+		(lot->length)++;
+	else if (old > 0 && tickets == 0)
+		(lot->length)--;
+
+	lot->tickets[position] = tickets;
+	lot->total += tickets - old;
+
+	lot_update(lot, position, tickets - old);
+
+	return DS_OK;
+}
+
+// Takes prc out of the pool and gives its position back
+Status lot_remove(LotteryPool *lot, Process *prc)
+{
+	if (lot == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (prc->slot == PROCESS_NO_SLOT || lot->owner[prc->slot] != prc)
+		return DS_ERR_NOT_FOUND;
+
+	Status st = lot_set_tickets(lot, prc, 0);
+
+	if (st != DS_OK)
+		return st;
+
+	lot->owner[prc->slot] = NULL;
+	lot->spare[(lot->spares)++] = prc->slot;
+
+	prc->slot = PROCESS_NO_SLOT;
+
+	return DS_OK;
+}
+
+// Each ticket is equally likely to win. The winner keeps its position with
+// 0 tickets.
+Status lot_draw(LotteryPool *lot, Process **result)
+{
+	if (lot == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (lot_is_empty(lot))
+		return DS_ERR_INVALID_OPERATION;
+
+	size_t ticket = rng_range(&lot->rng, 0, lot->total - 1);
+
+	// Largest position whose prefix sum is not above ticket, plus one
+	size_t position = 0, step;
+
+	for (step = lot->capacity; step > 0; step >>= 1)
+	{
+		if (position + step <= lot->capacity && lot->tree[position + step] <= ticket)
+		{
+			position += step;
+
+			ticket -= lot->tree[position];
+		}
+	}
+
+	*result = lot->owner[position + 1];
+
+	return lot_set_tickets(lot, *result, 0);
+}
+
+bool lot_is_empty(LotteryPool *lot)
+{
+	return lot->length == 0;
+}
+
+Status lot_display(LotteryPool *lot)
+{
+	if (lot == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	printf("\n");
+
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
+	printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+
+	size_t i;
+	for (i = 1; i <= lot->used; i++)
+	{
+		if (lot->tickets[i] > 0)
+			prc_display(lot->owner[i]);
+	}
+
+	printf("\n");
+
+	return DS_OK;
+}
+
+// Deletes every process that still has a position
+Status lot_delete(LotteryPool **lot)
+{
+	if ((*lot) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 1; i <= (*lot)->used; i++)
+	{
+		if ((*lot)->owner[i] != NULL)
+		{
+			Status st = prc_delete(&((*lot)->owner[i]));
+
+			if (st != DS_OK)
+				return st;
+		}
+	}
+
+	free((*lot)->tree);
+	free((*lot)->tickets);
+	free((*lot)->owner);
+	free((*lot)->spare);
+	free(*lot);
+
+	*lot = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- LotteryPool.c */
+
+/* ---------------------------------------------------------------------------------------------------- ProcessIndex.c */
+
+Status pix_init(ProcessIndex **pix)
+{
+	(*pix) = malloc(sizeof(ProcessIndex));
+
+	if (!(*pix))
+		return DS_ERR_ALLOC;
+
+	(*pix)->slots = calloc(PROCESS_INDEX_INIT_SIZE, sizeof(Process *));
+
+	if (!((*pix)->slots))
+	{
+		free(*pix);
+
+		*pix = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*pix)->capacity = PROCESS_INDEX_INIT_SIZE;
+	(*pix)->length = 0;
+
+	return DS_OK;
+}
+
+static inline size_t pix_home(ProcessIndex *pix, size_t pid)
+{
+	return (size_t)(((uint64_t)pid * 0x9E3779B97F4A7C15ULL) >> 32) & (pix->capacity - 1);
+}
+
+static Status pix_grow(ProcessIndex *pix)
+{
+	size_t capacity = pix->capacity * 2;
+
+	Process **old = pix->slots;
+
+	Process **slots = calloc(capacity, sizeof(Process *));
+
+	if (!slots)
+		return DS_ERR_ALLOC;
+
+	size_t old_capacity = pix->capacity;
+
+	pix->slots = slots;
+	pix->capacity = capacity;
+
+	size_t i;
+	for (i = 0; i < old_capacity; i++)
+	{
+		if (old[i] == NULL)
+			continue;
+
+		size_t slot = pix_home(pix, old[i]->pid);
+
+		while (slots[slot] != NULL)
+			slot = (slot + 1) & (capacity - 1);
+
+		slots[slot] = old[i];
+	}
+
+	free(old);
+
+	return DS_OK;
+}
+
+Status pix_insert(ProcessIndex *pix, Process *prc)
+{
+	if (pix == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (2 * (pix->length + 1) > pix->capacity)
+	{
+		Status st = pix_grow(pix);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	size_t slot = pix_home(pix, prc->pid);
+
+	while (pix->slots[slot] != NULL)
+	{
+		if (pix->slots[slot]->pid == prc->pid)
+			return DS_OK;
+
+		slot = (slot + 1) & (pix->capacity - 1);
+	}
+
+	pix->slots[slot] = prc;
+
+	(pix->length)++;
+
+	return DS_OK;
+}
+
+Status pix_find(ProcessIndex *pix, size_t pid, Process **result)
+{
+	if (pix == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t slot = pix_home(pix, pid);
+
+	while (pix->slots[slot] != NULL)
+	{
+		if (pix->slots[slot]->pid == pid)
+		{
+			*result = pix->slots[slot];
+
+			return DS_OK;
+		}
+
+		slot = (slot + 1) & (pix->capacity - 1);
+	}
+
+	return DS_ERR_NOT_FOUND;
+}
+
+// Removes prc if it is the process indexed under its PID. The processes
+// after it in the probe sequence move back so no search stops early.
+Status pix_remove(ProcessIndex *pix, Process *prc)
+{
+	if (pix == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t mask = pix->capacity - 1;
+	size_t slot = pix_home(pix, prc->pid);
+
+	while (pix->slots[slot] != prc)
+	{
+		if (pix->slots[slot] == NULL)
+			return DS_ERR_NOT_FOUND;
+
+		slot = (slot + 1) & mask;
+	}
+
+	size_t hole = slot;
+
+	while (1)
+	{
+		slot = (slot + 1) & mask;
+
+		if (pix->slots[slot] == NULL)
+			break;
+
+		size_t home = pix_home(pix, pix->slots[slot]->pid);
+
+		// Moves back unless its home lies cyclically in (hole, slot]
+		if (((slot - home) & mask) >= ((slot - hole) & mask))
+		{
+			pix->slots[hole] = pix->slots[slot];
+
+			hole = slot;
+		}
+	}
+
+	pix->slots[hole] = NULL;
+
+	(pix->length)--;
+
+	return DS_OK;
+}
+
+Status pix_delete(ProcessIndex **pix)
+{
+	if ((*pix) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	free((*pix)->slots);
+	free(*pix);
+
+	*pix = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- ProcessIndex.c */
+
+/* ---------------------------------------------------------------------------------------------------- Hooks.c */
+
+Status hok_init(Hooks **hooks)
+{
+	(*hooks) = malloc(sizeof(Hooks));
+
+	if (!(*hooks))
+		return DS_ERR_ALLOC;
+
+	(*hooks)->observers = 0;
+	(*hooks)->mask = 0;
+	(*hooks)->sync = 0;
+	(*hooks)->length = 0;
+	(*hooks)->ticking = false;
+	(*hooks)->busy = 0;
+
+	return DS_OK;
+}
+
+static void hok_masks(Hooks *hooks)
+{
+	hooks->mask = 0;
+	hooks->sync = 0;
+
+	size_t i, kind;
+	for (i = 0; i < hooks->observers; i++)
+	{
+		for (kind = 0; kind < HOOK_COUNT; kind++)
+		{
+			if (hooks->observer[i].on[kind] != NULL)
+				hooks->mask |= 1u << kind;
+		}
+
+		hooks->sync |= hooks->observer[i].sync;
+	}
+}
+
+static bool hok_same(const Observer *a, const Observer *b)
+{
+	return memcmp(a->on, b->on, sizeof(a->on)) == 0 && a->sync == b->sync && a->context == b->context;
+}
+
+// An observer that is already there is not added twice
+Status hok_observe(Hooks *hooks, const Observer *obs)
+{
+	if (hooks == NULL || obs == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 0; i < hooks->observers; i++)
+	{
+		if (hok_same(&hooks->observer[i], obs))
+			return DS_OK;
+	}
+
+	if (hooks->observers == HOOK_MAX_OBSERVERS)
+		return DS_ERR_FULL;
+
+	// The ones there get what happened before this one came
+	Status st = hok_flush(hooks);
+
+	if (st != DS_OK)
+		return st;
+
+	hooks->observer[(hooks->observers)++] = *obs;
+
+	hok_masks(hooks);
+
+	return DS_OK;
+}
+
+Status hok_unobserve(Hooks *hooks, const Observer *obs)
+{
+	if (hooks == NULL || obs == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 0; i < hooks->observers; i++)
+	{
+		if (hok_same(&hooks->observer[i], obs))
+			break;
+	}
+
+	if (i == hooks->observers)
+		return DS_ERR_NOT_FOUND;
+
+	Status st = hok_flush(hooks);
+
+	if (st != DS_OK)
+		return st;
+
+	memmove(&hooks->observer[i], &hooks->observer[i + 1], sizeof(Observer) * (hooks->observers - i - 1));
+
+	(hooks->observers)--;
+
+	hok_masks(hooks);
+
+	return DS_OK;
+}
+
+// The ticks that went by as one event, there is always room for it
+static inline void hok_ticks(Hooks *hooks)
+{
+	hooks->event[(hooks->length)++] = (HookEvent){HOOK_TICK, hooks->tick, NULL, hooks->busy};
+
+	hooks->ticking = false;
+	hooks->busy = 0;
+}
+
+// Records an event, handing the batch over when it is full or the event is
+// one some observer wants in sync
+static inline Status hok_emit(Hooks *hooks, HookKind kind, size_t tick, Process *prc)
+{
+	if (!(hooks->mask & 1u << kind))
+		return DS_OK;
+
+	if (hooks->ticking)
+	{
+		hok_ticks(hooks);
+
+		if (hooks->length == HOOK_BATCH)
+		{
+			Status st = hok_flush(hooks);
+
+			if (st != DS_OK)
+				return st;
+		}
+	}
+
+	hooks->event[(hooks->length)++] = (HookEvent){kind, tick, prc, 0};
+
+	if (hooks->length == HOOK_BATCH || hooks->sync & 1u << kind)
+		return hok_flush(hooks);
+
+	return DS_OK;
+}
+
+// Ticks in a row are a single event, up to the last of them, only recorded
+// when something else happens or the batch is handed over
+static inline Status hok_tick(Hooks *hooks, size_t tick, size_t busy)
+{
+	if (!(hooks->mask & 1u << HOOK_TICK))
+		return DS_OK;
+
+	hooks->ticking = true;
+	hooks->tick = tick;
+	hooks->busy += busy;
+
+	if (hooks->sync & 1u << HOOK_TICK)
+		return hok_flush(hooks);
+
+	return DS_OK;
+}
+
+/**
+ * Hands the recorded events to the observers, each one in order, one call
+ * per run of events of a kind it wants. The batch is empty afterwards even
+ * when an observer fails.
+ */
+Status hok_flush(Hooks *hooks)
+{
+	if (hooks->ticking)
+		hok_ticks(hooks);
+
+	size_t length = hooks->length;
+
+	hooks->length = 0;
+
+	Status st = DS_OK;
+
+	size_t i, start, end;
+	for (i = 0; i < hooks->observers && st == DS_OK; i++)
+	{
+		Observer *obs = &hooks->observer[i];
+
+		for (start = 0; start < length && st == DS_OK; start = end)
+		{
+			HookKind kind = hooks->event[start].kind;
+
+			for (end = start + 1; end < length && hooks->event[end].kind == kind; end++)
+				;
+
+			if (obs->on[kind] != NULL)
+				st = obs->on[kind](obs->context, &hooks->event[start], end - start);
+		}
+	}
+
+	return st;
+}
+
+Status hok_delete(Hooks **hooks)
+{
+	if ((*hooks) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	free(*hooks);
+
+	*hooks = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Hooks.c */
+
+/* ---------------------------------------------------------------------------------------------------- Metrics.c */
+
+static size_t sta_bucket(size_t value)
+{
+	if (value < STATISTIC_SUB)
+		return value;
+
+	int msb = 63 - __builtin_clzll((unsigned long long)value);
+	int shift = msb - STATISTIC_SUB_BITS;
+
+	return (size_t)(shift + 1) * STATISTIC_SUB + ((value >> shift) & (STATISTIC_SUB - 1));
+}
+
+// Largest value that falls in a bucket
+static size_t sta_bucket_top(size_t bucket)
+{
+	if (bucket < STATISTIC_SUB)
+		return bucket;
+
+	size_t shift = bucket / STATISTIC_SUB - 1;
+	size_t sub = bucket % STATISTIC_SUB;
+
+	return ((STATISTIC_SUB + sub) << shift) + ((size_t)1 << shift) - 1;
+}
+
+void sta_add(Statistic *sta, size_t value)
+{
+	sta->count++;
+	sta->sum += (double)value;
+
+	if (value > sta->max)
+		sta->max = value;
+
+	sta->buckets[sta_bucket(value)]++;
+}
+
+double sta_mean(Statistic *sta)
+{
+	if (sta->count == 0)
+		return 0.0;
+
+	return sta->sum / sta->count;
+}
+
+size_t sta_percentile(Statistic *sta, double p)
+{
+	if (sta->count == 0)
+		return 0;
+
+	size_t rank = (size_t)ceil(p * sta->count);
+
+	if (rank == 0)
+		rank = 1;
+
+	size_t i, seen = 0;
+	for (i = 0; i < STATISTIC_BUCKETS; i++)
+	{
+		seen += sta->buckets[i];
+
+		if (seen >= rank)
+		{
+			size_t top = sta_bucket_top(i);
+
+			return top < sta->max ? top : sta->max;
+		}
+	}
+
+	return sta->max;
+}
+
+Status met_init(Metrics **met)
+{
+	(*met) = malloc(sizeof(Metrics));
+
+	if (!(*met))
+		return DS_ERR_ALLOC;
+
+	met_clear(*met);
+
+	return DS_OK;
+}
+
+void met_clear(Metrics *met)
+{
+	memset(met, 0, sizeof(Metrics));
+}
+
+void met_finish(Metrics *met, Process *prc)
+{
+	met->finished++;
+
+	sta_add(&met->turnaround, prc->finish - prc->arrival);
+	sta_add(&met->waiting, prc->waiting);
+	sta_add(&met->response, prc->first_run - prc->arrival);
+
+	size_t turnaround = prc->finish - prc->arrival;
+	size_t service = turnaround - prc->waiting - prc->blocked;
+
+	double slowdown = (double)turnaround / (service > 0 ? service : 1);
+
+	met->slowdown += slowdown;
+	met->slowdown_sq += slowdown * slowdown;
+
+	met->jobs += prc->jobs;
+	met->misses += prc->misses;
+}
+
+static Status met_on_tick(void *context, const HookEvent *events, size_t count)
+{
+	Metrics *met = context;
+
+	size_t i;
+	for (i = 0; i < count; i++)
+		met->busy += events[i].busy;
+
+	met->ticks = events[count - 1].tick;
+
+	return DS_OK;
+}
+
+// A killed process only counts as killed, with none of the statistics
+static Status met_on_exit(void *context, const HookEvent *events, size_t count)
+{
+	Metrics *met = context;
+
+	size_t i;
+	for (i = 0; i < count; i++)
+	{
+		if (events[i].prc->killed)
+			(met->killed)++;
+		else
+			met_finish(met, events[i].prc);
+	}
+
+	return DS_OK;
+}
+
+// Keeps met up to date with the run it observes
+void met_observer(Metrics *met, Observer *obs)
+{
+	memset(obs, 0, sizeof(Observer));
+
+	obs->on[HOOK_TICK] = met_on_tick;
+	obs->on[HOOK_EXIT] = met_on_exit;
+	obs->context = met;
+}
+
+double met_throughput(Metrics *met)
+{
+	if (met->ticks == 0)
+		return 0.0;
+
+	return (double)met->finished / met->ticks;
+}
+
+double met_utilization(Metrics *met)
+{
+	if (met->ticks == 0)
+		return 0.0;
+
+	return (double)met->busy / met->ticks;
+}
+
+// Jain's index of the slowdowns: 1 when every process was slowed down by
+// the same factor, down to 1/n when one process got all the delay
+double met_fairness(Metrics *met)
+{
+	if (met->slowdown_sq == 0.0)
+		return 1.0;
+
+	return met->slowdown * met->slowdown / (met->finished * met->slowdown_sq);
+}
+
+double met_miss_ratio(Metrics *met)
+{
+	if (met->jobs == 0)
+		return 0.0;
+
+	return (double)met->misses / met->jobs;
+}
+
+// The metrics of the library interface, which only has plain numbers
+void met_summary(Metrics *met, SimulationMetrics *result)
+{
+	result->finished = met->finished;
+	result->killed = met->killed;
+	result->ticks = met->ticks;
+	result->busy = met->busy;
+	result->jobs = met->jobs;
+	result->misses = met->misses;
+
+	result->turnaround_mean = sta_mean(&met->turnaround);
+	result->turnaround_max = met->turnaround.max;
+	result->turnaround_p99 = sta_percentile(&met->turnaround, 0.99);
+
+	result->waiting_mean = sta_mean(&met->waiting);
+	result->waiting_max = met->waiting.max;
+	result->waiting_p99 = sta_percentile(&met->waiting, 0.99);
+
+	result->response_mean = sta_mean(&met->response);
+	result->response_max = met->response.max;
+	result->response_p99 = sta_percentile(&met->response, 0.99);
+
+	result->throughput = met_throughput(met);
+	result->utilization = met_utilization(met);
+	result->fairness = met_fairness(met);
+	result->miss_ratio = met_miss_ratio(met);
+}
+
+Status met_display(Metrics *met)
+{
+	if (met == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	printf("\n%-12s\t%10s\t%10s\t%10s\n", "Metric", "Mean", "Max", "P99");
+	printf("%-12s\t%10s\t%10s\t%10s\n", "------", "----", "---", "---");
+
+	char *names[3] = {"Turnaround", "Waiting", "Response"};
+	Statistic *stats[3] = {&met->turnaround, &met->waiting, &met->response};
+
+	size_t i;
+	for (i = 0; i < 3; i++)
+	{
+		printf("%-12s\t%10.2f\t%10lu\t%10lu\n", names[i], sta_mean(stats[i]),
+			   stats[i]->max, sta_percentile(stats[i], 0.99));
+	}
+
+	printf("\nFinished: %lu processes in %lu ticks\n", met->finished, met->ticks);
+	printf("Throughput: %.4f processes per tick\n", met_throughput(met));
+	printf("CPU utilization: %.2f%%\n", 100.0 * met_utilization(met));
+	printf("Fairness (Jain, slowdown): %.4f\n", met_fairness(met));
+
+	if (met->jobs > 0)
+		printf("Deadline misses: %lu of %lu jobs (%.2f%%)\n", met->misses, met->jobs, 100.0 * met_miss_ratio(met));
+
+	if (met->killed > 0)
+		printf("Killed: %lu processes\n", met->killed);
+
+	return DS_OK;
+}
+
+Status met_display_processes(QueueArray *finished)
+{
+	if (finished == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	printf("\n%s\t%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "ARRIVAL", "FIRST", "FINISH", "WAITING", "BLOCKED");
+	printf("%s\t%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "-------", "-----", "------", "-------", "-------");
+
+	size_t i;
+	for (i = 0; i < finished->length; i++)
+	{
+		Process *prc = finished->buffer[i];
+
+		// A process killed before it ever ran has no first tick
+		char first[24] = "-";
+
+		if (prc->first_run != PROCESS_NOT_RUN)
+			snprintf(first, sizeof(first), "%lu", prc->first_run);
+
+		printf("%12s\t%lu\t%lu\t%s\t%lu\t%lu\t%lu%s\n", prc->name->buffer, prc->pid, prc->arrival,
+			   first, prc->finish, prc->waiting, prc->blocked, prc->killed ? "\tkilled" : "");
+	}
+
+	return DS_OK;
+}
+
+// Jobs and misses of the processes that had deadlines, nothing if none had
+Status met_display_deadlines(QueueArray *finished)
+{
+	if (finished == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	bool header = false;
+
+	size_t i;
+	for (i = 0; i < finished->length; i++)
+	{
+		Process *prc = finished->buffer[i];
+
+		if (prc->jobs == 0)
+			continue;
+
+		if (!header)
+		{
+			printf("\n%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "PERIOD", "DEADLINE", "JOBS", "MISSES");
+			printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "------", "--------", "----", "------");
+
+			header = true;
+		}
+
+		printf("%12s\t%lu\t%lu\t%lu\t%lu\t%lu\n", prc->name->buffer, prc->pid, prc->period,
+			   prc->deadline > 0 ? prc->deadline : prc->period, prc->jobs, prc->misses);
+	}
+
+	return DS_OK;
+}
+
+Status met_delete(Metrics **met)
+{
+	if ((*met) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	free(*met);
+
+	*met = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Metrics.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Source Files
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         File IO Functions
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Writer.c */
+
+Status wrt_open(Writer **wrt, char *path)
+{
+	if (path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	// Allocated before the file is opened, so no failure leaves a descriptor
+	(*wrt) = malloc(sizeof(Writer));
+
+	if (!(*wrt))
+		return DS_ERR_ALLOC;
+
+	(*wrt)->buffer = malloc(WRITER_BUFFER_SIZE);
+
+	if (!((*wrt)->buffer))
+	{
+		free(*wrt);
+
+		*wrt = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	int fd = 1;
+
+	// "-" writes to stdout
+	if (strcmp(path, "-") != 0)
+	{
+		fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+		if (fd < 0)
+		{
+			free((*wrt)->buffer);
+			free(*wrt);
+
+			*wrt = NULL;
+
+			return DS_ERR_UNEXPECTED_RESULT;
+		}
+	}
+
+	(*wrt)->fd = fd;
+	(*wrt)->length = 0;
+	(*wrt)->capacity = WRITER_BUFFER_SIZE;
+	(*wrt)->written = 0;
+
+	return DS_OK;
+}
+
+Status wrt_flush(Writer *wrt)
+{
+	if (wrt == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t done = 0;
+
+	while (done < wrt->length)
+	{
+		ssize_t n = write(wrt->fd, wrt->buffer + done, wrt->length - done);
+
+		if (n < 0)
+			return DS_ERR_UNEXPECTED_RESULT;
+
+		done += n;
+	}
+
+	wrt->written += wrt->length;
+	wrt->length = 0;
+
+	return DS_OK;
+}
+
+Status wrt_write(Writer *wrt, const char *data, size_t length)
+{
+	if (wrt == NULL || data == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	while (length > 0)
+	{
+		if (wrt->length == wrt->capacity)
+		{
+			st = wrt_flush(wrt);
+
+			if (st != DS_OK)
+				return st;
+		}
+
+		size_t n = wrt->capacity - wrt->length;
+
+		if (n > length)
+			n = length;
+
+		memcpy(wrt->buffer + wrt->length, data, n);
+
+		wrt->length += n;
+
+		data += n;
+		length -= n;
+	}
+
+	return DS_OK;
+}
+
+Status wrt_string(Writer *wrt, const char *string)
+{
+	return wrt_write(wrt, string, strlen(string));
+}
+
+Status wrt_char(Writer *wrt, char c)
+{
+	if (wrt->length == wrt->capacity)
+	{
+		Status st = wrt_flush(wrt);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	wrt->buffer[wrt->length++] = c;
+
+	return DS_OK;
+}
+
+Status wrt_size(Writer *wrt, size_t value)
+{
+	// Enough for any 64-bit number
+	if (wrt->capacity - wrt->length < 20)
+	{
+		Status st = wrt_flush(wrt);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	char digits[20];
+
+	size_t n = 0;
+
+	do
+	{
+		digits[n++] = (char)('0' + value % 10);
+
+		value /= 10;
+	} while (value > 0);
+
+	while (n > 0)
+		wrt->buffer[wrt->length++] = digits[--n];
+
+	return DS_OK;
+}
+
+// LEB128, 7 bits per byte from the lowest ones
+Status wrt_varint(Writer *wrt, uint64_t value)
+{
+	if (wrt->capacity - wrt->length < 10)
+	{
+		Status st = wrt_flush(wrt);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	while (value >= 0x80)
+	{
+		wrt->buffer[wrt->length++] = (char)(value | 0x80);
+
+		value >>= 7;
+	}
+
+	wrt->buffer[wrt->length++] = (char)value;
+
+	return DS_OK;
+}
+
+Status wrt_close(Writer **wrt)
+{
+	if ((*wrt) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = wrt_flush(*wrt);
+
+	if ((*wrt)->fd != 1 && close((*wrt)->fd) != 0 && st == DS_OK)
+		st = DS_ERR_UNEXPECTED_RESULT;
+
+	free((*wrt)->buffer);
+
+	free(*wrt);
+
+	*wrt = NULL;
+
+	return st;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Writer.c */
+
+/* ---------------------------------------------------------------------------------------------------- Trace.c */
+
+Status trc_open(Trace **trc, char *path, TraceFormat format)
+{
+	(*trc) = malloc(sizeof(Trace));
+
+	if (!(*trc))
+		return DS_ERR_ALLOC;
+
+	Status st = wrt_open(&((*trc)->writer), path);
+
+	if (st != DS_OK)
+	{
+		free(*trc);
+
+		*trc = NULL;
+
+		return st;
+	}
+
+	(*trc)->format = format;
+	(*trc)->run = 0;
+	(*trc)->events = 0;
+	(*trc)->slice = NULL;
+	(*trc)->last_end = 0;
+	(*trc)->last_pid = 0;
+	(*trc)->window = NULL;
+	(*trc)->seen = NULL;
+	(*trc)->records = 0;
+	(*trc)->period = 0;
+	(*trc)->matched = 0;
+	(*trc)->header = 0;
+	(*trc)->index = NULL;
+	(*trc)->entries = NULL;
+	(*trc)->entry_length = 0;
+	(*trc)->entry_capacity = 0;
+	(*trc)->indexing = false;
+	(*trc)->since = 0;
+	(*trc)->last_change = 0;
+	(*trc)->change_pid = 0;
+	(*trc)->queued = NULL;
+	(*trc)->queued_length = 0;
+	(*trc)->queued_capacity = 0;
+	(*trc)->ran = NULL;
+	(*trc)->ran_length = 0;
+	(*trc)->ran_capacity = 0;
+	(*trc)->ran_set = NULL;
+
+	if (format == TRACE_DISPATCH)
+	{
+		char *index = malloc(strlen(path) + strlen(TRACE_INDEX_SUFFIX) + 1);
+
+		(*trc)->window = malloc(sizeof(TraceRecord) * TRACE_WINDOW);
+		(*trc)->seen = calloc(TRACE_HASH, sizeof(size_t));
+
+		if (!index || !(*trc)->window || !(*trc)->seen)
+			st = DS_ERR_ALLOC;
+		else
+		{
+			strcat(strcpy(index, path), TRACE_INDEX_SUFFIX);
+
+			st = wrt_open(&((*trc)->index), index);
+		}
+
+		free(index);
+
+		if (st == DS_OK)
+			st = wrt_write((*trc)->index, TRACE_INDEX_MAGIC, strlen(TRACE_INDEX_MAGIC));
+
+		if (st != DS_OK)
+		{
+			trc_close(trc);
+
+			return st;
+		}
+
+		return wrt_write((*trc)->writer, TRACE_MAGIC, strlen(TRACE_MAGIC));
+	}
+
+	return wrt_string((*trc)->writer, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+}
+
+static char *trc_ends[] = {"preempt", "block", "finish"};
+
+// JSON string body, escaping what the process name may contain
+static Status trc_name(Trace *trc, String *name)
+{
+	Writer *wrt = trc->writer;
+
+	Status st = DS_OK;
+
+	size_t i;
+	for (i = 0; i < name->len && st == DS_OK; i++)
+	{
+		unsigned char c = (unsigned char)name->buffer[i];
+
+		if (c == '"' || c == '\\')
+		{
+			st = wrt_char(wrt, '\\');
+
+			if (st == DS_OK)
+				st = wrt_char(wrt, (char)c);
+		}
+		else if (c < 0x20)
+			st = wrt_char(wrt, ' ');
+		else
+			st = wrt_char(wrt, (char)c);
+	}
+
+	return st;
+}
+
+// Writes the separator and the fields every event shares
+static Status trc_event(Trace *trc, char *phase, size_t ts, size_t tid)
+{
+	Writer *wrt = trc->writer;
+
+	Status st = wrt_string(wrt, trc->events == 0 ? "\n{\"ph\":\"" : ",\n{\"ph\":\"");
+
+	if (st == DS_OK)
+		st = wrt_string(wrt, phase);
+	if (st == DS_OK)
+		st = wrt_string(wrt, "\",\"ts\":");
+	if (st == DS_OK)
+		st = wrt_size(wrt, ts);
+	if (st == DS_OK)
+		st = wrt_string(wrt, ",\"pid\":");
+	if (st == DS_OK)
+		st = wrt_size(wrt, trc->run);
+	if (st == DS_OK)
+		st = wrt_string(wrt, ",\"tid\":");
+	if (st == DS_OK)
+		st = wrt_size(wrt, tid);
+
+	trc->events++;
+
+	return st;
+}
+
+static Status trc_metadata(Trace *trc, char *kind, size_t tid, char *name)
+{
+	Status st = trc_event(trc, "M", 0, tid);
+
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, ",\"name\":\"");
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, kind);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, "\",\"args\":{\"name\":\"");
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, name);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, "\"}}");
+
+	return st;
+}
+
+static Status trc_literal(Trace *trc, TraceRecord *rec)
+{
+	Status st = wrt_varint(trc->writer, rec->head);
+
+	if (st == DS_OK && (rec->head & 4) != 0)
+		st = wrt_varint(trc->writer, rec->gap);
+	if (st == DS_OK)
+		st = wrt_varint(trc->writer, rec->zigzag);
+
+	return st;
+}
+
+// Writes the records matched by the repeat, as a repeat when it pays off
+static Status trc_flush_repeat(Trace *trc)
+{
+	Status st = DS_OK;
+
+	if (trc->matched >= 2)
+	{
+		st = wrt_varint(trc->writer, (uint64_t)trc->matched << 3 | TRACE_REPEAT);
+
+		if (st == DS_OK)
+			st = wrt_varint(trc->writer, trc->period);
+	}
+	else if (trc->matched == 1)
+		st = trc_literal(trc, &trc->window[(trc->records - 1) % TRACE_WINDOW]);
+
+	trc->period = 0;
+	trc->matched = 0;
+
+	return st;
+}
+
+static size_t trc_hash(TraceRecord *rec)
+{
+	return (size_t)((rec->head * 0x9e3779b97f4a7c15ULL ^ rec->gap * 0xc2b2ae3d27d4eb4fULL ^ rec->zigzag) *
+					0x165667b19e3779f9ULL >> 40) % TRACE_HASH;
+}
+
+static bool trc_same(TraceRecord *rec1, TraceRecord *rec2)
+{
+	return rec1->head == rec2->head && rec1->gap == rec2->gap && rec1->zigzag == rec2->zigzag;
+}
+
+/**
+ * Goes on with the repeat being matched when rec is the record period
+ * records back, else writes that repeat and starts a new one from the last
+ * record like rec, or writes rec when there is none in the window.
+ */
+static Status trc_record(Trace *trc, TraceRecord *rec)
+{
+	Status st = DS_OK;
+
+	size_t number = trc->records, hash = trc_hash(rec), last = trc->seen[hash];
+
+	if (trc->period != 0 && !trc_same(rec, &trc->window[(number - trc->period) % TRACE_WINDOW]))
+		st = trc_flush_repeat(trc);
+
+	if (trc->period != 0)
+		(trc->matched)++;
+	else if (last != 0 && number - (last - 1) <= TRACE_WINDOW && trc_same(rec, &trc->window[(last - 1) % TRACE_WINDOW]))
+	{
+		trc->period = number - (last - 1);
+		trc->matched = 1;
+	}
+	else if (st == DS_OK)
+		st = trc_literal(trc, rec);
+
+	trc->window[number % TRACE_WINDOW] = *rec;
+	trc->seen[hash] = number + 1;
+	trc->records = number + 1;
+
+	return st;
+}
+
+// Bytes written so far, buffered ones too
+static size_t trc_offset(Writer *wrt)
+{
+	return wrt->written + wrt->length;
+}
+
+static int trc_compare(const void *a, const void *b)
+{
+	size_t x = *(const size_t *)a, y = *(const size_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+// Writes pids sorted, without repeats, as differences and sets *count to
+// how many were written
+static Status trc_pids(Trace *trc, size_t *pids, size_t length, uint64_t *count)
+{
+	if (length > 1)
+		qsort(pids, length, sizeof(size_t), trc_compare);
+
+	Status st = DS_OK;
+
+	size_t last = 0, i;
+
+	*count = 0;
+
+	for (i = 0; i < length && st == DS_OK; i++)
+	{
+		if (i > 0 && pids[i] == last)
+			continue;
+
+		st = wrt_varint(trc->index, pids[i] - last);
+
+		last = pids[i];
+
+		(*count)++;
+	}
+
+	return st;
+}
+
+// Adds the PID of a slice to the ones since the last entry
+static Status trc_ran(Trace *trc, size_t pid)
+{
+	if (trc->ran_length == trc->ran_capacity)
+	{
+		size_t capacity = trc->ran_capacity == 0 ? 64 : trc->ran_capacity * 2;
+
+		size_t *ran = realloc(trc->ran, sizeof(size_t) * capacity);
+
+		if (!ran)
+			return DS_ERR_ALLOC;
+
+		trc->ran = ran;
+
+		size_t *set = calloc(capacity * 2, sizeof(size_t));
+
+		if (!set)
+			return DS_ERR_ALLOC;
+
+		free(trc->ran_set);
+
+		trc->ran_set = set;
+		trc->ran_capacity = capacity;
+
+		size_t length = trc->ran_length;
+
+		// Hashed again below, one by one
+		trc->ran_length = 0;
+
+		size_t i;
+		for (i = 0; i < length; i++)
+			trc_ran(trc, ran[i]);
+	}
+
+	size_t mask = trc->ran_capacity * 2 - 1, slot = (size_t)((uint64_t)pid * 0x9e3779b97f4a7c15ULL >> 32) & mask;
+
+	while (trc->ran_set[slot] != 0)
+	{
+		if (trc->ran_set[slot] == pid + 1)
+			return DS_OK;
+
+		slot = (slot + 1) & mask;
+	}
+
+	trc->ran_set[slot] = pid + 1;
+	trc->ran[(trc->ran_length)++] = pid;
+
+	return DS_OK;
+}
+
+// Writes the processes that ran since the last entry and closes it
+static Status trc_index_end(Trace *trc)
+{
+	if (!trc->indexing)
+		return DS_OK;
+
+	TraceEntry *entry = &trc->entries[trc->entry_length - 1];
+
+	entry->processes = trc_offset(trc->index);
+
+	Status st = trc_pids(trc, trc->ran, trc->ran_length, &entry->ran);
+
+	if (trc->ran_capacity > 0)
+		memset(trc->ran_set, 0, sizeof(size_t) * trc->ran_capacity * 2);
+
+	trc->ran_length = 0;
+	trc->indexing = false;
+
+	return st;
+}
+
+static Status trc_change(Trace *trc, Process *prc, size_t now, bool leave)
+{
+	if (trc == NULL || !trc->indexing)
+		return DS_OK;
+
+	uint64_t delta = (uint64_t)prc->pid - (uint64_t)trc->change_pid;
+
+	Status st = wrt_varint(trc->index, now - trc->last_change);
+
+	if (st == DS_OK)
+		st = wrt_varint(trc->index, (delta << 1 ^ (uint64_t)-(int64_t)(delta >> 63)) << 1 | leave);
+
+	trc->last_change = now;
+	trc->change_pid = prc->pid;
+
+	(trc->entries[trc->entry_length - 1].events)++;
+
+	return st;
+}
+
+static Status trc_dispatch_slice(Trace *trc, Process *prc, TraceEnd reason)
+{
+	size_t gap = trc->slice_start - trc->last_end, length = trc->slice_end - trc->slice_start;
+
+	uint64_t delta = (uint64_t)prc->pid - (uint64_t)trc->last_pid;
+
+	TraceRecord rec = {(uint64_t)length << 3 | (uint64_t)(gap > 0) << 2 | reason, gap,
+					   delta << 1 ^ (uint64_t)-(int64_t)(delta >> 63)};
+
+	trc->last_end = trc->slice_end;
+	trc->last_pid = prc->pid;
+
+	trc->events++;
+
+	(trc->since)++;
+
+	Status st = trc->indexing ? trc_ran(trc, prc->pid) : DS_OK;
+
+	return st == DS_OK ? trc_record(trc, &rec) : st;
+}
+
+// Emits the pending CPU slice, if any
+static Status trc_flush_slice(Trace *trc, TraceEnd reason)
+{
+	if (trc->slice == NULL)
+		return DS_OK;
+
+	Process *prc = trc->slice;
+
+	trc->slice = NULL;
+
+	if (trc->format == TRACE_DISPATCH)
+		return trc_dispatch_slice(trc, prc, reason);
+
+	Status st = trc_event(trc, "X", trc->slice_start, 0);
+
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, ",\"cat\":\"cpu\",\"dur\":");
+	if (st == DS_OK)
+		st = wrt_size(trc->writer, trc->slice_end - trc->slice_start);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, ",\"name\":\"");
+	if (st == DS_OK)
+		st = trc_name(trc, prc->name);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, "\",\"args\":{\"pid\":");
+	if (st == DS_OK)
+		st = wrt_size(trc->writer, prc->pid);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, ",\"end\":\"");
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, trc_ends[reason]);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, "\"}}");
+
+	return st;
+}
+
+// Only TRACE_CHROME has I/O waits, a dispatch trace knows a slice blocked
+static Status trc_io(Trace *trc, char *phase, Process *prc, size_t now)
+{
+	if (trc->format == TRACE_DISPATCH)
+		return DS_OK;
+
+	Status st = trc_event(trc, phase, now, 0);
+
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, ",\"cat\":\"io\",\"id\":");
+	if (st == DS_OK)
+		st = wrt_size(trc->writer, prc->pid);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, ",\"name\":\"");
+	if (st == DS_OK)
+		st = trc_name(trc, prc->name);
+	if (st == DS_OK)
+		st = wrt_string(trc->writer, " I/O\"}");
+
+	return st;
+}
+
+Status trc_begin_run(Trace *trc, char *name)
+{
+	if (trc == NULL || name == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	trc->run++;
+	trc->slice = NULL;
+
+	if (trc->format == TRACE_DISPATCH)
+	{
+		size_t length = strlen(name);
+
+		// Repeats do not cross runs, the times of a run start from 0
+		Status st = trc_flush_repeat(trc);
+
+		if (st == DS_OK)
+			st = trc_index_end(trc);
+
+		trc->header = trc_offset(trc->writer);
+		trc->last_end = 0;
+		trc->last_pid = 0;
+		trc->records = 0;
+
+		memset(trc->seen, 0, sizeof(size_t) * TRACE_HASH);
+
+		if (st == DS_OK)
+			st = wrt_varint(trc->writer, (uint64_t)length << 3 | TRACE_RUN);
+
+		return st == DS_OK ? wrt_write(trc->writer, name, length) : st;
+	}
+
+	Status st = trc_metadata(trc, "process_name", 0, name);
+
+	if (st == DS_OK)
+		st = trc_metadata(trc, "thread_name", 0, "CPU 0");
+
+	return st;
+}
+
+Status trc_end_run(Trace *trc)
+{
+	if (trc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	return trc_flush_slice(trc, TRACE_PREEMPT);
+}
+
+Status trc_dispatch(Trace *trc, Process *prc, size_t now)
+{
+	if (trc == NULL)
+		return DS_OK;
+
+	// Preempted and dispatched again right away: keep a single slice
+	if (trc->slice == prc && trc->slice_end == now)
+		return DS_OK;
+
+	Status st = trc_flush_slice(trc, TRACE_PREEMPT);
+
+	trc->slice = prc;
+	trc->slice_start = now;
+	trc->slice_end = now;
+
+	return st;
+}
+
+Status trc_preempt(Trace *trc, Process *prc, size_t now)
+{
+	if (trc == NULL)
+		return DS_OK;
+
+	if (trc->slice != prc)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	// Held back until the next dispatch shows whether the burst continues
+	trc->slice_end = now;
+
+	return DS_OK;
+}
+
+Status trc_block(Trace *trc, Process *prc, size_t now)
+{
+	if (trc == NULL)
+		return DS_OK;
+
+	if (trc->slice != prc)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	trc->slice_end = now;
+
+	Status st = trc_flush_slice(trc, TRACE_BLOCK);
+
+	if (st != DS_OK)
+		return st;
+
+	return trc_io(trc, "b", prc, now);
+}
+
+Status trc_unblock(Trace *trc, Process *prc, size_t now)
+{
+	if (trc == NULL)
+		return DS_OK;
+
+	return trc_io(trc, "e", prc, now);
+}
+
+Status trc_finish(Trace *trc, Process *prc, size_t now)
+{
+	if (trc == NULL)
+		return DS_OK;
+
+	if (trc->slice != prc)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	trc->slice_end = now;
+
+	return trc_flush_slice(trc, TRACE_FINISH);
+}
+
+Status trc_ready(Trace *trc, Process *prc, size_t now)
+{
+	return trc_change(trc, prc, now, false);
+}
+
+Status trc_leave(Trace *trc, Process *prc, size_t now)
+{
+	return trc_change(trc, prc, now, true);
+}
+
+bool trc_due(Trace *trc)
+{
+	return trc->format == TRACE_DISPATCH && (!trc->indexing || trc->since >= TRACE_INDEX_EVERY);
+}
+
+Status trc_queued(Trace *trc, size_t pid)
+{
+	if (trc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (trc->queued_length == trc->queued_capacity)
+	{
+		size_t capacity = trc->queued_capacity == 0 ? 64 : trc->queued_capacity * 2;
+
+		size_t *queued = realloc(trc->queued, sizeof(size_t) * capacity);
+
+		if (!queued)
+			return DS_ERR_ALLOC;
+
+		trc->queued = queued;
+		trc->queued_capacity = capacity;
+	}
+
+	trc->queued[(trc->queued_length)++] = pid;
+
+	return DS_OK;
+}
+
+/**
+ * Closes the last entry and starts one at the next record, with the PIDs
+ * given to trc_queued. The repeat being matched is written and the next
+ * ones cannot reach back past here, so the records that follow can be read
+ * without the ones before.
+ */
+Status trc_index(Trace *trc, size_t now)
+{
+	if (trc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (trc->format != TRACE_DISPATCH)
+		return DS_ERR_INVALID_OPERATION;
+
+	Status st = trc_index_end(trc);
+
+	if (st == DS_OK)
+		st = trc_flush_repeat(trc);
+
+	if (st != DS_OK)
+		return st;
+
+	trc->records = 0;
+
+	memset(trc->seen, 0, sizeof(size_t) * TRACE_HASH);
+
+	if (trc->entry_length == trc->entry_capacity)
+	{
+		size_t capacity = trc->entry_capacity == 0 ? 64 : trc->entry_capacity * 2;
+
+		TraceEntry *entries = realloc(trc->entries, sizeof(TraceEntry) * capacity);
+
+		if (!entries)
+			return DS_ERR_ALLOC;
+
+		trc->entries = entries;
+		trc->entry_capacity = capacity;
+	}
+
+	TraceEntry *entry = &trc->entries[(trc->entry_length)++];
+
+	*entry = (TraceEntry){trc->run, now, trc->header, trc_offset(trc->writer), trc->last_end, trc->last_pid,
+						  trc_offset(trc->index), 0, 0, 0, 0};
+
+	st = trc_pids(trc, trc->queued, trc->queued_length, &entry->queued);
+
+	trc->queued_length = 0;
+	trc->indexing = true;
+	trc->since = 0;
+	trc->last_change = now;
+	trc->change_pid = 0;
+
+	return st;
+}
+
+// The entries and where they start, after the lists
+static Status trc_index_close(Trace *trc)
+{
+	Status st = trc_index_end(trc);
+
+	while (st == DS_OK && trc_offset(trc->index) % 8 != 0)
+		st = wrt_char(trc->index, 0);
+
+	uint64_t footer[2] = {trc_offset(trc->index), trc->entry_length};
+
+	if (st == DS_OK && trc->entry_length > 0)
+		st = wrt_write(trc->index, (char *)trc->entries, sizeof(TraceEntry) * trc->entry_length);
+	if (st == DS_OK)
+		st = wrt_write(trc->index, (char *)footer, sizeof(footer));
+
+	return st;
+}
+
+Status trc_close(Trace **trc)
+{
+	if ((*trc) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = trc_flush_slice(*trc, TRACE_PREEMPT);
+
+	if (st == DS_OK && (*trc)->format == TRACE_CHROME)
+		st = wrt_string((*trc)->writer, "\n]}\n");
+	else if (st == DS_OK)
+		st = trc_flush_repeat(*trc);
+
+	if (st == DS_OK && (*trc)->index != NULL)
+		st = trc_index_close(*trc);
+
+	Status cl = wrt_close(&((*trc)->writer));
+
+	if ((*trc)->index != NULL)
+	{
+		Status ci = wrt_close(&((*trc)->index));
+
+		if (cl == DS_OK)
+			cl = ci;
+	}
+
+	free((*trc)->window);
+	free((*trc)->seen);
+	free((*trc)->entries);
+	free((*trc)->queued);
+	free((*trc)->ran);
+	free((*trc)->ran_set);
+	free(*trc);
+
+	*trc = NULL;
+
+	return st != DS_OK ? st : cl;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Trace.c */
+
+#define FILE_CHUNK_SIZE (1 << 20)
+#define FILE_STREAM_BURSTS (1 << 20) /*!< Bursts of a streamed table per arena */
+#define FILE_FIELDS 6	 /*!< name,pid,cpu,io,pri,type */
+#define FILE_MAX_FIELDS 9 /*!< and the optional period,deadline,arrival */
+
+static Status file_make_string(String **str, const char *text, size_t length)
+{
+	Status st = str_init(str);
+
+	if (st != DS_OK)
+		return st;
+
+	while (!str_buffer_fits(*str, length))
+	{
+		st = str_realloc(*str);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	memcpy((*str)->buffer, text, length);
+
+	(*str)->len = length;
+	(*str)->buffer[length] = '\0';
+
+	return DS_OK;
+}
+
+static Status file_parse_size(char *text, size_t length, size_t *result)
+{
+	if (length == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	size_t i, value = 0;
+	for (i = 0; i < length; i++)
+	{
+		if (text[i] < '0' || text[i] > '9')
+			return DS_ERR_INVALID_ARGUMENT;
+
+		value = value * 10 + (size_t)(text[i] - '0');
+	}
+
+	*result = value;
+
+	return DS_OK;
+}
+
+/**
+ * Appends the bursts of a "cpu/io/cpu/.../cpu" column to *arena, made on
+ * the first call, and gives where they start and how many they are. count
+ * is 0 for a plain number, which is left to file_parse_size.
+ */
+static Status file_parse_bursts(char *text, size_t length, BurstArena **arena, size_t *first, size_t *count)
+{
+	size_t i, n = 1;
+	for (i = 0; i < length; i++)
+	{
+		if (text[i] == '/')
+			n++;
+	}
+
+	*count = 0;
+
+	if (n == 1)
+		return DS_OK;
+
+	// It starts and ends with a CPU burst
+	if (n % 2 == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	Status st = (*arena) == NULL ? brs_init(arena) : DS_OK;
+
+	if (st == DS_OK)
+		st = brs_reserve(*arena, n);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t *burst = (*arena)->burst + (*arena)->length, start = 0, k = 0;
+
+	for (i = 0; i <= length; i++)
+	{
+		if (i < length && text[i] != '/')
+			continue;
+
+		st = file_parse_size(text + start, i - start, &burst[k]);
+
+		if (st != DS_OK)
+			return st;
+
+		if (burst[k] == 0)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		k++;
+
+		start = i + 1;
+	}
+
+	*first = (*arena)->length;
+	*count = n;
+
+	(*arena)->length += n;
+
+	return DS_OK;
+}
+
+// Parses one "name,pid,cpu,io,pri,type[,period[,deadline[,arrival]]]" row,
+// cpu being either a number or the bursts of the process
+static Status file_parse_line(char *line, size_t length, BurstArena **arena, Process **result)
+{
+	char *field[FILE_MAX_FIELDS];
+	size_t size[FILE_MAX_FIELDS];
+
+	size_t i, n = 0;
+
+	field[0] = line;
+
+	for (i = 0; i < length; i++)
+	{
+		if (line[i] == ',')
+		{
+			size[n] = line + i - field[n];
+
+			n++;
+
+			if (n == FILE_MAX_FIELDS)
+				return DS_ERR_INVALID_ARGUMENT;
+
+			field[n] = line + i + 1;
+		}
+	}
+
+	if (n < FILE_FIELDS - 1)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	size[n] = line + length - field[n];
+
+	size_t pid = 0, cpu = 0, io = 0, pri = 0, period = 0, deadline = 0, arrival = 0, first = 0, bursts = 0;
+
+	Status st = file_parse_size(field[1], size[1], &pid);
+
+	if (st == DS_OK && memchr(field[2], '/', size[2]) == NULL)
+		st = file_parse_size(field[2], size[2], &cpu);
+
+	if (st == DS_OK)
+		st = file_parse_size(field[3], size[3], &io);
+
+	if (st == DS_OK)
+		st = file_parse_size(field[4], size[4], &pri);
+
+	if (st == DS_OK && n >= 6)
+		st = file_parse_size(field[6], size[6], &period);
+
+	if (st == DS_OK && n >= 7)
+		st = file_parse_size(field[7], size[7], &deadline);
+
+	if (st == DS_OK && n >= 8)
+		st = file_parse_size(field[8], size[8], &arrival);
+
+	if (st == DS_OK)
+		st = file_parse_bursts(field[2], size[2], arena, &first, &bursts);
+
+	// The I/O of a process with bursts is in them
+	if (st == DS_OK && bursts > 0 && io > 0)
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	if (st != DS_OK)
+		return st;
+
+	String *name, *type;
+
+	st = file_make_string(&name, field[0], size[0]);
+
+	if (st != DS_OK)
+		return st;
+
+	st = file_make_string(&type, field[5], size[5]);
+
+	if (st != DS_OK)
+		return st;
+
+	Process *process;
+
+	st = prc_init(&process, name, pid, cpu, io, pri, type);
+
+	if (st != DS_OK)
+		return st;
+
+	process->period = period;
+	process->deadline = deadline;
+	process->arrival = arrival;
+
+	if (bursts > 0)
+		prc_set_bursts(process, *arena, first, bursts);
+
+	*result = process;
+
+	return DS_OK;
+}
+
+/**
+ * @brief A process table read one line at a time
+ *
+ * Only holds the chunk of the file around the next line, so a table of any
+ * size is read in constant memory.
+ */
+typedef struct FileStream
+{
+	FILE *file;		 /*!< Table being read */
+	char *buffer;	/*!< Chunk of the file not parsed yet */
+	size_t length;   /*!< Bytes read into buffer */
+	size_t offset;   /*!< Start of the next line in buffer */
+	size_t capacity; /*!< Buffer capacity */
+	bool eof;		 /*!< The whole file is in buffer */
+	BurstArena *arena; /*!< Where the bursts of the rows go, made by the first row that has any */
+	size_t chunk;	  /*!< Bursts after which the next row starts a new arena, 0 to keep one for the table */
+} FileStream;
+
+Status file_open_stream(FileStream **fst, const char *path)
+{
+	(*fst) = malloc(sizeof(FileStream));
+
+	if (!(*fst))
+		return DS_ERR_ALLOC;
+
+	(*fst)->buffer = malloc(FILE_CHUNK_SIZE);
+
+	if (!(*fst)->buffer)
+	{
+		free(*fst);
+
+		*fst = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*fst)->file = fopen(path, "r");
+
+	if ((*fst)->file == NULL)
+	{
+		free((*fst)->buffer);
+		free(*fst);
+
+		*fst = NULL;
+
+		return DS_ERR_UNEXPECTED_RESULT;
+	}
+
+	(*fst)->length = 0;
+	(*fst)->offset = 0;
+	(*fst)->capacity = FILE_CHUNK_SIZE;
+	(*fst)->eof = false;
+	(*fst)->arena = NULL;
+	(*fst)->chunk = 0;
+
+	return DS_OK;
+}
+
+// Parses the next line with a process, result is NULL at the end of the file
+Status file_next(FileStream *fst, Process **result)
+{
+	*result = NULL;
+
+	for (;;)
+	{
+		char *line = fst->buffer + fst->offset, *end = fst->buffer + fst->length;
+
+		while (line < end)
+		{
+			char *newline = memchr(line, '\n', end - line);
+
+			if (newline == NULL && !fst->eof)
+				break;
+
+			char *start = line, *stop = newline == NULL ? end : newline;
+
+			size_t size = stop - start;
+
+			if (size > 0 && start[size - 1] == '\r')
+				size--;
+
+			line = newline == NULL ? end : newline + 1;
+
+			fst->offset = line - fst->buffer;
+
+			// The rows before keep the old arena until they are all freed
+			if (fst->arena != NULL && fst->chunk > 0 && fst->arena->length >= fst->chunk)
+				brs_release(&(fst->arena));
+
+			if (size > 0)
+				return file_parse_line(start, size, &(fst->arena), result);
+		}
+
+		if (fst->eof)
+			return DS_OK;
+
+		fst->length -= fst->offset;
+
+		memmove(fst->buffer, fst->buffer + fst->offset, fst->length);
+
+		fst->offset = 0;
+
+		// A single line longer than the buffer
+		if (fst->length == fst->capacity)
+		{
+			char *buffer = realloc(fst->buffer, fst->capacity * 2);
+
+			if (!buffer)
+				return DS_ERR_ALLOC;
+
+			fst->buffer = buffer;
+
+			fst->capacity *= 2;
+		}
+
+		size_t read = fread(fst->buffer + fst->length, 1, fst->capacity - fst->length, fst->file);
+
+		fst->length += read;
+
+		fst->eof = read == 0;
+	}
+}
+
+Status file_close_stream(FileStream **fst)
+{
+	if ((*fst) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	fclose((*fst)->file);
+
+	brs_release(&((*fst)->arena));
+
+	free((*fst)->buffer);
+	free(*fst);
+
+	*fst = NULL;
+
+	return DS_OK;
+}
+
+/**
+ * Reads the file in large chunks and parses it line by line, so loading is
+ * linear in the size of the table.
+ */
+Status file_load_path(DynamicArray *process_table, const char *path)
+{
+	FileStream *fst;
+
+	Status st = file_open_stream(&fst, path);
+
+	if (st != DS_OK)
+		return st;
+
+	Process *prc;
+
+	while ((st = file_next(fst, &prc)) == DS_OK && prc != NULL)
+	{
+		st = dar_insert_back(process_table, prc);
+
+		if (st != DS_OK)
+		{
+			prc_delete(&prc);
+
+			break;
+		}
+	}
+
+	file_close_stream(&fst);
+
+	return st;
+}
+
+Status file_load(DynamicArray *process_table)
+{
+	return file_load_path(process_table, FILE_NAME);
+}
+
+static int file_compare_pid(const void *a, const void *b)
+{
+	return prc_compare(*(Process *const *)a, *(Process *const *)b);
+}
+
+// Loads a process table sorted by PID
+Status file_load_table(const char *path, QueueArray **table)
+{
+	DynamicArray *ptable;
+
+	Status st = dar_init(&ptable);
+
+	if (st != DS_OK)
+		return st;
+
+	st = file_load_path(ptable, path);
+
+	if (st != DS_OK)
+		return st;
+
+	st = dar_copy(ptable, table);
+
+	if (st != DS_OK)
+		return st;
+
+	dar_delete(&ptable);
+
+	// The menu sorts with a selection sort, too slow for generated tables
+	qsort((*table)->buffer, (*table)->length, sizeof(Process *), file_compare_pid);
+
+	return DS_OK;
+}
+
+Status file_save(DynamicArray *content)
+{
+	FILE *f = fopen(FILE_NAME, "w");
+
+	if (f == NULL)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	size_t i;
+	for (i = 0; i < content->size; i++)
+	{
+		Process *prc = content->buffer[i];
+
+		fprintf(f, "%s,%lu,", prc->name->buffer, prc->pid);
+
+		if (prc->arena != NULL)
+		{
+			size_t *burst = prc->arena->burst + prc->first_burst, j;
+
+			for (j = 0; j < prc->bursts; j++)
+				fprintf(f, j == 0 ? "%lu" : "/%lu", burst[j]);
+		}
+		else
+			fprintf(f, "%lu", prc->cpu);
+
+		fprintf(f, ",%lu,%lu,%s", prc->io, prc->pri, prc->type->buffer);
+
+		if (prc->arrival > 0)
+			fprintf(f, ",%lu,%lu,%lu", prc->period, prc->deadline, prc->arrival);
+		else if (prc->deadline > 0)
+			fprintf(f, ",%lu,%lu", prc->period, prc->deadline);
+		else if (prc->period > 0)
+			fprintf(f, ",%lu", prc->period);
+
+		fprintf(f, "\n");
+	}
+
+	fclose(f);
+
+	return DS_OK;
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         File IO Functions
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Algorithms
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Policy.c */
+
+/**
+ * @brief Compile-time description of a scheduling policy
+ *
+ * A policy is a ready queue type, a key function and four hooks. Tables
+ * are only ever passed as constants to the FORCE_INLINE kernel below, so the
+ * compiler turns every call through them into a direct, inlined call and
+ * each policy gets a loop without indirect calls.
+ */
+typedef struct Policy
+{
+	Status (*init)(Scheduler *sch);							/*!< Creates the ready queue */
+	Status (*destroy)(Scheduler *sch);						/*!< Deletes the ready queue and what is left in it */
+	Status (*push)(Scheduler *sch, Process *prc, size_t key); /*!< Adds a ready process, queues with remove move a queued one */
+	Status (*pop)(Scheduler *sch, Process **prc);			/*!< Takes the next process to run */
+	Status (*display)(Scheduler *sch);						/*!< Prints the ready queue */
+	size_t (*key)(Scheduler *sch, Process *prc);			/*!< Ready queue key, lower runs first */
+	size_t (*quantum)(Scheduler *sch, Process *prc);		/*!< Ticks a dispatched process may run */
+	void (*on_block)(Scheduler *sch, Process *prc);			/*!< Process left the CPU for I/O */
+	void (*on_unblock)(Scheduler *sch, Process *prc);		/*!< Process is back from I/O, before its push */
+	void (*on_requeue)(Scheduler *sch, Process *prc);		/*!< Quantum expired, before its push */
+	void (*on_finish)(Scheduler *sch, Process *prc);		/*!< Process used all of its CPU time, or was killed */
+	Status (*remove)(Scheduler *sch, Process *prc);			/*!< Takes a ready process out, NULL when the queue cannot */
+	void (*on_priority)(Scheduler *sch, Process *prc, size_t old); /*!< pri of a process in a queue without remove changed */
+} Policy;
+
+// FIFO ready queue, keys are ignored
+
+static Status rq_fifo_init(Scheduler *sch)
+{
+	return rbf_init(&sch->ready.fifo);
+}
+
+static Status rq_fifo_destroy(Scheduler *sch)
+{
+	return rbf_delete(&sch->ready.fifo);
+}
+
+static inline Status rq_fifo_push(Scheduler *sch, Process *prc, size_t key)
+{
+	(void)key;
+
+	return rbf_enqueue(sch->ready.fifo, prc);
+}
+
+static inline Status rq_fifo_pop(Scheduler *sch, Process **prc)
+{
+	return rbf_dequeue(sch->ready.fifo, prc);
+}
+
+static Status rq_fifo_display(Scheduler *sch)
+{
+	return rbf_display(sch->ready.fifo);
+}
+
+// For queues whose order does not depend on pri
+static void rq_no_priority(Scheduler *sch, Process *prc, size_t old)
+{
+	(void)sch;
+	(void)prc;
+	(void)old;
+}
+
+#define READY_QUEUE_FIFO            \
+	.init = rq_fifo_init,           \
+	.destroy = rq_fifo_destroy,     \
+	.push = rq_fifo_push,           \
+	.pop = rq_fifo_pop,             \
+	.display = rq_fifo_display,     \
+	.on_priority = rq_no_priority
+
+// Priority ready queue, lowest key first and FIFO among equal keys
+
+static Status rq_prq_init(Scheduler *sch)
+{
+	return prq_init_queue(&sch->ready.prq);
+}
+
+static Status rq_prq_destroy(Scheduler *sch)
+{
+	return prq_delete_queue(&sch->ready.prq);
+}
+
+static inline Status rq_prq_push(Scheduler *sch, Process *prc, size_t key)
+{
+	if (prq_contains(sch->ready.prq, prc))
+		return prq_update(sch->ready.prq, prc, key);
+
+	return prq_enqueue(sch->ready.prq, prc, key);
+}
+
+static inline Status rq_prq_pop(Scheduler *sch, Process **prc)
+{
+	return prq_dequeue(sch->ready.prq, prc);
+}
+
+static Status rq_prq_display(Scheduler *sch)
+{
+	return prq_display(sch->ready.prq);
+}
+
+static Status rq_prq_remove(Scheduler *sch, Process *prc)
+{
+	return prq_remove(sch->ready.prq, prc);
+}
+
+#define READY_QUEUE_PRIORITY        \
+	.init = rq_prq_init,            \
+	.destroy = rq_prq_destroy,      \
+	.push = rq_prq_push,            \
+	.pop = rq_prq_pop,              \
+	.display = rq_prq_display,      \
+	.remove = rq_prq_remove
+
+// Indexed heap ready queue. The running process keeps its node, so putting
+// it back after a quantum only moves it to its new key, and it only leaves
+// the heap when it blocks or finishes (rq_heap_leave). Lowest key first and
+// FIFO among equal keys.
+
+static Status rq_heap_init(Scheduler *sch)
+{
+	return ihp_init(&sch->ready.heap);
+}
+
+static Status rq_heap_destroy(Scheduler *sch)
+{
+	// sch_delete deletes the running process itself
+	if (sch->running != NULL && ihp_contains(sch->ready.heap, sch->running))
+		ihp_remove(sch->ready.heap, sch->running);
+
+	return ihp_delete(&sch->ready.heap);
+}
+
+static inline Status rq_heap_push(Scheduler *sch, Process *prc, size_t key)
+{
+	if (ihp_contains(sch->ready.heap, prc))
+		return ihp_update(sch->ready.heap, prc, key);
+
+	return ihp_push(sch->ready.heap, prc, key);
+}
+
+static inline Status rq_heap_pop(Scheduler *sch, Process **prc)
+{
+	return ihp_peek(sch->ready.heap, prc);
+}
+
+static Status rq_heap_display(Scheduler *sch)
+{
+	return ihp_display(sch->ready.heap);
+}
+
+static inline void rq_heap_leave(Scheduler *sch, Process *prc)
+{
+	ihp_remove(sch->ready.heap, prc);
+}
+
+static Status rq_heap_remove(Scheduler *sch, Process *prc)
+{
+	return ihp_remove(sch->ready.heap, prc);
+}
+
+#define READY_QUEUE_HEAP            \
+	.init = rq_heap_init,           \
+	.destroy = rq_heap_destroy,     \
+	.push = rq_heap_push,           \
+	.pop = rq_heap_pop,             \
+	.display = rq_heap_display,     \
+	.remove = rq_heap_remove,       \
+	.on_block = rq_heap_leave,      \
+	.on_finish = rq_heap_leave
+
+// Shared pieces
+
+static inline size_t pol_no_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+	(void)prc;
+
+	return 0;
+}
+
+static inline size_t pol_one_tick(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+	(void)prc;
+
+	return 1;
+}
+
+static inline void pol_no_hook(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+	(void)prc;
+}
+
+// Round Robin: FIFO order, one tick each
+
+static const Policy policy_round_robin = {
+	READY_QUEUE_FIFO,
+	.key = pol_no_key,
+	.quantum = pol_one_tick,
+	.on_block = pol_no_hook,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook,
+	.on_finish = pol_no_hook};
+
+// Static Priority: lowest pri first, pri never changes
+
+static inline size_t pol_pri_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	return prc->pri;
+}
+
+static const Policy policy_pri_static = {
+	READY_QUEUE_PRIORITY,
+	.key = pol_pri_key,
+	.quantum = pol_one_tick,
+	.on_block = pol_no_hook,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook,
+	.on_finish = pol_no_hook};
+
+// Dynamic Priority: coming back from I/O raises the priority, using the CPU
+// lowers it. With aging, every params.aging ticks in the ready queue also
+// raise it one level. Instead of touching every waiting process each tick,
+// the key is pri * aging + the tick it became ready (since): at any later
+// tick the effective priority is (key - now) / aging, the same offset for
+// every process, so the order of the queue never changes and aging costs
+// nothing per tick. A live priority change of a queued process keeps its
+// tick and so the aging it already earned.
+
+static inline size_t pol_pri_dynamic_key(Scheduler *sch, Process *prc)
+{
+	if (sch->params.aging == 0)
+		return prc->pri;
+
+	return prc->pri * sch->params.aging + prc->since;
+}
+
+static inline void pol_pri_dynamic_on_unblock(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	if (prc->pri > 0)
+		(prc->pri)--;
+}
+
+static inline void pol_pri_dynamic_on_requeue(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	if (prc->pri > 0)
+		(prc->pri)++;
+}
+
+static const Policy policy_pri_dynamic = {
+	READY_QUEUE_PRIORITY,
+	.key = pol_pri_dynamic_key,
+	.quantum = pol_one_tick,
+	.on_block = pol_no_hook,
+	.on_unblock = pol_pri_dynamic_on_unblock,
+	.on_requeue = pol_pri_dynamic_on_requeue,
+	.on_finish = pol_no_hook};
+
+// By Process Type: SO before UI before UNI
+
+static inline size_t pol_pri_type_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	return prc_translate_type(prc->type);
+}
+
+static const Policy policy_pri_type = {
+	READY_QUEUE_PRIORITY,
+	.key = pol_pri_type_key,
+	.quantum = pol_one_tick,
+	.on_block = pol_no_hook,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook,
+	.on_finish = pol_no_hook};
+
+// Shortest Job First: least CPU time left first, runs until it blocks or
+// finishes
+
+static inline size_t pol_cpu_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	return prc->cpu;
+}
+
+static inline size_t pol_no_quantum(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+	(void)prc;
+
+	return SIZE_MAX;
+}
+
+static const Policy policy_sjf = {
+	READY_QUEUE_HEAP,
+	.key = pol_cpu_key,
+	.quantum = pol_no_quantum,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook};
+
+// Shortest Remaining Time First: preemptive SJF. Every tick the running
+// process goes back with its new remaining time, a decrease-key on its own
+// node, and loses the CPU only if a shorter process became ready.
+
+static const Policy policy_srtf = {
+	READY_QUEUE_HEAP,
+	.key = pol_cpu_key,
+	.quantum = pol_one_tick,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook};
+
+// Multilevel Feedback Queue: one FIFO per level, each with its own
+// quantum. A process that uses its whole quantum goes one level down, one
+// that comes back from I/O goes one level up, and every mlfq_boost ticks
+// everybody goes back to level 0. The key is the level.
+
+// Catches up with the boosts due by now
+static inline void pol_mlfq_sync(Scheduler *sch)
+{
+	if (sch->params.mlfq_boost == 0)
+		return;
+
+	size_t due = sch->clock / sch->params.mlfq_boost;
+
+	if (sch->ready.mlq->generation < due)
+		mlq_boost(sch->ready.mlq, due - sch->ready.mlq->generation);
+}
+
+static Status rq_mlq_init(Scheduler *sch)
+{
+	return mlq_init(&sch->ready.mlq, sch->params.mlfq_levels);
+}
+
+static Status rq_mlq_destroy(Scheduler *sch)
+{
+	return mlq_delete(&sch->ready.mlq);
+}
+
+static inline Status rq_mlq_push(Scheduler *sch, Process *prc, size_t key)
+{
+	return mlq_push(sch->ready.mlq, prc, key);
+}
+
+static inline Status rq_mlq_pop(Scheduler *sch, Process **prc)
+{
+	pol_mlfq_sync(sch);
+
+	return mlq_pop(sch->ready.mlq, prc);
+}
+
+static Status rq_mlq_display(Scheduler *sch)
+{
+	return mlq_display(sch->ready.mlq);
+}
+
+static inline size_t pol_mlfq_key(Scheduler *sch, Process *prc)
+{
+	pol_mlfq_sync(sch);
+
+	return mlq_level(sch->ready.mlq, prc);
+}
+
+static inline size_t pol_mlfq_quantum(Scheduler *sch, Process *prc)
+{
+	return sch->params.mlfq_quantum[prc->level];
+}
+
+static inline void pol_mlfq_on_unblock(Scheduler *sch, Process *prc)
+{
+	size_t level = mlq_level(sch->ready.mlq, prc);
+
+	mlq_set_level(sch->ready.mlq, prc, level > 0 ? level - 1 : 0);
+}
+
+static inline void pol_mlfq_on_requeue(Scheduler *sch, Process *prc)
+{
+	mlq_set_level(sch->ready.mlq, prc, mlq_level(sch->ready.mlq, prc) + 1);
+}
+
+static const Policy policy_mlfq = {
+	.init = rq_mlq_init,
+	.destroy = rq_mlq_destroy,
+	.push = rq_mlq_push,
+	.pop = rq_mlq_pop,
+	.display = rq_mlq_display,
+	.key = pol_mlfq_key,
+	.quantum = pol_mlfq_quantum,
+	.on_block = pol_no_hook,
+	.on_unblock = pol_mlfq_on_unblock,
+	.on_requeue = pol_mlfq_on_requeue,
+	.on_finish = pol_no_hook,
+	.on_priority = rq_no_priority};
+
+// Completely Fair: the process that got the least CPU time, weighted by
+// its priority, runs next. Its quantum is its weighted share of
+// cfs_latency, never less than cfs_granularity. The key is the virtual
+// runtime.
+
+#define CFS_WEIGHT_0 1024 /*!< Weight of pri 0, a tick of CPU is worth CFS_WEIGHT_0 of vruntime at it */
+
+// Weight of each pri, Linux's table for nice 0 to 19: each step is about
+// 10% less CPU
+static const size_t cfs_weights[] = {1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+									 110, 87, 70, 56, 45, 36, 29, 23, 18, 15};
+
+static inline size_t pol_cfs_pri_weight(size_t pri)
+{
+	size_t last = sizeof(cfs_weights) / sizeof(cfs_weights[0]) - 1;
+
+	return cfs_weights[pri < last ? pri : last];
+}
+
+static inline size_t pol_cfs_weight(Process *prc)
+{
+	return pol_cfs_pri_weight(prc->pri);
+}
+
+static Status rq_cfs_init(Scheduler *sch)
+{
+	sch->ready.cfs = malloc(sizeof(FairQueue));
+
+	if (!sch->ready.cfs)
+		return DS_ERR_ALLOC;
+
+	sch->ready.cfs->min_vruntime = 0;
+	sch->ready.cfs->load = 0;
+
+	return rbt_init(&sch->ready.cfs->tree);
+}
+
+static Status rq_cfs_destroy(Scheduler *sch)
+{
+	Status st = rbt_delete(&sch->ready.cfs->tree);
+
+	if (st != DS_OK)
+		return st;
+
+	free(sch->ready.cfs);
+
+	sch->ready.cfs = NULL;
+
+	return DS_OK;
+}
+
+// A process that slept gets at most half a latency of credit over the ones
+// that kept running. One that never ran gets none, or a stream of arrivals
+// would keep jumping ahead of everyone already admitted.
+static inline Status rq_cfs_push(Scheduler *sch, Process *prc, size_t key)
+{
+	(void)key;
+
+	FairQueue *cfs = sch->ready.cfs;
+
+	size_t credit = prc->first_run == PROCESS_NOT_RUN ? 0 : sch->params.cfs_latency * CFS_WEIGHT_0 / 2;
+
+	if (cfs->min_vruntime > credit && prc->vruntime < cfs->min_vruntime - credit)
+		prc->vruntime = cfs->min_vruntime - credit;
+
+	cfs->load += pol_cfs_weight(prc);
+
+	return rbt_insert(cfs->tree, prc, prc->vruntime);
+}
+
+static inline Status rq_cfs_pop(Scheduler *sch, Process **prc)
+{
+	FairQueue *cfs = sch->ready.cfs;
+
+	Status st = rbt_pop_min(cfs->tree, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	cfs->load -= pol_cfs_weight(*prc);
+
+	if ((*prc)->vruntime > cfs->min_vruntime)
+		cfs->min_vruntime = (*prc)->vruntime;
+
+	return DS_OK;
+}
+
+static Status rq_cfs_display(Scheduler *sch)
+{
+	return rbt_display(sch->ready.cfs->tree);
+}
+
+// The tree has no removal, a queued process keeps its place and only its
+// weight in the load changes
+static void rq_cfs_on_priority(Scheduler *sch, Process *prc, size_t old)
+{
+	sch->ready.cfs->load += pol_cfs_weight(prc) - pol_cfs_pri_weight(old);
+}
+
+static inline size_t pol_cfs_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	return prc->vruntime;
+}
+
+// Called right after the dispatch, so the load is the tree plus prc
+static inline size_t pol_cfs_quantum(Scheduler *sch, Process *prc)
+{
+	size_t weight = pol_cfs_weight(prc);
+
+	size_t slice = sch->params.cfs_latency * weight / (sch->ready.cfs->load + weight);
+
+	if (slice < sch->params.cfs_granularity)
+		slice = sch->params.cfs_granularity;
+
+	return slice > 0 ? slice : 1;
+}
+
+// Charges the ticks used since the dispatch, whichever way it left the CPU
+static inline void pol_cfs_charge(Scheduler *sch, Process *prc)
+{
+	prc->vruntime += (sch->clock - sch->dispatched) * CFS_WEIGHT_0 * CFS_WEIGHT_0 / pol_cfs_weight(prc);
+}
+
+static const Policy policy_cfs = {
+	.init = rq_cfs_init,
+	.destroy = rq_cfs_destroy,
+	.push = rq_cfs_push,
+	.pop = rq_cfs_pop,
+	.display = rq_cfs_display,
+	.key = pol_cfs_key,
+	.quantum = pol_cfs_quantum,
+	.on_block = pol_cfs_charge,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_cfs_charge,
+	.on_finish = pol_no_hook,
+	.on_priority = rq_cfs_on_priority};
+
+// Lottery: every tick a random ticket wins the CPU. A process gets more
+// tickets the lower its pri and the more important its type. The key is the
+// number of tickets. The pool keeps the running and blocked processes with
+// 0 tickets until they finish or start an I/O burst.
+
+static const size_t lottery_type_tickets[] = {4, 2, 1, 1}; // SO, UI, UNI, unknown
+
+static Status rq_lottery_init(Scheduler *sch)
+{
+	return lot_init(&sch->ready.lottery, sch->params.lottery_seed);
+}
+
+// sch_delete deletes the running and blocked processes itself
+static Status rq_lottery_destroy(Scheduler *sch)
+{
+	if (sch->running != NULL)
+		lot_remove(sch->ready.lottery, sch->running);
+
+	if (sch->blocked != NULL)
+		lot_remove(sch->ready.lottery, sch->blocked);
+
+	return lot_delete(&sch->ready.lottery);
+}
+
+static inline Status rq_lottery_push(Scheduler *sch, Process *prc, size_t key)
+{
+	return lot_set_tickets(sch->ready.lottery, prc, key);
+}
+
+static inline Status rq_lottery_pop(Scheduler *sch, Process **prc)
+{
+	return lot_draw(sch->ready.lottery, prc);
+}
+
+static Status rq_lottery_display(Scheduler *sch)
+{
+	return lot_display(sch->ready.lottery);
+}
+
+static inline size_t pol_lottery_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	size_t pri = prc->pri < PROCESS_MAX_PRI ? prc->pri : PROCESS_MAX_PRI;
+
+	return (PROCESS_MAX_PRI + 1 - pri) * lottery_type_tickets[prc_translate_type(prc->type)];
+}
+
+static inline void pol_lottery_on_finish(Scheduler *sch, Process *prc)
+{
+	lot_remove(sch->ready.lottery, prc);
+}
+
+// A process in an I/O burst waits in the timers, which take its slot
+static inline void pol_lottery_on_block(Scheduler *sch, Process *prc)
+{
+	if (prc->burst % 2 == 1)
+		lot_remove(sch->ready.lottery, prc);
+}
+
+static Status rq_lottery_remove(Scheduler *sch, Process *prc)
+{
+	return lot_remove(sch->ready.lottery, prc);
+}
+
+static const Policy policy_lottery = {
+	.init = rq_lottery_init,
+	.destroy = rq_lottery_destroy,
+	.push = rq_lottery_push,
+	.pop = rq_lottery_pop,
+	.display = rq_lottery_display,
+	.key = pol_lottery_key,
+	.quantum = pol_one_tick,
+	.on_block = pol_lottery_on_block,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook,
+	.on_finish = pol_lottery_on_finish,
+	.remove = rq_lottery_remove};
+
+// Earliest Deadline First: the job whose absolute deadline comes first
+// runs, preempting the running one when an earlier deadline is released.
+// Processes without deadlines run when no job with one is ready.
+
+static inline size_t pol_edf_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	return prc->due;
+}
+
+static const Policy policy_edf = {
+	READY_QUEUE_HEAP,
+	.key = pol_edf_key,
+	.quantum = pol_one_tick,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook};
+
+// Rate Monotonic: fixed priorities, the shorter the period the higher.
+// Processes that are not periodic run last.
+
+static inline size_t pol_rm_key(Scheduler *sch, Process *prc)
+{
+	(void)sch;
+
+	return prc->period > 0 ? prc->period : SIZE_MAX;
+}
+
+static const Policy policy_rm = {
+	READY_QUEUE_HEAP,
+	.key = pol_rm_key,
+	.quantum = pol_one_tick,
+	.on_unblock = pol_no_hook,
+	.on_requeue = pol_no_hook};
+
+static const Policy *policies[ALG_COUNT] = {
+#define X(name, id, option, label) &policy_##name,
+	SCHEDULER_POLICIES(X)
+#undef X
+};
+
+/* ---------------------------------------------------------------------------------------------------- Policy.c */
+
+/* ---------------------------------------------------------------------------------------------------- Scheduler.c */
+
+#ifndef PROCESS_NO_MAIN
+// The ready queue, the running process and the blocked ones
+void sch_display(Scheduler *sch)
+{
+	policies[sch->policy]->display(sch);
+
+	if (sch->running != NULL)
+	{
+		printf("\nCurrently running:\n");
+
+		prc_display(sch->running);
+	}
+
+	printf("\nCurrently blocked:\n");
+
+	bool none = sch->blocked == NULL;
+
+	if (sch->blocked != NULL)
+		prc_display(sch->blocked);
+
+	size_t i;
+	for (i = 0; i < sch->timers->length; i++)
+	{
+		Process *prc = sch->timers->buffer[i].data;
+
+		if (prc->burst % 2 == 1)
+		{
+			prc_display(prc);
+
+			none = false;
+		}
+	}
+
+	if (none)
+		printf("None\n");
+}
+
+static Status sch_show(void *context, const HookEvent *events, size_t count)
+{
+	(void)events;
+	(void)count;
+
+	CLEAR_SCREEN;
+
+	sch_display(context);
+
+	SLEEP_F;
+
+	return DS_OK;
+}
+
+// Shows the queues and sleeps after every tick
+Status sch_visual(Scheduler *sch)
+{
+	Observer obs;
+
+	memset(&obs, 0, sizeof(Observer));
+
+	obs.on[HOOK_TICK] = sch_show;
+	obs.sync = 1u << HOOK_TICK;
+	obs.context = sch;
+
+	return sch_observe(sch, &obs);
+}
+#endif
+
+FORCE_INLINE Status sch_kernel_push(Scheduler *sch, const Policy *pol, Process *prc)
+{
+	Status st = pol->push(sch, prc, pol->key(sch, prc));
+
+	if (st != DS_OK)
+		return st;
+
+	(sch->queued)++;
+
+	return DS_OK;
+}
+
+// Gives the trace every process in the ready queue for an index entry. A
+// process killed in a queue that could not take it out is not there.
+static Status sch_index(Scheduler *sch, size_t now)
+{
+	Status st = DS_OK;
+
+	size_t i;
+	for (i = 0; i < sch->index->capacity && st == DS_OK; i++)
+	{
+		Process *prc = sch->index->slots[i];
+
+		if (prc != NULL && prc != sch->running && prc != sch->blocked && !prc->killed &&
+			!ihp_contains(sch->timers, prc))
+			st = trc_queued(sch->trace, prc->pid);
+	}
+
+	return st == DS_OK ? trc_index(sch->trace, now) : st;
+}
+
+// An index entry is taken at a dispatch, in sync, while the queues are as
+// the dispatch left them
+static Status sch_trace_dispatch(void *context, const HookEvent *events, size_t count)
+{
+	Scheduler *sch = context;
+
+	size_t i;
+	for (i = 0; i < count; i++)
+	{
+		Status st = trc_dispatch(sch->trace, events[i].prc, events[i].tick);
+
+		if (st == DS_OK && trc_due(sch->trace))
+			st = sch_index(sch, events[i].tick);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+// The other kinds the trace records, each with its trc_ function
+#define SCHEDULER_TRACE_HOOKS(X) \
+	X(PREEMPT, trc_preempt)      \
+	X(BLOCK, trc_block)          \
+	X(UNBLOCK, trc_unblock)      \
+	X(FINISH, trc_finish)        \
+	X(READY, trc_ready)          \
+	X(LEAVE, trc_leave)
+
+#define X(kind, function)                                                                    \
+	static Status sch_##function(void *context, const HookEvent *events, size_t count)     \
+	{                                                                                        \
+		Scheduler *sch = context;                                                            \
+                                                                                             \
+		size_t i;                                                                            \
+		for (i = 0; i < count; i++)                                                          \
+		{                                                                                    \
+			Status st = function(sch->trace, events[i].prc, events[i].tick);                 \
+                                                                                             \
+			if (st != DS_OK)                                                                 \
+				return st;                                                                   \
+		}                                                                                    \
+                                                                                             \
+		return DS_OK;                                                                        \
+	}
+SCHEDULER_TRACE_HOOKS(X)
+#undef X
+
+static void sch_trace_observer(Scheduler *sch, Observer *obs)
+{
+	memset(obs, 0, sizeof(Observer));
+
+	obs->on[HOOK_DISPATCH] = sch_trace_dispatch;
+#define X(kind, function) obs->on[HOOK_##kind] = sch_##function;
+	SCHEDULER_TRACE_HOOKS(X)
+#undef X
+
+	if (sch->trace->format == TRACE_DISPATCH)
+		obs->sync = 1u << HOOK_DISPATCH;
+
+	obs->context = sch;
+}
+
+// Tells the observers, the only cost of a run that has none is the test
+static inline Status sch_hook(Scheduler *sch, HookKind kind, size_t tick, Process *prc)
+{
+	return sch->hooks == NULL ? DS_OK : hok_emit(sch->hooks, kind, tick, prc);
+}
+
+// Hands the observers what is left of the batch before returning to a caller
+static Status sch_flush(Scheduler *sch)
+{
+	return sch->hooks == NULL || (sch->hooks->length == 0 && !sch->hooks->ticking) ? DS_OK : hok_flush(sch->hooks);
+}
+
+// Keeps a process that left the run, or hands it to the sink and frees it
+static inline Status sch_finished(Scheduler *sch, Process *prc)
+{
+	Status st = sch_hook(sch, HOOK_EXIT, prc->finish, prc);
+
+	if (st != DS_OK || sch->sink == NULL)
+		return st == DS_OK ? qua_enqueue(sch->finished, prc) : st;
+
+	// The observers still get it in one piece
+	st = sch_flush(sch);
+
+	if (st == DS_OK)
+		st = sch->sink(sch->context, prc);
+
+	prc_delete(&prc);
+
+	return st;
+}
+
+// A killed process leaves the run. It joins the finished processes but not
+// the statistics, with finish set to the tick of the kill.
+static Status sch_retire(Scheduler *sch, Process *prc, size_t now)
+{
+	if (!prc->killed)
+	{
+		prc->killed = true;
+		prc->finish = now;
+	}
+
+	Status st = pix_remove(sch->index, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	return sch_finished(sch, prc);
+}
+
+/**
+ * Takes a process out of the run wherever it is. Queues with a remove
+ * operation give it up in O(log n); from the others it is dropped when the
+ * queue hands it out, so the kill costs nothing now.
+ */
+static Status sch_kernel_kill(Scheduler *sch, const Policy *pol, size_t pid)
+{
+	Process *prc;
+
+	Status st = pix_find(sch->index, pid, &prc);
+
+	if (st != DS_OK)
+		return st;
+
+	if (prc->killed)
+		return DS_ERR_NOT_FOUND;
+
+	size_t now = sch->clock;
+
+	if (prc == sch->running)
+	{
+		sch->running = NULL;
+
+		pol->on_finish(sch, prc);
+
+		st = sch_hook(sch, HOOK_FINISH, now, prc);
+	}
+	else if (prc == sch->blocked)
+	{
+		sch->blocked = NULL;
+
+		pol->on_finish(sch, prc);
+
+		prc_unblock(prc, now);
+
+		st = sch_hook(sch, HOOK_UNBLOCK, now, prc);
+	}
+	else if (ihp_contains(sch->timers, prc))
+	{
+		st = ihp_remove(sch->timers, prc);
+
+		// Its queue already let it go when its I/O burst started
+		if (st == DS_OK && prc->burst % 2 == 1)
+		{
+			prc_unblock(prc, now);
+
+			st = sch_hook(sch, HOOK_UNBLOCK, now, prc);
+		}
+	}
+	else if (pol->remove != NULL)
+	{
+		st = pol->remove(sch, prc);
+
+		if (st == DS_OK)
+			(sch->queued)--;
+
+		if (st == DS_OK)
+			st = sch_hook(sch, HOOK_LEAVE, now, prc);
+	}
+	else
+	{
+		prc->killed = true;
+		prc->finish = now;
+
+		return sch_hook(sch, HOOK_LEAVE, now, prc);
+	}
+
+	if (st != DS_OK)
+		return st;
+
+	return sch_retire(sch, prc, now);
+}
+
+/**
+ * Changes the priority of a process that has not finished. A ready process
+ * in an indexed queue moves to its new key in O(log n), in the other queues
+ * it keeps its place. Anywhere else the new priority counts from its next
+ * push.
+ */
+static Status sch_kernel_set_priority(Scheduler *sch, const Policy *pol, size_t pid, size_t pri)
+{
+	Process *prc;
+
+	Status st = pix_find(sch->index, pid, &prc);
+
+	if (st != DS_OK)
+		return st;
+
+	if (prc->killed)
+		return DS_ERR_NOT_FOUND;
+
+	size_t old = prc->pri;
+
+	prc->pri = pri;
+
+	if (prc == sch->running || prc == sch->blocked || ihp_contains(sch->timers, prc))
+		return DS_OK;
+
+	// The push of a queue with remove moves a process it already has
+	if (pol->remove != NULL)
+		return pol->push(sch, prc, pol->key(sch, prc));
+
+	pol->on_priority(sch, prc, old);
+
+	return DS_OK;
+}
+
+// Applies the kills and priority changes due by now. A PID that already
+// finished, or never existed, is not an error.
+static Status sch_apply_events(Scheduler *sch, const Policy *pol)
+{
+	while (sch->event < sch->params.events && sch->params.event[sch->event].tick <= sch->clock)
+	{
+		SchedulerEvent *event = &sch->params.event[(sch->event)++];
+
+		Status st;
+
+		if (event->pri == SCHEDULER_KILL)
+			st = sch_kernel_kill(sch, pol, event->pid);
+		else
+			st = sch_kernel_set_priority(sch, pol, event->pid, event->pri);
+
+		if (st != DS_OK && st != DS_ERR_NOT_FOUND)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+// Moves every process released, or done with an I/O burst, by now from the
+// timers to the ready queue
+FORCE_INLINE Status sch_kernel_release(Scheduler *sch, const Policy *pol, size_t now)
+{
+	while (!ihp_is_empty(sch->timers) && sch->timers->buffer[0].key <= now)
+	{
+		Process *prc;
+
+		Status st = ihp_pop(sch->timers, &prc);
+
+		if (st != DS_OK)
+			return st;
+
+		// The end of an I/O burst, the next CPU one starts
+		if (prc->burst % 2 == 1)
+		{
+			(prc->burst)++;
+
+			prc->cpu = prc->arena->burst[prc->first_burst + prc->burst];
+
+			pol->on_unblock(sch, prc);
+
+			prc_unblock(prc, now);
+
+			st = sch_hook(sch, HOOK_UNBLOCK, now, prc);
+
+			if (st != DS_OK)
+				return st;
+		}
+		else
+			prc_ready(prc, now);
+
+		st = sch_kernel_push(sch, pol, prc);
+
+		if (st == DS_OK)
+			st = sch_hook(sch, HOOK_READY, now, prc);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+// The running process used all of its CPU time. A periodic process starts
+// its next job, right away if it was already released or when it is, and
+// any other process is done.
+FORCE_INLINE Status sch_kernel_complete(Scheduler *sch, const Policy *pol, Process *prc, size_t now)
+{
+	Status st;
+
+	if (prc->due != PROCESS_NO_DEADLINE)
+	{
+		(prc->jobs)++;
+
+		if (now > prc->due)
+			(prc->misses)++;
+	}
+
+	if (prc->period > 0)
+	{
+		size_t release = prc->arrival + (prc->job + 1) * prc->period;
+
+		if (release < (sch->params.horizon > 0 ? sch->params.horizon : sch->hyperperiod))
+		{
+			(prc->job)++;
+
+			prc->cpu = prc->job_cpu;
+			prc->io = prc->job_io;
+			prc->burst = 0;
+			prc->due = release + (prc->deadline > 0 ? prc->deadline : prc->period);
+
+			st = sch_hook(sch, HOOK_PREEMPT, now, prc);
+
+			if (st != DS_OK)
+				return st;
+
+			if (release <= now)
+			{
+				prc_ready(prc, now);
+
+				return sch_kernel_push(sch, pol, prc);
+			}
+
+			// The slice ended as a preemption but the next job is not out yet
+			st = sch_hook(sch, HOOK_LEAVE, now, prc);
+
+			if (st != DS_OK)
+				return st;
+
+			return ihp_push(sch->timers, prc, release);
+		}
+	}
+
+	prc->finish = now;
+
+	st = sch_hook(sch, HOOK_FINISH, now, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	st = pix_remove(sch->index, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	return sch_finished(sch, prc);
+}
+
+// The blocked process finished its I/O and goes back to the ready queue
+FORCE_INLINE Status sch_kernel_unblock(Scheduler *sch, const Policy *pol, size_t now)
+{
+	Process *prc = sch->blocked;
+
+	sch->blocked = NULL;
+
+	pol->on_unblock(sch, prc);
+
+	prc_unblock(prc, now);
+
+	Status st = sch_hook(sch, HOOK_UNBLOCK, now, prc);
+
+	if (st == DS_OK)
+		st = sch_kernel_push(sch, pol, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	return sch_hook(sch, HOOK_READY, now, prc);
+}
+
+/**
+ * The running process ended a CPU burst and has an I/O burst next. It waits
+ * for it in the timers, so any number of processes do their I/O at once,
+ * each one for exactly the ticks of its burst.
+ */
+FORCE_INLINE Status sch_kernel_wait(Scheduler *sch, const Policy *pol, Process *prc, size_t now)
+{
+	(prc->burst)++;
+
+	pol->on_block(sch, prc);
+
+	prc_block(prc, now);
+
+	Status st = sch_hook(sch, HOOK_BLOCK, now, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	return ihp_push(sch->timers, prc, now + prc->arena->burst[prc->first_burst + prc->burst]);
+}
+
+/**
+ * One tick. The running process, or the next one in the ready queue, uses
+ * the CPU for a tick and then either blocks for I/O, keeps the CPU until
+ * its quantum is over, goes back to the ready queue or finishes. There is
+ * one I/O slot: a process that blocks releases the one already waiting,
+ * and when nothing else is ready the waiting one is released too.
+ */
+FORCE_INLINE Status sch_kernel_step(Scheduler *sch, const Policy *pol)
+{
+	if (sch_done(sch))
+		return DS_ERR_INVALID_OPERATION;
+
+	Status st;
+
+	if (sch->event < sch->params.events && sch->params.event[sch->event].tick <= sch->clock)
+	{
+		st = sch_apply_events(sch, pol);
+
+		if (st != DS_OK)
+			return st;
+
+		if (sch_done(sch))
+			return DS_OK;
+	}
+
+	size_t now = sch->clock;
+
+	st = sch_kernel_release(sch, pol, now);
+
+	if (st != DS_OK)
+		return st;
+
+	if (sch->running == NULL && sch->queued == 0)
+	{
+		if (sch->blocked != NULL)
+			st = sch_kernel_unblock(sch, pol, now);
+		else if (!ihp_is_empty(sch->timers))
+		{
+			// Nothing to run until the next release, skip the idle ticks
+			now = sch->clock = sch->timers->buffer[0].key;
+
+			st = sch_kernel_release(sch, pol, now);
+		}
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	if (sch->running == NULL)
+	{
+		st = pol->pop(sch, &sch->running);
+
+		if (st != DS_OK)
+			return st;
+
+		(sch->queued)--;
+
+		// Killed while in a queue that could not take it out, the step ends
+		// here without using the tick
+		if (sch->running->killed)
+		{
+			Process *killed = sch->running;
+
+			sch->running = NULL;
+
+			pol->on_finish(sch, killed);
+
+			return sch_retire(sch, killed, now);
+		}
+
+		sch->dispatched = now;
+
+		prc_dispatch(sch->running, now);
+
+		st = sch_hook(sch, HOOK_DISPATCH, now, sch->running);
+
+		if (st != DS_OK)
+			return st;
+
+		sch->slice = pol->quantum(sch, sch->running);
+	}
+
+	Process *current = sch->running;
+
+	size_t busy = 0;
+
+	if (current->cpu > 0)
+	{
+		(current->cpu)--;
+
+		busy = 1;
+	}
+
+	sch->clock = ++now;
+
+	if (current->io > 0)
+	{
+		if (sch->blocked != NULL)
+		{
+			st = sch_kernel_unblock(sch, pol, now);
+
+			if (st != DS_OK)
+				return st;
+		}
+
+		(current->io)--;
+
+		pol->on_block(sch, current);
+
+		prc_block(current, now);
+
+		st = sch_hook(sch, HOOK_BLOCK, now, current);
+
+		if (st != DS_OK)
+			return st;
+
+		sch->blocked = current;
+		sch->running = NULL;
+	}
+	else if (current->cpu > 0)
+	{
+		if (--(sch->slice) == 0)
+		{
+			pol->on_requeue(sch, current);
+
+			prc_ready(current, now);
+
+			st = sch_hook(sch, HOOK_PREEMPT, now, current);
+
+			if (st != DS_OK)
+				return st;
+
+			st = sch_kernel_push(sch, pol, current);
+
+			if (st != DS_OK)
+				return st;
+
+			sch->running = NULL;
+		}
+	}
+	else if (current->burst + 1 < current->bursts)
+	{
+		sch->running = NULL;
+
+		st = sch_kernel_wait(sch, pol, current, now);
+
+		if (st != DS_OK)
+			return st;
+	}
+	else
+	{
+		pol->on_finish(sch, current);
+
+		sch->running = NULL;
+
+		st = sch_kernel_complete(sch, pol, current, now);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return sch->hooks == NULL ? DS_OK : hok_tick(sch->hooks, now, busy);
+}
+
+// Until every process finished or the clock reaches until
+FORCE_INLINE Status sch_kernel_run(Scheduler *sch, const Policy *pol, size_t until)
+{
+	Status st;
+
+	while (!sch_done(sch) && sch->clock < until)
+	{
+		st = sch_kernel_step(sch, pol);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+// One specialized step and run per policy
+#define X(name, id, option, label)                             \
+	static Status sch_step_##name(Scheduler *sch)              \
+	{                                                          \
+		return sch_kernel_step(sch, &policy_##name);           \
+	}                                                          \
+	static Status sch_run_##name(Scheduler *sch, size_t until) \
+	{                                                          \
+		return sch_kernel_run(sch, &policy_##name, until);     \
+	}
+SCHEDULER_POLICIES(X)
+#undef X
+
+void sch_default_params(SchedulerParams *params)
+{
+	params->aging = 0;
+	params->mlfq_levels = 4;
+	params->mlfq_quantum[0] = 1;
+	params->mlfq_quantum[1] = 2;
+	params->mlfq_quantum[2] = 4;
+	params->mlfq_quantum[3] = 8;
+	params->mlfq_boost = 50;
+	params->cfs_latency = 20;
+	params->cfs_granularity = 2;
+	params->lottery_seed = 1;
+	params->horizon = 0;
+	params->events = 0;
+}
+
+// Parses the MLFQ quanta, "q0,q1,...", one level per quantum. The text is
+// only read, so it can be a literal and parses can run on any thread.
+Status sch_parse_quanta(SchedulerParams *params, const char *text)
+{
+	size_t levels = 0, quantum[MLFQ_MAX_LEVELS];
+
+	while (1)
+	{
+		char *end;
+
+		unsigned long long value = strtoull(text, &end, 10);
+
+		if (end == text || value == 0 || levels == MLFQ_MAX_LEVELS || (*end != ',' && *end != '\0'))
+			return DS_ERR_INVALID_ARGUMENT;
+
+		quantum[levels++] = (size_t)value;
+
+		if (*end == '\0')
+			break;
+
+		text = end + 1;
+	}
+
+	memcpy(params->mlfq_quantum, quantum, sizeof(size_t) * levels);
+
+	params->mlfq_levels = levels;
+
+	return DS_OK;
+}
+
+// Parses "pid@tick" for a kill or "pid@tick=pri" for a priority change and
+// adds it after the events of earlier or equal ticks
+Status sch_parse_event(SchedulerParams *params, const char *text, bool kill)
+{
+	unsigned long long pid, tick, pri = SCHEDULER_KILL;
+	int used = 0;
+
+	if (kill)
+		sscanf(text, "%llu@%llu%n", &pid, &tick, &used);
+	else
+		sscanf(text, "%llu@%llu=%llu%n", &pid, &tick, &pri, &used);
+
+	if (used == 0 || text[used] != '\0' || (pri == SCHEDULER_KILL && !kill))
+		return DS_ERR_INVALID_ARGUMENT;
+
+	if (params->events == SCHEDULER_MAX_EVENTS)
+		return DS_ERR_FULL;
+
+	size_t i = params->events++;
+
+	for (; i > 0 && params->event[i - 1].tick > tick; i--)
+		params->event[i] = params->event[i - 1];
+
+	params->event[i] = (SchedulerEvent){(size_t)tick, (size_t)pid, (size_t)pri};
+
+	return DS_OK;
+}
+
+static Status sch_parse_size(const char *text, size_t *result)
+{
+	char *end;
+
+	unsigned long long value = strtoull(text, &end, 10);
+
+	if (end == text || *end != '\0')
+		return DS_ERR_INVALID_ARGUMENT;
+
+	*result = (size_t)value;
+
+	return DS_OK;
+}
+
+// Sets one policy tunable by its command line name, without the dashes.
+// DS_ERR_NOT_FOUND when name is not one of them.
+Status sch_parse_param(SchedulerParams *params, const char *name, const char *value)
+{
+	if (strcmp(name, "aging") == 0)
+		return sch_parse_size(value, &params->aging);
+	else if (strcmp(name, "mlfq") == 0)
+		return sch_parse_quanta(params, value);
+	else if (strcmp(name, "boost") == 0)
+		return sch_parse_size(value, &params->mlfq_boost);
+	else if (strcmp(name, "latency") == 0)
+		return sch_parse_size(value, &params->cfs_latency);
+	else if (strcmp(name, "granularity") == 0)
+		return sch_parse_size(value, &params->cfs_granularity);
+	else if (strcmp(name, "horizon") == 0)
+		return sch_parse_size(value, &params->horizon);
+	else if (strcmp(name, "kill") == 0)
+		return sch_parse_event(params, value, true);
+	else if (strcmp(name, "priority") == 0)
+		return sch_parse_event(params, value, false);
+	else if (strcmp(name, "lottery-seed") == 0)
+	{
+		size_t seed = 0;
+
+		Status st = sch_parse_size(value, &seed);
+
+		params->lottery_seed = seed;
+
+		return st;
+	}
+
+	return DS_ERR_NOT_FOUND;
+}
+
+// params may be NULL for the defaults
+Status sch_init(Scheduler **sch, AlgorithmId policy, const SchedulerParams *params)
+{
+	if (policy >= ALG_COUNT)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	(*sch) = malloc(sizeof(Scheduler));
+
+	if (!(*sch))
+		return DS_ERR_ALLOC;
+
+	(*sch)->policy = policy;
+
+	if (params != NULL)
+		(*sch)->params = *params;
+	else
+		sch_default_params(&((*sch)->params));
+
+	(*sch)->queued = 0;
+	(*sch)->running = NULL;
+	(*sch)->slice = 0;
+	(*sch)->dispatched = 0;
+	(*sch)->blocked = NULL;
+	(*sch)->event = 0;
+	(*sch)->hyperperiod = 1;
+	(*sch)->clock = 0;
+	(*sch)->sink = NULL;
+	(*sch)->context = NULL;
+	(*sch)->hooks = NULL;
+	(*sch)->metrics = NULL;
+	(*sch)->trace = NULL;
+
+	Status st = policies[policy]->init(*sch);
+
+	if (st != DS_OK)
+		return st;
+
+	st = qua_init(&((*sch)->finished));
+
+	if (st != DS_OK)
+		return st;
+
+	st = ihp_init(&((*sch)->timers));
+
+	if (st != DS_OK)
+		return st;
+
+	st = pix_init(&((*sch)->index));
+
+	if (st != DS_OK)
+		return st;
+
+	return DS_OK;
+}
+
+static size_t sch_lcm(size_t a, size_t b)
+{
+	size_t x = a, y = b;
+
+	while (y != 0)
+	{
+		size_t r = x % y;
+
+		x = y;
+		y = r;
+	}
+
+	a /= x;
+
+	if (a > SCHEDULER_MAX_HYPERPERIOD / b)
+		return SCHEDULER_MAX_HYPERPERIOD;
+
+	return a * b < SCHEDULER_MAX_HYPERPERIOD ? a * b : SCHEDULER_MAX_HYPERPERIOD;
+}
+
+// Sets up the first job of a process and adds it to the index
+static Status sch_admit(Scheduler *sch, Process *prc)
+{
+	if (prc->arrival < sch->clock)
+		prc->arrival = sch->clock;
+
+	prc->since = prc->arrival;
+
+	prc->job_cpu = prc->cpu;
+	prc->job_io = prc->io;
+	prc->job = 0;
+
+	if (prc->deadline > 0)
+		prc->due = prc->arrival + prc->deadline;
+	else if (prc->period > 0)
+		prc->due = prc->arrival + prc->period;
+
+	if (prc->period > 0)
+		sch->hyperperiod = sch_lcm(sch->hyperperiod, prc->period);
+
+	return pix_insert(sch->index, prc);
+}
+
+Status sch_submit(Scheduler *sch, Process *prc)
+{
+	if (sch == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = sch_admit(sch, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	// A process that arrives later waits in the timers, not in the ready queue
+	if (prc->arrival > sch->clock)
+		return ihp_push(sch->timers, prc, prc->arrival);
+
+	st = policies[sch->policy]->push(sch, prc, policies[sch->policy]->key(sch, prc));
+
+	if (st != DS_OK)
+		return st;
+
+	(sch->queued)++;
+
+	st = sch_hook(sch, HOOK_READY, sch->clock, prc);
+
+	return st == DS_OK ? sch_flush(sch) : st;
+}
+
+// Like sch_submit for a process that has not arrived before the current
+// tick, always through the timers, with the insertion number it takes among
+// the ones with the same arrival
+Status sch_submit_ordered(Scheduler *sch, Process *prc, size_t order)
+{
+	if (sch == NULL || prc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (prc->arrival < sch->clock)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	Status st = sch_admit(sch, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t next = sch->timers->order;
+
+	sch->timers->order = order;
+
+	st = ihp_push(sch->timers, prc, prc->arrival);
+
+	sch->timers->order = next;
+
+	return st;
+}
+
+Status sch_kill(Scheduler *sch, size_t pid)
+{
+	if (sch == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = sch_kernel_kill(sch, policies[sch->policy], pid);
+
+	return st == DS_OK ? sch_flush(sch) : st;
+}
+
+Status sch_set_priority(Scheduler *sch, size_t pid, size_t pri)
+{
+	if (sch == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	return sch_kernel_set_priority(sch, policies[sch->policy], pid, pri);
+}
+
+Status sch_step(Scheduler *sch)
+{
+	if (sch == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	switch (sch->policy)
+	{
+#define X(name, id, option, label) \
+	case ALG_##id:                 \
+		st = sch_step_##name(sch); \
+		break;
+		SCHEDULER_POLICIES(X)
+#undef X
+	default:
+		return DS_ERR_INVALID_ARGUMENT;
+	}
+
+	return st == DS_OK ? sch_flush(sch) : st;
+}
+
+Status sch_run(Scheduler *sch)
+{
+	return sch_run_until(sch, SIZE_MAX);
+}
+
+// Stops before the first tick at or after until, or when every process
+// finished
+Status sch_run_until(Scheduler *sch, size_t until)
+{
+	if (sch == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	switch (sch->policy)
+	{
+#define X(name, id, option, label)        \
+	case ALG_##id:                        \
+		st = sch_run_##name(sch, until); \
+		break;
+		SCHEDULER_POLICIES(X)
+#undef X
+	default:
+		return DS_ERR_INVALID_ARGUMENT;
+	}
+
+	return st == DS_OK ? sch_flush(sch) : st;
+}
+
+bool sch_done(Scheduler *sch)
+{
+	return sch->queued == 0 && sch->running == NULL && sch->blocked == NULL && ihp_is_empty(sch->timers);
+}
+
+// Sink of a run that only wants its metrics
+Status sch_discard(void *context, Process *prc)
+{
+	(void)context;
+	(void)prc;
+
+	return DS_OK;
+}
+
+Status sch_observe(Scheduler *sch, const Observer *obs)
+{
+	if (sch == NULL || obs == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (sch->hooks == NULL)
+	{
+		Status st = hok_init(&(sch->hooks));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return hok_observe(sch->hooks, obs);
+}
+
+// Without observers the run goes back to having no Hooks
+Status sch_unobserve(Scheduler *sch, const Observer *obs)
+{
+	if (sch == NULL || obs == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (sch->hooks == NULL)
+		return DS_ERR_NOT_FOUND;
+
+	Status st = hok_unobserve(sch->hooks, obs);
+
+	if (st == DS_OK && sch->hooks->observers == 0)
+		st = hok_delete(&(sch->hooks));
+
+	return st;
+}
+
+// Replaces the metrics the run keeps, NULL for none
+Status sch_metrics(Scheduler *sch, Metrics *metrics)
+{
+	if (sch == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (sch->metrics == metrics)
+		return DS_OK;
+
+	Observer obs;
+
+	if (sch->metrics != NULL)
+	{
+		met_observer(sch->metrics, &obs);
+
+		Status st = sch_unobserve(sch, &obs);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	sch->metrics = metrics;
+
+	if (metrics == NULL)
+		return DS_OK;
+
+	met_observer(metrics, &obs);
+
+	return sch_observe(sch, &obs);
+}
+
+// Replaces the trace the run writes, NULL for none
+Status sch_trace(Scheduler *sch, Trace *trace)
+{
+	if (sch == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (sch->trace == trace)
+		return DS_OK;
+
+	Observer obs;
+
+	if (sch->trace != NULL)
+	{
+		sch_trace_observer(sch, &obs);
+
+		Status st = sch_unobserve(sch, &obs);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	sch->trace = trace;
+
+	if (trace == NULL)
+		return DS_OK;
+
+	sch_trace_observer(sch, &obs);
+
+	return sch_observe(sch, &obs);
+}
+
+Status sch_delete(Scheduler **sch)
+{
+	if ((*sch) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = policies[(*sch)->policy]->destroy(*sch);
+
+	if (st != DS_OK)
+		return st;
+
+	if ((*sch)->finished != NULL)
+	{
+		st = qua_delete(&((*sch)->finished));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	if ((*sch)->running != NULL)
+		prc_delete(&((*sch)->running));
+
+	if ((*sch)->blocked != NULL)
+		prc_delete(&((*sch)->blocked));
+
+	if ((*sch)->timers != NULL)
+	{
+		st = ihp_delete(&((*sch)->timers));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	if ((*sch)->index != NULL)
+	{
+		st = pix_delete(&((*sch)->index));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	if ((*sch)->hooks != NULL)
+		hok_delete(&((*sch)->hooks));
+
+	free(*sch);
+
+	*sch = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Scheduler.c */
+
+/**
+ * Runs every process of pqueue to completion with one policy. pqueue is left
+ * empty and result receives the processes in the order they finished.
+ */
+static Status alg_simulate(AlgorithmId policy, QueueArray *pqueue, QueueArray **result,
+						   const SchedulerParams *params, Metrics *metrics, Trace *trace, bool visual)
+{
+	if (pqueue == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (qua_is_empty(pqueue))
+		return DS_ERR_INVALID_ARGUMENT;
+
+	Scheduler *sch;
+
+	Status st = sch_init(&sch, policy, params);
+
+	if (st != DS_OK)
+		return st;
+
+	st = sch_metrics(sch, metrics);
+
+	if (st == DS_OK)
+		st = sch_trace(sch, trace);
+
+#ifndef PROCESS_NO_MAIN
+	if (st == DS_OK && visual)
+		st = sch_visual(sch);
+#else
+	(void)visual;
+#endif
+
+	if (st != DS_OK)
+		return st;
+
+	size_t i;
+	for (i = 0; i < pqueue->length; i++)
+	{
+		st = sch_submit(sch, pqueue->buffer[i]);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	pqueue->length = 0;
+
+	st = sch_run(sch);
+
+	if (st != DS_OK)
+		return st;
+
+	*result = sch->finished;
+
+	sch->finished = NULL;
+
+	return sch_delete(&sch);
+}
+
+#define X(name, id, option, label)                                                                    \
+	Status alg_##name(QueueArray *pqueue, QueueArray **result, const SchedulerParams *params, Metrics *metrics, \
+					  Trace *trace, bool visual)                                                          \
+	{                                                                                                 \
+		return alg_simulate(ALG_##id, pqueue, result, params, metrics, trace, visual);                \
+	}
+SCHEDULER_POLICIES(X)
+#undef X
+
+/**
+ * Reads the rows of the table that arrive in the same tick as *next, sorted
+ * by PID as file_load_table sorts a table, and leaves the row after them in
+ * *next. Rows out of arrival order are an error.
+ */
+static Status alg_batch(FileStream *fst, Process **next, DynamicArray *batch)
+{
+	Process *prc = *next;
+
+	Status st = DS_OK;
+
+	*next = NULL;
+
+	batch->size = 0;
+
+	while (prc != NULL && (batch->size == 0 || prc->arrival == batch->buffer[0]->arrival))
+	{
+		st = dar_insert_back(batch, prc);
+
+		if (st != DS_OK)
+		{
+			prc_delete(&prc);
+
+			return st;
+		}
+
+		st = file_next(fst, &prc);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	*next = prc;
+
+	if (prc != NULL && prc->arrival < batch->buffer[0]->arrival)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	qsort(batch->buffer, batch->size, sizeof(Process *), file_compare_pid);
+
+	return DS_OK;
+}
+
+// A kill or a priority change looks for the process before it arrives
+static bool alg_targeted(const SchedulerParams *params, size_t pid)
+{
+	size_t i;
+	for (i = 0; i < params->events; i++)
+	{
+		if (params->event[i].pid == pid)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * One pass over the table at path for what a run of the whole table knows
+ * from the start: the rows that arrive later, the hyperperiod and the rows
+ * kills and priority changes look for, which are submitted right away.
+ */
+static Status alg_scan(Scheduler *sch, const char *path, DynamicArray *batch)
+{
+	FileStream *fst;
+
+	Status st = file_open_stream(&fst, path);
+
+	if (st != DS_OK)
+		return st;
+
+	fst->chunk = FILE_STREAM_BURSTS;
+
+	Process *next;
+
+	size_t late = 0, hyperperiod = 1, i;
+
+	st = file_next(fst, &next);
+
+	while (st == DS_OK && next != NULL)
+	{
+		st = alg_batch(fst, &next, batch);
+
+		for (i = 0; i < batch->size; i++)
+		{
+			Process *prc = batch->buffer[i];
+
+			if (prc->period > 0)
+				hyperperiod = sch_lcm(hyperperiod, prc->period);
+
+			if (prc->arrival == 0)
+			{
+				prc_delete(&prc);
+
+				continue;
+			}
+
+			late++;
+
+			if (st == DS_OK && alg_targeted(&(sch->params), prc->pid))
+				st = sch_submit_ordered(sch, prc, i);
+			else
+				prc_delete(&prc);
+		}
+	}
+
+	if (next != NULL)
+		prc_delete(&next);
+
+	batch->size = 0;
+
+	file_close_stream(&fst);
+
+	if (st != DS_OK)
+		return st;
+
+	// Releases of later jobs and ends of I/O bursts come after every row, as
+	// when all are submitted
+	sch->timers->order = late;
+
+	sch->hyperperiod = hyperperiod;
+
+	return DS_OK;
+}
+
+/**
+ * Runs the table at path with one policy while it reads it, one arrival at
+ * a time, and hands every finished process to sink. Only the processes that
+ * arrived and did not finish yet are in memory, however long the table is.
+ * The rows must be in arrival order, the run is the one alg_simulate makes
+ * of the whole table.
+ */
+Status alg_stream(AlgorithmId policy, const char *path, const SchedulerParams *params, Metrics *metrics,
+				  Trace *trace, SchedulerSink sink, void *context)
+{
+	if (path == NULL || sink == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Scheduler *sch;
+
+	Status st = sch_init(&sch, policy, params);
+
+	if (st != DS_OK)
+		return st;
+
+	sch->sink = sink;
+	sch->context = context;
+
+	st = sch_metrics(sch, metrics);
+
+	if (st == DS_OK)
+		st = sch_trace(sch, trace);
+
+	DynamicArray *batch = NULL;
+
+	if (st == DS_OK)
+		st = dar_init(&batch);
+
+	if (st != DS_OK)
+	{
+		sch_delete(&sch);
+
+		return st;
+	}
+
+	FileStream *fst = NULL;
+
+	Process *next = NULL;
+
+	size_t rows = 0, i;
+
+	st = alg_scan(sch, path, batch);
+
+	if (st == DS_OK)
+		st = file_open_stream(&fst, path);
+
+	// An arena is freed once its rows are, so only the bursts of the rows
+	// still in the run are held
+	if (st == DS_OK)
+	{
+		fst->chunk = FILE_STREAM_BURSTS;
+
+		st = file_next(fst, &next);
+	}
+
+	while (st == DS_OK && next != NULL)
+	{
+		size_t arrival = next->arrival;
+
+		st = alg_batch(fst, &next, batch);
+
+		for (i = 0; i < batch->size; i++)
+		{
+			Process *prc = batch->buffer[i];
+
+			if (st != DS_OK || (prc->arrival > 0 && alg_targeted(params, prc->pid)))
+				prc_delete(&prc);
+			else if (prc->arrival == 0)
+				st = sch_submit(sch, prc);
+			else
+				st = sch_submit_ordered(sch, prc, i);
+		}
+
+		rows += batch->size;
+
+		batch->size = 0;
+
+		// Run up to an arrival only once its rows are in the timers, an idle
+		// CPU skips to the next release and would otherwise go past them
+		if (st == DS_OK && arrival > 0)
+			st = sch_run_until(sch, arrival);
+	}
+
+	if (next != NULL)
+		prc_delete(&next);
+
+	if (fst != NULL)
+		file_close_stream(&fst);
+
+	dar_delete_shallow(&batch);
+
+	if (st == DS_OK && rows == 0)
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	if (st == DS_OK)
+		st = sch_run(sch);
+
+	Status dl = sch_delete(&sch);
+
+	return st != DS_OK ? st : dl;
+}
+
+Algorithm alg_table[ALG_COUNT] = {
+#define X(name, id, option, label) alg_##name,
+	SCHEDULER_POLICIES(X)
+#undef X
+};
+
+char *alg_names[ALG_COUNT] = {
+#define X(name, id, option, label) label,
+	SCHEDULER_POLICIES(X)
+#undef X
+};
+
+char *alg_options[ALG_COUNT] = {
+#define X(name, id, option, label) option,
+	SCHEDULER_POLICIES(X)
+#undef X
+};
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Algorithms
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Workloads
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Random.c */
+
+static uint64_t rng_splitmix(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return z ^ (z >> 31);
+}
+
+static uint64_t rng_rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+void rng_seed(Random *rng, uint64_t seed, uint64_t stream)
+{
+	uint64_t x = seed;
+
+	// Mix the stream number in so that nearby streams are uncorrelated
+	x ^= rng_splitmix(&stream);
+
+	size_t i;
+	for (i = 0; i < 4; i++)
+		rng->state[i] = rng_splitmix(&x);
+}
+
+uint64_t rng_next(Random *rng)
+{
+	uint64_t *s = rng->state;
+
+	uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+
+	s[2] ^= t;
+
+	s[3] = rng_rotl(s[3], 45);
+
+	return result;
+}
+
+double rng_double(Random *rng)
+{
+	// 53 random bits in [0, 1)
+	return (rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+size_t rng_range(Random *rng, size_t lo, size_t hi)
+{
+	if (hi <= lo)
+		return lo;
+
+	uint64_t span = (uint64_t)(hi - lo) + 1;
+
+	if (span == 0)
+		return (size_t)rng_next(rng);
+
+	// Reject the biased tail so every value is equally likely
+	uint64_t limit = UINT64_MAX - UINT64_MAX % span;
+	uint64_t r;
+
+	do
+	{
+		r = rng_next(rng);
+	} while (r >= limit);
+
+	return lo + (size_t)(r % span);
+}
+
+// Heavy tails can go past anything a tick counter should hold
+#define DIST_MAX_VALUE 1e15
+
+size_t dst_sample(Distribution *dst, Random *rng)
+{
+	double x;
+
+	switch (dst->kind)
+	{
+	case DIST_EXPONENTIAL:
+		x = dst->b - dst->a * log(1.0 - rng_double(rng));
+		break;
+	case DIST_PARETO:
+		x = dst->a / pow(1.0 - rng_double(rng), 1.0 / dst->b);
+		break;
+	case DIST_UNIFORM:
+	default:
+		return rng_range(rng, (size_t)dst->a, (size_t)dst->b);
+	}
+
+	if (x > DIST_MAX_VALUE)
+		x = DIST_MAX_VALUE;
+
+	return (size_t)(x + 0.5);
+}
+
+/**
+ * Accepted forms are "lo:hi" or "uniform:lo:hi", "exp:mean" or
+ * "exp:mean:shift" and "pareto:scale:shape".
+ */
+Status dst_parse(Distribution *dst, char *text)
+{
+	if (dst == NULL || text == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	double a, b = 0;
+	int n;
+
+	if (strncmp(text, "exp:", 4) == 0)
+	{
+		n = sscanf(text + 4, "%lf:%lf", &a, &b);
+
+		if (n < 1 || a <= 0 || b < 0)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		dst->kind = DIST_EXPONENTIAL;
+	}
+	else if (strncmp(text, "pareto:", 7) == 0)
+	{
+		n = sscanf(text + 7, "%lf:%lf", &a, &b);
+
+		if (n != 2 || a <= 0 || b <= 0)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		dst->kind = DIST_PARETO;
+	}
+	else
+	{
+		unsigned long lo, hi;
+
+		if (strncmp(text, "uniform:", 8) == 0)
+			text += 8;
+
+		n = sscanf(text, "%lu:%lu", &lo, &hi);
+
+		if (n == 1)
+			hi = lo;
+		else if (n != 2)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		if (hi < lo)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		dst->kind = DIST_UNIFORM;
+
+		a = lo;
+		b = hi;
+	}
+
+	dst->a = a;
+	dst->b = b;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Random.c */
+
+/* ---------------------------------------------------------------------------------------------------- Workload.c */
+
+static char *process_type_names[PROCESS_TYPES] = {"SO", "UI", "UNI"};
+
+void wkl_default(WorkloadSpec *spec)
+{
+	spec->processes = 6;
+
+	spec->cpu = (Distribution){DIST_UNIFORM, 1, 10};
+	spec->io = (Distribution){DIST_UNIFORM, 0, 4};
+	spec->pri = (Distribution){DIST_UNIFORM, 0, PROCESS_MAX_PRI};
+
+	size_t i;
+	for (i = 0; i < PROCESS_TYPES; i++)
+		spec->types[i] = 1.0;
+
+	spec->periodic = false;
+	spec->period = (Distribution){DIST_UNIFORM, 10, 50};
+
+	spec->arriving = false;
+	spec->gap = (Distribution){DIST_UNIFORM, 0, 10};
+
+	spec->bursty = false;
+	spec->bursts = (Distribution){DIST_UNIFORM, 1, 8};
+}
+
+Status wkl_parse_types(WorkloadSpec *spec, char *text)
+{
+	if (spec == NULL || text == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	double w[PROCESS_TYPES];
+
+	if (sscanf(text, "%lf:%lf:%lf", &w[0], &w[1], &w[2]) != PROCESS_TYPES)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	if (w[0] < 0 || w[1] < 0 || w[2] < 0 || w[0] + w[1] + w[2] <= 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	size_t i;
+	for (i = 0; i < PROCESS_TYPES; i++)
+		spec->types[i] = w[i];
+
+	return DS_OK;
+}
+
+static size_t wkl_sample_type(WorkloadSpec *spec, Random *rng)
+{
+	double total = 0;
+
+	size_t i;
+	for (i = 0; i < PROCESS_TYPES; i++)
+		total += spec->types[i];
+
+	double r = rng_double(rng) * total;
+
+	for (i = 0; i < PROCESS_TYPES - 1; i++)
+	{
+		if (r < spec->types[i])
+			return i;
+
+		r -= spec->types[i];
+	}
+
+	return PROCESS_TYPES - 1;
+}
+
+/**
+ * Appends the bursts of one process to arena: CPU bursts drawn from cpu
+ * with the I/O bursts between them drawn from io, a draw of 0 taking one
+ * tick, and count gets how many there are.
+ */
+static Status wkl_bursts(WorkloadSpec *spec, Random *rng, BurstArena *arena, size_t *count)
+{
+	size_t cpus = dst_sample(&spec->bursts, rng);
+
+	*count = cpus > 0 ? 2 * cpus - 1 : 1;
+
+	Status st = brs_reserve(arena, *count);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t *burst = arena->burst + arena->length, i;
+
+	for (i = 0; i < *count; i++)
+	{
+		size_t value = dst_sample(i % 2 == 0 ? &spec->cpu : &spec->io, rng);
+
+		burst[i] = value > 0 ? value : 1;
+	}
+
+	arena->length += *count;
+
+	return DS_OK;
+}
+
+Status wkl_generate(WorkloadSpec *spec, Random *rng, QueueArray **result)
+{
+	if (spec == NULL || rng == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (spec->processes == 0)
+		return DS_ERR_INVALID_SIZE;
+
+	Status st = qua_init(result);
+
+	if (st != DS_OK)
+		return st;
+
+	// One arena for the bursts of the whole table
+	BurstArena *arena = NULL;
+
+	if (spec->bursty && (st = brs_init(&arena)) != DS_OK)
+		return st;
+
+	char buffer[32];
+
+	size_t i, arrival = 0;
+	for (i = 0; i < spec->processes && st == DS_OK; i++)
+	{
+		String *name, *type;
+		Process *process;
+
+		snprintf(buffer, sizeof(buffer), "Proc%lu", i);
+
+		st = str_make(&name, buffer);
+
+		if (st != DS_OK)
+			break;
+
+		// Draw in a fixed order so a stream always yields the same table
+		size_t cpu = 0, io = 0, first = 0, count = 0;
+
+		if (spec->bursty)
+		{
+			first = arena->length;
+
+			st = wkl_bursts(spec, rng, arena, &count);
+
+			if (st != DS_OK)
+				break;
+
+			cpu = arena->burst[first];
+		}
+		else
+		{
+			cpu = dst_sample(&spec->cpu, rng);
+			io = dst_sample(&spec->io, rng);
+		}
+
+		size_t pri = dst_sample(&spec->pri, rng);
+
+		st = str_make(&type, process_type_names[wkl_sample_type(spec, rng)]);
+
+		if (st != DS_OK)
+			break;
+
+		st = prc_init(&process, name, 1000 + i, cpu, io, pri, type);
+
+		if (st != DS_OK)
+			break;
+
+		if (count > 0)
+			prc_set_bursts(process, arena, first, count);
+
+		if (spec->periodic)
+			process->period = dst_sample(&spec->period, rng);
+
+		if (spec->arriving)
+			process->arrival = arrival += dst_sample(&spec->gap, rng);
+
+		st = qua_enqueue(*result, process);
+	}
+
+	brs_release(&arena);
+
+	return st;
+}
+
+/**
+ * Streams spec->processes rows straight into a buffered writer in the same
+ * format read by file_load, so the table never has to fit in memory.
+ */
+Status wkl_write(WorkloadSpec *spec, Random *rng, char *path)
+{
+	if (spec == NULL || rng == NULL || path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Writer *wrt;
+
+	Status st = wrt_open(&wrt, path);
+
+	if (st != DS_OK)
+		return st;
+
+	// Holds the bursts of one row at a time
+	BurstArena *arena = NULL;
+
+	if (spec->bursty)
+		st = brs_init(&arena);
+
+	size_t i, j, arrival = 0;
+	for (i = 0; i < spec->processes && st == DS_OK; i++)
+	{
+		size_t cpu = 0, io = 0, count = 0;
+
+		if (spec->bursty)
+		{
+			arena->length = 0;
+
+			st = wkl_bursts(spec, rng, arena, &count);
+		}
+		else
+		{
+			cpu = dst_sample(&spec->cpu, rng);
+			io = dst_sample(&spec->io, rng);
+		}
+
+		size_t pri = dst_sample(&spec->pri, rng);
+
+		char *type = process_type_names[wkl_sample_type(spec, rng)];
+
+		size_t period = spec->periodic ? dst_sample(&spec->period, rng) : 0;
+
+		if (spec->arriving)
+			arrival += dst_sample(&spec->gap, rng);
+
+		if (st == DS_OK)
+			st = wrt_write(wrt, "Proc", 4);
+		if (st == DS_OK)
+			st = wrt_size(wrt, i);
+		if (st == DS_OK)
+			st = wrt_char(wrt, ',');
+		if (st == DS_OK)
+			st = wrt_size(wrt, 1000 + i);
+		if (st == DS_OK)
+			st = wrt_char(wrt, ',');
+		if (st == DS_OK && count == 0)
+			st = wrt_size(wrt, cpu);
+		for (j = 0; j < count && st == DS_OK; j++)
+		{
+			if (j > 0)
+				st = wrt_char(wrt, '/');
+			if (st == DS_OK)
+				st = wrt_size(wrt, arena->burst[j]);
+		}
+		if (st == DS_OK)
+			st = wrt_char(wrt, ',');
+		if (st == DS_OK)
+			st = wrt_size(wrt, io);
+		if (st == DS_OK)
+			st = wrt_char(wrt, ',');
+		if (st == DS_OK)
+			st = wrt_size(wrt, pri);
+		if (st == DS_OK)
+			st = wrt_char(wrt, ',');
+		if (st == DS_OK)
+			st = wrt_string(wrt, type);
+		if (st == DS_OK && (period > 0 || arrival > 0))
+			st = wrt_char(wrt, ',');
+		if (st == DS_OK && (period > 0 || arrival > 0))
+			st = wrt_size(wrt, period);
+		if (st == DS_OK && arrival > 0)
+			st = wrt_write(wrt, ",0,", 3);
+		if (st == DS_OK && arrival > 0)
+			st = wrt_size(wrt, arrival);
+		if (st == DS_OK)
+			st = wrt_char(wrt, '\n');
+	}
+
+	brs_release(&arena);
+
+	Status cl = wrt_close(&wrt);
+
+	return st != DS_OK ? st : cl;
+}
+/* ---------------------------------------------------------------------------------------------------- Workload.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Workloads
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Monte Carlo
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- MonteCarlo.c */
+
+static char *mc_metric_names[MC_METRICS] = {"Turnaround (mean)", "Turnaround (p99)", "Waiting (mean)",
+											"Response (mean)", "Throughput", "CPU utilization", "Fairness (Jain)",
+											"Deadline misses"};
+
+typedef struct MonteCarloWorker
+{
+	MonteCarlo *mc; /*!< Shared run description */
+	size_t first;	/*!< First sample of this worker */
+	size_t stride;  /*!< Distance between two samples of this worker */
+	Status status;  /*!< Result of the worker */
+} MonteCarloWorker;
+
+Status mc_init(MonteCarlo **mc)
+{
+	(*mc) = malloc(sizeof(MonteCarlo));
+
+	if (!(*mc))
+		return DS_ERR_ALLOC;
+
+	wkl_default(&((*mc)->spec));
+
+	sch_default_params(&((*mc)->params));
+
+	(*mc)->samples = 100;
+	(*mc)->seed = 1;
+	(*mc)->values = NULL;
+
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	(*mc)->threads = cores > 0 ? (size_t)cores : 1;
+
+	size_t i;
+	for (i = 0; i < ALG_COUNT; i++)
+		(*mc)->algorithms[i] = true;
+
+	return DS_OK;
+}
+
+static double *mc_value(MonteCarlo *mc, size_t alg, size_t sample)
+{
+	return mc->values + (alg * mc->samples + sample) * MC_METRICS;
+}
+
+static Status mc_sample(MonteCarlo *mc, size_t sample)
+{
+	Random rng;
+	QueueArray *table;
+	Metrics *metrics = NULL;
+
+	rng_seed(&rng, mc->seed, sample);
+
+	Status st = wkl_generate(&mc->spec, &rng, &table);
+
+	if (st != DS_OK)
+		return st;
+
+	st = met_init(&metrics);
+
+	size_t alg;
+	for (alg = 0; st == DS_OK && alg < ALG_COUNT; alg++)
+	{
+		if (!mc->algorithms[alg])
+			continue;
+
+		QueueArray *queue, *finished;
+
+		st = qua_copy(table, &queue);
+
+		if (st != DS_OK)
+			break;
+
+		met_clear(metrics);
+
+		// Every sample draws its own lottery
+		SchedulerParams params = mc->params;
+
+		params.lottery_seed = mc->params.lottery_seed + sample;
+
+		st = alg_table[alg](queue, &finished, &params, metrics, NULL, false);
+
+		if (st == DS_OK)
+		{
+			double *value = mc_value(mc, alg, sample);
+
+			value[MC_TURNAROUND_MEAN] = sta_mean(&metrics->turnaround);
+			value[MC_TURNAROUND_P99] = (double)sta_percentile(&metrics->turnaround, 0.99);
+			value[MC_WAITING_MEAN] = sta_mean(&metrics->waiting);
+			value[MC_RESPONSE_MEAN] = sta_mean(&metrics->response);
+			value[MC_THROUGHPUT] = met_throughput(metrics);
+			value[MC_UTILIZATION] = met_utilization(metrics);
+			value[MC_FAIRNESS] = met_fairness(metrics);
+			value[MC_MISSES] = met_miss_ratio(metrics);
+
+			st = qua_delete(&finished);
+		}
+
+		Status dl = qua_delete(&queue);
+
+		if (st == DS_OK)
+			st = dl;
+	}
+
+	// One way out, so a failed sample frees its table like a finished one
+	if (metrics != NULL)
+		met_delete(&metrics);
+
+	Status dl = qua_delete(&table);
+
+	return st != DS_OK ? st : dl;
+}
+
+static void *mc_worker(void *arg)
+{
+	MonteCarloWorker *worker = arg;
+
+	size_t i;
+	for (i = worker->first; i < worker->mc->samples; i += worker->stride)
+	{
+		worker->status = mc_sample(worker->mc, i);
+
+		if (worker->status != DS_OK)
+			break;
+	}
+
+	return NULL;
+}
+
+Status mc_run(MonteCarlo *mc)
+{
+	if (mc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (mc->samples == 0 || mc->threads == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	free(mc->values);
+
+	mc->values = calloc(ALG_COUNT * mc->samples * MC_METRICS, sizeof(double));
+
+	if (!mc->values)
+		return DS_ERR_ALLOC;
+
+	size_t threads = mc->threads < mc->samples ? mc->threads : mc->samples;
+
+	pthread_t *ids = malloc(sizeof(pthread_t) * threads);
+	MonteCarloWorker *workers = malloc(sizeof(MonteCarloWorker) * threads);
+
+	if (!ids || !workers)
+	{
+		free(ids);
+		free(workers);
+
+		return DS_ERR_ALLOC;
+	}
+
+	Status st = DS_OK;
+
+	size_t i, started = 0;
+	for (i = 0; i < threads; i++)
+	{
+		workers[i] = (MonteCarloWorker){mc, i, threads, DS_OK};
+
+		if (pthread_create(&ids[i], NULL, mc_worker, &workers[i]) != 0)
+		{
+			st = DS_ERR_UNEXPECTED_RESULT;
+
+			break;
+		}
+
+		started++;
+	}
+
+	for (i = 0; i < started; i++)
+	{
+		pthread_join(ids[i], NULL);
+
+		if (workers[i].status != DS_OK)
+			st = workers[i].status;
+	}
+
+	free(ids);
+	free(workers);
+
+	return st;
+}
+
+// Two-sided 95% critical values of Student's t for 1 to 30 degrees of freedom
+static double mc_t_critical(size_t df)
+{
+	static const double table[30] = {
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+	if (df == 0)
+		return 0.0;
+
+	if (df <= 30)
+		return table[df - 1];
+
+	return 1.96;
+}
+
+Status mc_report(MonteCarlo *mc)
+{
+	if (mc == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (mc->values == NULL)
+		return DS_ERR_INVALID_OPERATION;
+
+	printf("\nMonte Carlo: %lu samples of %lu processes, seed %lu, %lu threads\n",
+		   mc->samples, mc->spec.processes, (unsigned long)mc->seed, mc->threads);
+
+	printf("\n%-30s %-20s %14s %14s\n", "Algorithm", "Metric", "Mean", "95% CI (+/-)");
+	printf("%-30s %-20s %14s %14s\n", "---------", "------", "----", "------------");
+
+	double t = mc_t_critical(mc->samples - 1);
+
+	size_t alg, m, i;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+	{
+		if (!mc->algorithms[alg])
+			continue;
+
+		for (m = 0; m < MC_METRICS; m++)
+		{
+			// Reduce in sample order so the sums do not depend on the thread count
+			double sum = 0, sq = 0;
+
+			for (i = 0; i < mc->samples; i++)
+				sum += mc_value(mc, alg, i)[m];
+
+			double mean = sum / mc->samples;
+
+			for (i = 0; i < mc->samples; i++)
+			{
+				double d = mc_value(mc, alg, i)[m] - mean;
+
+				sq += d * d;
+			}
+
+			double half = 0.0;
+
+			if (mc->samples > 1)
+				half = t * sqrt(sq / (mc->samples - 1)) / sqrt((double)mc->samples);
+
+			printf("%-30s %-20s %14.4f %14.4f\n", m == 0 ? alg_names[alg] : "",
+				   mc_metric_names[m], mean, half);
+		}
+	}
+
+	printf("\n");
+
+	return DS_OK;
+}
+
+Status mc_delete(MonteCarlo **mc)
+{
+	if ((*mc) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	free((*mc)->values);
+
+	free(*mc);
+
+	*mc = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- MonteCarlo.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Monte Carlo
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                           Snapshots
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Snapshot.c */
+
+// A process of the scheduler being written and the number of its record
+typedef struct SnapshotRef
+{
+	Process *prc;  /*!< Process */
+	size_t number; /*!< Position of its record */
+} SnapshotRef;
+
+/**
+ * @brief What a snapshot leaves out
+ */
+typedef enum SnapshotKind
+{
+	SNAPSHOT_WHOLE = 0,	/**< Nothing, the one of snp_take */
+	SNAPSHOT_PARTIAL = 1, /**< Finished processes and the ones waiting for their first arrival, a checkpoint log has them */
+	SNAPSHOT_TABLE = 2	/**< Processes waiting for their first arrival, the table file has them */
+} SnapshotKind;
+
+typedef struct SnapshotWriter
+{
+	Snapshot *snp;	 /*!< Output */
+	Scheduler *sch;	/*!< Scheduler being written */
+	SnapshotKind kind; /*!< What is left out */
+	SnapshotRef *refs; /*!< Every process written, sorted by address */
+	size_t processes;  /*!< Entries of refs */
+	Status st;		   /*!< First failure, nothing is written after it */
+} SnapshotWriter;
+
+typedef struct SnapshotReader
+{
+	const unsigned char *data; /*!< Encoded state */
+	size_t length;			   /*!< Bytes in data */
+	size_t position;		   /*!< Next byte to decode */
+	Process **processes;	   /*!< Processes decoded so far, by number */
+	size_t count;			   /*!< Entries of processes */
+	Status st;				   /*!< First failure, everything read after it is 0 or NULL */
+	BurstArena *arena;		   /*!< Bursts of the decoded processes, made by the first one with any */
+} SnapshotReader;
+
+// An empty one
+static Status snp_create(Snapshot **snp, size_t clock)
+{
+	(*snp) = malloc(sizeof(Snapshot));
+
+	if (!(*snp))
+		return DS_ERR_ALLOC;
+
+	(*snp)->buffer = malloc(SNAPSHOT_INIT_SIZE);
+
+	if (!(*snp)->buffer)
+	{
+		free(*snp);
+
+		*snp = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*snp)->length = 0;
+	(*snp)->capacity = SNAPSHOT_INIT_SIZE;
+	(*snp)->clock = clock;
+	(*snp)->table = NULL;
+	(*snp)->every = 0;
+
+	return DS_OK;
+}
+
+static bool snp_room(SnapshotWriter *wrt, size_t bytes)
+{
+	Snapshot *snp = wrt->snp;
+
+	if (wrt->st != DS_OK)
+		return false;
+
+	if (snp->length + bytes <= snp->capacity)
+		return true;
+
+	size_t capacity = snp->capacity;
+
+	while (capacity < snp->length + bytes)
+		capacity *= 2;
+
+	unsigned char *buffer = realloc(snp->buffer, capacity);
+
+	if (!buffer)
+	{
+		wrt->st = DS_ERR_ALLOC;
+
+		return false;
+	}
+
+	snp->buffer = buffer;
+	snp->capacity = capacity;
+
+	return true;
+}
+
+static void snp_put_varint(SnapshotWriter *wrt, uint64_t value)
+{
+	if (!snp_room(wrt, 10))
+		return;
+
+	Snapshot *snp = wrt->snp;
+
+	while (value >= 0x80)
+	{
+		snp->buffer[(snp->length)++] = (unsigned char)(value | 0x80);
+
+		value >>= 7;
+	}
+
+	snp->buffer[(snp->length)++] = (unsigned char)value;
+}
+
+static void snp_put_size(SnapshotWriter *wrt, size_t value)
+{
+	snp_put_varint(wrt, (uint64_t)value + 1);
+}
+
+static void snp_put_bytes(SnapshotWriter *wrt, const void *data, size_t length)
+{
+	if (!snp_room(wrt, length))
+		return;
+
+	memcpy(wrt->snp->buffer + wrt->snp->length, data, length);
+
+	wrt->snp->length += length;
+}
+
+static void snp_put_double(SnapshotWriter *wrt, double value)
+{
+	snp_put_bytes(wrt, &value, sizeof(double));
+}
+
+static void snp_put_string(SnapshotWriter *wrt, String *str)
+{
+	snp_put_size(wrt, str->len);
+	snp_put_bytes(wrt, str->buffer, str->len);
+}
+
+static int snp_compare_ref(const void *ref1, const void *ref2)
+{
+	uintptr_t prc1 = (uintptr_t)((const SnapshotRef *)ref1)->prc;
+	uintptr_t prc2 = (uintptr_t)((const SnapshotRef *)ref2)->prc;
+
+	return (prc1 > prc2) - (prc1 < prc2);
+}
+
+// The number of the record of prc, (size_t)-1 for NULL
+static void snp_put_ref(SnapshotWriter *wrt, Process *prc)
+{
+	size_t number = SIZE_MAX;
+
+	if (prc != NULL)
+	{
+		SnapshotRef key = {prc, 0};
+
+		SnapshotRef *ref = bsearch(&key, wrt->refs, wrt->processes, sizeof(SnapshotRef), snp_compare_ref);
+
+		// Every process a structure holds is finished or in the index
+		if (ref == NULL)
+		{
+			wrt->st = DS_ERR_UNEXPECTED_RESULT;
+
+			return;
+		}
+
+		number = ref->number;
+	}
+
+	snp_put_size(wrt, number);
+}
+
+// Whether a checkpoint leaves prc out: it waits for its first arrival and
+// no kill or priority change reached it, so it is still a row of the table
+static bool snp_pending(Scheduler *sch, Process *prc)
+{
+	if (prc->job > 0 || prc->arrival <= sch->clock)
+		return false;
+
+	size_t i;
+	for (i = 0; i < sch->event; i++)
+	{
+		if (sch->params.event[i].pid == prc->pid)
+			return false;
+	}
+
+	return true;
+}
+
+static void snp_put_process(SnapshotWriter *wrt, Process *prc)
+{
+	snp_put_string(wrt, prc->name);
+	snp_put_string(wrt, prc->type);
+
+	snp_put_size(wrt, prc->bursts);
+
+	if (prc->bursts > 0)
+	{
+		size_t i;
+		for (i = 0; i < prc->bursts; i++)
+			snp_put_size(wrt, prc->arena->burst[prc->first_burst + i]);
+
+		snp_put_size(wrt, prc->burst);
+	}
+
+#define X(field) snp_put_size(wrt, (size_t)prc->field);
+	PROCESS_FIELDS(X)
+#undef X
+}
+
+// Only the buckets in use, each one as its distance to the previous one
+// and its count. None is past the one of the largest value.
+static void snp_put_statistic(SnapshotWriter *wrt, Statistic *sta)
+{
+	size_t i, used = 0, last = 0, end = sta->count > 0 ? sta_bucket(sta->max) + 1 : 0;
+
+	for (i = 0; i < end; i++)
+		if (sta->buckets[i] != 0)
+			used++;
+
+	snp_put_size(wrt, sta->count);
+	snp_put_double(wrt, sta->sum);
+	snp_put_size(wrt, sta->max);
+	snp_put_size(wrt, used);
+
+	for (i = 0; i < end; i++)
+	{
+		if (sta->buckets[i] == 0)
+			continue;
+
+		snp_put_size(wrt, i - last);
+		snp_put_size(wrt, sta->buckets[i]);
+
+		last = i;
+	}
+}
+
+static void snp_put_metrics(SnapshotWriter *wrt, Metrics *met)
+{
+	snp_put_statistic(wrt, &met->turnaround);
+	snp_put_statistic(wrt, &met->waiting);
+	snp_put_statistic(wrt, &met->response);
+	snp_put_double(wrt, met->slowdown);
+	snp_put_double(wrt, met->slowdown_sq);
+	snp_put_size(wrt, met->jobs);
+	snp_put_size(wrt, met->misses);
+	snp_put_size(wrt, met->finished);
+	snp_put_size(wrt, met->killed);
+	snp_put_size(wrt, met->busy);
+	snp_put_size(wrt, met->ticks);
+}
+
+static void snp_put_params(SnapshotWriter *wrt, SchedulerParams *params)
+{
+	snp_put_size(wrt, params->aging);
+	snp_put_size(wrt, params->mlfq_levels);
+
+	size_t i;
+	for (i = 0; i < params->mlfq_levels; i++)
+		snp_put_size(wrt, params->mlfq_quantum[i]);
+
+	snp_put_size(wrt, params->mlfq_boost);
+	snp_put_size(wrt, params->cfs_latency);
+	snp_put_size(wrt, params->cfs_granularity);
+	snp_put_varint(wrt, params->lottery_seed);
+	snp_put_size(wrt, params->horizon);
+	snp_put_size(wrt, params->events);
+
+	for (i = 0; i < params->events; i++)
+	{
+		snp_put_size(wrt, params->event[i].tick);
+		snp_put_size(wrt, params->event[i].pid);
+		snp_put_size(wrt, params->event[i].pri);
+	}
+}
+
+// Nodes in buffer order, so the heap comes back as it was
+static void snp_put_heap(SnapshotWriter *wrt, IndexedHeap *ihp)
+{
+	size_t length = ihp->length, i;
+
+	if (wrt->kind != SNAPSHOT_WHOLE)
+	{
+		for (i = 0; i < ihp->length; i++)
+		{
+			if (snp_pending(wrt->sch, ihp->buffer[i].data))
+				length--;
+		}
+	}
+
+	snp_put_size(wrt, ihp->order);
+	snp_put_size(wrt, length);
+
+	for (i = 0; i < ihp->length; i++)
+	{
+		if (wrt->kind != SNAPSHOT_WHOLE && snp_pending(wrt->sch, ihp->buffer[i].data))
+			continue;
+
+		snp_put_size(wrt, ihp->buffer[i].key);
+		snp_put_size(wrt, ihp->buffer[i].order);
+		snp_put_ref(wrt, ihp->buffer[i].data);
+	}
+}
+
+static void snp_put_ring(SnapshotWriter *wrt, RingBuffer *rbf)
+{
+	snp_put_size(wrt, rbf->length);
+
+	size_t i;
+	for (i = 0; i < rbf->length; i++)
+		snp_put_ref(wrt, rbf->buffer[(rbf->front + i) & (rbf->capacity - 1)]);
+}
+
+// The ready queue of the policy of sch, whichever kind it is
+static void snp_put_ready(SnapshotWriter *wrt, Scheduler *sch)
+{
+	const Policy *pol = policies[sch->policy];
+
+	size_t i;
+
+	if (pol->init == rq_fifo_init)
+		snp_put_ring(wrt, sch->ready.fifo);
+	else if (pol->init == rq_prq_init)
+	{
+		// Priorities and insertion numbers give the order on every backend
+		PriorityQueue *prq = sch->ready.prq;
+
+		PriorityQueueNode *node;
+
+		size_t cursor = 0;
+
+		snp_put_size(wrt, prq->order);
+		snp_put_size(wrt, prq->length);
+
+		while ((node = prq_next(prq, &cursor)) != NULL)
+		{
+			snp_put_size(wrt, node->priority);
+			snp_put_size(wrt, node->order);
+			snp_put_ref(wrt, node->data);
+		}
+	}
+	else if (pol->init == rq_heap_init)
+		snp_put_heap(wrt, sch->ready.heap);
+	else if (pol->init == rq_mlq_init)
+	{
+		MultilevelQueue *mlq = sch->ready.mlq;
+
+		snp_put_size(wrt, mlq->generation);
+
+		for (i = 0; i < mlq->levels; i++)
+			snp_put_ring(wrt, mlq->queue[i]);
+	}
+	else if (pol->init == rq_cfs_init)
+	{
+		RedBlackTree *rbt = sch->ready.cfs->tree;
+
+		snp_put_size(wrt, sch->ready.cfs->min_vruntime);
+		snp_put_size(wrt, sch->ready.cfs->load);
+		snp_put_size(wrt, rbt->order);
+		snp_put_size(wrt, rbt->length);
+
+		// In order, from the leftmost node
+		RedBlackNode *node = rbt->leftmost;
+
+		while (node != NULL)
+		{
+			snp_put_size(wrt, node->key);
+			snp_put_size(wrt, node->order);
+			snp_put_ref(wrt, node->data);
+
+			if (node->right != NULL)
+			{
+				node = node->right;
+
+				while (node->left != NULL)
+					node = node->left;
+			}
+			else
+			{
+				while (node->parent != NULL && node == node->parent->right)
+					node = node->parent;
+
+				node = node->parent;
+			}
+		}
+	}
+	else if (pol->init == rq_lottery_init)
+	{
+		// Positions as they are, the draws depend on them
+		LotteryPool *lot = sch->ready.lottery;
+
+		snp_put_size(wrt, lot->capacity);
+		snp_put_size(wrt, lot->used);
+
+		for (i = 0; i < 4; i++)
+			snp_put_varint(wrt, lot->rng.state[i]);
+
+		for (i = 1; i <= lot->used; i++)
+		{
+			snp_put_size(wrt, lot->tickets[i]);
+			snp_put_ref(wrt, lot->owner[i]);
+		}
+
+		snp_put_size(wrt, lot->spares);
+
+		for (i = 0; i < lot->spares; i++)
+			snp_put_size(wrt, lot->spare[i]);
+	}
+	else
+		wrt->st = DS_ERR_INVALID_ARGUMENT;
+}
+
+/**
+ * Layout: magic, version, its kind, policy, clock, the parameters, the
+ * scalars of the scheduler, the number of process records and how many of
+ * them are of finished processes, then one record per process with its
+ * bursts, the finished ones first in completion order and then the ones in
+ * the index in slot order. After them come the running and blocked
+ * processes, which slots of the index are in use, the timers, the ready
+ * queue and the metrics.
+ *
+ * A partial snapshot, the one a checkpoint log keeps, has no finished
+ * processes and no processes waiting for their first arrival, only how many
+ * of them there are, and no slots: the log has the first ones and the table
+ * the others, and restoring it rebuilds the index. A table snapshot only
+ * leaves out the second ones, and has the size and modification time of the
+ * table file after their count.
+ */
+static Status snp_encode(Snapshot **snp, Scheduler *sch, SnapshotKind kind, const char *table)
+{
+	if (sch == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	struct stat info;
+
+	if (kind == SNAPSHOT_TABLE && stat(table, &info) != 0)
+		return DS_ERR_NOT_FOUND;
+
+	Status st = snp_create(snp, sch->clock);
+
+	if (st != DS_OK)
+		return st;
+
+	ProcessIndex *pix = sch->index;
+
+	size_t finished = kind == SNAPSHOT_PARTIAL ? 0 : sch->finished->length, count = finished, pending = 0, i,
+		   number = 0;
+
+	for (i = 0; i < pix->capacity; i++)
+	{
+		if (pix->slots[i] == NULL)
+			continue;
+
+		if (kind != SNAPSHOT_WHOLE && snp_pending(sch, pix->slots[i]))
+			pending++;
+		else
+			count++;
+	}
+
+	SnapshotRef *refs = malloc(sizeof(SnapshotRef) * (count > 0 ? count : 1));
+
+	if (!refs)
+	{
+		snp_delete(snp);
+
+		return DS_ERR_ALLOC;
+	}
+
+	for (i = 0; i < finished; i++, number++)
+		refs[number] = (SnapshotRef){sch->finished->buffer[i], number};
+
+	for (i = 0; i < pix->capacity; i++)
+	{
+		if (pix->slots[i] != NULL && !(kind != SNAPSHOT_WHOLE && snp_pending(sch, pix->slots[i])))
+			refs[number] = (SnapshotRef){pix->slots[i], number}, number++;
+	}
+
+	qsort(refs, count, sizeof(SnapshotRef), snp_compare_ref);
+
+	SnapshotWriter wrt = {*snp, sch, kind, refs, count, DS_OK};
+
+	snp_put_varint(&wrt, SNAPSHOT_MAGIC);
+	snp_put_size(&wrt, SNAPSHOT_VERSION);
+	snp_put_size(&wrt, kind);
+	snp_put_size(&wrt, sch->policy);
+	snp_put_size(&wrt, sch->clock);
+
+	snp_put_params(&wrt, &sch->params);
+
+	snp_put_size(&wrt, sch->queued);
+	snp_put_size(&wrt, sch->slice);
+	snp_put_size(&wrt, sch->dispatched);
+	snp_put_size(&wrt, sch->event);
+	snp_put_size(&wrt, sch->hyperperiod);
+
+	snp_put_size(&wrt, count);
+	snp_put_size(&wrt, finished);
+
+	if (kind == SNAPSHOT_PARTIAL)
+	{
+		snp_put_size(&wrt, sch->finished->length);
+		snp_put_size(&wrt, pending);
+	}
+	else if (kind == SNAPSHOT_TABLE)
+	{
+		snp_put_size(&wrt, pending);
+		snp_put_size(&wrt, (size_t)info.st_size);
+		snp_put_size(&wrt, (size_t)info.st_mtim.tv_sec);
+		snp_put_size(&wrt, (size_t)info.st_mtim.tv_nsec);
+	}
+
+	for (i = 0; i < finished; i++)
+		snp_put_process(&wrt, sch->finished->buffer[i]);
+
+	for (i = 0; i < pix->capacity; i++)
+	{
+		if (pix->slots[i] != NULL && !(kind != SNAPSHOT_WHOLE && snp_pending(sch, pix->slots[i])))
+			snp_put_process(&wrt, pix->slots[i]);
+	}
+
+	snp_put_ref(&wrt, sch->running);
+	snp_put_ref(&wrt, sch->blocked);
+
+	if (kind == SNAPSHOT_WHOLE)
+	{
+		snp_put_size(&wrt, pix->capacity);
+
+		for (i = 0; i < pix->capacity; i++)
+			snp_put_size(&wrt, pix->slots[i] != NULL);
+	}
+
+	snp_put_heap(&wrt, sch->timers);
+
+	snp_put_ready(&wrt, sch);
+
+	snp_put_size(&wrt, sch->metrics != NULL);
+
+	if (sch->metrics != NULL)
+		snp_put_metrics(&wrt, sch->metrics);
+
+	free(refs);
+
+	if (wrt.st == DS_OK && kind == SNAPSHOT_TABLE)
+	{
+		(*snp)->table = malloc(strlen(table) + 1);
+
+		if (!(*snp)->table)
+			wrt.st = DS_ERR_ALLOC;
+		else
+			strcpy((*snp)->table, table);
+	}
+
+	if (wrt.st != DS_OK)
+	{
+		snp_delete(snp);
+
+		return wrt.st;
+	}
+
+	return DS_OK;
+}
+
+Status snp_take(Snapshot **snp, Scheduler *sch)
+{
+	return snp_encode(snp, sch, SNAPSHOT_WHOLE, NULL);
+}
+
+/**
+ * A snapshot of a run that was given every row of the table file at path
+ * at tick 0, in the order file_load_table reads them, without the processes
+ * that did not arrive yet. Restoring it reads them from the table again, so
+ * it is about as large as the processes in the run and not the whole table.
+ */
+Status snp_take_table(Snapshot **snp, Scheduler *sch, const char *table)
+{
+	if (table == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	return snp_encode(snp, sch, SNAPSHOT_TABLE, table);
+}
+
+static void snp_fail(SnapshotReader *rdr, Status st)
+{
+	if (rdr->st == DS_OK)
+		rdr->st = st;
+}
+
+static uint64_t snp_get_varint(SnapshotReader *rdr)
+{
+	uint64_t value = 0;
+
+	unsigned shift;
+	for (shift = 0; rdr->st == DS_OK && rdr->position < rdr->length && shift < 64; shift += 7)
+	{
+		unsigned char byte = rdr->data[(rdr->position)++];
+
+		value |= (uint64_t)(byte & 0x7f) << shift;
+
+		if (!(byte & 0x80))
+			return value;
+	}
+
+	snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+	return 0;
+}
+
+static size_t snp_get_size(SnapshotReader *rdr)
+{
+	return (size_t)(snp_get_varint(rdr) - 1);
+}
+
+// A number of things that take at least a byte each, so a damaged count
+// cannot ask for more memory than the snapshot has
+static size_t snp_get_count(SnapshotReader *rdr)
+{
+	size_t count = snp_get_size(rdr);
+
+	if (rdr->st != DS_OK || count > rdr->length - rdr->position)
+	{
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+		return 0;
+	}
+
+	return count;
+}
+
+static double snp_get_double(SnapshotReader *rdr)
+{
+	double value = 0;
+
+	if (rdr->st != DS_OK || rdr->length - rdr->position < sizeof(double))
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+	else
+	{
+		memcpy(&value, rdr->data + rdr->position, sizeof(double));
+
+		rdr->position += sizeof(double);
+	}
+
+	return value;
+}
+
+static String *snp_get_string(SnapshotReader *rdr)
+{
+	String *str = NULL;
+
+	size_t length = snp_get_count(rdr);
+
+	if (rdr->st != DS_OK)
+		return NULL;
+
+	Status st = file_make_string(&str, (const char *)rdr->data + rdr->position, length);
+
+	if (st != DS_OK)
+	{
+		snp_fail(rdr, st);
+
+		return NULL;
+	}
+
+	rdr->position += length;
+
+	return str;
+}
+
+// A reference that cannot be NULL, to a process that has not finished
+static Process *snp_get_member(SnapshotReader *rdr, size_t finished)
+{
+	size_t number = snp_get_size(rdr);
+
+	if (rdr->st != DS_OK || number < finished || number >= rdr->count)
+	{
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+		return NULL;
+	}
+
+	return rdr->processes[number];
+}
+
+// NULL for (size_t)-1, or else a process that has not finished
+static Process *snp_get_optional(SnapshotReader *rdr, size_t finished)
+{
+	size_t number = snp_get_size(rdr);
+
+	if (rdr->st != DS_OK || number == SIZE_MAX)
+		return NULL;
+
+	if (number < finished || number >= rdr->count)
+	{
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+		return NULL;
+	}
+
+	return rdr->processes[number];
+}
+
+static Process *snp_get_process(SnapshotReader *rdr)
+{
+	String *name = snp_get_string(rdr), *type = snp_get_string(rdr);
+
+	Process *prc = NULL;
+
+	if (rdr->st == DS_OK)
+	{
+		Status st = prc_init(&prc, name, 0, 0, 0, 0, type);
+
+		if (st != DS_OK)
+			snp_fail(rdr, st);
+	}
+
+	if (rdr->st != DS_OK)
+	{
+		if (name != NULL)
+			str_delete(&name);
+
+		if (type != NULL)
+			str_delete(&type);
+
+		return NULL;
+	}
+
+	size_t bursts = snp_get_count(rdr), burst = 0;
+
+	if (bursts % 2 == 0 && bursts > 0)
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+	if (bursts > 0 && rdr->st == DS_OK)
+	{
+		Status st = rdr->arena == NULL ? brs_init(&rdr->arena) : DS_OK;
+
+		if (st == DS_OK)
+			st = brs_reserve(rdr->arena, bursts);
+
+		if (st != DS_OK)
+			snp_fail(rdr, st);
+	}
+
+	if (bursts > 0 && rdr->st == DS_OK)
+	{
+		size_t *next = rdr->arena->burst + rdr->arena->length, i;
+
+		for (i = 0; i < bursts; i++)
+		{
+			next[i] = snp_get_size(rdr);
+
+			if (next[i] == 0)
+				snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+		}
+
+		burst = snp_get_size(rdr);
+
+		if (burst >= bursts)
+			snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+		if (rdr->st == DS_OK)
+		{
+			prc_set_bursts(prc, rdr->arena, rdr->arena->length, bursts);
+
+			rdr->arena->length += bursts;
+		}
+	}
+
+#define X(field) prc->field = snp_get_size(rdr);
+	PROCESS_FIELDS(X)
+#undef X
+
+	prc->burst = prc->arena != NULL ? burst : 0;
+
+	return prc;
+}
+
+static void snp_get_statistic(SnapshotReader *rdr, Statistic *sta)
+{
+	sta->count = snp_get_size(rdr);
+	sta->sum = snp_get_double(rdr);
+	sta->max = snp_get_size(rdr);
+
+	memset(sta->buckets, 0, sizeof(sta->buckets));
+
+	size_t used = snp_get_count(rdr), bucket = 0, i;
+
+	for (i = 0; i < used && rdr->st == DS_OK; i++)
+	{
+		bucket += snp_get_size(rdr);
+
+		if (bucket >= STATISTIC_BUCKETS)
+			snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+		else
+			sta->buckets[bucket] = snp_get_size(rdr);
+	}
+}
+
+static void snp_get_metrics(SnapshotReader *rdr, Metrics *met)
+{
+	snp_get_statistic(rdr, &met->turnaround);
+	snp_get_statistic(rdr, &met->waiting);
+	snp_get_statistic(rdr, &met->response);
+	met->slowdown = snp_get_double(rdr);
+	met->slowdown_sq = snp_get_double(rdr);
+	met->jobs = snp_get_size(rdr);
+	met->misses = snp_get_size(rdr);
+	met->finished = snp_get_size(rdr);
+	met->killed = snp_get_size(rdr);
+	met->busy = snp_get_size(rdr);
+	met->ticks = snp_get_size(rdr);
+}
+
+static void snp_get_params(SnapshotReader *rdr, SchedulerParams *params)
+{
+	params->aging = snp_get_size(rdr);
+	params->mlfq_levels = snp_get_size(rdr);
+
+	if (params->mlfq_levels == 0 || params->mlfq_levels > MLFQ_MAX_LEVELS)
+	{
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+		return;
+	}
+
+	size_t i;
+	for (i = 0; i < params->mlfq_levels; i++)
+		params->mlfq_quantum[i] = snp_get_size(rdr);
+
+	params->mlfq_boost = snp_get_size(rdr);
+	params->cfs_latency = snp_get_size(rdr);
+	params->cfs_granularity = snp_get_size(rdr);
+	params->lottery_seed = snp_get_varint(rdr);
+	params->horizon = snp_get_size(rdr);
+	params->events = snp_get_size(rdr);
+
+	if (params->events > SCHEDULER_MAX_EVENTS)
+	{
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+		return;
+	}
+
+	for (i = 0; i < params->events; i++)
+	{
+		params->event[i].tick = snp_get_size(rdr);
+		params->event[i].pid = snp_get_size(rdr);
+		params->event[i].pri = snp_get_size(rdr);
+	}
+}
+
+// Nodes back where they were, or pushed again when some were left out
+static void snp_get_heap(SnapshotReader *rdr, IndexedHeap *ihp, size_t finished, bool push)
+{
+	size_t order = snp_get_size(rdr), length = snp_get_count(rdr), i;
+
+	for (i = 0; push && i < length && rdr->st == DS_OK; i++)
+	{
+		size_t key = snp_get_size(rdr);
+
+		ihp->order = snp_get_size(rdr);
+
+		Process *prc = snp_get_member(rdr, finished);
+
+		if (prc != NULL)
+		{
+			Status st = ihp_push(ihp, prc, key);
+
+			if (st != DS_OK)
+				snp_fail(rdr, st);
+		}
+	}
+
+	if (push)
+		length = 0;
+
+	if (length > ihp->capacity)
+	{
+		IndexedHeapNode *buffer = realloc(ihp->buffer, sizeof(IndexedHeapNode) * length);
+
+		if (!buffer)
+		{
+			snp_fail(rdr, DS_ERR_ALLOC);
+
+			return;
+		}
+
+		ihp->buffer = buffer;
+		ihp->capacity = length;
+	}
+
+	while (ihp->length < length && rdr->st == DS_OK)
+	{
+		IndexedHeapNode node;
+
+		node.key = snp_get_size(rdr);
+		node.order = snp_get_size(rdr);
+		node.data = snp_get_member(rdr, finished);
+
+		if (rdr->st != DS_OK)
+			break;
+
+		ihp->buffer[ihp->length] = node;
+
+		node.data->slot = (ihp->length)++;
+	}
+
+	ihp->order = order;
+}
+
+// The same slots, so the index finds the same process for every PID
+static void snp_get_slots(SnapshotReader *rdr, ProcessIndex *pix, size_t finished)
+{
+	size_t capacity = snp_get_count(rdr), next = finished, i;
+
+	if (rdr->st == DS_OK && (capacity < PROCESS_INDEX_INIT_SIZE || (capacity & (capacity - 1)) != 0))
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+	if (rdr->st != DS_OK)
+		return;
+
+	Process **slots = calloc(capacity, sizeof(Process *));
+
+	if (!slots)
+	{
+		snp_fail(rdr, DS_ERR_ALLOC);
+
+		return;
+	}
+
+	free(pix->slots);
+
+	pix->slots = slots;
+	pix->capacity = capacity;
+
+	for (i = 0; i < capacity && rdr->st == DS_OK; i++)
+	{
+		if (snp_get_size(rdr) == 0)
+			continue;
+
+		if (next == rdr->count)
+			snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+		else
+			pix->slots[i] = rdr->processes[next++];
+	}
+
+	pix->length = next - finished;
+
+	if (rdr->st == DS_OK && next != rdr->count)
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+}
+
+static void snp_get_ring(SnapshotReader *rdr, RingBuffer *rbf, size_t finished)
+{
+	size_t length = snp_get_count(rdr), i;
+
+	for (i = 0; i < length && rdr->st == DS_OK; i++)
+	{
+		Process *prc = snp_get_member(rdr, finished);
+
+		if (prc != NULL)
+		{
+			Status st = rbf_enqueue(rbf, prc);
+
+			if (st != DS_OK)
+				snp_fail(rdr, st);
+		}
+	}
+}
+
+static void snp_get_lottery(SnapshotReader *rdr, LotteryPool *lot, size_t finished)
+{
+	size_t capacity = snp_get_size(rdr), used = snp_get_count(rdr), i;
+
+	// Positions are only added when all of them are in use
+	if (rdr->st != DS_OK || (capacity & (capacity - 1)) != 0 || capacity < LOTTERY_POOL_INIT_SIZE ||
+		used > capacity || (capacity > LOTTERY_POOL_INIT_SIZE && capacity > 2 * used))
+	{
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+		return;
+	}
+
+	if (capacity > lot->capacity)
+	{
+		size_t *tree = calloc(capacity + 1, sizeof(size_t)), *tickets = calloc(capacity + 1, sizeof(size_t));
+		size_t *spare = malloc(sizeof(size_t) * (capacity + 1));
+		Process **owner = calloc(capacity + 1, sizeof(Process *));
+
+		if (!tree || !tickets || !spare || !owner)
+		{
+			free(tree);
+			free(tickets);
+			free(spare);
+			free(owner);
+
+			snp_fail(rdr, DS_ERR_ALLOC);
+
+			return;
+		}
+
+		free(lot->tree);
+		free(lot->tickets);
+		free(lot->spare);
+		free(lot->owner);
+
+		lot->tree = tree;
+		lot->tickets = tickets;
+		lot->spare = spare;
+		lot->owner = owner;
+		lot->capacity = capacity;
+	}
+
+	for (i = 0; i < 4; i++)
+		lot->rng.state[i] = snp_get_varint(rdr);
+
+	for (i = 1; i <= used && rdr->st == DS_OK; i++)
+	{
+		size_t tickets = snp_get_size(rdr);
+
+		Process *prc = snp_get_optional(rdr, finished);
+
+		if (rdr->st != DS_OK)
+			break;
+
+		if (prc == NULL && tickets > 0)
+		{
+			snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+
+			break;
+		}
+
+		lot->used = i;
+		lot->owner[i] = prc;
+		lot->tickets[i] = tickets;
+		lot->total += tickets;
+
+		if (tickets > 0)
+			(lot->length)++;
+
+		if (prc != NULL)
+			prc->slot = i;
+	}
+
+	lot_build(lot);
+
+	lot->spares = snp_get_count(rdr);
+
+	if (lot->spares > used)
+	{
+		lot->spares = 0;
+
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+	}
+
+	for (i = 0; i < lot->spares; i++)
+	{
+		lot->spare[i] = snp_get_size(rdr);
+
+		if (lot->spare[i] == 0 || lot->spare[i] > used)
+			snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+	}
+}
+
+static void snp_get_ready(SnapshotReader *rdr, Scheduler *sch, size_t finished)
+{
+	const Policy *pol = policies[sch->policy];
+
+	size_t i;
+
+	if (pol->init == rq_fifo_init)
+		snp_get_ring(rdr, sch->ready.fifo, finished);
+	else if (pol->init == rq_prq_init)
+	{
+		PriorityQueue *prq = sch->ready.prq;
+
+		size_t order = snp_get_size(rdr), length = snp_get_count(rdr);
+
+		for (i = 0; i < length && rdr->st == DS_OK; i++)
+		{
+			size_t priority = snp_get_size(rdr);
+
+			prq->order = snp_get_size(rdr);
+
+			Process *prc = snp_get_member(rdr, finished);
+
+			if (prc != NULL)
+			{
+				Status st = prq_enqueue(prq, prc, priority);
+
+				if (st != DS_OK)
+					snp_fail(rdr, st);
+			}
+		}
+
+		prq->order = order;
+	}
+	else if (pol->init == rq_heap_init)
+		snp_get_heap(rdr, sch->ready.heap, finished, false);
+	else if (pol->init == rq_mlq_init)
+	{
+		MultilevelQueue *mlq = sch->ready.mlq;
+
+		mlq->generation = snp_get_size(rdr);
+
+		for (i = 0; i < mlq->levels && rdr->st == DS_OK; i++)
+		{
+			snp_get_ring(rdr, mlq->queue[i], finished);
+
+			if (rbf_is_empty(mlq->queue[i]))
+				continue;
+
+			mlq->occupied |= (uint64_t)1 << i;
+
+			// What the last boost left unserved, from the generations
+			if (mlq_front(mlq, i)->generation != mlq->generation)
+				mlq->pending |= (uint64_t)1 << i;
+
+			mlq->length += mlq->queue[i]->length;
+		}
+	}
+	else if (pol->init == rq_cfs_init)
+	{
+		RedBlackTree *rbt = sch->ready.cfs->tree;
+
+		sch->ready.cfs->min_vruntime = snp_get_size(rdr);
+		sch->ready.cfs->load = snp_get_size(rdr);
+
+		size_t order = snp_get_size(rdr), length = snp_get_count(rdr);
+
+		for (i = 0; i < length && rdr->st == DS_OK; i++)
+		{
+			size_t key = snp_get_size(rdr);
+
+			rbt->order = snp_get_size(rdr);
+
+			Process *prc = snp_get_member(rdr, finished);
+
+			if (prc != NULL)
+			{
+				Status st = rbt_insert(rbt, prc, key);
+
+				if (st != DS_OK)
+					snp_fail(rdr, st);
+			}
+		}
+
+		rbt->order = order;
+	}
+	else if (pol->init == rq_lottery_init)
+		snp_get_lottery(rdr, sch->ready.lottery, finished);
+	else
+		snp_fail(rdr, DS_ERR_INVALID_ARGUMENT);
+}
+
+// Empties every structure of a scheduler that failed to restore without
+// deleting its processes, which are only in the reader
+static void snp_release(Scheduler *sch)
+{
+	const Policy *pol = policies[sch->policy];
+
+	Process *prc;
+
+	size_t i;
+
+	sch->finished->length = 0;
+	sch->timers->length = 0;
+	sch->running = NULL;
+	sch->blocked = NULL;
+
+	if (pol->init == rq_fifo_init)
+		sch->ready.fifo->length = 0;
+	else if (pol->init == rq_prq_init)
+	{
+		while (!prq_is_empty(sch->ready.prq))
+			prq_dequeue(sch->ready.prq, &prc);
+	}
+	else if (pol->init == rq_heap_init)
+		sch->ready.heap->length = 0;
+	else if (pol->init == rq_mlq_init)
+	{
+		for (i = 0; i < sch->ready.mlq->levels; i++)
+			sch->ready.mlq->queue[i]->length = 0;
+	}
+	else if (pol->init == rq_cfs_init)
+	{
+		while (!rbt_is_empty(sch->ready.cfs->tree))
+			rbt_pop_min(sch->ready.cfs->tree, &prc);
+	}
+	else if (pol->init == rq_lottery_init)
+	{
+		for (i = 1; i <= sch->ready.lottery->used; i++)
+			sch->ready.lottery->owner[i] = NULL;
+	}
+}
+
+// DS_ERR_NOT_FOUND when the table of a snapshot is gone and
+// DS_ERR_INVALID_ARGUMENT when it is not the file it was taken with
+static Status snp_check_table(const char *table, size_t size, size_t seconds, size_t nanoseconds)
+{
+	struct stat info;
+
+	if (table == NULL)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	if (stat(table, &info) != 0)
+		return DS_ERR_NOT_FOUND;
+
+	if ((size_t)info.st_size != size || (size_t)info.st_mtim.tv_sec != seconds ||
+		(size_t)info.st_mtim.tv_nsec != nanoseconds)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	return DS_OK;
+}
+
+/**
+ * Submits again the rows of table that a snapshot of snp_take_table left
+ * out, the ones still waiting for their first arrival, with the insertion
+ * numbers they took when every row was submitted at tick 0.
+ * DS_ERR_INVALID_ARGUMENT when they do not add up to pending.
+ */
+static Status snp_refill(Scheduler *sch, const char *table, size_t pending)
+{
+	QueueArray *rows;
+
+	Status st = file_load_table(table, &rows);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t rank = 0, i;
+
+	for (i = 0; i < rows->length && st == DS_OK; i++)
+	{
+		Process *row = rows->buffer[i], *prc;
+
+		if (row->arrival == 0)
+			continue;
+
+		rank++;
+
+		if (!snp_pending(sch, row))
+			continue;
+
+		if (pending == 0)
+		{
+			st = DS_ERR_INVALID_ARGUMENT;
+
+			break;
+		}
+
+		pending--;
+
+		st = prc_copy(row, &prc);
+
+		if (st == DS_OK)
+			st = sch_submit_ordered(sch, prc, rank - 1);
+	}
+
+	Status dl = qua_delete(&rows);
+
+	if (st == DS_OK && pending > 0)
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	return st != DS_OK ? st : dl;
+}
+
+/**
+ * finished and pending are NULL for a snapshot of snp_take or
+ * snp_take_table. For a partial one they get how many processes had
+ * finished and how many were left out waiting for their first arrival, and
+ * the scheduler has neither of them.
+ */
+static Status snp_decode(Snapshot *snp, Scheduler **sch, Metrics *metrics, size_t *finished, size_t *pending)
+{
+	if (snp == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	SnapshotReader rdr = {snp->buffer, snp->length, 0, NULL, 0, DS_OK, NULL};
+
+	SchedulerParams params;
+
+	bool partial = finished != NULL;
+
+	if (snp_get_varint(&rdr) != SNAPSHOT_MAGIC || snp_get_size(&rdr) != SNAPSHOT_VERSION)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	size_t kind = snp_get_size(&rdr);
+
+	if (partial ? kind != SNAPSHOT_PARTIAL : kind != SNAPSHOT_WHOLE && kind != SNAPSHOT_TABLE)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	size_t policy = snp_get_size(&rdr), clock = snp_get_size(&rdr);
+
+	snp_get_params(&rdr, &params);
+
+	if (rdr.st != DS_OK || policy >= ALG_COUNT)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	Status st = sch_init(sch, (AlgorithmId)policy, &params);
+
+	if (st != DS_OK)
+		return st;
+
+	Scheduler *restored = *sch;
+
+	restored->clock = clock;
+	restored->queued = snp_get_size(&rdr);
+	restored->slice = snp_get_size(&rdr);
+	restored->dispatched = snp_get_size(&rdr);
+	restored->event = snp_get_size(&rdr);
+	restored->hyperperiod = snp_get_size(&rdr);
+
+	size_t count = snp_get_count(&rdr), records = snp_get_size(&rdr), i;
+
+	if (restored->event > params.events || records > count || (partial && records > 0))
+		snp_fail(&rdr, DS_ERR_INVALID_ARGUMENT);
+
+	size_t left = 0;
+
+	if (partial)
+	{
+		*finished = snp_get_size(&rdr);
+		*pending = snp_get_size(&rdr);
+	}
+	else if (kind == SNAPSHOT_TABLE)
+	{
+		left = snp_get_size(&rdr);
+
+		size_t size = snp_get_size(&rdr), seconds = snp_get_size(&rdr), nanoseconds = snp_get_size(&rdr);
+
+		// Before anything is decoded, its rows would not be the ones left out
+		if (rdr.st == DS_OK)
+			rdr.st = snp_check_table(snp->table, size, seconds, nanoseconds);
+	}
+
+	if (rdr.st == DS_OK)
+	{
+		rdr.processes = malloc(sizeof(Process *) * (count > 0 ? count : 1));
+
+		if (!rdr.processes)
+			snp_fail(&rdr, DS_ERR_ALLOC);
+	}
+
+	while (rdr.count < count && rdr.st == DS_OK)
+	{
+		Process *prc = snp_get_process(&rdr);
+
+		if (prc != NULL)
+			rdr.processes[(rdr.count)++] = prc;
+	}
+
+	// The structures below give back the slots of the processes in them
+	for (i = records; i < rdr.count; i++)
+		rdr.processes[i]->slot = PROCESS_NO_SLOT;
+
+	for (i = 0; i < records && rdr.st == DS_OK; i++)
+	{
+		st = qua_enqueue(restored->finished, rdr.processes[i]);
+
+		if (st != DS_OK)
+			snp_fail(&rdr, st);
+	}
+
+	restored->running = snp_get_optional(&rdr, records);
+	restored->blocked = snp_get_optional(&rdr, records);
+
+	if (kind != SNAPSHOT_WHOLE)
+	{
+		// Rebuilt, the processes left out are added to it afterwards
+		for (i = records; i < rdr.count && rdr.st == DS_OK; i++)
+		{
+			st = pix_insert(restored->index, rdr.processes[i]);
+
+			if (st != DS_OK)
+				snp_fail(&rdr, st);
+		}
+	}
+	else
+		snp_get_slots(&rdr, restored->index, records);
+
+	snp_get_heap(&rdr, restored->timers, records, kind != SNAPSHOT_WHOLE);
+
+	snp_get_ready(&rdr, restored, records);
+
+	if (snp_get_size(&rdr) != 0 && rdr.st == DS_OK)
+	{
+		Metrics *saved;
+
+		st = met_init(&saved);
+
+		if (st != DS_OK)
+			snp_fail(&rdr, st);
+		else
+		{
+			snp_get_metrics(&rdr, saved);
+
+			if (metrics != NULL)
+				*metrics = *saved;
+
+			met_delete(&saved);
+		}
+	}
+	else if (metrics != NULL)
+		met_clear(metrics);
+
+	if (rdr.st == DS_OK && rdr.position != rdr.length)
+		snp_fail(&rdr, DS_ERR_INVALID_ARGUMENT);
+
+	if (rdr.st != DS_OK)
+	{
+		snp_release(restored);
+
+		sch_delete(sch);
+
+		for (i = 0; i < rdr.count; i++)
+			prc_delete(&rdr.processes[i]);
+
+		free(rdr.processes);
+
+		brs_release(&rdr.arena);
+
+		return rdr.st;
+	}
+
+	free(rdr.processes);
+
+	brs_release(&rdr.arena);
+
+	st = kind == SNAPSHOT_TABLE ? snp_refill(restored, snp->table, left) : DS_OK;
+
+	if (st == DS_OK)
+		st = sch_metrics(restored, metrics);
+
+	if (st != DS_OK)
+		sch_delete(sch);
+
+	return st;
+}
+
+/**
+ * Creates a scheduler in the state of the snapshot, with its own copy of
+ * every process. metrics, which may be NULL, gets the metrics of the
+ * snapshot and is the one the scheduler keeps up to date from then on.
+ * DS_ERR_INVALID_ARGUMENT when the snapshot is damaged or its table file
+ * changed since it was taken, DS_ERR_NOT_FOUND when that file is gone.
+ */
+Status snp_restore(Snapshot *snp, Scheduler **sch, Metrics *metrics)
+{
+	return snp_decode(snp, sch, metrics, NULL, NULL);
+}
+
+// FNV-1a over the table and the encoded state, a damaged file fails it
+static uint64_t snp_checksum(const char *table, size_t size, const unsigned char *buffer, size_t length)
+{
+	uint64_t digest = 0xcbf29ce484222325ULL;
+
+	size_t i;
+	for (i = 0; i < size; i++)
+		digest = (digest ^ (unsigned char)table[i]) * 0x100000001b3ULL;
+
+	for (i = 0; i < length; i++)
+		digest = (digest ^ buffer[i]) * 0x100000001b3ULL;
+
+	return digest;
+}
+
+// A new file next to path for a checkpoint to be written to, its name in
+// temporary, -1 when it cannot be made. Named after the process and a count
+// of the calls, so threads saving to the same path do not share one.
+static int snp_temporary(const char *path, char *temporary, size_t size)
+{
+	static size_t calls = 0;
+
+	size_t call = __atomic_add_fetch(&calls, 1, __ATOMIC_RELAXED);
+
+	if ((size_t)snprintf(temporary, size, "%s.%ld.%lu", path, (long)getpid(), call) >= size)
+		return -1;
+
+	return open(temporary, O_WRONLY | O_CREAT | O_EXCL, 0666);
+}
+
+static bool snp_write_all(int fd, const void *data, size_t length)
+{
+	const unsigned char *next = data;
+
+	while (length > 0)
+	{
+		ssize_t written = write(fd, next, length);
+
+		if (written < 0 && errno == EINTR)
+			continue;
+
+		if (written <= 0)
+			return false;
+
+		next += written;
+		length -= (size_t)written;
+	}
+
+	return true;
+}
+
+/**
+ * File layout, in host byte order: magic and version as 32 bit words, then
+ * the clock, the interval between checkpoints, the length of the path of
+ * the table, the length of the snapshot and their checksum as 64 bit
+ * words, the path without its
+ * terminator and the snapshot itself. Written to temporary, which fd is
+ * open on, and renamed to path, so the file always holds a whole
+ * checkpoint, the new one or the one before. Only makes async-signal-safe
+ * calls, so the child of a fork can write it whatever the other threads of
+ * the parent held.
+ */
+static Status snp_write(Snapshot *snp, int fd, const char *temporary, const char *path)
+{
+	size_t size = snp->table != NULL ? strlen(snp->table) : 0;
+
+	uint32_t header[2] = {SNAPSHOT_FILE_MAGIC, SNAPSHOT_VERSION};
+	uint64_t words[5] = {snp->clock, snp->every, size, snp->length,
+						 snp_checksum(snp->table, size, snp->buffer, snp->length)};
+
+	bool written = snp_write_all(fd, header, sizeof(header)) && snp_write_all(fd, words, sizeof(words)) &&
+				   snp_write_all(fd, snp->table, size) && snp_write_all(fd, snp->buffer, snp->length);
+
+	if (close(fd) != 0)
+		written = false;
+
+	if (written && rename(temporary, path) == 0)
+		return DS_OK;
+
+	unlink(temporary);
+
+	return DS_ERR_UNEXPECTED_RESULT;
+}
+
+Status snp_save(Snapshot *snp, const char *path)
+{
+	if (snp == NULL || path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	char temporary[PATH_MAX + 16];
+
+	int fd = snp_temporary(path, temporary, sizeof(temporary));
+
+	if (fd < 0)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	return snp_write(snp, fd, temporary, path);
+}
+
+// DS_ERR_NOT_FOUND when path cannot be opened, DS_ERR_INVALID_ARGUMENT when
+// it is not a whole checkpoint of this version
+Status snp_load(Snapshot **snp, const char *path)
+{
+	if (path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	*snp = NULL;
+
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL)
+		return DS_ERR_NOT_FOUND;
+
+	uint32_t header[2];
+	uint64_t words[5];
+
+	struct stat info;
+
+	Status st = DS_OK;
+
+	if (fstat(fileno(file), &info) != 0 || fread(header, sizeof(header), 1, file) != 1 ||
+		fread(words, sizeof(words), 1, file) != 1 || header[0] != SNAPSHOT_FILE_MAGIC ||
+		header[1] != SNAPSHOT_VERSION || words[2] >= PATH_MAX ||
+		words[2] + words[3] != (uint64_t)info.st_size - sizeof(header) - sizeof(words))
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	if (st == DS_OK)
+		st = snp_create(snp, words[0]);
+
+	if (st == DS_OK)
+		(*snp)->every = words[1];
+
+	if (st == DS_OK && words[2] > 0)
+	{
+		(*snp)->table = malloc(words[2] + 1);
+
+		if (!(*snp)->table)
+			st = DS_ERR_ALLOC;
+		else if (fread((*snp)->table, 1, words[2], file) != words[2])
+			st = DS_ERR_INVALID_ARGUMENT;
+		else
+			(*snp)->table[words[2]] = '\0';
+	}
+
+	if (st == DS_OK && (*snp)->capacity < words[3])
+	{
+		unsigned char *buffer = realloc((*snp)->buffer, words[3]);
+
+		if (!buffer)
+			st = DS_ERR_ALLOC;
+		else
+		{
+			(*snp)->buffer = buffer;
+			(*snp)->capacity = words[3];
+		}
+	}
+
+	if (st == DS_OK)
+	{
+		(*snp)->length = words[3];
+
+		if (fread((*snp)->buffer, 1, words[3], file) != words[3] ||
+			snp_checksum((*snp)->table, words[2], (*snp)->buffer, (*snp)->length) != words[4])
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
+
+	fclose(file);
+
+	if (st != DS_OK && *snp != NULL)
+		snp_delete(snp);
+
+	return st;
+}
+
+/**
+ * Writes snp to path from a forked child and returns without waiting for
+ * it, snp can be deleted right away. The state is encoded before the fork,
+ * so the child only writes bytes that are already there and makes no call
+ * that could wait for a lock another thread of the parent held at the fork.
+ * writer is 0 or the child of the previous call, see snp_poll.
+ */
+Status snp_fork(Snapshot *snp, const char *path, pid_t *writer)
+{
+	if (snp == NULL || path == NULL || writer == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = snp_poll(writer);
+
+	if (st != DS_OK)
+		return st;
+
+	char temporary[PATH_MAX + 16];
+
+	int fd = snp_temporary(path, temporary, sizeof(temporary));
+
+	if (fd < 0)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	pid_t child = fork();
+
+	// Leaves the buffers of the parent, stdout and the trace, unflushed
+	if (child == 0)
+		_exit(snp_write(snp, fd, temporary, path));
+
+	close(fd);
+
+	if (child < 0)
+	{
+		unlink(temporary);
+
+		return DS_ERR_UNEXPECTED_RESULT;
+	}
+
+	*writer = child;
+
+	return DS_OK;
+}
+
+// The status of the child of snp_fork once it is done, DS_ERR_FULL while
+// it is still writing and DS_OK when there is none
+Status snp_poll(pid_t *writer)
+{
+	if (writer == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (*writer == 0)
+		return DS_OK;
+
+	int status;
+
+	pid_t done = waitpid(*writer, &status, WNOHANG);
+
+	if (done == 0)
+		return DS_ERR_FULL;
+
+	*writer = 0;
+
+	if (done < 0 || !WIFEXITED(status))
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	return (Status)WEXITSTATUS(status);
+}
+
+// Waits for the child of snp_fork, if any, and gives its status
+Status snp_wait(pid_t *writer)
+{
+	if (writer == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (*writer == 0)
+		return DS_OK;
+
+	int status;
+
+	pid_t done;
+
+	do
+		done = waitpid(*writer, &status, 0);
+	while (done < 0 && errno == EINTR);
+
+	*writer = 0;
+
+	if (done < 0 || !WIFEXITED(status))
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	return (Status)WEXITSTATUS(status);
+}
+
+Status snp_delete(Snapshot **snp)
+{
+	if ((*snp) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	free((*snp)->buffer);
+	free((*snp)->table);
+	free(*snp);
+
+	*snp = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Snapshot.c */
+
+/* ---------------------------------------------------------------------------------------------------- Checkpoint.c */
+
+// params may be NULL for the defaults
+Status ckp_init(CheckpointLog **log, AlgorithmId policy, const SchedulerParams *params)
+{
+	if (policy >= ALG_COUNT)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	(*log) = malloc(sizeof(CheckpointLog));
+
+	if (!(*log))
+		return DS_ERR_ALLOC;
+
+	(*log)->policy = policy;
+
+	if (params != NULL)
+		(*log)->params = *params;
+	else
+		sch_default_params(&((*log)->params));
+
+	(*log)->table = NULL;
+	(*log)->arrivals = NULL;
+	(*log)->late = 0;
+	(*log)->fed = 0;
+	(*log)->result = NULL;
+	(*log)->spare = NULL;
+	(*log)->length = 0;
+	(*log)->bytes = 0;
+	(*log)->interval = CHECKPOINT_INTERVAL;
+	(*log)->next = 0;
+
+	return DS_OK;
+}
+
+// Deletes the processes of the last result a run did not take again
+static void ckp_discard(CheckpointLog *log)
+{
+	if (log->spare == NULL)
+		return;
+
+	size_t i;
+	for (i = 0; i < log->spare->capacity; i++)
+	{
+		if (log->spare->slots[i] != NULL)
+			prc_delete(&(log->spare->slots[i]));
+	}
+
+	pix_delete(&(log->spare));
+}
+
+// Drops the checkpoints from first on
+static void ckp_truncate(CheckpointLog *log, size_t first)
+{
+	while (log->length > first)
+	{
+		Checkpoint *ckp = &log->checkpoints[--(log->length)];
+
+		log->bytes -= ckp->snapshot->length;
+
+		snp_delete(&ckp->snapshot);
+	}
+}
+
+// Drops every other checkpoint, keeping the first one
+static void ckp_thin(CheckpointLog *log)
+{
+	size_t i, kept = 0;
+
+	for (i = 0; i < log->length; i++)
+	{
+		if (i % 2 == 0)
+		{
+			log->checkpoints[kept++] = log->checkpoints[i];
+
+			continue;
+		}
+
+		log->bytes -= log->checkpoints[i].snapshot->length;
+
+		snp_delete(&log->checkpoints[i].snapshot);
+	}
+
+	log->length = kept;
+	log->interval *= 2;
+}
+
+// Whether one of the first count kills and priority changes names pid
+static bool ckp_targeted(CheckpointLog *log, size_t pid, size_t count)
+{
+	size_t i;
+	for (i = 0; i < count; i++)
+	{
+		if (log->params.event[i].pid == pid)
+			return true;
+	}
+
+	return false;
+}
+
+static size_t ckp_hyperperiod(QueueArray *table)
+{
+	size_t hyperperiod = 1, i;
+
+	for (i = 0; i < table->length; i++)
+	{
+		if (table->buffer[i]->period > 0)
+			hyperperiod = sch_lcm(hyperperiod, table->buffer[i]->period);
+	}
+
+	return hyperperiod;
+}
+
+static int ckp_compare_arrival(const void *arr1, const void *arr2)
+{
+	const CheckpointArrival *a = arr1, *b = arr2;
+
+	if (a->arrival != b->arrival)
+		return a->arrival < b->arrival ? -1 : 1;
+
+	return a->rank < b->rank ? -1 : a->rank > b->rank;
+}
+
+// Sorts the rows of log->table that arrive after tick 0 by arrival
+static Status ckp_index(CheckpointLog *log)
+{
+	size_t i;
+
+	free(log->arrivals);
+
+	log->arrivals = malloc(sizeof(CheckpointArrival) * (log->table->length + 1));
+
+	if (!log->arrivals)
+		return DS_ERR_ALLOC;
+
+	log->late = 0;
+	log->fed = 0;
+
+	for (i = 0; i < log->table->length; i++)
+	{
+		Process *row = log->table->buffer[i];
+
+		if (row->arrival == 0)
+			continue;
+
+		log->arrivals[log->late] =
+			(CheckpointArrival){row->arrival, i, log->late, ckp_targeted(log, row->pid, log->params.events)};
+
+		(log->late)++;
+	}
+
+	qsort(log->arrivals, log->late, sizeof(CheckpointArrival), ckp_compare_arrival);
+
+	return DS_OK;
+}
+
+/**
+ * Moves the index of log->table to table, which has removed or added or
+ * both at position instead of it, without sorting it again. The rows after
+ * position move with the ones that come and go, and so do their ranks.
+ */
+static Status ckp_reindex(CheckpointLog *log, QueueArray *table, size_t position, Process *removed, Process *added)
+{
+	CheckpointArrival *arrivals = malloc(sizeof(CheckpointArrival) * (table->length + 1)), entry, next;
+
+	if (!arrivals)
+		return DS_ERR_ALLOC;
+
+	size_t gone = removed != NULL, come = added != NULL, late = 0, rank = 0, i;
+
+	bool inserted = added == NULL || added->arrival == 0;
+
+	for (i = 0; i < position; i++)
+	{
+		if (table->buffer[i]->arrival > 0)
+			rank++;
+	}
+
+	if (!inserted)
+		entry = (CheckpointArrival){added->arrival, position, rank, ckp_targeted(log, added->pid, log->params.events)};
+
+	for (i = 0; i < log->late; i++)
+	{
+		next = log->arrivals[i];
+
+		if (removed != NULL && next.row == position)
+			continue;
+
+		if (next.row >= position)
+		{
+			next.row = next.row - gone + come;
+			next.rank = next.rank - (removed != NULL && removed->arrival > 0) + (added != NULL && added->arrival > 0);
+		}
+
+		if (!inserted && ckp_compare_arrival(&entry, &next) < 0)
+		{
+			arrivals[late++] = entry;
+			inserted = true;
+		}
+
+		arrivals[late++] = next;
+	}
+
+	if (!inserted)
+		arrivals[late++] = entry;
+
+	free(log->arrivals);
+
+	log->arrivals = arrivals;
+	log->late = late;
+	log->fed = 0;
+
+	return DS_OK;
+}
+
+/**
+ * Submits a process for the row of arr, the run keeps the row. A process
+ * of the last result with its PID, name and type is reset to it instead of
+ * making a copy, the rows are as prc_copy leaves them.
+ */
+static Status ckp_submit(CheckpointLog *log, Scheduler *sch, CheckpointArrival *arr)
+{
+	Process *row = log->table->buffer[arr->row], *prc;
+
+	Status st;
+
+	if (log->spare != NULL && pix_find(log->spare, row->pid, &prc) == DS_OK && str_equals(prc->name, row->name) &&
+		str_equals(prc->type, row->type))
+	{
+		String *name = prc->name, *type = prc->type;
+
+		st = pix_remove(log->spare, prc);
+
+		if (st != DS_OK)
+			return st;
+
+		brs_release(&(prc->arena));
+
+		*prc = *row;
+
+		prc->name = name;
+		prc->type = type;
+
+		if (prc->arena != NULL)
+			brs_retain(prc->arena);
+	}
+	else if ((st = prc_copy(row, &prc)) != DS_OK)
+		return st;
+
+	return sch_submit_ordered(sch, prc, arr->rank);
+}
+
+/**
+ * Submits the rows that arrive before the next checkpoint and, unless one
+ * is already waiting past it, the ones that arrive first after it. The run
+ * skips idle ticks to the earliest timer, so it never goes past a row it
+ * has not been given. Rows submitted from the start do not count, a kill
+ * may take them out of the timers before they arrive.
+ */
+static Status ckp_feed(CheckpointLog *log, Scheduler *sch)
+{
+	Status st;
+
+	bool waiting = false;
+
+	size_t ahead = 0, i;
+
+	for (i = log->fed; i > 0; i--)
+	{
+		if (!log->arrivals[i - 1].targeted)
+		{
+			waiting = log->arrivals[i - 1].arrival >= log->next;
+
+			break;
+		}
+	}
+
+	for (; log->fed < log->late; (log->fed)++)
+	{
+		CheckpointArrival *arr = &log->arrivals[log->fed];
+
+		if (arr->targeted)
+			continue;
+
+		if (arr->arrival >= log->next)
+		{
+			if (waiting && arr->arrival != ahead)
+				break;
+
+			waiting = true;
+			ahead = arr->arrival;
+		}
+
+		st = ckp_submit(log, sch, arr);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+// Submits every row of a run from tick 0 but the ones left to ckp_feed
+static Status ckp_start(CheckpointLog *log, Scheduler *sch)
+{
+	Process *prc;
+
+	Status st;
+
+	size_t i;
+
+	for (i = 0; i < log->table->length; i++)
+	{
+		if (log->table->buffer[i]->arrival > 0)
+			continue;
+
+		st = prc_copy(log->table->buffer[i], &prc);
+
+		if (st != DS_OK)
+			return st;
+
+		st = sch_submit(sch, prc);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	// Releases of later jobs and ends of I/O bursts come after every row, as
+	// when all are submitted
+	sch->timers->order = log->late;
+
+	// and stop at the hyperperiod of every row, not only the ones submitted
+	sch->hyperperiod = ckp_hyperperiod(log->table);
+
+	// Kills and priority changes find the process before it arrives
+	for (i = 0; i < log->late; i++)
+	{
+		if (!log->arrivals[i].targeted)
+			continue;
+
+		st = ckp_submit(log, sch, &log->arrivals[i]);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+static Status ckp_take(CheckpointLog *log, Scheduler *sch)
+{
+	if (log->length == CHECKPOINT_MAX)
+		ckp_thin(log);
+
+	Checkpoint *ckp = &log->checkpoints[log->length];
+
+	Status st = snp_encode(&ckp->snapshot, sch, SNAPSHOT_PARTIAL, NULL);
+
+	if (st != DS_OK)
+		return st;
+
+	ckp->finished = sch->finished->length;
+	ckp->event = sch->event;
+	ckp->late = log->late;
+	ckp->submitted = log->fed > 0 ? log->arrivals[log->fed - 1].arrival : 0;
+
+	(log->length)++;
+
+	log->bytes += ckp->snapshot->length;
+
+	// Taking one costs about as much as its size, the run has to outweigh it
+	size_t spacing = ckp->snapshot->length * CHECKPOINT_SPACING;
+
+	while (log->bytes > CHECKPOINT_BUDGET && log->length > 1)
+		ckp_thin(log);
+
+	log->next = sch->clock + (spacing > log->interval ? spacing : log->interval);
+
+	return DS_OK;
+}
+
+// Runs sch to the end with a checkpoint at next and every interval ticks
+// from then on
+static Status ckp_run(CheckpointLog *log, Scheduler *sch)
+{
+	Status st;
+
+	while (true)
+	{
+		st = ckp_feed(log, sch);
+
+		if (st != DS_OK)
+			return st;
+
+		st = sch_run_until(sch, log->next);
+
+		if (st != DS_OK || (sch_done(sch) && log->fed == log->late))
+			return st;
+
+		st = ckp_take(log, sch);
+
+		if (st != DS_OK)
+			return st;
+	}
+}
+
+// Whether two rows of a table are submitted the same way
+static bool ckp_same(Process *prc1, Process *prc2)
+{
+	return prc1->pid == prc2->pid && prc1->cpu == prc2->cpu && prc1->io == prc2->io && prc1->pri == prc2->pri &&
+		   prc1->period == prc2->period && prc1->deadline == prc2->deadline && prc1->arrival == prc2->arrival &&
+		   str_equals(prc1->name, prc2->name) && str_equals(prc1->type, prc2->type) && prc_same_bursts(prc1, prc2);
+}
+
+/**
+ * Finds the one row that sets table apart from last: removed is the row of
+ * last that is gone or altered and added the row of table that is new or
+ * altered, NULL when there is none, and position where they are.
+ * DS_ERR_NOT_FOUND when they differ in more than one row.
+ */
+static Status ckp_diff(QueueArray *last, QueueArray *table, Process **removed, Process **added, size_t *position)
+{
+	size_t head = 0, tail = 0;
+
+	while (head < last->length && head < table->length && ckp_same(last->buffer[head], table->buffer[head]))
+		head++;
+
+	while (tail < last->length - head && tail < table->length - head &&
+		   ckp_same(last->buffer[last->length - 1 - tail], table->buffer[table->length - 1 - tail]))
+		tail++;
+
+	if (last->length - head - tail > 1 || table->length - head - tail > 1)
+		return DS_ERR_NOT_FOUND;
+
+	*removed = last->length - head - tail == 1 ? last->buffer[head] : NULL;
+	*added = table->length - head - tail == 1 ? table->buffer[head] : NULL;
+	*position = head;
+
+	return DS_OK;
+}
+
+// Whether the process of a row still waited for its first arrival at a
+// checkpoint, untouched by kills and priority changes. NULL is.
+static bool ckp_pending(CheckpointLog *log, Checkpoint *ckp, Process *row)
+{
+	if (row == NULL)
+		return true;
+
+	return row->arrival > ckp->snapshot->clock && !ckp_targeted(log, row->pid, ckp->event);
+}
+
+// Whether the snapshot of a checkpoint left out the process of a row of
+// log->table, one that was submitted and had not arrived yet
+static bool ckp_omitted(CheckpointLog *log, Checkpoint *ckp, CheckpointArrival *arr)
+{
+	if (arr->arrival <= ckp->snapshot->clock || (arr->arrival > ckp->submitted && !arr->targeted))
+		return false;
+
+	return !arr->targeted || !ckp_targeted(log, log->table->buffer[arr->row]->pid, ckp->event);
+}
+
+// First row of the index that arrives after tick
+static size_t ckp_after(CheckpointLog *log, size_t tick)
+{
+	size_t low = 0, high = log->late;
+
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+
+		if (log->arrivals[middle].arrival <= tick)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+/**
+ * Gives a scheduler restored from a checkpoint the insertion numbers a run
+ * of table, with late rows that arrive after tick 0, gives its timers.
+ * DS_ERR_NOT_FOUND when the rows of the last table left out do not add up
+ * to pending.
+ */
+static Status ckp_complete(CheckpointLog *log, Checkpoint *ckp, Scheduler *sch, QueueArray *table, size_t late,
+						   size_t pending)
+{
+	size_t omitted = 0, rank, i;
+
+	for (i = ckp_after(log, ckp->snapshot->clock); i < log->late; i++)
+	{
+		if (log->arrivals[i].arrival > ckp->submitted && log->params.events == 0)
+			break;
+
+		if (ckp_omitted(log, ckp, &log->arrivals[i]))
+			omitted++;
+	}
+
+	if (omitted != pending)
+		return DS_ERR_NOT_FOUND;
+
+	// Releases of later jobs and ends of I/O bursts come after every row, in
+	// the order they were pushed
+	for (i = 0; i < sch->timers->length; i++)
+	{
+		IndexedHeapNode *node = &sch->timers->buffer[i];
+
+		if (node->data->job > 0 || node->data->burst > 0)
+			node->order = node->order - ckp->late + late;
+	}
+
+	// First arrivals go by row, found through the index in one pass
+	for (i = 0, rank = 0; i < table->length; i++)
+	{
+		Process *prc;
+
+		if (table->buffer[i]->arrival == 0)
+			continue;
+
+		if (pix_find(sch->index, table->buffer[i]->pid, &prc) == DS_OK && ihp_contains(sch->timers, prc) &&
+			prc->job == 0 && prc->burst == 0)
+			sch->timers->buffer[prc->slot].order = rank;
+
+		rank++;
+	}
+
+	sch->timers->order = sch->timers->order - ckp->late + late;
+
+	return DS_OK;
+}
+
+// Restores the last checkpoint the change from log->table to table could
+// not have made a difference to, DS_ERR_NOT_FOUND when there is none
+static Status ckp_resume(CheckpointLog *log, QueueArray *table, Scheduler **sch, Metrics *metrics, Checkpoint **ckp)
+{
+	Process *removed, *added;
+
+	size_t finished, pending, position, k;
+
+	Status st = ckp_diff(log->table, table, &removed, &added, &position);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t late = log->late - (removed != NULL && removed->arrival > 0) + (added != NULL && added->arrival > 0);
+
+	size_t hyperperiod = 0;
+
+	if ((removed != NULL && removed->period > 0) || (added != NULL && added->period > 0))
+	{
+		hyperperiod = ckp_hyperperiod(table);
+
+		// Releases before the checkpoint may have stopped at the last one
+		if (log->params.horizon == 0 && ckp_hyperperiod(log->table) != hyperperiod)
+			return DS_ERR_NOT_FOUND;
+	}
+
+	for (k = log->length; k > 0; k--)
+	{
+		if (ckp_pending(log, &log->checkpoints[k - 1], removed) && ckp_pending(log, &log->checkpoints[k - 1], added))
+			break;
+	}
+
+	if (k == 0)
+		return DS_ERR_NOT_FOUND;
+
+	*ckp = &log->checkpoints[k - 1];
+
+	st = snp_decode((*ckp)->snapshot, sch, metrics, &finished, &pending);
+
+	if (st != DS_OK)
+		return st;
+
+	if (finished != (*ckp)->finished)
+		st = DS_ERR_UNEXPECTED_RESULT;
+	else
+		st = ckp_complete(log, *ckp, *sch, table, late, pending);
+
+	if (st == DS_OK)
+		st = ckp_reindex(log, table, position, removed, added);
+
+	if (st != DS_OK)
+	{
+		sch_delete(sch);
+
+		return st;
+	}
+
+	// The ones up to it are the same for table, the rest are taken again
+	ckp_truncate(log, k);
+
+	if (hyperperiod > 0)
+		(*sch)->hyperperiod = hyperperiod;
+
+	// So are the processes that finished before it, the ones after it are
+	// made again and can be reused for that
+	st = pix_init(&(log->spare));
+
+	if (st != DS_OK)
+		return st;
+
+	size_t i;
+	for (i = (*ckp)->finished; i < log->result->length; i++)
+	{
+		Process *prc = log->result->buffer[i], *other;
+
+		if (pix_find(log->spare, prc->pid, &other) == DS_OK)
+			st = prc_delete(&prc);
+		else
+			st = pix_insert(log->spare, prc);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	log->result->length = (*ckp)->finished;
+
+	qua_delete(&((*sch)->finished));
+
+	(*sch)->finished = log->result;
+
+	log->result = NULL;
+
+	// The last table becomes table
+	QueueArray *last = log->table;
+
+	if (removed != NULL)
+	{
+		prc_delete(&removed);
+
+		memmove(last->buffer + position, last->buffer + position + 1, (last->length - position - 1) * sizeof(Process *));
+
+		(last->length)--;
+	}
+
+	if (added != NULL)
+	{
+		st = prc_copy(added, &added);
+
+		if (st == DS_OK)
+			st = qua_enqueue(last, added);
+
+		if (st != DS_OK)
+			return st;
+
+		memmove(last->buffer + position + 1, last->buffer + position, (last->length - position - 1) * sizeof(Process *));
+
+		last->buffer[position] = added;
+	}
+
+	return DS_OK;
+}
+
+// Submits again the rows of log->table the snapshot of ckp left out and
+// leaves the rest of them to ckp_feed
+static Status ckp_refeed(CheckpointLog *log, Checkpoint *ckp, Scheduler *sch)
+{
+	Status st;
+
+	size_t i;
+
+	for (i = ckp_after(log, ckp->snapshot->clock); i < log->late; i++)
+	{
+		CheckpointArrival *arr = &log->arrivals[i];
+
+		if (arr->arrival > ckp->submitted && log->params.events == 0)
+			break;
+
+		if (!ckp_omitted(log, ckp, arr))
+			continue;
+
+		st = ckp_submit(log, sch, arr);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	log->fed = ckp_after(log, ckp->submitted);
+
+	return DS_OK;
+}
+
+/**
+ * Runs every process of table with the algorithm of the log. Unlike the
+ * alg_table entries, table is left as it is and result, the processes in
+ * the order they finished, belongs to the log until its next run. When
+ * table is the table of the last run with at most one row altered, added
+ * or removed, the run resumes from a checkpoint of the last one and resumed
+ * gets its tick, otherwise it starts over and resumed gets 0. metrics gets
+ * the metrics of the run.
+ */
+Status ckp_simulate(CheckpointLog *log, QueueArray *table, QueueArray **result, Metrics *metrics, bool visual,
+					size_t *resumed)
+{
+	if (log == NULL || table == NULL || resumed == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (qua_is_empty(table))
+		return DS_ERR_INVALID_ARGUMENT;
+
+	Scheduler *sch;
+
+	Checkpoint *ckp = NULL;
+
+	Status st = DS_ERR_NOT_FOUND;
+
+	// A run that failed left no result
+	if (log->table != NULL && log->result != NULL)
+		st = ckp_resume(log, table, &sch, metrics, &ckp);
+
+	if (st == DS_ERR_NOT_FOUND)
+	{
+		// A checkpoint that was restored and could not be used left its metrics
+		if (metrics != NULL)
+			met_clear(metrics);
+
+		ckp_truncate(log, 0);
+
+		if (log->result != NULL)
+			qua_delete(&(log->result));
+
+		if (log->table != NULL)
+			qua_delete(&(log->table));
+
+		log->interval = CHECKPOINT_INTERVAL;
+
+		st = sch_init(&sch, log->policy, &(log->params));
+
+		if (st != DS_OK)
+			return st;
+
+		st = sch_metrics(sch, metrics);
+
+		if (st != DS_OK)
+			return st;
+
+		ckp = NULL;
+	}
+	else if (st != DS_OK)
+		return st;
+
+	if (ckp != NULL)
+		st = ckp_refeed(log, ckp, sch);
+	else if ((st = qua_copy(table, &(log->table))) == DS_OK && (st = ckp_index(log)) == DS_OK)
+		st = ckp_start(log, sch);
+
+	if (st != DS_OK)
+		return st;
+
+	*resumed = ckp != NULL ? sch->clock : 0;
+
+	log->next = sch->clock + log->interval;
+
+#ifndef PROCESS_NO_MAIN
+	if (visual && (st = sch_visual(sch)) != DS_OK)
+		return st;
+#else
+	(void)visual;
+#endif
+
+	st = ckp_run(log, sch);
+
+	ckp_discard(log);
+
+	if (st != DS_OK)
+		return st;
+
+	*result = log->result = sch->finished;
+
+	sch->finished = NULL;
+
+	return sch_delete(&sch);
+}
+
+Status ckp_delete(CheckpointLog **log)
+{
+	if ((*log) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	ckp_truncate(*log, 0);
+
+	ckp_discard(*log);
+
+	if ((*log)->result != NULL)
+		qua_delete(&((*log)->result));
+
+	if ((*log)->table != NULL)
+		qua_delete(&((*log)->table));
+
+	free((*log)->arrivals);
+	free(*log);
+
+	*log = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Checkpoint.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                           Snapshots
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                             Library
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Simulation.c */
+
+/**
+ * @brief One scheduling run of the library interface
+ *
+ * The scheduler is only created when the first process arrives, so sim_set
+ * can change its parameters until then.
+ */
+struct Simulation
+{
+	AlgorithmId policy;		/*!< Algorithm of the run */
+	SchedulerParams params; /*!< Tunables, copied into sch when it is created */
+	Scheduler *sch;			/*!< NULL until the first submit, step or run */
+	Metrics *metrics;		/*!< Metrics of sch */
+	pid_t writer;			/*!< Child writing the last sim_save, 0 for none */
+	bool sinking;			/*!< Finished processes go to sink instead of being kept */
+	SimulationSink sink;	/*!< Optional, gets the finished processes */
+	void *context;			/*!< Passed to sink */
+	BurstArena *arena;		/*!< Bursts of the submitted processes, made by the first one with any */
+};
+
+static Status sim_finish(void *context, Process *prc)
+{
+	Simulation *sim = context;
+
+	if (sim->sink == NULL)
+		return DS_OK;
+
+	SimulationResult result = {prc->name->buffer, prc->pid, prc->arrival, prc->first_run, prc->finish,
+							   prc->waiting, prc->blocked, prc->jobs, prc->misses, prc->killed};
+
+	sim->sink(sim->context, &result);
+
+	return DS_OK;
+}
+
+static Status sim_scheduler(Simulation *sim)
+{
+	if (sim->sch != NULL)
+		return DS_OK;
+
+	Status st = sch_init(&(sim->sch), sim->policy, &(sim->params));
+
+	if (st != DS_OK)
+		return st;
+
+	st = sch_metrics(sim->sch, sim->metrics);
+
+	if (st != DS_OK)
+		return st;
+
+	if (sim->sinking)
+	{
+		sim->sch->sink = sim_finish;
+		sim->sch->context = sim;
+	}
+
+	return DS_OK;
+}
+
+Status sim_create(Simulation **sim, const char *algorithm)
+{
+	if (algorithm == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t alg;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+	{
+		if (strcmp(algorithm, alg_options[alg]) == 0)
+			break;
+	}
+
+	if (alg == ALG_COUNT)
+		return DS_ERR_NOT_FOUND;
+
+	(*sim) = malloc(sizeof(Simulation));
+
+	if (!(*sim))
+		return DS_ERR_ALLOC;
+
+	Status st = met_init(&((*sim)->metrics));
+
+	if (st != DS_OK)
+	{
+		free(*sim);
+
+		*sim = NULL;
+
+		return st;
+	}
+
+	(*sim)->policy = (AlgorithmId)alg;
+	(*sim)->sch = NULL;
+	(*sim)->writer = 0;
+	(*sim)->sinking = false;
+	(*sim)->arena = NULL;
+
+	sch_default_params(&((*sim)->params));
+
+	return DS_OK;
+}
+
+Status sim_set(Simulation *sim, const char *option, const char *value)
+{
+	if (sim == NULL || option == NULL || value == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (sim->sch != NULL)
+		return DS_ERR_INVALID_OPERATION;
+
+	return sch_parse_param(&(sim->params), option, value);
+}
+
+Status sim_submit(Simulation *sim, const SimulationProcess *process)
+{
+	if (sim == NULL || process == NULL || process->name == NULL || process->type == NULL ||
+		(process->bursts > 0 && process->burst == NULL))
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 0; i < process->bursts; i++)
+	{
+		if (process->burst[i] == 0)
+			return DS_ERR_INVALID_ARGUMENT;
+	}
+
+	if (process->bursts % 2 == 0 && process->bursts > 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	Status st = sim_scheduler(sim);
+
+	if (st == DS_OK && process->bursts > 0)
+	{
+		if (sim->arena == NULL)
+			st = brs_init(&(sim->arena));
+
+		if (st == DS_OK)
+			st = brs_reserve(sim->arena, process->bursts);
+	}
+
+	if (st != DS_OK)
+		return st;
+
+	String *name, *type;
+
+	st = file_make_string(&name, process->name, strlen(process->name));
+
+	if (st != DS_OK)
+		return st;
+
+	st = file_make_string(&type, process->type, strlen(process->type));
+
+	if (st != DS_OK)
+		return st;
+
+	Process *prc;
+
+	st = prc_init(&prc, name, process->pid, process->cpu, process->io, process->pri, type);
+
+	if (st != DS_OK)
+		return st;
+
+	prc->period = process->period;
+	prc->deadline = process->deadline;
+	prc->arrival = process->arrival;
+
+	if (process->bursts > 0)
+	{
+		memcpy(sim->arena->burst + sim->arena->length, process->burst, sizeof(size_t) * process->bursts);
+
+		prc_set_bursts(prc, sim->arena, sim->arena->length, process->bursts);
+
+		sim->arena->length += process->bursts;
+	}
+
+	return sch_submit(sim->sch, prc);
+}
+
+Status sim_load(Simulation *sim, const char *path)
+{
+	if (sim == NULL || path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = sim_scheduler(sim);
+
+	if (st != DS_OK)
+		return st;
+
+	DynamicArray *table;
+
+	st = dar_init(&table);
+
+	if (st != DS_OK)
+		return st;
+
+	st = file_load_path(table, path);
+
+	size_t i, submitted = 0;
+	while (st == DS_OK && submitted < table->size)
+	{
+		st = sch_submit(sim->sch, table->buffer[submitted]);
+
+		if (st == DS_OK)
+			submitted++;
+	}
+
+	// The processes the scheduler did not take still belong to the table
+	for (i = submitted; i < table->size; i++)
+		prc_delete(&(table->buffer[i]));
+
+	dar_delete_shallow(&table);
+
+	return st;
+}
+
+Status sim_step(Simulation *sim)
+{
+	if (sim == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = sim_scheduler(sim);
+
+	if (st != DS_OK)
+		return st;
+
+	return sch_step(sim->sch);
+}
+
+Status sim_run(Simulation *sim)
+{
+	if (sim == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = sim_scheduler(sim);
+
+	if (st != DS_OK)
+		return st;
+
+	return sch_run(sim->sch);
+}
+
+bool sim_done(Simulation *sim)
+{
+	return sim->sch == NULL || sch_done(sim->sch);
+}
+
+size_t sim_clock(Simulation *sim)
+{
+	return sim->sch == NULL ? 0 : sim->sch->clock;
+}
+
+Status sim_metrics(Simulation *sim, SimulationMetrics *result)
+{
+	if (sim == NULL || result == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	met_summary(sim->metrics, result);
+
+	return DS_OK;
+}
+
+Status sim_sink(Simulation *sim, SimulationSink sink, void *context)
+{
+	if (sim == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	sim->sinking = true;
+	sim->sink = sink;
+	sim->context = context;
+
+	if (sim->sch != NULL)
+	{
+		sim->sch->sink = sim_finish;
+		sim->sch->context = sim;
+	}
+
+	return DS_OK;
+}
+
+Status sim_save(Simulation *sim, const char *path)
+{
+	if (sim == NULL || path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = sim_scheduler(sim);
+
+	// Not encoded for nothing while the previous one is still being written
+	if (st == DS_OK)
+		st = snp_poll(&(sim->writer));
+
+	if (st != DS_OK)
+		return st;
+
+	Snapshot *snp;
+
+	st = snp_take(&snp, sim->sch);
+
+	if (st != DS_OK)
+		return st;
+
+	st = snp_fork(snp, path, &(sim->writer));
+
+	snp_delete(&snp);
+
+	return st;
+}
+
+Status sim_wait(Simulation *sim)
+{
+	if (sim == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	return snp_wait(&(sim->writer));
+}
+
+Status sim_open(Simulation **sim, const char *path)
+{
+	if (path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Snapshot *snp;
+
+	Status st = snp_load(&snp, path);
+
+	if (st != DS_OK)
+		return st;
+
+	(*sim) = malloc(sizeof(Simulation));
+
+	if (!(*sim))
+	{
+		snp_delete(&snp);
+
+		return DS_ERR_ALLOC;
+	}
+
+	st = met_init(&((*sim)->metrics));
+
+	if (st == DS_OK)
+	{
+		st = snp_restore(snp, &((*sim)->sch), (*sim)->metrics);
+
+		if (st != DS_OK)
+			met_delete(&((*sim)->metrics));
+	}
+
+	snp_delete(&snp);
+
+	if (st != DS_OK)
+	{
+		free(*sim);
+
+		*sim = NULL;
+
+		return st;
+	}
+
+	(*sim)->policy = (*sim)->sch->policy;
+	(*sim)->params = (*sim)->sch->params;
+	(*sim)->writer = 0;
+	(*sim)->sinking = false;
+	(*sim)->arena = NULL;
+
+	return DS_OK;
+}
+
+Status sim_delete(Simulation **sim)
+{
+	if ((*sim) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	// Not left behind as a zombie, its status is lost
+	snp_wait(&((*sim)->writer));
+
+	if ((*sim)->sch != NULL)
+	{
+		Status st = sch_delete(&((*sim)->sch));
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	met_delete(&((*sim)->metrics));
+
+	brs_release(&((*sim)->arena));
+
+	free(*sim);
+
+	*sim = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Simulation.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                             Library
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+#ifndef PROCESS_NO_MAIN
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Benchmarks
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Bench.c */
+
+static char *bch_kind_names[BENCH_KINDS] = {"enqueue", "update", "dequeue", "remove"};
+
+// Where the recording ready queue writes. Recording runs one at a time and
+// never on the threads of a Monte Carlo run.
+static BenchLog *bch_recording = NULL;
+
+typedef struct BenchValue
+{
+	Process *prc; /*!< Submitted process */
+	size_t index; /*!< Its position in the table */
+} BenchValue;
+
+static BenchValue *bch_values = NULL; // Submitted processes sorted by address
+
+static int bch_compare_address(const void *a, const void *b)
+{
+	const Process *prc1 = ((const BenchValue *)a)->prc, *prc2 = ((const BenchValue *)b)->prc;
+
+	return (prc1 > prc2) - (prc1 < prc2);
+}
+
+static Status bch_log(Process *prc, BenchOpKind kind, size_t priority)
+{
+	BenchLog *log = bch_recording;
+
+	if (log->length == log->capacity)
+	{
+		size_t capacity = (log->capacity == 0) ? 1024 : log->capacity * 2;
+
+		BenchOp *new_ops = realloc(log->ops, sizeof(BenchOp) * capacity);
+
+		if (!new_ops)
+			return DS_ERR_ALLOC;
+
+		log->ops = new_ops;
+		log->capacity = capacity;
+	}
+
+	BenchValue key = {prc, 0};
+
+	BenchValue *found = bsearch(&key, bch_values, log->values, sizeof(BenchValue), bch_compare_address);
+
+	if (found == NULL)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	BenchOp op = {kind, found->index, priority};
+
+	log->ops[(log->length)++] = op;
+
+	(log->count[kind])++;
+
+	return DS_OK;
+}
+
+// The priority ready queue with every call logged
+
+static inline Status bch_rq_push(Scheduler *sch, Process *prc, size_t key)
+{
+	BenchLog *log = bch_recording;
+
+	bool queued = prq_contains(sch->ready.prq, prc);
+
+	if (log->count[BENCH_DEQUEUE] > 0 && key < log->last)
+		(log->below)++;
+
+	Status st = bch_log(prc, queued ? BENCH_UPDATE : BENCH_ENQUEUE, key);
+
+	if (st != DS_OK)
+		return st;
+
+	st = rq_prq_push(sch, prc, key);
+
+	if (st == DS_OK && sch->ready.prq->length > log->peak)
+		log->peak = sch->ready.prq->length;
+
+	return st;
+}
+
+static inline Status bch_rq_pop(Scheduler *sch, Process **prc)
+{
+	PriorityQueueNode *top;
+
+	if (prq_is_empty(sch->ready.prq))
+		return DS_ERR_INVALID_OPERATION;
+
+	Status st = prq_top(sch->ready.prq, &top);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t priority = top->priority;
+
+	st = rq_prq_pop(sch, prc);
+
+	if (st != DS_OK)
+		return st;
+
+	st = bch_log(*prc, BENCH_DEQUEUE, priority);
+
+	if (st != DS_OK)
+		return st;
+
+	BenchLog *log = bch_recording;
+
+	log->last = priority;
+	log->check = log->check * 31 + log->ops[log->length - 1].value + 1;
+
+	return DS_OK;
+}
+
+static Status bch_rq_remove(Scheduler *sch, Process *prc)
+{
+	Status st = bch_log(prc, BENCH_REMOVE, 0);
+
+	if (st != DS_OK)
+		return st;
+
+	return rq_prq_remove(sch, prc);
+}
+
+Status bch_record(AlgorithmId policy, QueueArray *table, const SchedulerParams *params, BenchLog **log)
+{
+	if (table == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (policy >= ALG_COUNT || policies[policy]->init != rq_prq_init || qua_is_empty(table))
+		return DS_ERR_INVALID_ARGUMENT;
+
+	(*log) = calloc(1, sizeof(BenchLog));
+
+	if (!(*log))
+		return DS_ERR_ALLOC;
+
+	QueueArray *queue;
+
+	Status st = qua_copy(table, &queue);
+
+	if (st != DS_OK)
+		return st;
+
+	Scheduler *sch;
+
+	st = sch_init(&sch, policy, params);
+
+	if (st != DS_OK)
+		return st;
+
+	bch_values = malloc(sizeof(BenchValue) * queue->length);
+
+	if (!bch_values)
+		return DS_ERR_ALLOC;
+
+	size_t i;
+	for (i = 0; i < queue->length; i++)
+	{
+		bch_values[i].prc = queue->buffer[i];
+		bch_values[i].index = i;
+	}
+
+	qsort(bch_values, queue->length, sizeof(BenchValue), bch_compare_address);
+
+	(*log)->values = queue->length;
+
+	bch_recording = *log;
+
+	// Processes that are ready at submit are pushed outside of the run
+	for (i = 0; i < queue->length && st == DS_OK; i++)
+	{
+		Process *prc = queue->buffer[i];
+
+		st = sch_submit(sch, prc);
+
+		if (st == DS_OK && prq_contains(sch->ready.prq, prc))
+		{
+			st = bch_log(prc, BENCH_ENQUEUE, policies[policy]->key(sch, prc));
+
+			if (sch->ready.prq->length > (*log)->peak)
+				(*log)->peak = sch->ready.prq->length;
+		}
+	}
+
+	queue->length = 0;
+
+	// The same policy with its queue calls logged. Not a constant table, so
+	// this run goes through function pointers, which the replay never does.
+	Policy recorder = *policies[policy];
+
+	recorder.push = bch_rq_push;
+	recorder.pop = bch_rq_pop;
+	recorder.remove = bch_rq_remove;
+
+	if (st == DS_OK)
+		st = sch_kernel_run(sch, &recorder, SIZE_MAX);
+
+	bch_recording = NULL;
+
+	free(bch_values);
+
+	bch_values = NULL;
+
+	Status dl = sch_delete(&sch);
+
+	qua_delete(&queue);
+
+	return st != DS_OK ? st : dl;
+}
+
+static double bch_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Runs the log once against a fresh queue
+static Status bch_replay_once(BenchLog *log, Process *values, uint64_t *check)
+{
+	PriorityQueue *prq;
+
+	Status st = prq_init_queue(&prq);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t i;
+	for (i = 0; i < log->values; i++)
+		values[i].slot = PROCESS_NO_SLOT;
+
+	*check = 0;
+
+	Process *prc = NULL;
+
+	for (i = 0; i < log->length && st == DS_OK; i++)
+	{
+		BenchOp *op = &log->ops[i];
+
+		switch (op->kind)
+		{
+		case BENCH_ENQUEUE:
+			st = prq_enqueue(prq, &values[op->value], op->priority);
+			break;
+		case BENCH_UPDATE:
+			st = prq_update(prq, &values[op->value], op->priority);
+			break;
+		case BENCH_DEQUEUE:
+			st = prq_dequeue(prq, &prc);
+
+			*check = *check * 31 + (size_t)(prc - values) + 1;
+			break;
+		case BENCH_REMOVE:
+			st = prq_remove(prq, &values[op->value]);
+			break;
+		default:
+			st = DS_ERR_INVALID_ARGUMENT;
+		}
+	}
+
+	// The values are not processes of their own, they must not be deleted
+	while (!prq_is_empty(prq) && prq_dequeue(prq, &prc) == DS_OK)
+		;
+
+	Status dl = prq_delete_queue(&prq);
+
+	return st != DS_OK ? st : dl;
+}
+
+// Best time of repeats replays. The dequeue order must be the recorded one.
+Status bch_replay(BenchLog *log, size_t repeats, double *seconds)
+{
+	if (log == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Process *values = calloc(log->values, sizeof(Process));
+
+	if (!values)
+		return DS_ERR_ALLOC;
+
+	Status st = DS_OK;
+
+	*seconds = 0;
+
+	size_t i;
+	for (i = 0; i < repeats && st == DS_OK; i++)
+	{
+		uint64_t check;
+
+		double start = bch_now();
+
+		st = bch_replay_once(log, values, &check);
+
+		double elapsed = bch_now() - start;
+
+		if (st == DS_OK && check != log->check)
+			st = DS_ERR_UNEXPECTED_RESULT;
+
+		if (i == 0 || elapsed < *seconds)
+			*seconds = elapsed;
+	}
+
+	free(values);
+
+	return st;
+}
+
+Status bch_report(BenchLog *log, double seconds, size_t repeats)
+{
+	if (log == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t changes = log->count[BENCH_ENQUEUE] + log->count[BENCH_UPDATE];
+
+	printf("%-16s%lu (", "Operations", log->length);
+
+	size_t kind;
+	for (kind = 0; kind < BENCH_KINDS; kind++)
+		printf("%s%s %.1f%%", kind > 0 ? ", " : "", bch_kind_names[kind],
+			   log->length > 0 ? 100.0 * log->count[kind] / log->length : 0.0);
+
+	printf(")\n");
+	printf("%-16s%lu of %lu processes\n", "Peak length", log->peak, log->values);
+	printf("%-16s%.1f%% of enqueues and updates\n", "Below last", changes > 0 ? 100.0 * log->below / changes : 0.0);
+	printf("%-16s%.3f ms, %.1f ns per operation (best of %lu)\n", "Time", seconds * 1e3,
+		   log->length > 0 ? seconds * 1e9 / log->length : 0.0, repeats);
+	printf("%-16s%016llx\n", "Order", (unsigned long long)log->check);
+
+	return DS_OK;
+}
+
+Status bch_delete(BenchLog **log)
+{
+	if ((*log) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	free((*log)->ops);
+	free((*log));
+
+	(*log) = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Bench.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Benchmarks
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                             Checks
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Check.c */
+
+// Few distinct CPU bursts and long I/O bursts, so equal keys are everywhere
+// and first arrivals often come on the tick some I/O burst ends
+static void chk_workload(WorkloadSpec *spec)
+{
+	wkl_default(spec);
+
+	spec->processes = CHECK_PROCESSES;
+	spec->cpu = (Distribution){DIST_UNIFORM, 1, 4};
+	spec->io = (Distribution){DIST_UNIFORM, 100, 400};
+	spec->arriving = true;
+	spec->gap = (Distribution){DIST_UNIFORM, 0, 6};
+	spec->bursty = true;
+	spec->bursts = (Distribution){DIST_UNIFORM, 1, 2};
+}
+
+// Takes row out of table, or gives it the next priority when remove is false
+static Status chk_edit(QueueArray *table, size_t row, bool remove)
+{
+	Process *prc = table->buffer[row];
+
+	if (!remove)
+	{
+		prc->pri = (prc->pri + 1) % (PROCESS_MAX_PRI + 1);
+
+		return DS_OK;
+	}
+
+	memmove(table->buffer + row, table->buffer + row + 1, (table->length - row - 1) * sizeof(Process *));
+
+	(table->length)--;
+
+	return prc_delete(&prc);
+}
+
+// Position of the first process two runs of the same table did not finish
+// alike, the length of the shorter one when every process before it did
+static size_t chk_differ(QueueArray *run, QueueArray *full)
+{
+	size_t length = run->length < full->length ? run->length : full->length, i;
+
+	for (i = 0; i < length; i++)
+	{
+		Process *a = run->buffer[i], *b = full->buffer[i];
+
+		if (a->pid != b->pid || a->finish != b->finish || a->first_run != b->first_run ||
+			a->waiting != b->waiting || a->blocked != b->blocked)
+			break;
+	}
+
+	return i;
+}
+
+/**
+ * Runs every algorithm of algorithms on generated tables, then CHECK_EDITS
+ * times more with one row removed or given another priority each time.
+ * Those runs resume from the checkpoints of the run before, and a run of
+ * the same table from scratch has to finish every process at the same tick
+ * and in the same order. DS_ERR_UNEXPECTED_RESULT when one does not.
+ */
+Status chk_resume(bool *algorithms, size_t tables, size_t seed)
+{
+	if (algorithms == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	WorkloadSpec spec;
+
+	chk_workload(&spec);
+
+	size_t runs = 0, resumes = 0, failures = 0, sample, alg, edit;
+
+	Status st = DS_OK;
+
+	for (sample = 0; sample < tables && st == DS_OK; sample++)
+	{
+		Random rng;
+
+		rng_seed(&rng, seed, sample);
+
+		QueueArray *generated;
+
+		st = wkl_generate(&spec, &rng, &generated);
+
+		if (st != DS_OK)
+			break;
+
+		for (alg = 0; alg < ALG_COUNT && st == DS_OK; alg++)
+		{
+			if (!algorithms[alg])
+				continue;
+
+			CheckpointLog *log, *fresh;
+
+			QueueArray *table, *result, *full;
+
+			size_t resumed, started;
+
+			st = qua_copy(generated, &table);
+
+			if (st != DS_OK)
+				break;
+
+			st = ckp_init(&log, alg, NULL);
+
+			if (st != DS_OK)
+			{
+				qua_delete(&table);
+
+				break;
+			}
+
+			st = ckp_simulate(log, table, &result, NULL, false, &resumed);
+
+			for (edit = 0; edit < CHECK_EDITS && st == DS_OK; edit++)
+			{
+				size_t row = (edit + 1) * table->length / (CHECK_EDITS + 1), pid = table->buffer[row]->pid;
+
+				bool remove = edit % 2 == 0;
+
+				st = chk_edit(table, row, remove);
+
+				if (st == DS_OK)
+					st = ckp_simulate(log, table, &result, NULL, false, &resumed);
+
+				// The same table from scratch, on a log of its own
+				if (st == DS_OK && (st = ckp_init(&fresh, alg, NULL)) == DS_OK)
+				{
+					st = ckp_simulate(fresh, table, &full, NULL, false, &started);
+
+					if (st == DS_OK)
+					{
+						size_t i = chk_differ(result, full);
+
+						runs++;
+
+						if (resumed > 0)
+							resumes++;
+
+						if (i < result->length || i < full->length)
+						{
+							failures++;
+
+							printf("%s, table %lu, PID %lu %s: resumed at tick %lu, ", alg_names[alg], sample + 1, pid,
+								   remove ? "removed" : "reprioritized", resumed);
+
+							if (i < result->length && i < full->length)
+								printf("finish %lu is PID %lu at tick %lu, PID %lu at tick %lu in a full run\n", i + 1,
+									   result->buffer[i]->pid, result->buffer[i]->finish, full->buffer[i]->pid,
+									   full->buffer[i]->finish);
+							else
+								printf("%lu processes finished, %lu in a full run\n", result->length, full->length);
+						}
+					}
+
+					ckp_delete(&fresh);
+				}
+			}
+
+			ckp_delete(&log);
+
+			qua_delete(&table);
+		}
+
+		qua_delete(&generated);
+	}
+
+	if (st != DS_OK)
+		return st;
+
+	printf("Resume: %lu runs after a row changed, %lu resumed from a checkpoint, %lu unlike a full run\n", runs,
+		   resumes, failures);
+
+	return failures == 0 ? DS_OK : DS_ERR_UNEXPECTED_RESULT;
+}
+
+/**
+ * Random pushes, pops and boosts, often several boosts before the processes
+ * of the first one ran, on a MultilevelQueue and on plain level arrays
+ * where a boost moves every process to the end of level 0, level by level.
+ * Both have to give the same processes in the same order, at the same
+ * level. DS_ERR_UNEXPECTED_RESULT when they do not.
+ */
+Status chk_boost(size_t seed)
+{
+	MultilevelQueue *mlq;
+
+	Status st = mlq_init(&mlq, CHECK_LEVELS);
+
+	if (st != DS_OK)
+		return st;
+
+	Process pool[CHECK_QUEUED], *idle[CHECK_QUEUED], *level[CHECK_LEVELS][CHECK_QUEUED];
+
+	size_t idles = CHECK_QUEUED, length[CHECK_LEVELS] = {0}, overlaps = 0, operation, i, j;
+
+	memset(pool, 0, sizeof(pool));
+
+	for (i = 0; i < CHECK_QUEUED; i++)
+		idle[i] = &pool[i];
+
+	Random rng;
+
+	rng_seed(&rng, seed, 0);
+
+	for (operation = 0; operation < CHECK_OPERATIONS && st == DS_OK; operation++)
+	{
+		size_t draw = rng_range(&rng, 0, 9);
+
+		if (draw < 5 && idles > 0)
+		{
+			Process *prc = idle[--idles];
+
+			size_t to = rng_range(&rng, 0, CHECK_LEVELS - 1);
+
+			st = mlq_push(mlq, prc, to);
+
+			level[to][(length[to])++] = prc;
+		}
+		else if (draw < 9 && !mlq_is_empty(mlq))
+		{
+			Process *prc, *expected;
+
+			for (i = 0; length[i] == 0; i++)
+				;
+
+			expected = level[i][0];
+
+			memmove(level[i], level[i] + 1, (--(length[i])) * sizeof(Process *));
+
+			st = mlq_pop(mlq, &prc);
+
+			if (st == DS_OK && (prc != expected || prc->level != i))
+			{
+				printf("Boost: operation %lu gave process %ld at level %lu instead of process %ld at level %lu\n",
+					   operation + 1, (long)(prc - pool), prc->level, (long)(expected - pool), i);
+
+				st = DS_ERR_UNEXPECTED_RESULT;
+			}
+
+			idle[idles++] = prc;
+		}
+		else if (draw == 9)
+		{
+			if (mlq->pending != 0)
+				overlaps++;
+
+			mlq_boost(mlq, rng_range(&rng, 1, 3));
+
+			for (i = 1; i < CHECK_LEVELS; i++)
+			{
+				for (j = 0; j < length[i]; j++)
+					level[0][(length[0])++] = level[i][j];
+
+				length[i] = 0;
+			}
+		}
+	}
+
+	// The processes are in pool, not the queue's to delete
+	Process *prc;
+
+	while (!mlq_is_empty(mlq))
+		mlq_pop(mlq, &prc);
+
+	mlq_delete(&mlq);
+
+	if (st != DS_OK)
+		return st;
+
+	printf("Boost: %lu queue operations, %lu boosts with an earlier one pending, like plain level queues\n", operation,
+		   overlaps);
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Check.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                             Checks
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                             Daemon
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Daemon.c */
+
+Status dmn_send(int fd, const void *buffer, size_t length)
+{
+	const char *bytes = buffer;
+
+	while (length > 0)
+	{
+		ssize_t sent = send(fd, bytes, length, MSG_NOSIGNAL);
+
+		if (sent < 0 && errno == EINTR)
+			continue;
+
+		if (sent <= 0)
+			return DS_ERR_UNEXPECTED_RESULT;
+
+		bytes += sent;
+		length -= (size_t)sent;
+	}
+
+	return DS_OK;
+}
+
+// DS_ERR_NOT_FOUND when the peer closed before the first byte
+Status dmn_receive(int fd, void *buffer, size_t length)
+{
+	char *bytes = buffer;
+
+	size_t done = 0;
+
+	while (done < length)
+	{
+		ssize_t got = recv(fd, bytes + done, length - done, 0);
+
+		if (got < 0 && errno == EINTR)
+			continue;
+
+		if (got == 0 && done == 0)
+			return DS_ERR_NOT_FOUND;
+
+		if (got <= 0)
+			return DS_ERR_UNEXPECTED_RESULT;
+
+		done += (size_t)got;
+	}
+
+	return DS_OK;
+}
+
+static Status dmn_address(const char *path, struct sockaddr_un *address)
+{
+	if (strlen(path) >= sizeof(address->sun_path))
+		return DS_ERR_INVALID_ARGUMENT;
+
+	memset(address, 0, sizeof(struct sockaddr_un));
+
+	address->sun_family = AF_UNIX;
+
+	strcpy(address->sun_path, path);
+
+	return DS_OK;
+}
+
+Status dmn_connect(const char *path, int *fd)
+{
+	struct sockaddr_un address;
+
+	Status st = dmn_address(path, &address);
+
+	if (st != DS_OK)
+		return st;
+
+	*fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (*fd < 0)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	if (connect(*fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+	{
+		close(*fd);
+
+		return DS_ERR_NOT_FOUND;
+	}
+
+	return DS_OK;
+}
+
+// Index of the table named path in dmn->tables, dmn->loaded when it is not
+// loaded. Only with tables_lock held.
+static size_t dmn_find(Daemon *dmn, const char *path)
+{
+	size_t i;
+	for (i = 0; i < dmn->loaded; i++)
+	{
+		if (strcmp(dmn->tables[i].path, path) == 0)
+			break;
+	}
+
+	return i;
+}
+
+/**
+ * The table named path, loaded by the first request that needs it. The
+ * file is read without tables_lock, so a slow load does not hold up the
+ * requests for tables already loaded. Two requests that load the same table
+ * at once both read it and the second one to finish drops its copy.
+ */
+static Status dmn_table(Daemon *dmn, const char *path, QueueArray **table)
+{
+	pthread_mutex_lock(&dmn->tables_lock);
+
+	size_t i = dmn_find(dmn, path);
+
+	bool found = i < dmn->loaded;
+
+	if (found)
+		*table = dmn->tables[i].table;
+
+	pthread_mutex_unlock(&dmn->tables_lock);
+
+	if (found)
+		return DS_OK;
+
+	char *name = malloc(strlen(path) + 1);
+
+	if (!name)
+		return DS_ERR_ALLOC;
+
+	strcpy(name, path);
+
+	QueueArray *loaded;
+
+	Status st = file_load_table(name, &loaded);
+
+	if (st != DS_OK)
+	{
+		free(name);
+
+		return st;
+	}
+
+	pthread_mutex_lock(&dmn->tables_lock);
+
+	i = dmn_find(dmn, path);
+
+	if (i == dmn->loaded)
+	{
+		DaemonTable *tables = realloc(dmn->tables, sizeof(DaemonTable) * (dmn->loaded + 1));
+
+		if (tables)
+		{
+			dmn->tables = tables;
+
+			tables[i].path = name;
+			tables[i].table = loaded;
+
+			dmn->loaded++;
+
+			name = NULL;
+			loaded = NULL;
+		}
+		else
+			st = DS_ERR_ALLOC;
+	}
+
+	if (st == DS_OK)
+		*table = dmn->tables[i].table;
+
+	pthread_mutex_unlock(&dmn->tables_lock);
+
+	// Another request loaded it first, or there was no room for it
+	if (loaded != NULL)
+	{
+		qua_delete(&loaded);
+
+		free(name);
+	}
+
+	return st;
+}
+
+static Status dmn_options(DaemonJob *job, SchedulerParams *params)
+{
+	sch_default_params(params);
+
+	char *option = job->body + job->request.path + 1;
+	char *end = option + job->request.options;
+
+	while (option < end)
+	{
+		char *value = option + strlen(option) + 1;
+
+		if (value >= end)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		Status st = sch_parse_param(params, option, value);
+
+		if (st == DS_ERR_NOT_FOUND)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		if (st != DS_OK)
+			return st;
+
+		option = value + strlen(value) + 1;
+	}
+
+	return DS_OK;
+}
+
+static Status dmn_execute(Daemon *dmn, DaemonJob *job, SimulationMetrics *result)
+{
+	if (job->request.algorithm >= ALG_COUNT)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	SchedulerParams params;
+
+	Status st = dmn_options(job, &params);
+
+	if (st != DS_OK)
+		return st;
+
+	QueueArray *table, *queue, *finished;
+
+	st = dmn_table(dmn, job->body, &table);
+
+	if (st != DS_OK)
+		return st;
+
+	Metrics *metrics;
+
+	st = met_init(&metrics);
+
+	if (st != DS_OK)
+		return st;
+
+	st = qua_copy(table, &queue);
+
+	if (st == DS_OK)
+	{
+		st = alg_table[job->request.algorithm](queue, &finished, &params, metrics, NULL, false);
+
+		if (st == DS_OK)
+		{
+			met_summary(metrics, result);
+
+			qua_delete(&finished);
+		}
+
+		qua_delete(&queue);
+	}
+
+	met_delete(&metrics);
+
+	return st;
+}
+
+static void dmn_release(DaemonConnection *con)
+{
+	Daemon *dmn = con->daemon;
+
+	close(con->fd);
+
+	pthread_mutex_lock(&dmn->lock);
+
+	DaemonConnection **link = &dmn->connections;
+
+	while (*link != con)
+		link = &((*link)->next);
+
+	*link = con->next;
+
+	dmn->open--;
+
+	pthread_cond_signal(&dmn->idle);
+
+	pthread_mutex_unlock(&dmn->lock);
+
+	pthread_mutex_destroy(&con->lock);
+	pthread_cond_destroy(&con->answered);
+
+	free(con);
+}
+
+static void *dmn_worker(void *arg)
+{
+	Daemon *dmn = arg;
+
+	while (true)
+	{
+		pthread_mutex_lock(&dmn->lock);
+
+		while (dmn->head == NULL && !dmn->stop)
+			pthread_cond_wait(&dmn->ready, &dmn->lock);
+
+		DaemonJob *job = dmn->head;
+
+		if (job != NULL)
+		{
+			dmn->head = job->next;
+
+			if (dmn->head == NULL)
+				dmn->tail = NULL;
+		}
+
+		pthread_mutex_unlock(&dmn->lock);
+
+		if (job == NULL)
+			break;
+
+		DaemonReply reply;
+
+		memset(&reply, 0, sizeof(DaemonReply));
+
+		reply.id = job->request.id;
+		reply.status = dmn_execute(dmn, job, &reply.metrics);
+
+		DaemonConnection *con = job->connection;
+
+		pthread_mutex_lock(&con->lock);
+
+		// A client that went away only loses its own replies
+		dmn_send(con->fd, &reply, sizeof(DaemonReply));
+
+		if (con->pending-- == DAEMON_MAX_WINDOW)
+			pthread_cond_signal(&con->answered);
+
+		bool last = con->pending == 0 && con->closed;
+
+		pthread_mutex_unlock(&con->lock);
+
+		if (last)
+			dmn_release(con);
+
+		pthread_mutex_lock(&dmn->lock);
+		dmn->served++;
+		pthread_mutex_unlock(&dmn->lock);
+
+		free(job->body);
+		free(job);
+	}
+
+	return NULL;
+}
+
+// Reads requests until the client closes or breaks the protocol
+static void *dmn_reader(void *arg)
+{
+	DaemonConnection *con = arg;
+	Daemon *dmn = con->daemon;
+
+	while (true)
+	{
+		// A full window leaves the rest of the requests in the socket
+		pthread_mutex_lock(&con->lock);
+
+		while (con->pending >= DAEMON_MAX_WINDOW)
+			pthread_cond_wait(&con->answered, &con->lock);
+
+		pthread_mutex_unlock(&con->lock);
+
+		DaemonJob *job = malloc(sizeof(DaemonJob));
+
+		if (!job)
+			break;
+
+		if (dmn_receive(con->fd, &job->request, sizeof(DaemonRequest)) != DS_OK ||
+			job->request.magic != DAEMON_MAGIC || job->request.path == 0 ||
+			job->request.options > DAEMON_MAX_OPTIONS)
+		{
+			free(job);
+
+			break;
+		}
+
+		size_t path = job->request.path, options = job->request.options;
+
+		job->body = malloc(path + 1 + options);
+
+		if (!job->body || dmn_receive(con->fd, job->body, path) != DS_OK ||
+			dmn_receive(con->fd, job->body + path + 1, options) != DS_OK ||
+			(options > 0 && job->body[path + options] != '\0'))
+		{
+			free(job->body);
+			free(job);
+
+			break;
+		}
+
+		job->body[path] = '\0';
+		job->connection = con;
+		job->next = NULL;
+
+		pthread_mutex_lock(&con->lock);
+		con->pending++;
+		pthread_mutex_unlock(&con->lock);
+
+		pthread_mutex_lock(&dmn->lock);
+
+		if (dmn->tail != NULL)
+			dmn->tail->next = job;
+		else
+			dmn->head = job;
+
+		dmn->tail = job;
+
+		pthread_cond_signal(&dmn->ready);
+
+		pthread_mutex_unlock(&dmn->lock);
+	}
+
+	pthread_mutex_lock(&con->lock);
+
+	con->closed = true;
+
+	bool last = con->pending == 0;
+
+	pthread_mutex_unlock(&con->lock);
+
+	if (last)
+		dmn_release(con);
+
+	return NULL;
+}
+
+static Status dmn_accept(Daemon *dmn, int fd)
+{
+	DaemonConnection *con = malloc(sizeof(DaemonConnection));
+
+	if (!con)
+	{
+		close(fd);
+
+		return DS_ERR_ALLOC;
+	}
+
+	con->fd = fd;
+	con->pending = 0;
+	con->closed = false;
+	con->daemon = dmn;
+
+	pthread_mutex_init(&con->lock, NULL);
+	pthread_cond_init(&con->answered, NULL);
+
+	pthread_mutex_lock(&dmn->lock);
+
+	con->next = dmn->connections;
+	dmn->connections = con;
+	dmn->open++;
+
+	pthread_mutex_unlock(&dmn->lock);
+
+	pthread_t id;
+
+	if (pthread_create(&id, NULL, dmn_reader, con) != 0)
+	{
+		pthread_mutex_lock(&con->lock);
+		con->closed = true;
+		pthread_mutex_unlock(&con->lock);
+
+		dmn_release(con);
+
+		return DS_ERR_UNEXPECTED_RESULT;
+	}
+
+	pthread_detach(id);
+
+	return DS_OK;
+}
+
+Status dmn_init(Daemon **dmn, const char *path, size_t threads)
+{
+	if (threads == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	struct sockaddr_un address;
+
+	Status st = dmn_address(path, &address);
+
+	if (st != DS_OK)
+		return st;
+
+	// Only a socket file left by a daemon that did not stop cleanly is
+	// removed, not another file and not the socket of one still running
+	struct stat info;
+
+	if (lstat(path, &info) == 0)
+	{
+		if (!S_ISSOCK(info.st_mode))
+			return DS_ERR_INVALID_ARGUMENT;
+
+		int fd;
+
+		if (dmn_connect(path, &fd) == DS_OK)
+		{
+			close(fd);
+
+			return DS_ERR_INVALID_OPERATION;
+		}
+
+		unlink(path);
+	}
+
+	(*dmn) = malloc(sizeof(Daemon));
+
+	if (!(*dmn))
+		return DS_ERR_ALLOC;
+
+	(*dmn)->path = malloc(strlen(path) + 1);
+	(*dmn)->workers = malloc(sizeof(pthread_t) * threads);
+
+	if (!(*dmn)->path || !(*dmn)->workers)
+	{
+		free((*dmn)->path);
+		free((*dmn)->workers);
+		free(*dmn);
+
+		*dmn = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	strcpy((*dmn)->path, path);
+
+	(*dmn)->threads = threads;
+	(*dmn)->head = NULL;
+	(*dmn)->tail = NULL;
+	(*dmn)->connections = NULL;
+	(*dmn)->open = 0;
+	(*dmn)->stop = false;
+	(*dmn)->signaled = false;
+	(*dmn)->tables = NULL;
+	(*dmn)->loaded = 0;
+	(*dmn)->served = 0;
+
+	pthread_mutex_init(&(*dmn)->lock, NULL);
+	pthread_cond_init(&(*dmn)->ready, NULL);
+	pthread_cond_init(&(*dmn)->idle, NULL);
+	pthread_mutex_init(&(*dmn)->tables_lock, NULL);
+
+	(*dmn)->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if ((*dmn)->listener < 0 ||
+		bind((*dmn)->listener, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+		listen((*dmn)->listener, SOMAXCONN) != 0)
+	{
+		if ((*dmn)->listener >= 0)
+			close((*dmn)->listener);
+
+		(*dmn)->listener = -1;
+
+		dmn_delete(dmn);
+
+		return DS_ERR_UNEXPECTED_RESULT;
+	}
+
+	return DS_OK;
+}
+
+// Waits for SIGINT or SIGTERM and wakes the accept of dmn_serve
+static void *dmn_waiter(void *arg)
+{
+	Daemon *dmn = arg;
+
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	sigaddset(&set, SIGTERM);
+
+	int signal;
+
+	sigwait(&set, &signal);
+
+	pthread_mutex_lock(&dmn->lock);
+	dmn->signaled = true;
+	pthread_mutex_unlock(&dmn->lock);
+
+	shutdown(dmn->listener, SHUT_RDWR);
+
+	return NULL;
+}
+
+/**
+ * Accepts connections until SIGINT or SIGTERM. The signals are blocked in
+ * every thread of the daemon and taken by dmn_waiter with sigwait, so no
+ * handler ever runs. Then every connection is shut down, the requests
+ * already read are answered and the workers are joined.
+ */
+Status dmn_serve(Daemon *dmn)
+{
+	if (dmn == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	sigset_t blocked, previous;
+
+	sigemptyset(&blocked);
+	sigaddset(&blocked, SIGINT);
+	sigaddset(&blocked, SIGTERM);
+
+	pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+
+	dmn->signaled = false;
+
+	Status st = DS_OK;
+
+	pthread_t waiter;
+
+	if (pthread_create(&waiter, NULL, dmn_waiter, dmn) != 0)
+	{
+		pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+		return DS_ERR_UNEXPECTED_RESULT;
+	}
+
+	size_t i, started = 0;
+	for (i = 0; i < dmn->threads; i++)
+	{
+		if (pthread_create(&dmn->workers[i], NULL, dmn_worker, dmn) != 0)
+		{
+			st = DS_ERR_UNEXPECTED_RESULT;
+
+			break;
+		}
+
+		started++;
+	}
+
+	while (st == DS_OK)
+	{
+		int fd = accept(dmn->listener, NULL, NULL);
+
+		if (fd >= 0)
+		{
+			// Out of descriptors or memory only costs that one client
+			dmn_accept(dmn, fd);
+
+			continue;
+		}
+
+		if (errno == EINTR || errno == ECONNABORTED)
+			continue;
+
+		pthread_mutex_lock(&dmn->lock);
+
+		if (!dmn->signaled)
+			st = DS_ERR_UNEXPECTED_RESULT;
+
+		pthread_mutex_unlock(&dmn->lock);
+
+		break;
+	}
+
+	// The waiter is still in sigwait when accept failed on its own
+	if (st != DS_OK)
+		pthread_kill(waiter, SIGTERM);
+
+	pthread_join(waiter, NULL);
+
+	close(dmn->listener);
+
+	dmn->listener = -1;
+
+	unlink(dmn->path);
+
+	pthread_mutex_lock(&dmn->lock);
+
+	DaemonConnection *con;
+	for (con = dmn->connections; con != NULL; con = con->next)
+		shutdown(con->fd, SHUT_RD);
+
+	while (dmn->open > 0 && started > 0)
+		pthread_cond_wait(&dmn->idle, &dmn->lock);
+
+	dmn->stop = true;
+
+	pthread_cond_broadcast(&dmn->ready);
+
+	pthread_mutex_unlock(&dmn->lock);
+
+	for (i = 0; i < started; i++)
+		pthread_join(dmn->workers[i], NULL);
+
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	return st;
+}
+
+Status dmn_delete(Daemon **dmn)
+{
+	if ((*dmn) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if ((*dmn)->listener >= 0)
+	{
+		close((*dmn)->listener);
+
+		unlink((*dmn)->path);
+	}
+
+	size_t i;
+	for (i = 0; i < (*dmn)->loaded; i++)
+	{
+		free((*dmn)->tables[i].path);
+
+		qua_delete(&((*dmn)->tables[i].table));
+	}
+
+	pthread_mutex_destroy(&(*dmn)->lock);
+	pthread_cond_destroy(&(*dmn)->ready);
+	pthread_cond_destroy(&(*dmn)->idle);
+	pthread_mutex_destroy(&(*dmn)->tables_lock);
+
+	free((*dmn)->tables);
+	free((*dmn)->workers);
+	free((*dmn)->path);
+	free(*dmn);
+
+	*dmn = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Daemon.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                             Daemon
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                        Result Cache
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- ResultCache.c */
+
+enum
+{
+#define X(field) RESULT_FIELD_##field,
+	PROCESS_FIELDS(X)
+#undef X
+		RESULT_PROCESS_VALUES
+};
+
+// FNV-1a with its 128 bit prime, going on from digest
+static void rch_hash(const unsigned char *data, size_t length, uint64_t digest[2])
+{
+	unsigned __int128 hash = ((unsigned __int128)digest[0] << 64) | digest[1];
+	const unsigned __int128 prime = ((unsigned __int128)1 << 88) | 0x13b;
+
+	size_t i;
+	for (i = 0; i < length; i++)
+	{
+		hash ^= data[i];
+		hash *= prime;
+	}
+
+	digest[0] = (uint64_t)(hash >> 64);
+	digest[1] = (uint64_t)hash;
+}
+
+static void rch_encode_table(SnapshotWriter *wrt, QueueArray *table)
+{
+	snp_put_size(wrt, table->length);
+
+	size_t i, j;
+	for (i = 0; i < table->length; i++)
+	{
+		Process *prc = table->buffer[i];
+
+		snp_put_string(wrt, prc->name);
+		snp_put_string(wrt, prc->type);
+
+		snp_put_size(wrt, prc->pid);
+		snp_put_size(wrt, prc->cpu);
+		snp_put_size(wrt, prc->io);
+		snp_put_size(wrt, prc->pri);
+		snp_put_size(wrt, prc->period);
+		snp_put_size(wrt, prc->deadline);
+		snp_put_size(wrt, prc->arrival);
+		snp_put_size(wrt, prc->bursts);
+
+		for (j = 0; j < prc->bursts; j++)
+			snp_put_size(wrt, prc->arena->burst[prc->first_burst + j]);
+	}
+}
+
+static void rch_encode_params(SnapshotWriter *wrt, AlgorithmId alg, const SchedulerParams *params)
+{
+	snp_put_size(wrt, RESULT_CACHE_VERSION);
+	snp_put_size(wrt, alg);
+
+	snp_put_size(wrt, params->aging);
+	snp_put_size(wrt, params->mlfq_levels);
+
+	size_t i;
+	for (i = 0; i < params->mlfq_levels; i++)
+		snp_put_size(wrt, params->mlfq_quantum[i]);
+
+	snp_put_size(wrt, params->mlfq_boost);
+	snp_put_size(wrt, params->cfs_latency);
+	snp_put_size(wrt, params->cfs_granularity);
+	snp_put_size(wrt, params->lottery_seed);
+	snp_put_size(wrt, params->horizon);
+	snp_put_size(wrt, params->events);
+
+	for (i = 0; i < params->events; i++)
+	{
+		snp_put_size(wrt, params->event[i].tick);
+		snp_put_size(wrt, params->event[i].pid);
+		snp_put_size(wrt, params->event[i].pri);
+	}
+}
+
+/**
+ * Key of the result of running alg on table with params. table has to be the
+ * exact queue the algorithm will be given, and the same table until the
+ * next rch_invalidate.
+ */
+Status rch_key(ResultCache *cache, QueueArray *table, AlgorithmId alg, const SchedulerParams *params, ResultKey *key)
+{
+	if (cache == NULL || table == NULL || params == NULL || key == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	SnapshotWriter wrt = {cache->input, NULL, false, NULL, 0, DS_OK};
+
+	if (!cache->encoded)
+	{
+		cache->input->length = 0;
+
+		rch_encode_table(&wrt, table);
+
+		if (wrt.st != DS_OK)
+			return wrt.st;
+
+		cache->table = cache->input->length;
+		cache->encoded = true;
+
+		// The offset basis
+		cache->state[0] = 0x6c62272e07bb0142ULL;
+		cache->state[1] = 0x62b821756295c58dULL;
+
+		rch_hash(cache->input->buffer, cache->table, cache->state);
+	}
+
+	cache->input->length = cache->table;
+
+	rch_encode_params(&wrt, alg, params);
+
+	if (wrt.st != DS_OK)
+		return wrt.st;
+
+	key->input = cache->input->buffer;
+	key->length = cache->input->length;
+
+	key->digest[0] = cache->state[0];
+	key->digest[1] = cache->state[1];
+
+	rch_hash(key->input + cache->table, key->length - cache->table, key->digest);
+
+	return DS_OK;
+}
+
+// Whether entry was stored under key
+static bool rch_matches(ResultEntry *entry, ResultKey *key)
+{
+	return entry->digest[0] == key->digest[0] && entry->digest[1] == key->digest[1] &&
+		   entry->length == key->length && memcmp(entry->input, key->input, key->length) == 0;
+}
+
+// prc_copy with the times of the run as well
+static Status rch_copy_process(Process *prc, Process **result)
+{
+	Status st = prc_copy(prc, result);
+
+	if (st != DS_OK)
+		return st;
+
+	String *name = (*result)->name, *type = (*result)->type;
+
+	**result = *prc;
+
+	(*result)->name = name;
+	(*result)->type = type;
+
+	return DS_OK;
+}
+
+static Status rch_copy(QueueArray *finished, QueueArray **result)
+{
+	Status st = qua_init(result);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t i;
+	for (i = 0; i < finished->length; i++)
+	{
+		Process *prc;
+
+		st = rch_copy_process(finished->buffer[i], &prc);
+
+		if (st != DS_OK)
+			return st;
+
+		st = qua_enqueue(*result, prc);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+static void rch_path(ResultCache *cache, uint64_t digest[2], char *path, size_t size)
+{
+	snprintf(path, size, "%s/%016llx%016llx", cache->directory, (unsigned long long)digest[0],
+			 (unsigned long long)digest[1]);
+}
+
+static Status rch_write_string(FILE *file, String *str)
+{
+	uint64_t length = str->len;
+
+	if (fwrite(&length, sizeof(uint64_t), 1, file) != 1 || fwrite(str->buffer, 1, str->len, file) != str->len)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	return DS_OK;
+}
+
+static Status rch_read_string(FILE *file, String **str)
+{
+	uint64_t length;
+
+	if (fread(&length, sizeof(uint64_t), 1, file) != 1 || length > UINT32_MAX)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	char *text = malloc(length + 1);
+
+	if (!text)
+		return DS_ERR_ALLOC;
+
+	Status st = DS_ERR_UNEXPECTED_RESULT;
+
+	if (fread(text, 1, length, file) == length)
+		st = file_make_string(str, text, length);
+
+	free(text);
+
+	return st;
+}
+
+/**
+ * File layout, all in host byte order: magic, version, sizeof(Metrics), the
+ * digest, the length of the input and its bytes, the Metrics as they are in
+ * memory and the number of processes, then
+ * for each process its name and type, each one a length and its bytes,
+ * and the PROCESS_FIELDS as 64 bit words. Written to a temporary
+ * file and renamed, so a reader never sees half a result.
+ */
+static Status rch_save(ResultCache *cache, ResultEntry *entry)
+{
+	char path[PATH_MAX], temporary[PATH_MAX + 16];
+
+	rch_path(cache, entry->digest, path, sizeof(path));
+
+	snprintf(temporary, sizeof(temporary), "%s.%ld", path, (long)getpid());
+
+	// Only fails when it already exists, or else fopen reports it
+	mkdir(cache->directory, 0755);
+
+	FILE *file = fopen(temporary, "wb");
+
+	if (file == NULL)
+		return DS_ERR_UNEXPECTED_RESULT;
+
+	uint32_t header[3] = {RESULT_CACHE_MAGIC, RESULT_CACHE_VERSION, (uint32_t)sizeof(Metrics)};
+	uint64_t input = entry->length, length = entry->finished->length;
+
+	Status st = DS_OK;
+
+	if (fwrite(header, sizeof(header), 1, file) != 1 || fwrite(entry->digest, sizeof(entry->digest), 1, file) != 1 ||
+		fwrite(&input, sizeof(uint64_t), 1, file) != 1 || fwrite(entry->input, 1, entry->length, file) != entry->length ||
+		fwrite(&entry->metrics, sizeof(Metrics), 1, file) != 1 || fwrite(&length, sizeof(uint64_t), 1, file) != 1)
+		st = DS_ERR_UNEXPECTED_RESULT;
+
+	size_t i;
+	for (i = 0; i < entry->finished->length && st == DS_OK; i++)
+	{
+		Process *prc = entry->finished->buffer[i];
+
+		uint64_t value[RESULT_PROCESS_VALUES], *next = value;
+
+#define X(field) *next++ = prc->field;
+		PROCESS_FIELDS(X)
+#undef X
+
+		st = rch_write_string(file, prc->name);
+
+		if (st == DS_OK)
+			st = rch_write_string(file, prc->type);
+
+		if (st == DS_OK && fwrite(value, sizeof(value), 1, file) != 1)
+			st = DS_ERR_UNEXPECTED_RESULT;
+	}
+
+	if (fclose(file) != 0 && st == DS_OK)
+		st = DS_ERR_UNEXPECTED_RESULT;
+
+	if (st == DS_OK && rename(temporary, path) != 0)
+		st = DS_ERR_UNEXPECTED_RESULT;
+
+	if (st != DS_OK)
+		remove(temporary);
+
+	return st;
+}
+
+// DS_ERR_NOT_FOUND when there is no file for the key, it is not usable or
+// it was stored under another input with the same digest
+static Status rch_load(ResultCache *cache, ResultKey *key, ResultEntry *entry)
+{
+	char path[PATH_MAX];
+
+	rch_path(cache, key->digest, path, sizeof(path));
+
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL)
+		return DS_ERR_NOT_FOUND;
+
+	uint32_t header[3];
+	uint64_t input = 0, length = 0;
+
+	entry->finished = NULL;
+
+	entry->length = key->length;
+	entry->input = malloc(key->length > 0 ? key->length : 1);
+
+	Status st = entry->input != NULL ? DS_OK : DS_ERR_ALLOC;
+
+	if (st == DS_OK &&
+		(fread(header, sizeof(header), 1, file) != 1 || header[0] != RESULT_CACHE_MAGIC ||
+		 header[1] != RESULT_CACHE_VERSION || header[2] != sizeof(Metrics) ||
+		 fread(entry->digest, sizeof(entry->digest), 1, file) != 1 || fread(&input, sizeof(uint64_t), 1, file) != 1 ||
+		 input != key->length || fread(entry->input, 1, entry->length, file) != entry->length ||
+		 !rch_matches(entry, key) || fread(&entry->metrics, sizeof(Metrics), 1, file) != 1 ||
+		 fread(&length, sizeof(uint64_t), 1, file) != 1))
+		st = DS_ERR_NOT_FOUND;
+
+	if (st == DS_OK)
+		st = qua_init(&entry->finished);
+
+	size_t i;
+	for (i = 0; i < length && st == DS_OK; i++)
+	{
+		String *name = NULL, *type = NULL;
+
+		uint64_t value[RESULT_PROCESS_VALUES], *next = value;
+
+		st = rch_read_string(file, &name);
+
+		if (st == DS_OK)
+			st = rch_read_string(file, &type);
+
+		if (st == DS_OK && fread(value, sizeof(value), 1, file) != 1)
+			st = DS_ERR_UNEXPECTED_RESULT;
+
+		Process *prc;
+
+		if (st == DS_OK)
+			st = prc_init(&prc, name, 0, 0, 0, 0, type);
+
+		if (st != DS_OK)
+		{
+			if (name != NULL)
+				str_delete(&name);
+
+			if (type != NULL)
+				str_delete(&type);
+
+			break;
+		}
+
+#define X(field) prc->field = *next++;
+		PROCESS_FIELDS(X)
+#undef X
+
+		st = qua_enqueue(entry->finished, prc);
+	}
+
+	fclose(file);
+
+	if (st != DS_OK && entry->finished != NULL)
+		qua_delete(&entry->finished);
+
+	if (st != DS_OK)
+	{
+		free(entry->input);
+
+		entry->input = NULL;
+	}
+
+	// A damaged file is only a miss, the run replaces it
+	return st == DS_OK ? DS_OK : DS_ERR_NOT_FOUND;
+}
+
+// Takes over entry, dropping the oldest result when memory is full
+static ResultEntry *rch_keep(ResultCache *cache, ResultEntry *entry)
+{
+	ResultEntry *slot;
+
+	if (cache->length < RESULT_CACHE_ENTRIES)
+		slot = &cache->entries[cache->length++];
+	else
+	{
+		slot = &cache->entries[cache->oldest];
+
+		qua_delete(&slot->finished);
+
+		free(slot->input);
+
+		cache->oldest = (cache->oldest + 1) % RESULT_CACHE_ENTRIES;
+	}
+
+	*slot = *entry;
+
+	return slot;
+}
+
+Status rch_init(ResultCache **cache, const char *directory)
+{
+	(*cache) = malloc(sizeof(ResultCache));
+
+	if (!(*cache))
+		return DS_ERR_ALLOC;
+
+	(*cache)->entries = malloc(sizeof(ResultEntry) * RESULT_CACHE_ENTRIES);
+	(*cache)->directory = NULL;
+	(*cache)->input = NULL;
+
+	if (directory != NULL)
+	{
+		(*cache)->directory = malloc(strlen(directory) + 1);
+
+		if ((*cache)->directory)
+			strcpy((*cache)->directory, directory);
+	}
+
+	if ((*cache)->entries && (directory == NULL || (*cache)->directory))
+		snp_create(&((*cache)->input), 0);
+
+	if (!(*cache)->entries || (directory != NULL && !(*cache)->directory) || !(*cache)->input)
+	{
+		free((*cache)->entries);
+		free((*cache)->directory);
+		free(*cache);
+
+		*cache = NULL;
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*cache)->length = 0;
+	(*cache)->oldest = 0;
+	(*cache)->table = 0;
+	(*cache)->encoded = false;
+	(*cache)->hits = 0;
+	(*cache)->misses = 0;
+
+	return DS_OK;
+}
+
+// The table changed, it has to be encoded again
+void rch_invalidate(ResultCache *cache)
+{
+	cache->encoded = false;
+}
+
+// Copies the result stored under key into finished and metrics.
+// DS_ERR_NOT_FOUND when it was never stored, in memory or on disk.
+Status rch_lookup(ResultCache *cache, ResultKey *key, QueueArray **finished, Metrics *metrics)
+{
+	if (cache == NULL || key == NULL || metrics == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	ResultEntry *found = NULL;
+
+	size_t i;
+	for (i = 0; i < cache->length && found == NULL; i++)
+	{
+		if (rch_matches(&cache->entries[i], key))
+			found = &cache->entries[i];
+	}
+
+	if (found == NULL && cache->directory != NULL)
+	{
+		ResultEntry entry;
+
+		if (rch_load(cache, key, &entry) == DS_OK)
+			found = rch_keep(cache, &entry);
+	}
+
+	if (found == NULL)
+	{
+		cache->misses++;
+
+		return DS_ERR_NOT_FOUND;
+	}
+
+	cache->hits++;
+
+	*metrics = found->metrics;
+
+	return rch_copy(found->finished, finished);
+}
+
+// Keeps a copy of finished and metrics under key
+Status rch_store(ResultCache *cache, ResultKey *key, QueueArray *finished, Metrics *metrics)
+{
+	if (cache == NULL || key == NULL || finished == NULL || metrics == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	ResultEntry entry;
+
+	entry.digest[0] = key->digest[0];
+	entry.digest[1] = key->digest[1];
+
+	entry.length = key->length;
+	entry.input = malloc(key->length > 0 ? key->length : 1);
+
+	if (!entry.input)
+		return DS_ERR_ALLOC;
+
+	memcpy(entry.input, key->input, key->length);
+
+	entry.metrics = *metrics;
+
+	Status st = rch_copy(finished, &entry.finished);
+
+	if (st != DS_OK)
+	{
+		free(entry.input);
+
+		return st;
+	}
+
+	// The disk is only a second level, a run is not lost when it is full
+	if (cache->directory != NULL)
+		rch_save(cache, &entry);
+
+	rch_keep(cache, &entry);
+
+	return DS_OK;
+}
+
+Status rch_delete(ResultCache **cache)
+{
+	if ((*cache) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 0; i < (*cache)->length; i++)
+	{
+		qua_delete(&((*cache)->entries[i].finished));
+
+		free((*cache)->entries[i].input);
+	}
+
+	snp_delete(&((*cache)->input));
+
+	free((*cache)->entries);
+	free((*cache)->directory);
+	free(*cache);
+
+	*cache = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- ResultCache.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                        Result Cache
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                              Replay
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- Replay.c */
+
+// Drops every other snapshot but the first one and doubles the interval
+static void rpl_thin(Replay *rpl)
+{
+	size_t i, kept = 0;
+	for (i = 0; i < rpl->length; i++)
+	{
+		if (i % 2 == 0)
+			rpl->points[kept++] = rpl->points[i];
+		else
+		{
+			rpl->bytes -= rpl->points[i].snapshot->length;
+
+			snp_delete(&rpl->points[i].snapshot);
+		}
+	}
+
+	rpl->length = kept;
+	rpl->interval *= 2;
+}
+
+static Status rpl_point(Replay *rpl)
+{
+	Snapshot *snp;
+
+	Status st = snp_take(&snp, rpl->sch);
+
+	if (st != DS_OK)
+		return st;
+
+	rpl->points[rpl->length++] = (ReplayPoint){snp, rpl->step};
+	rpl->bytes += snp->length;
+
+	while (rpl->length > 1 && (rpl->length == REPLAY_MAX || rpl->bytes > REPLAY_BUDGET))
+		rpl_thin(rpl);
+
+	return DS_OK;
+}
+
+static Status rpl_record(Replay *rpl, size_t clock, size_t advance)
+{
+	ReplayDelta *last = rpl->runs > 0 ? &rpl->deltas[rpl->runs - 1] : NULL;
+
+	if (last != NULL && last->advance == advance)
+	{
+		(last->count)++;
+
+		return DS_OK;
+	}
+
+	if (rpl->runs == rpl->capacity)
+	{
+		ReplayDelta *deltas = realloc(rpl->deltas, sizeof(ReplayDelta) * rpl->capacity * 2);
+
+		if (!deltas)
+			return DS_ERR_ALLOC;
+
+		rpl->deltas = deltas;
+		rpl->capacity *= 2;
+	}
+
+	rpl->deltas[(rpl->runs)++] = (ReplayDelta){rpl->steps, clock, advance, 1};
+
+	return DS_OK;
+}
+
+// One step of the state shown, recorded when it goes past the frontier
+static Status rpl_advance(Replay *rpl)
+{
+	size_t clock = rpl->sch->clock;
+
+	Status st = sch_step(rpl->sch);
+
+	if (st != DS_OK)
+		return st;
+
+	(rpl->step)++;
+
+	if (rpl->step <= rpl->steps)
+		return DS_OK;
+
+	st = rpl_record(rpl, clock, rpl->sch->clock - clock);
+
+	if (st != DS_OK)
+		return st;
+
+	rpl->steps = rpl->step;
+	rpl->frontier = rpl->sch->clock;
+	rpl->done = sch_done(rpl->sch);
+
+	if (!rpl->done && rpl->sch->clock >= rpl->points[rpl->length - 1].snapshot->clock + rpl->interval)
+		return rpl_point(rpl);
+
+	return DS_OK;
+}
+
+// Steps of the last state at or before tick, which the deltas have to reach
+static size_t rpl_step_at(Replay *rpl, size_t tick)
+{
+	size_t low = 0, high = rpl->runs;
+
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+
+		if (rpl->deltas[middle].clock <= tick)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if (low == 0)
+		return 0;
+
+	ReplayDelta *delta = &rpl->deltas[low - 1];
+
+	size_t taken = delta->count;
+
+	if (delta->advance > 0 && (tick - delta->clock) / delta->advance < taken)
+		taken = (tick - delta->clock) / delta->advance;
+
+	return delta->step + taken;
+}
+
+// The state after step, which was already recorded
+static Status rpl_goto(Replay *rpl, size_t step)
+{
+	Status st;
+
+	if (step < rpl->step || step - rpl->step > rpl->interval)
+	{
+		size_t low = 0, high = rpl->length;
+
+		while (low < high)
+		{
+			size_t middle = low + (high - low) / 2;
+
+			if (rpl->points[middle].step <= step)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		ReplayPoint *point = &rpl->points[low - 1];
+
+		// Running on is cheaper when the state shown is past the snapshot
+		if (point->step > rpl->step || rpl->step > step)
+		{
+			Scheduler *sch;
+
+			st = snp_restore(point->snapshot, &sch, rpl->metrics);
+
+			if (st != DS_OK)
+				return st;
+
+			sch_delete(&rpl->sch);
+
+			rpl->sch = sch;
+			rpl->step = point->step;
+		}
+	}
+
+	while (rpl->step < step)
+	{
+		st = rpl_advance(rpl);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return DS_OK;
+}
+
+// Copies the rows of table into a scheduler that has taken no step yet
+Status rpl_init(Replay **rpl, QueueArray *table, AlgorithmId policy, const SchedulerParams *params)
+{
+	if (table == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	(*rpl) = malloc(sizeof(Replay));
+
+	if (!(*rpl))
+		return DS_ERR_ALLOC;
+
+	(*rpl)->sch = NULL;
+	(*rpl)->metrics = NULL;
+	(*rpl)->step = 0;
+	(*rpl)->length = 0;
+	(*rpl)->bytes = 0;
+	(*rpl)->interval = REPLAY_INTERVAL;
+	(*rpl)->runs = 0;
+	(*rpl)->capacity = 16;
+	(*rpl)->steps = 0;
+	(*rpl)->frontier = 0;
+	(*rpl)->deltas = malloc(sizeof(ReplayDelta) * (*rpl)->capacity);
+
+	Status st = (*rpl)->deltas ? met_init(&(*rpl)->metrics) : DS_ERR_ALLOC;
+
+	if (st == DS_OK)
+		st = sch_init(&(*rpl)->sch, policy, params);
+
+	size_t i;
+	for (i = 0; i < table->length && st == DS_OK; i++)
+	{
+		Process *prc;
+
+		st = prc_copy(table->buffer[i], &prc);
+
+		if (st == DS_OK && (st = sch_submit((*rpl)->sch, prc)) != DS_OK)
+			prc_delete(&prc);
+	}
+
+	if (st == DS_OK)
+	{
+		(*rpl)->done = sch_done((*rpl)->sch);
+
+		st = sch_metrics((*rpl)->sch, (*rpl)->metrics);
+
+		if (st == DS_OK)
+			st = rpl_point(*rpl);
+	}
+
+	if (st != DS_OK)
+		rpl_delete(rpl);
+
+	return st;
+}
+
+// One step forward. DS_ERR_INVALID_OPERATION at the end of the run.
+Status rpl_step(Replay *rpl)
+{
+	if (rpl == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (rpl->done && rpl->step == rpl->steps)
+		return DS_ERR_INVALID_OPERATION;
+
+	return rpl_advance(rpl);
+}
+
+// One step back. DS_ERR_INVALID_OPERATION at the start of the run.
+Status rpl_back(Replay *rpl)
+{
+	if (rpl == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (rpl->step == 0)
+		return DS_ERR_INVALID_OPERATION;
+
+	return rpl_goto(rpl, rpl->step - 1);
+}
+
+// The last state at or before tick, the end of the run when it is past it
+Status rpl_seek(Replay *rpl, size_t tick)
+{
+	if (rpl == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st;
+
+	// The step after tick has to be known to tell where tick ends
+	while (!rpl->done && rpl->frontier <= tick)
+	{
+		st = rpl->step == rpl->steps ? rpl_advance(rpl) : rpl_goto(rpl, rpl->steps);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	return rpl_goto(rpl, rpl_step_at(rpl, tick));
+}
+
+Status rpl_view(Replay *rpl)
+{
+	if (rpl == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	Status st = DS_OK;
+
+	while (1)
+	{
+		CLEAR_SCREEN;
+
+		sch_display(rpl->sch);
+
+		if (rpl->done)
+			printf("\nTick %lu of %lu\n", rpl->sch->clock, rpl->frontier);
+		else
+			printf("\nTick %lu\n", rpl->sch->clock);
+
+		if (st != DS_OK)
+			printf("%s\n", rpl->step == 0 ? "Start of the run" : "End of the run");
+
+		printf(" n - Next tick | b - Previous tick | j - Jump to tick | 0 - Return\n > ");
+
+		char c = ENTER;
+
+		st = DS_OK;
+
+		// getch gives 0 at the end of the input
+		if (c == '0' || c == '\0')
+			return DS_OK;
+		else if (c == 'n')
+			st = rpl_step(rpl);
+		else if (c == 'b')
+			st = rpl_back(rpl);
+		else if (c == 'j')
+		{
+			unsigned long tick;
+
+			printf(" Tick: ");
+
+			if (scanf("%lu", &tick) == 1)
+				st = rpl_seek(rpl, tick);
+
+			getchar(); // get newline from scanf
+		}
+
+		// Only the ends of the run are shown, anything else stops the replay
+		if (st != DS_OK && st != DS_ERR_INVALID_OPERATION)
+			return st;
+	}
+}
+
+Status rpl_delete(Replay **rpl)
+{
+	if ((*rpl) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t i;
+	for (i = 0; i < (*rpl)->length; i++)
+		snp_delete(&(*rpl)->points[i].snapshot);
+
+	if ((*rpl)->sch != NULL)
+		sch_delete(&(*rpl)->sch);
+
+	if ((*rpl)->metrics != NULL)
+		met_delete(&(*rpl)->metrics);
+
+	free((*rpl)->deltas);
+	free(*rpl);
+
+	*rpl = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- Replay.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                              Replay
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                        Trace Reader
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------------- TraceReader.c */
+
+// Varint at *offset of a mapped file of size bytes. DS_ERR_NOT_FOUND at the
+// end of the file before the first byte.
+static Status trd_decode(const unsigned char *data, size_t size, size_t *offset, uint64_t *value)
+{
+	*value = 0;
+
+	unsigned shift;
+	for (shift = 0; shift < 64; shift += 7)
+	{
+		if (*offset >= size)
+			return shift == 0 ? DS_ERR_NOT_FOUND : DS_ERR_INVALID_ARGUMENT;
+
+		unsigned char c = data[(*offset)++];
+
+		*value |= (uint64_t)(c & 0x7f) << shift;
+
+		if ((c & 0x80) == 0)
+			return DS_OK;
+	}
+
+	return DS_ERR_INVALID_ARGUMENT;
+}
+
+static Status trd_varint(TraceReader *trd, uint64_t *value)
+{
+	return trd_decode(trd->data, trd->size, &trd->offset, value);
+}
+
+// Maps the whole file at path, that starts with magic
+static Status trd_map(const char *path, const char *magic, const unsigned char **data, size_t *size)
+{
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0)
+		return DS_ERR_NOT_FOUND;
+
+	struct stat info;
+
+	Status st = fstat(fd, &info) == 0 ? DS_OK : DS_ERR_UNEXPECTED_RESULT;
+
+	if (st == DS_OK && (size_t)info.st_size < strlen(magic))
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	void *map = MAP_FAILED;
+
+	if (st == DS_OK)
+	{
+		map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (map == MAP_FAILED)
+			st = DS_ERR_ALLOC;
+	}
+
+	close(fd);
+
+	if (st == DS_OK && memcmp(map, magic, strlen(magic)) != 0)
+	{
+		munmap(map, (size_t)info.st_size);
+
+		st = DS_ERR_INVALID_ARGUMENT;
+	}
+
+	if (st == DS_OK)
+	{
+		*data = map;
+		*size = (size_t)info.st_size;
+	}
+
+	return st;
+}
+
+Status trd_open(TraceReader **trd, const char *path)
+{
+	const unsigned char *data;
+
+	size_t size;
+
+	Status st = trd_map(path, TRACE_MAGIC, &data, &size);
+
+	if (st != DS_OK)
+		return st;
+
+	(*trd) = malloc(sizeof(TraceReader));
+
+	if (!(*trd))
+	{
+		munmap((void *)data, size);
+
+		return DS_ERR_ALLOC;
+	}
+
+	(*trd)->data = data;
+	(*trd)->size = size;
+	(*trd)->name = NULL;
+	(*trd)->window = malloc(sizeof(TraceRecord) * TRACE_WINDOW);
+
+	if (!(*trd)->window)
+	{
+		trd_close(trd);
+
+		return DS_ERR_ALLOC;
+	}
+
+	return trd_rewind(*trd);
+}
+
+// Reads the name of a run that starts, length bytes
+static Status trd_run(TraceReader *trd, size_t length, TraceSlice *slice)
+{
+	if (length > TRACE_NAME_MAX)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	char *name = realloc(trd->name, length + 1);
+
+	if (!name)
+		return DS_ERR_ALLOC;
+
+	trd->name = name;
+
+	if (length > trd->size - trd->offset)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	memcpy(name, trd->data + trd->offset, length);
+
+	name[length] = '\0';
+
+	trd->offset += length;
+	(trd->run)++;
+	trd->clock = 0;
+	trd->pid = 0;
+	trd->records = 0;
+
+	*slice = (TraceSlice){trd->run, 0, 0, 0, TRACE_RUN};
+
+	return DS_OK;
+}
+
+/**
+ * The next record: a slice or, with reason TRACE_RUN, the start of a run,
+ * whose name is then in trd->name. DS_ERR_NOT_FOUND at the end of the
+ * trace and DS_ERR_INVALID_ARGUMENT when it is damaged.
+ */
+Status trd_next(TraceReader *trd, TraceSlice *slice)
+{
+	if (trd == NULL || slice == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	TraceRecord rec = {0, 0, 0};
+
+	Status st;
+
+	if (trd->copies > 0)
+	{
+		rec = trd->window[(trd->records - trd->period) % TRACE_WINDOW];
+
+		(trd->copies)--;
+	}
+	else
+	{
+		st = trd_varint(trd, &rec.head);
+
+		if (st != DS_OK)
+			return st;
+
+		if ((rec.head & 7) == TRACE_RUN)
+			return trd_run(trd, (size_t)(rec.head >> 3), slice);
+
+		// A slice or a repeat before the first run
+		if (trd->run == 0)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		if ((rec.head & 7) == TRACE_REPEAT)
+		{
+			uint64_t period;
+
+			if ((st = trd_varint(trd, &period)) != DS_OK)
+				return st == DS_ERR_NOT_FOUND ? DS_ERR_INVALID_ARGUMENT : st;
+
+			if (period == 0 || period > TRACE_WINDOW || period > trd->records || (rec.head >> 3) == 0)
+				return DS_ERR_INVALID_ARGUMENT;
+
+			trd->period = (size_t)period;
+			trd->copies = (size_t)(rec.head >> 3);
+
+			return trd_next(trd, slice);
+		}
+
+		if ((rec.head & 4) != 0)
+			st = trd_varint(trd, &rec.gap);
+
+		if (st == DS_OK)
+			st = trd_varint(trd, &rec.zigzag);
+
+		if (st != DS_OK)
+			return st == DS_ERR_NOT_FOUND ? DS_ERR_INVALID_ARGUMENT : st;
+	}
+
+	trd->window[trd->records % TRACE_WINDOW] = rec;
+
+	(trd->records)++;
+
+	trd->pid += (size_t)(rec.zigzag >> 1 ^ -(rec.zigzag & 1));
+
+	slice->run = trd->run;
+	slice->pid = trd->pid;
+	slice->start = trd->clock + (size_t)rec.gap;
+	slice->end = slice->start + (size_t)(rec.head >> 3);
+	slice->reason = (TraceEnd)(rec.head & 3);
+
+	trd->clock = slice->end;
+
+	return DS_OK;
+}
+
+// Back to the first record
+Status trd_rewind(TraceReader *trd)
+{
+	if (trd == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	trd->offset = strlen(TRACE_MAGIC);
+	trd->run = 0;
+	trd->clock = 0;
+	trd->pid = 0;
+	trd->records = 0;
+	trd->copies = 0;
+
+	return DS_OK;
+}
+
+// To the record an index entry points to, with the name of its run
+Status trd_seek(TraceReader *trd, const TraceEntry *entry)
+{
+	if (trd == NULL || entry == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (entry->header >= trd->size || entry->offset > trd->size || entry->run == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	trd->offset = (size_t)entry->header;
+
+	uint64_t head;
+
+	Status st = trd_varint(trd, &head);
+
+	if (st == DS_OK && (head & 7) != TRACE_RUN)
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	TraceSlice slice;
+
+	if (st == DS_OK)
+		st = trd_run(trd, (size_t)(head >> 3), &slice);
+
+	if (st != DS_OK)
+		return st == DS_ERR_NOT_FOUND ? DS_ERR_INVALID_ARGUMENT : st;
+
+	trd->offset = (size_t)entry->offset;
+	trd->run = (size_t)entry->run;
+	trd->clock = (size_t)entry->clock;
+	trd->pid = (size_t)entry->pid;
+	trd->records = 0;
+	trd->copies = 0;
+
+	return DS_OK;
+}
+
+// Index of pid in the sorted pids, where it goes when it is not there
+static size_t trd_find(size_t *pids, size_t length, size_t pid)
+{
+	size_t low = 0, high = length;
+
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+
+		if (pids[middle] < pid)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+/**
+ * Reads run number run of the trace twice, once for its processes and its
+ * length and once to fill a row of width columns per process, and prints
+ * it. Each column stands for the same number of ticks and has a '#' when
+ * the process had the CPU in any of them. DS_ERR_NOT_FOUND when the trace
+ * has no such run.
+ */
+static Status trd_gantt_run(TraceReader *trd, size_t run, size_t width)
+{
+	TraceSlice slice;
+
+	size_t *pids = NULL, length = 0, capacity = 0, ticks = 0, position, i;
+
+	char *name = NULL, *grid = NULL;
+
+	Status st = trd_rewind(trd);
+
+	while (st == DS_OK && (st = trd_next(trd, &slice)) == DS_OK && slice.run <= run)
+	{
+		if (slice.run < run)
+			continue;
+
+		if (slice.reason == TRACE_RUN)
+		{
+			name = malloc(strlen(trd->name) + 1);
+
+			if (!name)
+				st = DS_ERR_ALLOC;
+			else
+				strcpy(name, trd->name);
+
+			continue;
+		}
+
+		if (slice.end > ticks)
+			ticks = slice.end;
+
+		position = trd_find(pids, length, slice.pid);
+
+		if (position < length && pids[position] == slice.pid)
+			continue;
+
+		if (length == capacity)
+		{
+			capacity = capacity == 0 ? 64 : capacity * 2;
+
+			size_t *grown = realloc(pids, sizeof(size_t) * capacity);
+
+			if (!grown)
+			{
+				st = DS_ERR_ALLOC;
+
+				break;
+			}
+
+			pids = grown;
+		}
+
+		memmove(&pids[position + 1], &pids[position], sizeof(size_t) * (length - position));
+
+		pids[position] = slice.pid;
+
+		length++;
+	}
+
+	// Stopped at the end of the trace or at the start of the next run
+	if (st == DS_OK || st == DS_ERR_NOT_FOUND)
+		st = name != NULL ? DS_OK : DS_ERR_NOT_FOUND;
+
+	size_t scale = ticks / width + (ticks % width != 0), columns = scale == 0 ? 0 : ticks / scale + (ticks % scale != 0);
+
+	if (st == DS_OK)
+	{
+		grid = malloc(length * columns + 1);
+
+		if (!grid)
+			st = DS_ERR_ALLOC;
+		else
+			memset(grid, '.', length * columns);
+	}
+
+	if (st == DS_OK)
+	{
+		st = trd_rewind(trd);
+
+		while (st == DS_OK && (st = trd_next(trd, &slice)) == DS_OK && slice.run <= run)
+		{
+			if (slice.run < run || slice.reason == TRACE_RUN || slice.end == slice.start)
+				continue;
+
+			char *row = grid + trd_find(pids, length, slice.pid) * columns;
+
+			for (position = slice.start / scale; position <= (slice.end - 1) / scale; position++)
+				row[position] = '#';
+		}
+
+		if (st == DS_ERR_NOT_FOUND)
+			st = DS_OK;
+	}
+
+	if (st == DS_OK)
+	{
+		printf("\n%s: %lu ticks, %lu processes, %lu ticks per column\n", name, ticks, length, scale);
+
+		for (i = 0; i < length; i++)
+			printf("%8lu |%.*s|\n", pids[i], (int)columns, grid + i * columns);
+	}
+
+	free(name);
+	free(grid);
+	free(pids);
+
+	return st;
+}
+
+// run 0 prints every run of the trace
+Status trd_gantt(TraceReader *trd, size_t run, size_t width)
+{
+	if (trd == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if (width == 0)
+		return DS_ERR_INVALID_ARGUMENT;
+
+	if (run != 0)
+		return trd_gantt_run(trd, run, width);
+
+	Status st;
+
+	for (run = 1; (st = trd_gantt_run(trd, run, width)) == DS_OK; run++)
+		;
+
+	return st == DS_ERR_NOT_FOUND && run > 1 ? DS_OK : st;
+}
+
+Status trd_close(TraceReader **trd)
+{
+	if ((*trd) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	munmap((void *)(*trd)->data, (*trd)->size);
+
+	free((*trd)->window);
+	free((*trd)->name);
+	free(*trd);
+
+	*trd = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- TraceReader.c */
+
+/* ---------------------------------------------------------------------------------------------------- TraceIndex.c */
+
+Status tix_open(TraceIndex **tix, const char *path)
+{
+	if (path == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	(*tix) = malloc(sizeof(TraceIndex));
+
+	if (!(*tix))
+		return DS_ERR_ALLOC;
+
+	(*tix)->reader = NULL;
+	(*tix)->data = NULL;
+	(*tix)->size = 0;
+	(*tix)->entries = NULL;
+	(*tix)->length = 0;
+	(*tix)->changes = NULL;
+	(*tix)->capacity = 0;
+
+	char *index = malloc(strlen(path) + strlen(TRACE_INDEX_SUFFIX) + 1);
+
+	Status st = index != NULL ? trd_open(&((*tix)->reader), path) : DS_ERR_ALLOC;
+
+	if (st == DS_OK)
+		st = trd_map(strcat(strcpy(index, path), TRACE_INDEX_SUFFIX), TRACE_INDEX_MAGIC, &(*tix)->data, &(*tix)->size);
+
+	free(index);
+
+	uint64_t footer[2] = {0, 0};
+
+	size_t lists = strlen(TRACE_INDEX_MAGIC), size = (*tix)->size;
+
+	if (st == DS_OK && size >= lists + sizeof(footer))
+		memcpy(footer, (*tix)->data + size - sizeof(footer), sizeof(footer));
+
+	// The entries fill the space between the lists and the footer
+	if (st == DS_OK && (size < lists + sizeof(footer) || footer[0] < lists || footer[0] % 8 != 0 ||
+						footer[0] > size - sizeof(footer) ||
+						(size - sizeof(footer) - footer[0]) % sizeof(TraceEntry) != 0 ||
+						(size - sizeof(footer) - footer[0]) / sizeof(TraceEntry) != footer[1]))
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	if (st != DS_OK)
+	{
+		tix_close(tix);
+
+		return st;
+	}
+
+	(*tix)->entries = (const TraceEntry *)((*tix)->data + footer[0]);
+	(*tix)->length = (size_t)footer[1];
+
+	return DS_OK;
+}
+
+// Varint of the lists of the index, which end where the entries start
+static Status tix_varint(TraceIndex *tix, size_t *offset, uint64_t *value)
+{
+	Status st = trd_decode(tix->data, (size_t)((const unsigned char *)tix->entries - tix->data), offset, value);
+
+	return st == DS_ERR_NOT_FOUND ? DS_ERR_INVALID_ARGUMENT : st;
+}
+
+// First entry after the ones of run taken by tick, length when there is none
+static size_t tix_after(TraceIndex *tix, size_t run, size_t tick)
+{
+	size_t low = 0, high = tix->length;
+
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+
+		const TraceEntry *entry = &tix->entries[middle];
+
+		if (entry->run < run || (entry->run == run && entry->tick <= tick))
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+static Status tix_change(TraceIndex *tix, size_t *length, size_t pid, bool leave)
+{
+	if (*length == tix->capacity)
+	{
+		size_t capacity = tix->capacity == 0 ? 64 : tix->capacity * 2;
+
+		TraceChange *changes = realloc(tix->changes, sizeof(TraceChange) * capacity);
+
+		if (!changes)
+			return DS_ERR_ALLOC;
+
+		tix->changes = changes;
+		tix->capacity = capacity;
+	}
+
+	tix->changes[*length] = (TraceChange){pid, *length, leave};
+
+	(*length)++;
+
+	return DS_OK;
+}
+
+// Takes the changes of the index list at *offset that happened before until
+static Status tix_events(TraceIndex *tix, size_t *offset, size_t *left, size_t *clock, size_t *pid, size_t until,
+						 size_t *length)
+{
+	Status st = DS_OK;
+
+	while (*left > 0 && st == DS_OK)
+	{
+		size_t next = *offset;
+
+		uint64_t delta, change;
+
+		st = tix_varint(tix, &next, &delta);
+
+		if (st != DS_OK || *clock + delta >= until)
+			break;
+
+		st = tix_varint(tix, &next, &change);
+
+		uint64_t zigzag = change >> 1;
+
+		*pid += (size_t)(zigzag >> 1 ^ -(zigzag & 1));
+
+		if (st == DS_OK)
+			st = tix_change(tix, length, *pid, (change & 1) != 0);
+
+		*offset = next;
+		*clock += (size_t)delta;
+
+		(*left)--;
+	}
+
+	return st;
+}
+
+static int tix_compare(const void *a, const void *b)
+{
+	const TraceChange *x = a, *y = b;
+
+	if (x->pid != y->pid)
+		return (x->pid > y->pid) - (x->pid < y->pid);
+
+	return (x->order > y->order) - (x->order < y->order);
+}
+
+/**
+ * Reads the ready queue of the entry as changes, then the slices and the
+ * other changes up to tick in the order they happened: the ends of slices,
+ * the changes of the index and the starts of slices of the same tick. The
+ * last change of each PID says whether it is ready at tick.
+ */
+static Status tix_replay(TraceIndex *tix, const TraceEntry *entry, size_t tick, TraceSlice *running, size_t *length)
+{
+	TraceReader *trd = tix->reader;
+
+	TraceSlice slice;
+
+	size_t offset = (size_t)entry->queue, left = (size_t)entry->events, clock = (size_t)entry->tick, pid = 0, changed = 0, i;
+
+	uint64_t delta;
+
+	Status st = DS_OK;
+
+	for (i = 0; i < entry->queued && st == DS_OK; i++)
+	{
+		st = tix_varint(tix, &offset, &delta);
+
+		pid += (size_t)delta;
+
+		if (st == DS_OK)
+			st = tix_change(tix, length, pid, false);
+	}
+
+	if (st == DS_OK)
+		st = trd_seek(trd, entry);
+
+	// Later entries do not matter, the slices go on past them
+	while (st == DS_OK && (st = trd_next(trd, &slice)) == DS_OK && slice.reason != TRACE_RUN)
+	{
+		st = tix_events(tix, &offset, &left, &clock, &changed, (slice.start < tick ? slice.start : tick) + 1, length);
+
+		if (st != DS_OK || slice.start > tick)
+			break;
+
+		st = tix_change(tix, length, slice.pid, true);
+
+		if (st == DS_OK && slice.end > tick)
+		{
+			*running = slice;
+
+			break;
+		}
+
+		if (st == DS_OK)
+			st = tix_events(tix, &offset, &left, &clock, &changed, slice.end, length);
+
+		if (st == DS_OK && slice.reason == TRACE_PREEMPT)
+			st = tix_change(tix, length, slice.pid, false);
+	}
+
+	if (st == DS_ERR_NOT_FOUND)
+		st = DS_OK;
+
+	return st == DS_OK ? tix_events(tix, &offset, &left, &clock, &changed, tick + 1, length) : st;
+}
+
+/**
+ * Prints which process had the CPU at tick in run number run and which
+ * ones were in the ready queue, from the last entry before tick. Before
+ * the first entry of a run nothing had been dispatched, so nothing was
+ * ready either.
+ */
+Status tix_state(TraceIndex *tix, size_t run, size_t tick)
+{
+	if (tix == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	size_t after = tix_after(tix, run, tick), length = 0, ready = 0, i;
+
+	bool before = after == 0 || tix->entries[after - 1].run != run;
+
+	if (before && (after == tix->length || tix->entries[after].run != run))
+		return DS_ERR_NOT_FOUND;
+
+	const TraceEntry *entry = &tix->entries[before ? after : after - 1];
+
+	// Reason TRACE_RUN while the CPU is idle
+	TraceSlice running = {run, 0, 0, 0, TRACE_RUN};
+
+	Status st = before ? trd_seek(tix->reader, entry) : tix_replay(tix, entry, tick, &running, &length);
+
+	if (st != DS_OK)
+		return st;
+
+	printf("\n%s, tick %lu\n", tix->reader->name, tick);
+
+	if (running.reason == TRACE_RUN)
+		printf("Running: none\n");
+	else
+		printf("Running: %lu, from %lu to %lu (%s)\n", running.pid, running.start, running.end,
+			   trc_ends[running.reason]);
+
+	if (length > 1)
+		qsort(tix->changes, length, sizeof(TraceChange), tix_compare);
+
+	for (i = 0; i < length; i++)
+	{
+		// The last change of each PID decides
+		if (i + 1 < length && tix->changes[i + 1].pid == tix->changes[i].pid)
+			continue;
+
+		if (!tix->changes[i].leave)
+			tix->changes[ready++] = tix->changes[i];
+	}
+
+	printf("Ready (%lu):", ready);
+
+	for (i = 0; i < ready; i++)
+		printf(i % 10 == 0 ? "\n    %lu" : " %lu", tix->changes[i].pid);
+
+	printf("\n");
+
+	return DS_OK;
+}
+
+// Whether pid is in the processes of the entry
+static Status tix_ran(TraceIndex *tix, const TraceEntry *entry, size_t pid, bool *found)
+{
+	size_t offset = (size_t)entry->processes, last = 0, i;
+
+	uint64_t delta;
+
+	Status st = DS_OK;
+
+	*found = false;
+
+	for (i = 0; i < entry->ran && st == DS_OK && last <= pid; i++)
+	{
+		st = tix_varint(tix, &offset, &delta);
+
+		last += (size_t)delta;
+
+		if (last == pid)
+			*found = true;
+	}
+
+	return st;
+}
+
+/**
+ * Prints every slice of pid in run number run, or in every run when run is
+ * 0, reading only from the entries whose processes include it.
+ * DS_ERR_NOT_FOUND when it never had the CPU there.
+ */
+Status tix_history(TraceIndex *tix, size_t run, size_t pid)
+{
+	if (tix == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	TraceReader *trd = tix->reader;
+
+	TraceSlice slice;
+
+	size_t current = 0, slices = 0, ticks = 0, total = 0, i;
+
+	bool found;
+
+	Status st = DS_OK;
+
+	for (i = 0; i < tix->length && st == DS_OK; i++)
+	{
+		const TraceEntry *entry = &tix->entries[i];
+
+		if (run != 0 && entry->run != run)
+			continue;
+
+		st = tix_ran(tix, entry, pid, &found);
+
+		if (st != DS_OK || !found)
+			continue;
+
+		st = trd_seek(trd, entry);
+
+		if (st != DS_OK)
+			break;
+
+		if (entry->run != current)
+		{
+			if (current != 0)
+				printf("%lu slices, %lu ticks\n", slices, ticks);
+
+			printf("\n%s, process %lu\n", trd->name, pid);
+
+			current = (size_t)entry->run;
+			total += slices;
+			slices = 0;
+			ticks = 0;
+		}
+
+		// The slices of the entry end where the next one of the run starts
+		size_t end = i + 1 < tix->length && tix->entries[i + 1].run == entry->run ? (size_t)tix->entries[i + 1].offset
+																				  : trd->size;
+
+		while ((trd->offset < end || trd->copies > 0) && (st = trd_next(trd, &slice)) == DS_OK &&
+			   slice.reason != TRACE_RUN)
+		{
+			if (slice.pid != pid)
+				continue;
+
+			printf("%12lu %12lu  %s\n", slice.start, slice.end, trc_ends[slice.reason]);
+
+			slices++;
+			ticks += slice.end - slice.start;
+		}
+
+		if (st == DS_ERR_NOT_FOUND)
+			st = DS_OK;
+	}
+
+	if (current != 0 && st == DS_OK)
+		printf("%lu slices, %lu ticks\n", slices, ticks);
+
+	total += slices;
+
+	return st == DS_OK && total == 0 ? DS_ERR_NOT_FOUND : st;
+}
+
+Status tix_close(TraceIndex **tix)
+{
+	if ((*tix) == NULL)
+		return DS_ERR_NULL_POINTER;
+
+	if ((*tix)->data != NULL)
+		munmap((void *)(*tix)->data, (*tix)->size);
+
+	if ((*tix)->reader != NULL)
+		trd_close(&((*tix)->reader));
+
+	free((*tix)->changes);
+	free(*tix);
+
+	*tix = NULL;
+
+	return DS_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------- TraceIndex.c */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                        Trace Reader
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Menu Functions
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+// Every edit invalidates the table digest of cache
+Status process_table(DynamicArray **ptable, ResultCache *cache)
+{
+	Status st;
+
+	int choice;
+
+	size_t i;
+
+	while (1)
+	{
+		CLEAR_SCREEN;
+		printf(" +--------------------------------------------------+\n");
+		printf(" |                  Process Table                   |\n");
+		printf(" +--------------------------------------------------+\n");
+		printf(" | 0 - Return                                       |\n");
+		printf(" | 1 - Add process                                  |\n");
+		printf(" | 2 - Alter process                                |\n");
+		printf(" | 3 - Remove process                               |\n");
+		printf(" | 4 - List process table                           |\n");
+		printf(" | 5 - Clear process table                          |\n");
+		printf(" | 6 - Reload from file                             |\n");
+		printf(" | 7 - Save to file                                 |\n");
+		printf(" | 8 - Sort table by PID                            |\n");
+		printf(" +--------------------------------------------------+\n");
+		printf(" > ");
+
+		scanf("%d", &choice);
+
+		if (choice == 0)
+		{
+			return DS_OK;
+		}
+		else if (choice == 1)
+		{
+			String *name, *type;
+			size_t pid = 0, pri, cpu, io;
+
+			st += str_init(&name);
+			st += str_init(&type);
+
+			if (st != DS_OK)
+				return st;
+
+			char c = ' ';
+
+			getchar(); // get newline from scanf
+
+			printf("Name > ");
+			while (c != '\n')
+			{
+				c = getchar();
+
+				if (c != '\n')
+				{
+					st = str_push_char_back(name, c);
+
+					if (st != DS_OK)
+						return st;
+				}
+			}
+
+			c = ' ';
 
 			printf("Type > ");
 			while (c != '\n')
 			{
-				c = getchar();
+				c = getchar();
+
+				if (c != '\n')
+				{
+					st = str_push_char_back(type, c);
+
+					if (st != DS_OK)
+						return st;
+				}
+			}
+
+			printf("PRI > ");
+			scanf("%lu", &pri);
+
+			printf("CPU > ");
+			scanf("%lu", &cpu);
+
+			printf("I/O > ");
+			scanf("%lu", &io);
+
+			if ((*ptable)->size == 0)
+				pid = 1001;
+			else
+			{
+				for (i = 0; i < (*ptable)->size; i++)
+				{
+					if ((*ptable)->buffer[i]->pid > pid)
+						pid = (*ptable)->buffer[i]->pid;
+				}
+
+				pid++;
+			}
+
+			Process *process;
+
+			st = prc_init(&process, name, pid, cpu, io, pri, type);
+
+			if (st != DS_OK)
+				return st;
+
+			st = dar_insert_back(*ptable, process);
+
+			if (st != DS_OK)
+				return st;
+
+			rch_invalidate(cache);
+		}
+		else if (choice == 2)
+		{
+			if ((*ptable)->size == 0)
+			{
+				printf("Process table is empty...");
+
+				ENTER;
+
+				continue;
+			}
+
+			Process *alter = NULL;
+
+			size_t pid;
+
+			printf("PID > ");
+			scanf("%lu", &pid);
+
+			bool found = false;
+
+			for (i = 0; i < (*ptable)->size; i++)
+			{
+				if ((*ptable)->buffer[i]->pid == pid)
+				{
+					found = true;
+
+					alter = (*ptable)->buffer[i];
+				}
+			}
+
+			if (!found)
+			{
+				printf("Process not found...");
+
+				ENTER;
+			}
+			else
+			{
+				rch_invalidate(cache);
+
+				while (1)
+				{
+					CLEAR_SCREEN;
+					printf(" +--------------------------------------------------+\n");
+					printf(" |                  Alter Process                   |\n");
+					printf(" +--------------------------------------------------+\n");
+					printf(" | 0 - Return                                       |\n");
+					printf(" | 1 - Alter Name                                   |\n");
+					printf(" | 2 - Alter Process ID                             |\n");
+					printf(" | 3 - Alter CPU                                    |\n");
+					printf(" | 4 - Alter I/O                                    |\n");
+					printf(" | 5 - Alter Priority                               |\n");
+					printf(" | 6 - Alter Type                                   |\n");
+					printf(" +--------------------------------------------------+\n");
+					printf("\n");
+					printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
+					printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
+					prc_display(alter);
+					printf("\n\n");
+					printf(" > ");
+
+					scanf("%d", &choice);
+
+					if (choice == 0)
+					{
+						break;
+					}
+					else if (choice == 1)
+					{
+						String *new_name;
+
+						st = str_init(&new_name);
+
+						if (st != DS_OK)
+							return st;
+
+						char ch = ' ';
+
+						getchar(); // get newline from scanf
+
+						printf("Name > ");
+						while (ch != '\n')
+						{
+							ch = getchar();
+
+							if (ch != '\n')
+							{
+								st = str_push_char_back(new_name, ch);
+
+								if (st != DS_OK)
+									return st;
+							}
+						}
+
+						st = str_delete(&(alter->name));
+
+						if (st != DS_OK)
+							return st;
+
+						alter->name = new_name;
+					}
+					else if (choice == 2)
+					{
+						size_t new_pid;
+
+						bool exists = false;
+
+						printf("PID > ");
+						scanf("%lu", &new_pid);
+
+						for (i = 0; i < (*ptable)->size; i++)
+						{
+							if ((*ptable)->buffer[i]->pid == new_pid)
+							{
+								exists = true;
+
+								break;
+							}
+						}
+
+						if (exists)
+						{
+							printf("PID already exists...");
+
+							ENTER;
+						}
+						else
+						{
+							alter->pid = new_pid;
+						}
+					}
+					else if (choice == 3)
+					{
+						size_t new_cpu;
+
+						printf("CPU > ");
+						scanf("%lu", &new_cpu);
+
+						// A single CPU time replaces the bursts
+						prc_set_bursts(alter, NULL, 0, 0);
+
+						alter->cpu = new_cpu;
+					}
+					else if (choice == 4)
+					{
+						size_t new_io;
+
+						printf("I/O > ");
+						scanf("%lu", &new_io);
+
+						prc_set_bursts(alter, NULL, 0, 0);
+
+						alter->io = new_io;
+					}
+					else if (choice == 5)
+					{
+						size_t new_pri;
+
+						printf("PRI > ");
+						scanf("%lu", &new_pri);
+
+						alter->pri = new_pri;
+					}
+					else if (choice == 6)
+					{
+						String *new_type;
+
+						st = str_init(&new_type);
+
+						if (st != DS_OK)
+							return st;
+
+						char n = ' ';
+
+						getchar(); // get newline from scanf
+
+						printf("Type > ");
+						while (n != '\n')
+						{
+							n = getchar();
+
+							if (n != '\n')
+							{
+								st = str_push_char_back(new_type, n);
+
+								if (st != DS_OK)
+									return st;
+							}
+						}
+
+						st = str_delete(&(alter->type));
+
+						if (st != DS_OK)
+							return st;
+
+						alter->type = new_type;
+					}
+					else
+					{
+						printf("Invalid command...");
+
+						ENTER;
+					}
+				}
+			}
+		}
+		else if (choice == 3)
+		{
+			Process *remove;
+
+			size_t pid;
+
+			printf("PID > ");
+			scanf("%lu", &pid);
+
+			bool found = false;
+			for (i = 0; i < (*ptable)->size; i++)
+			{
+				if ((*ptable)->buffer[i]->pid == pid)
+				{
+					found = true;
+
+					st = dar_remove_at(*ptable, i, &remove);
+
+					if (st != DS_OK)
+						return st;
+
+					st = prc_delete(&remove);
+
+					if (st != DS_OK)
+						return st;
+
+					rch_invalidate(cache);
+				}
+			}
+
+			if (!found)
+			{
+				printf("Process not found...");
+
+				ENTER;
+			}
+		}
+		else if (choice == 4)
+		{
+			st = dar_display(*ptable);
+
+			if (st != DS_OK)
+				return st;
+
+			printf("\nPress enter to continue...");
+			ENTER;
+		}
+		else if (choice == 5)
+		{
+			st = dar_erase(ptable);
+
+			if (st != DS_OK)
+				return st;
+
+			rch_invalidate(cache);
+		}
+		else if (choice == 6)
+		{
+			st = dar_erase(ptable);
+
+			if (st != DS_OK)
+				return st;
+
+			st = file_load(*ptable);
+
+			if (st != DS_OK)
+				return st;
+
+			rch_invalidate(cache);
+		}
+		else if (choice == 7)
+		{
+			st = file_save(*ptable);
+
+			if (st != DS_OK)
+			{
+				print_status_repr(st);
+
+				return st;
+			}
+		}
+		else if (choice == 8)
+		{
+			st = sort_selection_array_dar((*ptable)->buffer, (*ptable)->size);
+
+			if (st != DS_OK)
+				return st;
+		}
+		else
+		{
+			printf("Invalid command...");
+
+			ENTER;
+		}
+	}
+
+	return DS_OK;
+}
+
+// Runs the algorithms on ptable, or takes their results from cache
+// logs has the checkpoints of the last run of each algorithm
+Status process_scheduling(DynamicArray *ptable, ResultCache *cache, CheckpointLog **logs)
+{
+	Status st;
+
+	SchedulerParams params;
+
+	sch_default_params(&params);
+
+	ResultKey key;
+
+	char entry[64];
+
+	size_t alg, i;
+
+	while (1)
+	{
+		CLEAR_SCREEN;
+		printf(" +--------------------------------------------------+\n");
+		printf(" |           Process Scheduling Algorithms          |\n");
+		printf(" +--------------------------------------------------+\n");
+		printf(" | 0 - Return                                       |\n");
+
+		for (alg = 0; alg < ALG_COUNT; alg++)
+		{
+			snprintf(entry, sizeof(entry), "%lu - %s", alg + 1, alg_names[alg]);
+
+			printf(" | %-49s|\n", entry);
+		}
+
+		snprintf(entry, sizeof(entry), "%d - %s", ALG_COUNT + 1, "All Algorithms");
+
+		printf(" | %-49s|\n", entry);
+		printf(" +--------------------------------------------------+\n");
+		printf(" > ");
+
+		int choice;
+
+		scanf("%d", &choice);
+
+		if (choice == 0)
+		{
+			return DS_OK;
+		}
+		else if (choice >= 1 && choice <= ALG_COUNT + 1)
+		{
+			QueueArray *queue, *result;
+
+			Metrics *metrics;
+
+			st = met_init(&metrics);
+
+			if (st != DS_OK)
+				return st;
+
+			st = dar_copy(ptable, &queue);
+
+			if (st != DS_OK)
+				return st;
+
+			st = sort_selection_array_dar(queue->buffer, queue->length);
+
+			if (st != DS_OK)
+				return st;
+
+			if (choice <= ALG_COUNT)
+			{
+				size_t resumed = 0;
+
+				bool cached = false;
+
+				st = rch_key(cache, queue, choice - 1, &params, &key);
+
+				if (st == DS_OK)
+					cached = (st = rch_lookup(cache, &key, &result, metrics)) == DS_OK;
+
+				if (st == DS_ERR_NOT_FOUND)
+				{
+					st = ckp_simulate(logs[choice - 1], queue, &result, metrics, true, &resumed);
+
+					if (st == DS_OK)
+						st = rch_store(cache, &key, result, metrics);
+				}
+
+				if (st != DS_OK)
+				{
+					print_status_repr(st);
+
+					ENTER;
+				}
+				else
+				{
+					if (cached)
+						printf("\nResults (cached)\n");
+					else if (resumed > 0)
+						printf("\nResults (resumed at tick %lu)\n", resumed);
+					else
+						printf("\nResults\n");
+
+					qua_display(result);
+
+					met_display_processes(result);
+
+					met_display_deadlines(result);
+
+					met_display(metrics);
+
+					printf("\n r - Step through the run | Any other key - Return\n > ");
+
+					if (ENTER == 'r')
+					{
+						Replay *rpl;
+
+						st = rpl_init(&rpl, queue, choice - 1, &params);
+
+						if (st == DS_OK)
+						{
+							st = rpl_view(rpl);
+
+							rpl_delete(&rpl);
+						}
+
+						if (st != DS_OK)
+						{
+							print_status_repr(st);
+
+							ENTER;
+						}
+					}
+
+					// A result that was not cached belongs to the log
+					if (cached && (st = qua_delete(&result)) != DS_OK)
+						return st;
+				}
+			}
+			else
+			{
+				QueueArray *results[ALG_COUNT];
+
+				Metrics *all[ALG_COUNT];
+
+				int width[ALG_COUNT];
+
+				bool failed = false, cached[ALG_COUNT];
+
+				size_t resumed;
+
+				for (alg = 0; alg < ALG_COUNT; alg++)
+				{
+					st = met_init(&all[alg]);
+
+					if (st != DS_OK)
+						return st;
+
+					cached[alg] = false;
+
+					st = rch_key(cache, queue, alg, &params, &key);
+
+					if (st == DS_OK)
+						cached[alg] = (st = rch_lookup(cache, &key, &results[alg], all[alg])) == DS_OK;
+
+					if (st == DS_ERR_NOT_FOUND)
+					{
+						st = ckp_simulate(logs[alg], queue, &results[alg], all[alg], true, &resumed);
+
+						if (st == DS_OK)
+							st = rch_store(cache, &key, results[alg], all[alg]);
+					}
+
+					if (st != DS_OK)
+					{
+						print_status_repr(st);
+
+						ENTER;
+
+						results[alg] = NULL;
+
+						failed = true;
+					}
+
+					width[alg] = (int)strlen(alg_names[alg]) + 2;
+				}
+
+				if (!failed)
+				{
+					CLEAR_SCREEN;
+
+					printf("\n|");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf(" %s |", alg_names[alg]);
+
+					printf("\n|");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%.*s|", width[alg], "------------------------------------------------");
+
+					for (i = 0; i < results[0]->length; i++)
+					{
+						printf("\n|");
+
+						for (alg = 0; alg < ALG_COUNT; alg++)
+							printf("%*s|", width[alg], results[alg]->buffer[i]->name->buffer);
+					}
+
+					printf("\n\n|%-18s|", " Metric");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf(" %s |", alg_names[alg]);
+
+					printf("\n|%s|", "------------------");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%.*s|", width[alg], "------------------------------------------------");
+
+					printf("\n|%-18s|", " Turnaround mean");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%*.2f|", width[alg], sta_mean(&all[alg]->turnaround));
+
+					printf("\n|%-18s|", " Turnaround p99");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%*lu|", width[alg], sta_percentile(&all[alg]->turnaround, 0.99));
+
+					printf("\n|%-18s|", " Waiting mean");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%*.2f|", width[alg], sta_mean(&all[alg]->waiting));
+
+					printf("\n|%-18s|", " Response mean");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%*.2f|", width[alg], sta_mean(&all[alg]->response));
+
+					printf("\n|%-18s|", " Throughput");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%*.4f|", width[alg], met_throughput(all[alg]));
+
+					printf("\n|%-18s|", " CPU utilization");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%*.2f%%|", width[alg] - 1, 100 * met_utilization(all[alg]));
+
+					printf("\n|%-18s|", " Fairness");
+
+					for (alg = 0; alg < ALG_COUNT; alg++)
+						printf("%*.4f|", width[alg], met_fairness(all[alg]));
+
+					printf("\n");
+
+					ENTER;
+				}
+
+				for (alg = 0; alg < ALG_COUNT; alg++)
+				{
+					met_delete(&all[alg]);
+
+					if (results[alg] != NULL && cached[alg])
+						qua_delete(&results[alg]);
+				}
+			}
+
+			st = qua_delete(&queue);
+
+			if (st != DS_OK)
+				return st;
+
+			met_delete(&metrics);
+		}
+		else
+		{
+			printf("Invalid command...");
+
+			ENTER;
+		}
+	}
+
+	return DS_OK;
+}
+
+void copyright(void)
+{
+	CLEAR_SCREEN;
+	printf(" +--------------------------------------------------+\n");
+	printf(" |                     Copyright                    |\n");
+	printf(" +--------------------------------------------------+\n");
+	printf(" | Leonardo Vencovsky 201710276                     |\n");
+	printf(" +--------------------------------------------------+\n");
+
+	printf("\nPress enter to continue...");
+
+	ENTER;
+}
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Menu Functions
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------------------------------
+ *
+ *                                                                                         Command Line
+ *
+ * ---------------------------------------------------------------------------------------------------- */
+
+void cli_usage(void)
+{
+	printf("Usage: p [command] [options]\n");
+	printf("\n");
+	printf("Without a command the interactive menu is started.\n");
+	printf("\n");
+	printf("Commands:\n");
+	printf("  montecarlo    Run the algorithms over random process tables\n");
+	printf("      -n <samples>       Number of random tables (default 100)\n");
+	printf("      -p <processes>     Processes per table (default 6)\n");
+	printf("      -t <threads>       Worker threads (default: online cores)\n");
+	printf("      -s <seed>          Base seed (default 1)\n");
+	printf("      -a <algorithms>    Comma separated list of algorithms\n");
+	printf("  run           Run the algorithms on a process table and show their metrics\n");
+	printf("      -f <file>          Process table (default %s)\n", FILE_NAME);
+	printf("      -a <algorithms>    Comma separated list of algorithms\n");
+	printf("      -d                 Also list the times of every process\n");
+	printf("      --stream           Read the table, in arrival order, while running and keep no finished process\n");
+	printf("      --csv <file>       With --stream, write the times of every finished process to file\n");
+	printf("      --trace <file>     Write a Chrome/Perfetto trace of the runs\n");
+	printf("      --dispatch <file>  Write a compact binary trace of who had the CPU and its index, for gantt and seek\n");
+	printf("      --checkpoint <file> Save the state of the run of the one algorithm of -a to file, also on SIGINT/SIGTERM\n");
+	printf("      --every <ticks>    Ticks between two checkpoints (default %d)\n", SNAPSHOT_EVERY);
+	printf("      --resume <file>    Go on with the run saved in a checkpoint, saving again to it\n");
+	printf("  bench         Time the priority queue on the operations of real runs\n");
+	printf("      -f <file>          Process table (default %s)\n", FILE_NAME);
+	printf("      -a <algorithms>    Algorithms to record, only static, dynamic and type use the priority queue\n");
+	printf("      -r <repeats>       Replays of each run, the best one is shown (default 5)\n");
+	printf("  serve         Answer simulation requests on a Unix socket until interrupted\n");
+	printf("      -s <socket>        Socket path (default %s)\n", DAEMON_SOCKET);
+	printf("      -t <threads>       Worker threads (default: online cores)\n");
+	printf("  query         Send simulation requests to a running serve\n");
+	printf("      -s <socket>        Socket path (default %s)\n", DAEMON_SOCKET);
+	printf("      -f <file>          Process table (default %s)\n", FILE_NAME);
+	printf("      -a <algorithms>    Comma separated list of algorithms, requests cycle through them\n");
+	printf("      -n <requests>      Requests to send (default: one per algorithm)\n");
+	printf("      -w <window>        Requests in flight at once, 1 for no pipelining (default 64)\n");
+	printf("  view          Step through a run, forwards and backwards\n");
+	printf("      -f <file>          Process table (default %s)\n", FILE_NAME);
+	printf("      -a <algorithm>     The one algorithm to run (default rr)\n");
+	printf("      -t <tick>          Tick shown first (default 0)\n");
+	printf("  gantt         Draw the runs of a --dispatch trace as text Gantt charts\n");
+	printf("      -f <file>          Dispatch trace\n");
+	printf("      -r <run>           Only this run, from 1 (default: all of them)\n");
+	printf("      -w <columns>       Columns of each chart (default %d)\n", TRACE_GANTT_WIDTH);
+	printf("  seek          Read a --dispatch trace from its index\n");
+	printf("      -f <file>          Dispatch trace\n");
+	printf("      -t <tick>          Show the running and the ready processes at this tick\n");
+	printf("      -p <pid>           Show every slice of this process\n");
+	printf("      -r <run>           Run, from 1 (default: 1 with -t, all of them with -p)\n");
+	printf("  check         Check that resumed runs finish like full runs and MLFQ boosts keep their order\n");
+	printf("      -n <tables>        Generated tables (default %d)\n", CHECK_TABLES);
+	printf("      -s <seed>          Seed (default 1)\n");
+	printf("      -a <algorithms>    Comma separated list of algorithms\n");
+	printf("  generate      Write a random process table\n");
+	printf("      -o <file>          Output file (default: stdout)\n");
+	printf("      -p <processes>     Number of rows (default 6)\n");
+	printf("      -s <seed>          Seed (default 1)\n");
+	printf("\n");
+	printf("Workload options (montecarlo and generate):\n");
+	printf("      --cpu <dist>       CPU time distribution\n");
+	printf("      --io <dist>        I/O time distribution\n");
+	printf("      --pri <dist>       Priority distribution\n");
+	printf("      --types <so:ui:uni> Relative weights of each process type\n");
+	printf("      --period <dist>    Make every process periodic with this period\n");
+	printf("      --arrival <dist>   Processes arrive over time, this many ticks apart\n");
+	printf("      --bursts <dist>    CPU bursts of each process, from --cpu, with I/O bursts from --io between them\n");
+	printf("\n");
+	printf("Policy options (montecarlo, run, bench, query and view):\n");
+	printf("      --aging <ticks>    Waiting ticks that raise a dynamic priority one level, 0 for none (default 0)\n");
+	printf("      --mlfq <q0,q1,...> MLFQ quantum of each level (default 1,2,4,8)\n");
+	printf("      --boost <ticks>    Ticks between MLFQ global boosts, 0 for none (default 50)\n");
+	printf("      --latency <ticks>  CFS target latency (default 20)\n");
+	printf("      --granularity <ticks> CFS shortest quantum (default 2)\n");
+	printf("      --lottery-seed <seed> Seed of the lottery draws (default 1)\n");
+	printf("      --horizon <ticks>  Last tick periodic jobs are released (default: one hyperperiod)\n");
+	printf("      --kill <pid@tick>  Kill a process at a tick, can be repeated\n");
+	printf("      --priority <pid@tick=pri> Change the priority of a process at a tick, can be repeated\n");
+	printf("\n");
+	printf("Distributions: lo:hi (uniform), exp:mean[:shift], pareto:scale:shape\n");
+	printf("\n");
+	printf("Algorithms: all");
+
+	size_t i;
+	for (i = 0; i < ALG_COUNT; i++)
+		printf(", %s (%s)", alg_options[i], alg_names[i]);
+
+	printf("\n");
+}
+
+Status cli_size(char *text, size_t *result)
+{
+	char *end;
+
+	unsigned long long value = strtoull(text, &end, 10);
+
+	if (end == text || *end != '\0')
+		return DS_ERR_INVALID_ARGUMENT;
+
+	*result = (size_t)value;
+
+	return DS_OK;
+}
+
+Status cli_algorithms(char *text, bool *algorithms)
+{
+	size_t i;
+	for (i = 0; i < ALG_COUNT; i++)
+		algorithms[i] = false;
+
+	char *token = strtok(text, ",");
+
+	while (token != NULL)
+	{
+		bool found = false;
+
+		for (i = 0; i < ALG_COUNT; i++)
+		{
+			if (strcmp(token, alg_options[i]) == 0)
+			{
+				algorithms[i] = true;
+
+				found = true;
+			}
+		}
+
+		if (strcmp(token, "all") == 0)
+		{
+			for (i = 0; i < ALG_COUNT; i++)
+				algorithms[i] = true;
+
+			found = true;
+		}
+
+		if (!found)
+			return DS_ERR_INVALID_ARGUMENT;
+
+		token = strtok(NULL, ",");
+	}
+
+	return DS_OK;
+}
+
+// Policy tunables, shared by every command that runs the algorithms.
+// DS_ERR_NOT_FOUND when opt is not one of them.
+Status cli_params(SchedulerParams *params, char *opt, char *arg)
+{
+	if (strncmp(opt, "--", 2) != 0)
+		return DS_ERR_NOT_FOUND;
+
+	return sch_parse_param(params, opt + 2, arg);
+}
+
+// Options shared by every command that draws random process tables
+Status cli_workload(WorkloadSpec *spec, char *opt, char *arg)
+{
+	if (strcmp(opt, "--cpu") == 0)
+		return dst_parse(&spec->cpu, arg);
+	else if (strcmp(opt, "--io") == 0)
+		return dst_parse(&spec->io, arg);
+	else if (strcmp(opt, "--pri") == 0)
+		return dst_parse(&spec->pri, arg);
+	else if (strcmp(opt, "--types") == 0)
+		return wkl_parse_types(spec, arg);
+	else if (strcmp(opt, "--period") == 0)
+	{
+		spec->periodic = true;
+
+		return dst_parse(&spec->period, arg);
+	}
+	else if (strcmp(opt, "--arrival") == 0)
+	{
+		spec->arriving = true;
+
+		return dst_parse(&spec->gap, arg);
+	}
+	else if (strcmp(opt, "--bursts") == 0)
+	{
+		spec->bursty = true;
+
+		return dst_parse(&spec->bursts, arg);
+	}
+
+	return DS_ERR_INVALID_ARGUMENT;
+}
+
+Status cli_montecarlo(int argc, char **argv)
+{
+	MonteCarlo *mc;
+
+	Status st = mc_init(&mc);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t seed = 0;
+
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-n") == 0)
+			st = cli_size(arg, &mc->samples);
+		else if (strcmp(opt, "-p") == 0)
+			st = cli_size(arg, &mc->spec.processes);
+		else if (strcmp(opt, "-t") == 0)
+			st = cli_size(arg, &mc->threads);
+		else if (strcmp(opt, "-s") == 0)
+		{
+			st = cli_size(arg, &seed);
+
+			mc->seed = seed;
+		}
+		else if (strcmp(opt, "-a") == 0)
+			st = cli_algorithms(arg, mc->algorithms);
+		else if ((st = cli_params(&mc->params, opt, arg)) == DS_ERR_NOT_FOUND)
+			st = cli_workload(&mc->spec, opt, arg);
+	}
+
+	if (st != DS_OK)
+	{
+		cli_usage();
+
+		mc_delete(&mc);
+
+		return st;
+	}
+
+	st = mc_run(mc);
+
+	if (st == DS_OK)
+		st = mc_report(mc);
+
+	mc_delete(&mc);
+
+	return st;
+}
+
+/**
+ * Runs sch to the end for run --checkpoint, writing a checkpoint to path
+ * every `every` ticks from a forked child. The processes that did not
+ * arrive yet are left for the rows of table to give back, or written too
+ * when it is NULL. SIGINT and SIGTERM are blocked and looked for between
+ * chunks of the run: when one came, a last checkpoint is written after the
+ * child and paused is set.
+ */
+static Status cli_checkpointed(Scheduler *sch, const char *table, const char *path, size_t every, bool *paused)
+{
+	sigset_t set, previous;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	sigaddset(&set, SIGTERM);
+
+	sigprocmask(SIG_BLOCK, &set, &previous);
+
+	struct timespec now = {0, 0};
+
+	pid_t writer = 0;
+
+	size_t next = sch->clock + every;
+
+	Status st = DS_OK;
+
+	*paused = false;
+
+	while (st == DS_OK && !sch_done(sch))
+	{
+		size_t until = sch->clock + SNAPSHOT_POLL;
+
+		st = sch_run_until(sch, until < next ? until : next);
+
+		if (st != DS_OK)
+			break;
+
+		if (sigtimedwait(&set, NULL, &now) > 0)
+		{
+			*paused = true;
+
+			break;
+		}
+
+		if (sch->clock >= next && !sch_done(sch))
+		{
+			st = snp_poll(&writer);
+
+			// Still writing the one before, tried again after the next chunk
+			if (st == DS_ERR_FULL)
+			{
+				st = DS_OK;
+
+				continue;
+			}
+
+			Snapshot *snp;
+
+			if (st == DS_OK)
+				st = table != NULL ? snp_take_table(&snp, sch, table) : snp_take(&snp, sch);
+
+			if (st == DS_OK)
+			{
+				snp->every = every;
+
+				st = snp_fork(snp, path, &writer);
+
+				snp_delete(&snp);
+			}
+
+			if (st == DS_OK)
+				next = sch->clock + every;
+		}
+	}
+
+	Status wt = snp_wait(&writer);
+
+	if (st == DS_OK)
+		st = wt;
+
+	// After the child, which would rename an older state over it
+	if (st == DS_OK && *paused)
+	{
+		Snapshot *snp;
+
+		st = table != NULL ? snp_take_table(&snp, sch, table) : snp_take(&snp, sch);
+
+		if (st == DS_OK)
+		{
+			snp->every = every;
+
+			st = snp_save(snp, path);
+
+			snp_delete(&snp);
+		}
+	}
+
+	sigprocmask(SIG_SETMASK, &previous, NULL);
+
+	return st;
+}
+
+/**
+ * @brief Where run --csv writes the processes of the runs
+ */
+typedef struct CliCsv
+{
+	FILE *file;			   /*!< Output, one row per process */
+	const char *algorithm; /*!< Run the rows belong to */
+} CliCsv;
+
+// Sink of a streamed run, writes a process as it leaves the run
+static Status cli_csv(void *context, Process *prc)
+{
+	CliCsv *csv = context;
+
+	fprintf(csv->file, "%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%d\n", csv->algorithm, prc->name->buffer, prc->pid,
+			prc->arrival, prc->first_run, prc->finish, prc->waiting, prc->blocked, prc->jobs, prc->misses,
+			prc->killed);
+
+	return ferror(csv->file) ? DS_ERR_UNEXPECTED_RESULT : DS_OK;
+}
+
+Status cli_run(int argc, char **argv)
+{
+	bool algorithms[ALG_COUNT];
+	bool details = false, stream = false, every_given = false;
+
+	size_t alg;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		algorithms[alg] = true;
+
+	char *path = FILE_NAME, *trace_path = NULL, *checkpoint_path = NULL, *resume_path = NULL, *csv_path = NULL;
+
+	// Where checkpoints read the processes that did not arrive yet from
+	char table_path[PATH_MAX];
+
+	bool table_known = false;
+
+	TraceFormat format = TRACE_CHROME;
+
+	size_t every = SNAPSHOT_EVERY, selected = 0;
+
+	SchedulerParams params;
+
+	sch_default_params(&params);
+
+	Status st = DS_OK;
+
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i++)
+	{
+		char *opt = argv[i];
+
+		if (strcmp(opt, "-d") == 0)
+		{
+			details = true;
+
+			continue;
+		}
+
+		if (strcmp(opt, "--stream") == 0)
+		{
+			stream = true;
+
+			continue;
+		}
+
+		char *arg = argv[++i];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-f") == 0)
+			path = arg;
+		else if (strcmp(opt, "-a") == 0)
+			st = cli_algorithms(arg, algorithms);
+		else if (strcmp(opt, "--csv") == 0)
+			csv_path = arg;
+		else if (strcmp(opt, "--trace") == 0 || strcmp(opt, "--dispatch") == 0)
+		{
+			// One trace per run, in one of the formats
+			if (trace_path != NULL)
+				st = DS_ERR_INVALID_ARGUMENT;
+
+			trace_path = arg;
+			format = strcmp(opt, "--trace") == 0 ? TRACE_CHROME : TRACE_DISPATCH;
+		}
+		else if (strcmp(opt, "--checkpoint") == 0)
+			checkpoint_path = arg;
+		else if (strcmp(opt, "--every") == 0)
+		{
+			st = cli_size(arg, &every);
+
+			every_given = true;
+		}
+		else if (strcmp(opt, "--resume") == 0)
+			resume_path = arg;
+		else if ((st = cli_params(&params, opt, arg)) == DS_ERR_NOT_FOUND)
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
+
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		selected += algorithms[alg];
+
+	// One file holds one run, the one of the algorithm given with -a
+	if (st == DS_OK && ((checkpoint_path != NULL && selected != 1 && resume_path == NULL) || every == 0))
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	// A streamed run keeps nothing to list, save or resume
+	if (st == DS_OK && (stream ? details || checkpoint_path != NULL || resume_path != NULL : csv_path != NULL))
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	if (st != DS_OK)
+	{
+		cli_usage();
+
+		return st;
+	}
+
+	QueueArray *table = NULL, *queue = NULL, *finished = NULL;
+	CliCsv csv = {NULL, NULL};
+	Metrics *metrics;
+	Trace *trace = NULL;
+	Scheduler *sch = NULL;
+
+	st = met_init(&metrics);
+
+	if (st != DS_OK)
+		return st;
+
+	// The algorithm, the options and the processes all come from the file
+	if (resume_path != NULL)
+	{
+		Snapshot *snp;
+
+		st = snp_load(&snp, resume_path);
+
+		if (st == DS_OK)
+		{
+			st = snp_restore(snp, &sch, metrics);
+
+			if (st == DS_OK && snp->table != NULL)
+			{
+				snprintf(table_path, sizeof(table_path), "%s", snp->table);
+
+				table_known = true;
+			}
+
+			// The interval of the run goes on unless another one is given
+			if (!every_given && snp->every > 0)
+				every = snp->every;
+
+			snp_delete(&snp);
+		}
+
+		if (st != DS_OK)
+		{
+			met_delete(&metrics);
+
+			return st;
+		}
+
+		for (alg = 0; alg < ALG_COUNT; alg++)
+			algorithms[alg] = alg == sch->policy;
+
+		if (checkpoint_path == NULL)
+			checkpoint_path = resume_path;
+	}
+	else if (!stream)
+	{
+		st = file_load_table(path, &table);
+
+		if (st != DS_OK)
+		{
+			met_delete(&metrics);
+
+			return st;
+		}
+
+		// Absolute, a resumed run may be started from another directory
+		table_known = checkpoint_path != NULL && realpath(path, table_path) != NULL;
+	}
+
+	if (csv_path != NULL)
+	{
+		csv.file = fopen(csv_path, "w");
+
+		if (csv.file == NULL)
+		{
+			met_delete(&metrics);
+
+			return DS_ERR_UNEXPECTED_RESULT;
+		}
+
+		fprintf(csv.file, "algorithm,name,pid,arrival,first_run,finish,waiting,blocked,jobs,misses,killed\n");
+	}
+
+	if (trace_path != NULL)
+	{
+		st = trc_open(&trace, trace_path, format);
+
+		if (st != DS_OK)
+			return st;
+	}
+
+	for (alg = 0; alg < ALG_COUNT && st == DS_OK; alg++)
+	{
+		if (!algorithms[alg])
+			continue;
+
+		if (sch == NULL)
+		{
+			met_clear(metrics);
+
+			st = stream ? DS_OK : qua_copy(table, &queue);
+
+			if (st != DS_OK)
+				break;
+		}
+
+		if (trace != NULL)
+		{
+			st = trc_begin_run(trace, alg_names[alg]);
+
+			if (st != DS_OK)
+				break;
+		}
+
+		csv.algorithm = alg_options[alg];
+
+		if (stream)
+			st = alg_stream((AlgorithmId)alg, path, &params, metrics, trace, csv.file != NULL ? cli_csv : sch_discard,
+							&csv);
+		else if (checkpoint_path == NULL)
+			st = alg_table[alg](queue, &finished, &params, metrics, trace, false);
+		else
+		{
+			bool paused;
+
+			if (sch == NULL)
+			{
+				st = sch_init(&sch, (AlgorithmId)alg, &params);
+
+				for (i = 0; st == DS_OK && (size_t)i < queue->length; i++)
+					st = sch_submit(sch, queue->buffer[i]);
+
+				// The scheduler owns the ones it took
+				queue->length = st == DS_OK ? 0 : (size_t)i;
+			}
+
+			if (st != DS_OK)
+				break;
+
+			st = sch_metrics(sch, metrics);
+
+			if (st == DS_OK)
+				st = sch_trace(sch, trace);
+
+			if (st == DS_OK)
+				st = cli_checkpointed(sch, table_known ? table_path : NULL, checkpoint_path, every, &paused);
+
+			if (st != DS_OK)
+				break;
+
+			if (paused)
+			{
+				printf("Paused at tick %lu, resume with: run --resume %s\n", sch->clock, checkpoint_path);
+
+				break;
+			}
+
+			finished = sch->finished;
+
+			sch->finished = NULL;
+
+			st = sch_delete(&sch);
+		}
+
+		if (st != DS_OK)
+			break;
+
+		if (trace != NULL)
+		{
+			st = trc_end_run(trace);
+
+			if (st != DS_OK)
+				break;
+		}
+
+		printf("\n%s\n", alg_names[alg]);
+
+		if (details)
+		{
+			met_display_processes(finished);
+
+			met_display_deadlines(finished);
+		}
+
+		met_display(metrics);
+
+		if (finished != NULL)
+			qua_delete(&finished);
+
+		if (queue != NULL)
+			qua_delete(&queue);
+	}
+
+	if (sch != NULL)
+		sch_delete(&sch);
+
+	if (queue != NULL)
+		qua_delete(&queue);
+
+	met_delete(&metrics);
+
+	if (table != NULL)
+		qua_delete(&table);
+
+	if (csv.file != NULL && fclose(csv.file) != 0 && st == DS_OK)
+		st = DS_ERR_UNEXPECTED_RESULT;
+
+	if (trace != NULL)
+	{
+		Status cl = trc_close(&trace);
+
+		if (st == DS_OK)
+			st = cl;
+	}
+
+	return st;
+}
+
+Status cli_generate(int argc, char **argv)
+{
+	WorkloadSpec spec;
+
+	wkl_default(&spec);
+
+	char *path = "-";
+
+	size_t seed = 1;
+
+	Status st = DS_OK;
+
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-o") == 0)
+			path = arg;
+		else if (strcmp(opt, "-p") == 0)
+			st = cli_size(arg, &spec.processes);
+		else if (strcmp(opt, "-s") == 0)
+			st = cli_size(arg, &seed);
+		else
+			st = cli_workload(&spec, opt, arg);
+	}
+
+	if (st != DS_OK)
+	{
+		cli_usage();
+
+		return st;
+	}
+
+	Random rng;
+
+	rng_seed(&rng, seed, 0);
+
+	return wkl_write(&spec, &rng, path);
+}
+
+Status cli_bench(int argc, char **argv)
+{
+	bool algorithms[ALG_COUNT];
+
+	size_t alg;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		algorithms[alg] = true;
+
+	char *path = FILE_NAME;
+
+	size_t repeats = 5;
+
+	SchedulerParams params;
+
+	sch_default_params(&params);
+
+	Status st = DS_OK;
 
-				if (c != '\n')
-				{
-					st = str_push_char_back(type, c);
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-f") == 0)
+			path = arg;
+		else if (strcmp(opt, "-a") == 0)
+			st = cli_algorithms(arg, algorithms);
+		else if (strcmp(opt, "-r") == 0)
+			st = cli_size(arg, &repeats);
+		else if ((st = cli_params(&params, opt, arg)) == DS_ERR_NOT_FOUND)
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
 
-					if (st != DS_OK)
-						return st;
-				}
-			}
+	if (st == DS_OK && repeats == 0)
+		st = DS_ERR_INVALID_ARGUMENT;
 
-			printf("PRI > ");
-			scanf("%lu", &pri);
+	if (st != DS_OK)
+	{
+		cli_usage();
 
-			printf("CPU > ");
-			scanf("%lu", &cpu);
+		return st;
+	}
 
-			printf("I/O > ");
-			scanf("%lu", &io);
+	QueueArray *table;
 
-			if ((*ptable)->size == 0)
-				pid = 1001;
-			else
-			{
-				for (i = 0; i < (*ptable)->size; i++)
-				{
-					if ((*ptable)->buffer[i]->pid > pid)
-						pid = (*ptable)->buffer[i]->pid;
-				}
+	st = file_load_table(path, &table);
 
-				pid++;
-			}
+	if (st != DS_OK)
+		return st;
 
-			Process *process;
+	printf("Priority queue: %s\n", PQUEUE_BACKEND_NAME);
 
-			st = prc_init(&process, name, pid, cpu, io, pri, type);
+	for (alg = 0; alg < ALG_COUNT && st == DS_OK; alg++)
+	{
+		// Only the policies whose ready queue is the priority queue
+		if (!algorithms[alg] || policies[alg]->init != rq_prq_init)
+			continue;
 
-			if (st != DS_OK)
-				return st;
+		BenchLog *log;
 
-			st = dar_insert_back(*ptable, process);
+		double seconds;
 
-			if (st != DS_OK)
-				return st;
-		}
-		else if (choice == 2)
+		st = bch_record(alg, table, &params, &log);
+
+		if (st != DS_OK)
+			break;
+
+		st = bch_replay(log, repeats, &seconds);
+
+		if (st == DS_OK)
 		{
-			if ((*ptable)->size == 0)
-			{
-				printf("Process table is empty...");
+			printf("\n%s\n", alg_names[alg]);
 
-				ENTER;
+			st = bch_report(log, seconds, repeats);
+		}
 
-				continue;
-			}
+		bch_delete(&log);
+	}
 
-			Process *alter = NULL;
+	qua_delete(&table);
 
-			size_t pid;
+	return st;
+}
 
-			printf("PID > ");
-			scanf("%lu", &pid);
+Status cli_serve(int argc, char **argv)
+{
+	char *path = DAEMON_SOCKET;
 
-			bool found = false;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
 
-			for (i = 0; i < (*ptable)->size; i++)
-			{
-				if ((*ptable)->buffer[i]->pid == pid)
-				{
-					found = true;
+	size_t threads = cores > 0 ? (size_t)cores : 1;
 
-					alter = (*ptable)->buffer[i];
-				}
-			}
+	Status st = DS_OK;
 
-			if (!found)
-			{
-				printf("Process not found...");
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-s") == 0)
+			path = arg;
+		else if (strcmp(opt, "-t") == 0)
+			st = cli_size(arg, &threads);
+		else
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
 
-				ENTER;
-			}
-			else
-			{
-				while (1)
-				{
-					CLEAR_SCREEN;
-					printf(" +--------------------------------------------------+\n");
-					printf(" |                  Alter Process                   |\n");
-					printf(" +--------------------------------------------------+\n");
-					printf(" | 0 - Return                                       |\n");
-					printf(" | 1 - Alter Name                                   |\n");
-					printf(" | 2 - Alter Process ID                             |\n");
-					printf(" | 3 - Alter CPU                                    |\n");
-					printf(" | 4 - Alter I/O                                    |\n");
-					printf(" | 5 - Alter Priority                               |\n");
-					printf(" | 6 - Alter Type                                   |\n");
-					printf(" +--------------------------------------------------+\n");
-					printf("\n");
-					printf("%s\t%s\t%s\t%s\t%s\t%s\n", "Process Name", "PID", "CPU", "I/O", "PRI", "TYPE");
-					printf("%s\t%s\t%s\t%s\t%s\t%s\n", "------------", "---", "---", "---", "---", "----");
-					prc_display(alter);
-					printf("\n\n");
-					printf(" > ");
+	if (st == DS_OK && threads == 0)
+		st = DS_ERR_INVALID_ARGUMENT;
 
-					scanf("%d", &choice);
+	if (st != DS_OK)
+	{
+		cli_usage();
 
-					if (choice == 0)
-					{
-						break;
-					}
-					else if (choice == 1)
-					{
-						String *new_name;
+		return st;
+	}
 
-						st = str_init(&new_name);
+	Daemon *dmn;
 
-						if (st != DS_OK)
-							return st;
+	st = dmn_init(&dmn, path, threads);
 
-						char ch = ' ';
+	if (st != DS_OK)
+		return st;
 
-						getchar(); // get newline from scanf
+	printf("Listening on %s with %lu workers\n", path, threads);
 
-						printf("Name > ");
-						while (ch != '\n')
-						{
-							ch = getchar();
+	fflush(stdout);
 
-							if (ch != '\n')
-							{
-								st = str_push_char_back(new_name, ch);
+	st = dmn_serve(dmn);
 
-								if (st != DS_OK)
-									return st;
-							}
-						}
+	printf("Served %lu requests\n", dmn->served);
 
-						st = str_delete(&(alter->name));
+	dmn_delete(&dmn);
 
-						if (st != DS_OK)
-							return st;
+	return st;
+}
 
-						alter->name = new_name;
-					}
-					else if (choice == 2)
-					{
-						size_t new_pid;
+static int cli_compare_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
 
-						bool exists = false;
+	return (x > y) - (x < y);
+}
 
-						printf("PID > ");
-						scanf("%lu", &new_pid);
+static void cli_display_summary(SimulationMetrics *met)
+{
+	printf("%-12s\t%10.2f\t%10lu\t%10lu\n", "Turnaround", met->turnaround_mean, met->turnaround_max, met->turnaround_p99);
+	printf("%-12s\t%10.2f\t%10lu\t%10lu\n", "Waiting", met->waiting_mean, met->waiting_max, met->waiting_p99);
+	printf("%-12s\t%10.2f\t%10lu\t%10lu\n", "Response", met->response_mean, met->response_max, met->response_p99);
+	printf("Finished: %lu processes in %lu ticks, %.2f%% CPU utilization\n", met->finished, met->ticks,
+		   100.0 * met->utilization);
+}
 
-						for (i = 0; i < (*ptable)->size; i++)
-						{
-							if ((*ptable)->buffer[i]->pid == new_pid)
-							{
-								exists = true;
+/**
+ * Sends requests to a running daemon, cycling through the algorithms, with
+ * up to window of them in flight, and shows the metrics of each algorithm
+ * and the round trip time of the requests.
+ */
+Status cli_query(int argc, char **argv)
+{
+	bool algorithms[ALG_COUNT];
 
-								break;
-							}
-						}
+	size_t alg;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		algorithms[alg] = true;
 
-						if (exists)
-						{
-							printf("PID already exists...");
+	char *path = FILE_NAME, *socket_path = DAEMON_SOCKET;
 
-							ENTER;
-						}
-						else
-						{
-							alter->pid = new_pid;
-						}
-					}
-					else if (choice == 3)
-					{
-						size_t new_cpu;
+	size_t requests = 0, window = 64;
 
-						printf("CPU > ");
-						scanf("%lu", &new_cpu);
+	// Policy options are checked here and sent as they are
+	SchedulerParams params;
 
-						alter->cpu = new_cpu;
-					}
-					else if (choice == 4)
-					{
-						size_t new_io;
+	sch_default_params(&params);
 
-						printf("I/O > ");
-						scanf("%lu", &new_io);
+	char options[DAEMON_MAX_OPTIONS];
 
-						alter->io = new_io;
-					}
-					else if (choice == 5)
-					{
-						size_t new_pri;
+	size_t options_length = 0;
 
-						printf("PRI > ");
-						scanf("%lu", &new_pri);
+	Status st = DS_OK;
 
-						alter->pri = new_pri;
-					}
-					else if (choice == 6)
-					{
-						String *new_type;
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-s") == 0)
+			socket_path = arg;
+		else if (strcmp(opt, "-f") == 0)
+			path = arg;
+		else if (strcmp(opt, "-a") == 0)
+			st = cli_algorithms(arg, algorithms);
+		else if (strcmp(opt, "-n") == 0)
+			st = cli_size(arg, &requests);
+		else if (strcmp(opt, "-w") == 0)
+			st = cli_size(arg, &window);
+		else if ((st = cli_params(&params, opt, arg)) == DS_ERR_NOT_FOUND)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (st == DS_OK)
+		{
+			size_t name = strlen(opt + 2) + 1, value = strlen(arg) + 1;
 
-						st = str_init(&new_type);
+			if (options_length + name + value > DAEMON_MAX_OPTIONS)
+				st = DS_ERR_FULL;
+			else
+			{
+				memcpy(options + options_length, opt + 2, name);
+				memcpy(options + options_length + name, arg, value);
 
-						if (st != DS_OK)
-							return st;
+				options_length += name + value;
+			}
+		}
+	}
 
-						char n = ' ';
+	size_t chosen[ALG_COUNT], count = 0;
 
-						getchar(); // get newline from scanf
+	for (alg = 0; alg < ALG_COUNT; alg++)
+	{
+		if (algorithms[alg])
+			chosen[count++] = alg;
+	}
 
-						printf("Type > ");
-						while (n != '\n')
-						{
-							n = getchar();
+	// A window too large could fill the socket with replies nobody reads
+	if (st == DS_OK && (count == 0 || window == 0 || window > DAEMON_MAX_WINDOW))
+		st = DS_ERR_INVALID_ARGUMENT;
 
-							if (n != '\n')
-							{
-								st = str_push_char_back(new_type, n);
+	if (st != DS_OK)
+	{
+		cli_usage();
 
-								if (st != DS_OK)
-									return st;
-							}
-						}
+		return st;
+	}
 
-						st = str_delete(&(alter->type));
+	if (requests == 0)
+		requests = count;
 
-						if (st != DS_OK)
-							return st;
+	// The daemon may run in another directory
+	char table[PATH_MAX];
 
-						alter->type = new_type;
-					}
-					else
-					{
-						printf("Invalid command...");
+	if (realpath(path, table) == NULL)
+		return DS_ERR_NOT_FOUND;
 
-						ENTER;
-					}
-				}
-			}
-		}
-		else if (choice == 3)
-		{
-			Process *remove;
+	size_t path_length = strlen(table);
 
-			size_t pid;
+	if (path_length > UINT16_MAX)
+		return DS_ERR_INVALID_ARGUMENT;
 
-			printf("PID > ");
-			scanf("%lu", &pid);
+	int fd;
 
-			bool found = false;
-			for (i = 0; i < (*ptable)->size; i++)
-			{
-				if ((*ptable)->buffer[i]->pid == pid)
-				{
-					found = true;
+	st = dmn_connect(socket_path, &fd);
+
+	if (st != DS_OK)
+		return st;
+
+	size_t size = sizeof(DaemonRequest) + path_length + options_length;
+
+	char *message = malloc(size);
+	double *sent = malloc(sizeof(double) * requests);
+	double *latency = malloc(sizeof(double) * requests);
+
+	if (!message || !sent || !latency)
+	{
+		free(message);
+		free(sent);
+		free(latency);
+
+		close(fd);
+
+		return DS_ERR_ALLOC;
+	}
 
-					st = dar_remove_at(*ptable, i, &remove);
+	DaemonRequest header = {DAEMON_MAGIC, 0, 0, (uint16_t)path_length, (uint32_t)options_length};
 
-					if (st != DS_OK)
-						return st;
+	memcpy(message + sizeof(DaemonRequest), table, path_length);
+	memcpy(message + sizeof(DaemonRequest) + path_length, options, options_length);
 
-					st = prc_delete(&remove);
+	DaemonReply first[ALG_COUNT];
 
-					if (st != DS_OK)
-						return st;
-				}
-			}
+	bool shown[ALG_COUNT] = {false};
 
-			if (!found)
-			{
-				printf("Process not found...");
+	size_t issued = 0, answered = 0;
 
-				ENTER;
-			}
-		}
-		else if (choice == 4)
+	double start = bch_now();
+
+	while (answered < requests && st == DS_OK)
+	{
+		while (issued < requests && issued - answered < window && st == DS_OK)
 		{
-			st = dar_display(*ptable);
+			header.id = (uint32_t)issued;
+			header.algorithm = (uint16_t)chosen[issued % count];
 
-			if (st != DS_OK)
-				return st;
+			memcpy(message, &header, sizeof(DaemonRequest));
 
-			printf("\nPress enter to continue...");
-			ENTER;
-		}
-		else if (choice == 5)
-		{
-			st = dar_erase(ptable);
+			sent[issued++] = bch_now();
 
-			if (st != DS_OK)
-				return st;
+			st = dmn_send(fd, message, size);
 		}
-		else if (choice == 6)
-		{
-			st = dar_erase(ptable);
 
-			if (st != DS_OK)
-				return st;
+		DaemonReply reply;
 
-			st = file_load(*ptable);
+		if (st == DS_OK)
+			st = dmn_receive(fd, &reply, sizeof(DaemonReply));
 
-			if (st != DS_OK)
-				return st;
-		}
-		else if (choice == 7)
+		if (st != DS_OK)
+			break;
+
+		if (reply.id >= issued)
+			st = DS_ERR_UNEXPECTED_RESULT;
+		else if (reply.status != DS_OK)
+			st = (Status)reply.status;
+		else
 		{
-			st = file_save(*ptable);
+			latency[answered++] = bch_now() - sent[reply.id];
 
-			if (st != DS_OK)
-			{
-				print_status_repr(st);
+			alg = chosen[reply.id % count];
 
-				return st;
-			}
-		}
-		else if (choice == 8)
-		{
-			st = sort_selection_array_dar((*ptable)->buffer, (*ptable)->size);
+			if (!shown[alg])
+				first[alg] = reply;
 
-			if (st != DS_OK)
-				return st;
+			shown[alg] = true;
 		}
-		else
+	}
+
+	double elapsed = bch_now() - start;
+
+	close(fd);
+
+	if (st == DS_OK)
+	{
+		for (i = 0; i < (int)count; i++)
 		{
-			printf("Invalid command...");
+			printf("\n%s\n", alg_names[chosen[i]]);
 
-			ENTER;
+			cli_display_summary(&first[chosen[i]].metrics);
 		}
+
+		qsort(latency, answered, sizeof(double), cli_compare_double);
+
+		printf("\n%lu requests in %.3f ms, %.1f us each\n", requests, 1e3 * elapsed, 1e6 * elapsed / requests);
+		printf("Round trip: %.1f us median, %.1f us p99, %.1f us max\n", 1e6 * latency[answered / 2],
+			   1e6 * latency[(size_t)ceil(0.99 * answered) - 1], 1e6 * latency[answered - 1]);
 	}
 
-	return DS_OK;
+	free(message);
+	free(sent);
+	free(latency);
+
+	return st;
 }
 
-Status process_scheduling(DynamicArray *ptable)
+Status cli_view(int argc, char **argv)
 {
-	Status st;
+	bool algorithms[ALG_COUNT];
 
-	while (1)
+	size_t alg, selected = 0, tick = 0;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		algorithms[alg] = alg == 0;
+
+	char *path = FILE_NAME;
+
+	SchedulerParams params;
+
+	sch_default_params(&params);
+
+	Status st = DS_OK;
+
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
 	{
-		CLEAR_SCREEN;
-		printf(" +--------------------------------------------------+\n");
-		printf(" |           Process Scheduling Algorithms          |\n");
-		printf(" +--------------------------------------------------+\n");
-		printf(" | 0 - Return                                       |\n");
-		printf(" | 1 - Round Robin                                  |\n");
-		printf(" | 2 - Static Priority                              |\n");
-		printf(" | 3 - Dynamic Priority                             |\n");
-		printf(" | 4 - By Process Type                              |\n");
-		printf(" | 5 - All Algorithms                               |\n");
-		printf(" +--------------------------------------------------+\n");
-		printf(" > ");
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-f") == 0)
+			path = arg;
+		else if (strcmp(opt, "-a") == 0)
+			st = cli_algorithms(arg, algorithms);
+		else if (strcmp(opt, "-t") == 0)
+			st = cli_size(arg, &tick);
+		else if ((st = cli_params(&params, opt, arg)) == DS_ERR_NOT_FOUND)
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
 
-		int choice;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		selected += algorithms[alg];
 
-		scanf("%d", &choice);
+	if (st == DS_OK && selected != 1)
+		st = DS_ERR_INVALID_ARGUMENT;
 
-		if (choice == 0)
-		{
-			return DS_OK;
-		}
-		else if (choice >= 1 && choice <= 5)
-		{
-			QueueArray *queue, *result;
+	if (st != DS_OK)
+	{
+		cli_usage();
 
-			st = dar_copy(ptable, &queue);
+		return st;
+	}
 
-			if (st != DS_OK)
-				return st;
+	for (alg = 0; !algorithms[alg]; alg++)
+		;
 
-			st = sort_selection_array_dar(queue->buffer, queue->length);
+	QueueArray *table;
 
-			if (st != DS_OK)
-				return st;
+	st = file_load_table(path, &table);
 
-			if (choice == 1)
-			{
-				st = alg_round_robin(queue, &result);
+	if (st != DS_OK)
+		return st;
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+	Replay *rpl;
 
-					ENTER;
-				}
-			}
-			else if (choice == 2)
-			{
-				st = alg_pri_static(queue, &result);
+	st = rpl_init(&rpl, table, (AlgorithmId)alg, &params);
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+	if (st == DS_OK)
+	{
+		st = rpl_seek(rpl, tick);
 
-					ENTER;
-				}
-			}
-			else if (choice == 3)
-			{
-				st = alg_pri_dynamic(queue, &result);
+		if (st == DS_OK)
+			st = rpl_view(rpl);
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+		rpl_delete(&rpl);
+	}
 
-					ENTER;
-				}
-			}
-			else if (choice == 4)
-			{
-				st = alg_pri_type(queue, &result);
+	qua_delete(&table);
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+	return st;
+}
 
-					ENTER;
-				}
-			}
-			else if (choice == 5)
-			{
-				QueueArray *round_robin, *static_pri, *dynamic_pri, *type_pri;
+Status cli_gantt(int argc, char **argv)
+{
+	char *path = NULL;
 
-				QueueArray *queue1, *queue2, *queue3, *queue4;
+	size_t run = 0, width = TRACE_GANTT_WIDTH;
 
-				st += qua_copy(queue, &queue1);
-				st += qua_copy(queue, &queue2);
-				st += qua_copy(queue, &queue3);
-				st += qua_copy(queue, &queue4);
+	Status st = DS_OK;
 
-				if (st != DS_OK)
-					return st;
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-f") == 0)
+			path = arg;
+		else if (strcmp(opt, "-r") == 0)
+			st = cli_size(arg, &run);
+		else if (strcmp(opt, "-w") == 0)
+			st = cli_size(arg, &width);
+		else
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
 
-				st = alg_round_robin(queue1, &round_robin);
+	if (st == DS_OK && (path == NULL || width == 0))
+		st = DS_ERR_INVALID_ARGUMENT;
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+	if (st != DS_OK)
+	{
+		cli_usage();
 
-					ENTER;
-				}
+		return st;
+	}
 
-				st = alg_pri_static(queue2, &static_pri);
+	TraceReader *trd;
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+	st = trd_open(&trd, path);
 
-					ENTER;
-				}
+	if (st != DS_OK)
+		return st;
 
-				st = alg_pri_dynamic(queue3, &dynamic_pri);
+	st = trd_gantt(trd, run, width);
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+	trd_close(&trd);
 
-					ENTER;
-				}
+	return st;
+}
 
-				st = alg_pri_type(queue4, &type_pri);
+Status cli_seek(int argc, char **argv)
+{
+	char *path = NULL;
 
-				if (st != DS_OK)
-				{
-					print_status_repr(st);
+	size_t run = 0, tick = 0, pid = 0;
 
-					ENTER;
-				}
+	bool at = false, of = false;
 
-				CLEAR_SCREEN;
+	Status st = DS_OK;
 
-				printf("\n|%s|%s|%s|%s|", " Round Robin ", " Static Priority ", " Dynamic Priority ", " Priority by type ");
-				printf("\n|%s|%s|%s|%s|", "-------------", "-----------------", "------------------", "------------------");
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-f") == 0)
+			path = arg;
+		else if (strcmp(opt, "-r") == 0)
+			st = cli_size(arg, &run);
+		else if (strcmp(opt, "-t") == 0)
+		{
+			st = cli_size(arg, &tick);
+			at = true;
+		}
+		else if (strcmp(opt, "-p") == 0)
+		{
+			st = cli_size(arg, &pid);
+			of = true;
+		}
+		else
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
 
-				for (size_t i = 0; i < round_robin->length; i++)
-				{
-					printf("\n|%13s|%17s|%18s|%18s|",
-						   round_robin->buffer[i]->name->buffer,
-						   static_pri->buffer[i]->name->buffer,
-						   dynamic_pri->buffer[i]->name->buffer,
-						   type_pri->buffer[i]->name->buffer);
-				}
+	// Exactly one question
+	if (st == DS_OK && (path == NULL || at == of))
+		st = DS_ERR_INVALID_ARGUMENT;
 
-				ENTER;
+	if (st != DS_OK)
+	{
+		cli_usage();
 
-				qua_delete(&round_robin);
-				qua_delete(&static_pri);
-				qua_delete(&dynamic_pri);
-				qua_delete(&type_pri);
+		return st;
+	}
 
-				qua_delete(&queue1);
-				qua_delete(&queue2);
-				qua_delete(&queue3);
-				qua_delete(&queue4);
-			}
+	TraceIndex *tix;
 
-			if (choice != 5)
-			{
-				printf("\nResults\n");
+	st = tix_open(&tix, path);
 
-				qua_display(result);
+	if (st != DS_OK)
+		return st;
 
-				ENTER;
+	if (at)
+		st = tix_state(tix, run == 0 ? 1 : run, tick);
+	else
+		st = tix_history(tix, run, pid);
 
-				st = qua_delete(&result);
+	tix_close(&tix);
 
-				if (st != DS_OK)
-					return st;
-			}
+	return st;
+}
 
-			st = qua_delete(&queue);
+Status cli_check(int argc, char **argv)
+{
+	bool algorithms[ALG_COUNT];
 
-			if (st != DS_OK)
-				return st;
-		}
+	size_t alg;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		algorithms[alg] = true;
+
+	size_t tables = CHECK_TABLES, seed = 1;
+
+	Status st = DS_OK;
+
+	int i;
+	for (i = 2; i < argc && st == DS_OK; i += 2)
+	{
+		char *opt = argv[i], *arg = argv[i + 1];
+
+		if (arg == NULL)
+			st = DS_ERR_INVALID_ARGUMENT;
+		else if (strcmp(opt, "-n") == 0)
+			st = cli_size(arg, &tables);
+		else if (strcmp(opt, "-s") == 0)
+			st = cli_size(arg, &seed);
+		else if (strcmp(opt, "-a") == 0)
+			st = cli_algorithms(arg, algorithms);
 		else
-		{
-			printf("Invalid command...");
+			st = DS_ERR_INVALID_ARGUMENT;
+	}
 
-			ENTER;
-		}
+	if (st == DS_OK && tables == 0)
+		st = DS_ERR_INVALID_ARGUMENT;
+
+	if (st != DS_OK)
+	{
+		cli_usage();
+
+		return st;
 	}
 
-	return DS_OK;
+	st = chk_resume(algorithms, tables, seed);
+
+	if (st == DS_OK || st == DS_ERR_UNEXPECTED_RESULT)
+	{
+		Status boost = chk_boost(seed);
+
+		if (st == DS_OK)
+			st = boost;
+	}
+
+	return st;
 }
 
-void copyright(void)
+int cli_main(int argc, char **argv)
 {
-	CLEAR_SCREEN;
-	printf(" +--------------------------------------------------+\n");
-	printf(" |                     Copyright                    |\n");
-	printf(" +--------------------------------------------------+\n");
-	printf(" | Leonardo Vencovsky 201710276                     |\n");
-	printf(" +--------------------------------------------------+\n");
+	Status st;
 
-	printf("\nPress enter to continue...");
+	if (strcmp(argv[1], "montecarlo") == 0)
+		st = cli_montecarlo(argc, argv);
+	else if (strcmp(argv[1], "generate") == 0)
+		st = cli_generate(argc, argv);
+	else if (strcmp(argv[1], "run") == 0)
+		st = cli_run(argc, argv);
+	else if (strcmp(argv[1], "bench") == 0)
+		st = cli_bench(argc, argv);
+	else if (strcmp(argv[1], "serve") == 0)
+		st = cli_serve(argc, argv);
+	else if (strcmp(argv[1], "query") == 0)
+		st = cli_query(argc, argv);
+	else if (strcmp(argv[1], "view") == 0)
+		st = cli_view(argc, argv);
+	else if (strcmp(argv[1], "gantt") == 0)
+		st = cli_gantt(argc, argv);
+	else if (strcmp(argv[1], "seek") == 0)
+		st = cli_seek(argc, argv);
+	else if (strcmp(argv[1], "check") == 0)
+		st = cli_check(argc, argv);
+	else
+	{
+		cli_usage();
 
-	ENTER;
+		return DS_ERR_INVALID_ARGUMENT;
+	}
+
+	if (st != DS_OK)
+		print_status_repr(st);
+
+	return st;
 }
 
 /* ----------------------------------------------------------------------------------------------------
  *
- *                                                                                         Menu Functions
+ *                                                                                         Command Line
  *
  * ---------------------------------------------------------------------------------------------------- */
-
-int main()
+int main(int argc, char **argv)
 {
+	if (argc > 1)
+		return cli_main(argc, argv);
+
 	DynamicArray *ptable;
 
 	Status st = dar_init(&ptable);
@@ -3738,6 +19095,24 @@ int main()
 		return st;
 	}
 
+	ResultCache *cache;
+
+	st = rch_init(&cache, RESULT_CACHE_DIRECTORY);
+
+	if (st != DS_OK)
+		return st;
+
+	CheckpointLog *logs[ALG_COUNT];
+
+	size_t alg;
+	for (alg = 0; alg < ALG_COUNT; alg++)
+	{
+		st = ckp_init(&logs[alg], alg, NULL);
+
+		if (st != DS_OK)
+			return st;
+	}
+
 	bool exit = false;
 
 	int choice;
@@ -3763,7 +19138,7 @@ int main()
 			exit = true;
 			break;
 		case 1:
-			st = process_table(&ptable);
+			st = process_table(&ptable, cache);
 			if (st != DS_OK)
 			{
 				print_status_repr(st);
@@ -3772,7 +19147,7 @@ int main()
 			}
 			break;
 		case 2:
-			st = process_scheduling(ptable);
+			st = process_scheduling(ptable, cache, logs);
 			if (st != DS_OK)
 			{
 				print_status_repr(st);
@@ -3790,7 +19165,14 @@ int main()
 		}
 	}
 
+	for (alg = 0; alg < ALG_COUNT; alg++)
+		ckp_delete(&logs[alg]);
+
+	rch_delete(&cache);
+
 	dar_delete(&ptable);
 
 	return 0;
 }
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file process.h
+ *
+ * C interface of the process scheduling library
+ *
+ * Built from process.c with PROCESS_NO_MAIN defined, which leaves out the
+ * menus, the command line and the visual mode. Every call works on its own
+ * Simulation, nothing is shared between them and nothing is printed, so
+ * separate simulations can run at the same time on different threads.
+ *
+ */
+
+#ifndef PROCESS_SCHEDULING_H
+#define PROCESS_SCHEDULING_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Marks what a shared build exports, build it with -fvisibility=hidden
+#if defined(_WIN32) && defined(PROCESS_SHARED)
+#define PROCESS_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define PROCESS_API __attribute__((visibility("default")))
+#else
+#define PROCESS_API
+#endif
+
+/**
+ * @brief Status code returned by functions
+ *
+ * These status codes are returned by almost all functions in the project.
+ * They are used to prevent unwanted results when a function fails and can
+ * also be used by the user to control his/her own program flow.
+ *
+ */
+typedef enum Status
+{
+	DS_OK = 0,					  /**< Returned by a function when all operations were successful */
+	DS_ERR_INVALID_POSITION = 1,  /**< When an invalid position is passed as argument */
+	DS_ERR_INVALID_OPERATION = 2, /**< When an invalid operation is made (e.g. remove element of an empty list ) */
+	DS_ERR_INVALID_SIZE = 3,	  /**< When an invalid size is given */
+	DS_ERR_NOT_FOUND = 4,		  /**< When a search fails to find a value */
+	DS_ERR_ALLOC = 5,			  /**< When a function fails to allocate memory  */
+	DS_ERR_UNEXPECTED_RESULT = 6, /**< When an unexpected result happens. Contact developers. */
+	DS_ERR_ITER = 7,			  /**< When an iteration reaches an unexpected value */
+	DS_ERR_NULL_POINTER = 8,	  /**< When a @c NULL parameter is passed to a function */
+	DS_ERR_FULL = 9,			  /**< When a structure reaches its maximum capacity */
+	DS_ERR_INVALID_ARGUMENT = 10  /**< When an argument passed is invalid for that operation */
+} Status;
+
+PROCESS_API char *status_repr(Status status);
+
+/**
+ * @brief One scheduling run
+ *
+ * Created for one algorithm, tuned with sim_set, fed with sim_submit or
+ * sim_load and then stepped or run to the end. Opaque, only used through
+ * the functions below.
+ */
+typedef struct Simulation Simulation;
+
+/**
+ * @brief A process to submit, the columns of a process.txt line
+ */
+typedef struct SimulationProcess
+{
+	const char *name; /*!< Process name, copied */
+	size_t pid;		  /*!< Process ID, kills and priority changes find the process by it */
+	size_t cpu;		  /*!< CPU ticks, of each job when periodic */
+	size_t io;		  /*!< I/O ticks, of each job when periodic */
+	size_t pri;		  /*!< Priority, 0 is the highest */
+	const char *type; /*!< "SO", "UI" or "UNI" */
+	size_t period;	/*!< Ticks between job releases, 0 when not periodic */
+	size_t deadline;  /*!< Ticks a job has after its release, 0 for none (the period when periodic) */
+	size_t arrival;   /*!< Tick the process arrives */
+	const size_t *burst; /*!< CPU and I/O bursts in turn, first and last CPU, copied, or NULL for cpu and io */
+	size_t bursts;		 /*!< Entries of burst, odd */
+} SimulationProcess;
+
+/**
+ * @brief Metrics of a run, over the processes finished so far
+ */
+typedef struct SimulationMetrics
+{
+	size_t finished;		/*!< Finished processes */
+	size_t killed;			/*!< Processes killed before they finished */
+	size_t ticks;			/*!< Ticks simulated */
+	size_t busy;			/*!< Ticks in which the CPU did useful work */
+	size_t jobs;			/*!< Finished jobs that had a deadline */
+	size_t misses;			/*!< Jobs that finished after their deadline */
+	double turnaround_mean; /*!< Mean of finish - arrival */
+	size_t turnaround_max;  /*!< Largest turnaround */
+	size_t turnaround_p99;  /*!< 99th percentile turnaround */
+	double waiting_mean;	/*!< Mean ticks spent in a ready queue */
+	size_t waiting_max;		/*!< Largest waiting time */
+	size_t waiting_p99;		/*!< 99th percentile waiting time */
+	double response_mean;   /*!< Mean of first_run - arrival */
+	size_t response_max;	/*!< Largest response time */
+	size_t response_p99;	/*!< 99th percentile response time */
+	double throughput;		/*!< Finished processes per tick */
+	double utilization;		/*!< Fraction of ticks the CPU did useful work */
+	double fairness;		/*!< Jain's index of the slowdowns */
+	double miss_ratio;		/*!< Fraction of the jobs that missed their deadline */
+} SimulationMetrics;
+
+/**
+ * @brief A process that left a run, as a sink gets it
+ */
+typedef struct SimulationResult
+{
+	const char *name; /*!< Process name, only valid during the call */
+	size_t pid;		  /*!< Process ID */
+	size_t arrival;   /*!< Tick it arrived */
+	size_t first_run; /*!< Tick it first got the CPU */
+	size_t finish;	/*!< Tick it finished, or was killed */
+	size_t waiting;   /*!< Ticks spent in a ready queue */
+	size_t blocked;   /*!< Ticks spent waiting for I/O */
+	size_t jobs;	  /*!< Finished jobs that had a deadline */
+	size_t misses;	/*!< Jobs that finished after their deadline */
+	bool killed;	  /*!< Killed before it finished */
+} SimulationResult;
+
+typedef void (*SimulationSink)(void *context, const SimulationResult *result);
+
+// algorithm is a command line name: rr, static, dynamic, type, sjf, srtf,
+// mlfq, cfs, lottery, edf or rm
+PROCESS_API Status sim_create(Simulation **sim, const char *algorithm);
+
+// A policy option of the command line without its dashes ("aging", "mlfq",
+// "boost", "latency", "granularity", "horizon", "kill", "priority",
+// "lottery-seed"). Only before the first process is submitted.
+PROCESS_API Status sim_set(Simulation *sim, const char *option, const char *value);
+
+PROCESS_API Status sim_submit(Simulation *sim, const SimulationProcess *process);
+PROCESS_API Status sim_load(Simulation *sim, const char *path); // Submits every line of a process table
+
+PROCESS_API Status sim_step(Simulation *sim); // One tick
+PROCESS_API Status sim_run(Simulation *sim);  // Until every process finished
+
+PROCESS_API bool sim_done(Simulation *sim);
+PROCESS_API size_t sim_clock(Simulation *sim);
+
+PROCESS_API Status sim_metrics(Simulation *sim, SimulationMetrics *result);
+
+// Hands every process that leaves the run from now on to sink, or to
+// nothing when it is NULL, and frees it instead of keeping it until
+// sim_delete. Metrics still count it, so a run fed with sim_submit as its
+// processes arrive only holds the ones that did not finish yet.
+PROCESS_API Status sim_sink(Simulation *sim, SimulationSink sink, void *context);
+
+// Writes the whole state to a checkpoint file from a forked child and
+// returns without waiting for it. The state is encoded before the fork and
+// the child only writes it out with async-signal-safe calls, so other
+// threads of the process can be anywhere meanwhile. DS_ERR_FULL while the
+// file of the previous call is still being written. Not while another
+// thread runs the simulation.
+PROCESS_API Status sim_save(Simulation *sim, const char *path);
+PROCESS_API Status sim_wait(Simulation *sim); // Until the last sim_save is written, its status
+
+// A simulation in the state a checkpoint file was saved in, with its
+// algorithm and options, that goes on exactly as the saved one would have
+PROCESS_API Status sim_open(Simulation **sim, const char *path);
+
+PROCESS_API Status sim_delete(Simulation **sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif